@@ -0,0 +1,129 @@
+#include "benchmarkdata.h"
+
+#include <cad/primitive/arc.h>
+#include <cad/primitive/circle.h>
+#include <cad/primitive/line.h>
+
+#include <fstream>
+#include <string>
+
+using namespace lcbenchmark;
+
+const uint64_t Random::DEFAULT_SEED;
+
+Random::Random(uint64_t seed) :
+    _engine(seed) {
+}
+
+double Random::uniform(double min, double max) {
+    // 53 random bits give every double of [0, 1) with the same probability
+    const double unit = static_cast<double>(_engine() >> 11) / 9007199254740992.;
+    return min + (max - min) * unit;
+}
+
+size_t Random::index(size_t count) {
+    return static_cast<size_t>(_engine() % count);
+}
+
+lc::geo::Coordinate Random::coordinate(const lc::geo::Area& area) {
+    return lc::geo::Coordinate(
+            uniform(area.minP().x(), area.maxP().x()),
+            uniform(area.minP().y(), area.maxP().y())
+    );
+}
+
+lc::geo::Area lcbenchmark::documentArea() {
+    // Same as the spatial index of EntityContainer
+    return lc::geo::Area(lc::geo::Coordinate(-500000., -500000.), lc::geo::Coordinate(500000., 500000.));
+}
+
+lc::geo::Area lcbenchmark::randomWindow(Random& random, const lc::geo::Area& area, double part) {
+    const double width = area.width() * part;
+    const double height = area.height() * part;
+
+    auto min = random.coordinate(lc::geo::Area(
+            area.minP(),
+            lc::geo::Coordinate(area.maxP().x() - width, area.maxP().y() - height)
+    ));
+
+    return lc::geo::Area(min, lc::geo::Coordinate(min.x() + width, min.y() + height));
+}
+
+std::vector<lc::entity::CADEntity_CSPtr> lcbenchmark::randomLines(Random& random, size_t count,
+                                                                 const lc::geo::Area& area, double maxLength,
+                                                                 const lc::Layer_CSPtr& layer) {
+    std::vector<lc::entity::CADEntity_CSPtr> lines;
+    lines.reserve(count);
+
+    for (size_t i = 0; i < count; i++) {
+        auto start = random.coordinate(area);
+        auto end = lc::geo::Coordinate(
+                start.x() + random.uniform(-maxLength, maxLength),
+                start.y() + random.uniform(-maxLength, maxLength)
+        );
+
+        lines.push_back(std::make_shared<lc::entity::Line>(start, end, layer));
+    }
+
+    return lines;
+}
+
+std::vector<lc::entity::CADEntity_CSPtr> lcbenchmark::randomEntities(Random& random, size_t count,
+                                                                    const lc::geo::Area& area, double maxSize,
+                                                                    const lc::Layer_CSPtr& layer) {
+    std::vector<lc::entity::CADEntity_CSPtr> entities;
+    entities.reserve(count);
+
+    for (size_t i = 0; i < count; i++) {
+        auto center = random.coordinate(area);
+        auto size = random.uniform(maxSize / 100., maxSize);
+
+        switch (random.index(3)) {
+            case 0:
+                entities.push_back(std::make_shared<lc::entity::Line>(
+                        center,
+                        lc::geo::Coordinate(center.x() + size, center.y() + random.uniform(-size, size)),
+                        layer
+                ));
+                break;
+
+            case 1:
+                entities.push_back(std::make_shared<lc::entity::Circle>(center, size / 2., layer));
+                break;
+
+            default:
+                entities.push_back(std::make_shared<lc::entity::Arc>(
+                        center, size / 2., random.uniform(0., 3.), random.uniform(3., 6.), true, layer
+                ));
+                break;
+        }
+    }
+
+    return entities;
+}
+
+namespace {
+    /**
+     * @return value in bytes of a field of /proc/self/status given in kB, like VmRSS
+     */
+    size_t procStatus(const std::string& field) {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+
+        while (std::getline(status, line)) {
+            if (line.compare(0, field.size() + 1, field + ":") == 0) {
+                return std::stoul(line.substr(field.size() + 1)) * 1024;
+            }
+        }
+
+        return 0;
+    }
+}
+
+size_t lcbenchmark::residentSetSize() {
+    return procStatus("VmRSS");
+}
+
+size_t lcbenchmark::peakResidentSetSize() {
+    return procStatus("VmHWM");
+}
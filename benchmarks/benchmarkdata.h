@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <cad/base/cadentity.h>
+#include <cad/geometry/geoarea.h>
+#include <cad/geometry/geocoordinate.h>
+#include <cad/meta/layer.h>
+
+/**
+ * Generated data of the benchmarks
+ *
+ * All the data comes from a generator with a fixed seed, and doesn't use the distributions of the standard library
+ * which are implementation defined. The same benchmark gets the same entities on every build machine.
+ */
+namespace lcbenchmark {
+    class Random {
+        public:
+            static const uint64_t DEFAULT_SEED = 0x4c69627265434144;
+
+            explicit Random(uint64_t seed = DEFAULT_SEED);
+
+            /**
+             * @return number in [min, max)
+             */
+            double uniform(double min, double max);
+
+            /**
+             * @return index in [0, count)
+             */
+            size_t index(size_t count);
+
+            lc::geo::Coordinate coordinate(const lc::geo::Area& area);
+
+        private:
+            std::mt19937_64 _engine;
+    };
+
+    /**
+     * @return area of the spatial index of a document
+     */
+    lc::geo::Area documentArea();
+
+    /**
+     * @return area inside the document area, with the given part of its width and height
+     */
+    lc::geo::Area randomWindow(Random& random, const lc::geo::Area& area, double part);
+
+    /**
+     * @brief Lines with a random position in the area
+     * @param maxLength maximal length along each axis
+     */
+    std::vector<lc::entity::CADEntity_CSPtr> randomLines(Random& random, size_t count, const lc::geo::Area& area,
+                                                          double maxLength, const lc::Layer_CSPtr& layer);
+
+    /**
+     * @brief Lines, circles and arcs with a random position in the area
+     */
+    std::vector<lc::entity::CADEntity_CSPtr> randomEntities(Random& random, size_t count, const lc::geo::Area& area,
+                                                             double maxSize, const lc::Layer_CSPtr& layer);
+
+    /**
+     * @return resident set size of the process in bytes, 0 when it can't be read on this system
+     */
+    size_t residentSetSize();
+
+    /**
+     * @return peak resident set size of the process in bytes, 0 when it can't be read on this system
+     */
+    size_t peakResidentSetSize();
+}
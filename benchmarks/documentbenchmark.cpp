@@ -0,0 +1,82 @@
+#include <chrono>
+#include <benchmark/benchmark.h>
+#include <cad/base/entitypool.h>
+#include <cad/dochelpers/documentimpl.h>
+#include <cad/dochelpers/storagemanagerimpl.h>
+#include <cad/operations/entitybuilder.h>
+
+#include "benchmarkdata.h"
+
+using namespace lc;
+using namespace lcbenchmark;
+
+/**
+ * @return bytes reserved by all the shared entity pools
+ */
+static size_t poolBytesReserved() {
+    size_t reserved = 0;
+
+    for (size_t size = pool::FixedSizePool::Alignment; size <= pool::FixedSizePool::MaxBlockSize;
+         size += pool::FixedSizePool::Alignment) {
+        reserved += pool::FixedSizePool::forSize(size).bytesReserved();
+    }
+
+    return reserved;
+}
+
+/**
+ * Open a document of lines and close it again
+ * Opening is measured as creating all the lines with EntityBuilder:appendLines(), like a script or an import does.
+ * Time and resident set size of both steps are reported as counters, the iteration time covers both.
+ */
+static void Document_OpenClose(benchmark::State& state) {
+    Random random;
+    auto area = documentArea();
+    auto layer = std::make_shared<const Layer>();
+
+    std::vector<double> coordinates;
+    coordinates.reserve(state.range(0) * 4);
+    for (int64_t i = 0; i < state.range(0); i++) {
+        auto start = random.coordinate(area);
+        coordinates.push_back(start.x());
+        coordinates.push_back(start.y());
+        coordinates.push_back(start.x() + random.uniform(-1000., 1000.));
+        coordinates.push_back(start.y() + random.uniform(-1000., 1000.));
+    }
+
+    const double MB = 1024. * 1024.;
+    double openTime = 0;
+    double closeTime = 0;
+    double openedRSS = 0;
+    double closedRSS = 0;
+
+    for (auto _ : state) {
+        auto start = std::chrono::steady_clock::now();
+
+        auto document = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+        auto builder = std::make_shared<operation::EntityBuilder>(document);
+        builder->appendLines(coordinates, layer);
+        builder->execute();
+        builder.reset();
+
+        auto opened = std::chrono::steady_clock::now();
+        openedRSS += residentSetSize() / MB;
+
+        document.reset();
+
+        auto closed = std::chrono::steady_clock::now();
+        closedRSS += residentSetSize() / MB;
+
+        openTime += std::chrono::duration<double, std::milli>(opened - start).count();
+        closeTime += std::chrono::duration<double, std::milli>(closed - opened).count();
+    }
+
+    state.counters["open_ms"] = benchmark::Counter(openTime, benchmark::Counter::kAvgIterations);
+    state.counters["close_ms"] = benchmark::Counter(closeTime, benchmark::Counter::kAvgIterations);
+    state.counters["opened_rss_MB"] = benchmark::Counter(openedRSS, benchmark::Counter::kAvgIterations);
+    state.counters["closed_rss_MB"] = benchmark::Counter(closedRSS, benchmark::Counter::kAvgIterations);
+    state.counters["peak_rss_MB"] = peakResidentSetSize() / MB;
+    state.counters["closed_pool_MB"] = poolBytesReserved() / MB;
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(Document_OpenClose)->Arg(1000000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,50 @@
+#include <cstdio>
+#include <benchmark/benchmark.h>
+#include <cad/dochelpers/documentimpl.h>
+#include <cad/dochelpers/storagemanagerimpl.h>
+#include <file.h>
+#include <libdxfrw/dxfimpl.h>
+
+#include "benchmarkdata.h"
+
+using namespace lc;
+using namespace lcbenchmark;
+
+/**
+ * Import of a generated DXF file with lines, circles and arcs
+ */
+static void DXFimpl_Open(benchmark::State& state) {
+    const std::string path = "lcbenchmark_" + std::to_string(state.range(0)) + ".dxf";
+
+    {
+        Random random;
+        auto document = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+        auto layer = document->layerByName("0");
+        for (const auto& entity : randomEntities(random, state.range(0), documentArea(), 1000., layer)) {
+            document->insertEntity(entity);
+        }
+
+        DXFimpl dxf(document);
+        if (!dxf.writeDXF(path, File::LIBDXFRW_DXF_R2013)) {
+            state.SkipWithError("Cannot write the DXF file");
+            return;
+        }
+    }
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto document = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+        state.ResumeTiming();
+
+        File::open(document, path, File::LIBDXFRW);
+
+        state.PauseTiming();
+        benchmark::DoNotOptimize(document->entities().size());
+        document.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    std::remove(path.c_str());
+}
+BENCHMARK(DXFimpl_Open)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,106 @@
+#include <benchmark/benchmark.h>
+#include <cad/dochelpers/documentimpl.h>
+#include <cad/dochelpers/storagemanagerimpl.h>
+#include <cad/operations/entitybuilder.h>
+#include <cad/operations/entityops.h>
+
+#include "benchmarkdata.h"
+
+using namespace lc;
+using namespace lcbenchmark;
+
+/**
+ * Append entities to an empty document
+ */
+static void EntityBuilder_Append(benchmark::State& state) {
+    Random random;
+    auto entities = randomEntities(random, state.range(0), documentArea(), 1000., std::make_shared<const Layer>());
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto document = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+        auto builder = std::make_shared<operation::EntityBuilder>(document);
+        for (const auto& entity : entities) {
+            builder->appendEntity(entity);
+        }
+        state.ResumeTiming();
+
+        builder->execute();
+
+        state.PauseTiming();
+        builder.reset();
+        document.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * entities.size());
+}
+BENCHMARK(EntityBuilder_Append)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+/**
+ * Create lines from a flat list of coordinates, like scripts do with EntityBuilder:appendLines()
+ */
+static void EntityBuilder_AppendLines(benchmark::State& state) {
+    Random random;
+    auto area = documentArea();
+    auto layer = std::make_shared<const Layer>();
+
+    std::vector<double> coordinates;
+    coordinates.reserve(state.range(0) * 4);
+    for (int64_t i = 0; i < state.range(0); i++) {
+        auto start = random.coordinate(area);
+        coordinates.push_back(start.x());
+        coordinates.push_back(start.y());
+        coordinates.push_back(start.x() + random.uniform(-1000., 1000.));
+        coordinates.push_back(start.y() + random.uniform(-1000., 1000.));
+    }
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto document = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+        auto builder = std::make_shared<operation::EntityBuilder>(document);
+        state.ResumeTiming();
+
+        builder->appendLines(coordinates, layer);
+        builder->execute();
+
+        state.PauseTiming();
+        builder.reset();
+        document.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(EntityBuilder_AppendLines)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+/**
+ * Move all the entities of a document, which replaces them in the document
+ */
+static void EntityBuilder_Move(benchmark::State& state) {
+    Random random;
+    auto document = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+    auto layer = document->layerByName("0");
+
+    auto builder = std::make_shared<operation::EntityBuilder>(document);
+    for (const auto& entity : randomEntities(random, state.range(0), documentArea(), 1000., layer)) {
+        builder->appendEntity(entity);
+    }
+    builder->execute();
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        builder = std::make_shared<operation::EntityBuilder>(document);
+        for (const auto& entity : document->entityContainer().asVector()) {
+            builder->appendEntity(entity);
+        }
+        builder->appendOperation(std::make_shared<operation::Push>());
+        builder->appendOperation(std::make_shared<operation::Move>(geo::Coordinate(random.uniform(-10., 10.), random.uniform(-10., 10.))));
+        state.ResumeTiming();
+
+        builder->execute();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(EntityBuilder_Move)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
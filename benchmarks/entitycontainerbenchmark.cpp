@@ -0,0 +1,64 @@
+#include <benchmark/benchmark.h>
+#include <cad/dochelpers/entitycontainer.h>
+
+#include "benchmarkdata.h"
+
+using namespace lc;
+using namespace lcbenchmark;
+
+namespace {
+    using Container = EntityContainer<entity::CADEntity_CSPtr>;
+
+    void fill(Container& container, size_t count) {
+        Random random;
+
+        for (const auto& entity : randomEntities(random, count, documentArea(), 1000., std::make_shared<const Layer>())) {
+            container.insert(entity);
+        }
+    }
+
+    /**
+     * Query random windows of 1% of the document, like a zoomed in view
+     */
+    template<typename Query>
+    void query(benchmark::State& state, Query query) {
+        Container container;
+        fill(container, state.range(0));
+        Random random;
+        size_t found = 0;
+
+        for (auto _ : state) {
+            found += query(container, randomWindow(random, documentArea(), 0.01));
+        }
+
+        state.counters["entities"] = benchmark::Counter(found, benchmark::Counter::kAvgIterations);
+    }
+}
+
+static void EntityContainer_FullWithin(benchmark::State& state) {
+    query(state, [](const Container& container, const geo::Area& area) {
+        return container.entitiesFullWithin(area).size();
+    });
+}
+BENCHMARK(EntityContainer_FullWithin)->RangeMultiplier(10)->Range(10000, 1000000);
+
+static void EntityContainer_WithinAndCrossing(benchmark::State& state) {
+    query(state, [](const Container& container, const geo::Area& area) {
+        return container.entitiesWithinAndCrossing(area).size();
+    });
+}
+BENCHMARK(EntityContainer_WithinAndCrossing)->RangeMultiplier(10)->Range(10000, 1000000);
+
+static void EntityContainer_WithinAndCrossingArea(benchmark::State& state) {
+    query(state, [](const Container& container, const geo::Area& area) {
+        return container.entitiesWithinAndCrossingArea(area).asVector().size();
+    });
+}
+BENCHMARK(EntityContainer_WithinAndCrossingArea)->RangeMultiplier(10)->Range(10000, 1000000);
+
+static void EntityContainer_Overlapping(benchmark::State& state) {
+    query(state, [](const Container& container, const geo::Area& area) {
+        return container.entitiesOverlapping(area).size();
+    });
+}
+BENCHMARK(EntityContainer_Overlapping)->RangeMultiplier(10)->Range(10000, 1000000);
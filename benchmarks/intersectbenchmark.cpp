@@ -0,0 +1,104 @@
+#include <functional>
+#include <benchmark/benchmark.h>
+#include <cad/base/visitor.h>
+#include <cad/functions/intersect.h>
+
+#include "benchmarkdata.h"
+
+using namespace lc;
+using namespace lcbenchmark;
+
+namespace {
+    const size_t PAIRS = 256;
+
+    struct Primitive {
+        const char* name;
+        std::function<entity::CADEntity_CSPtr(Random&, const Layer_CSPtr&)> create;
+    };
+
+    /**
+     * Primitives of the Intersect visitor, all around the origin so most pairs intersect
+     * Points and splines are left out, their intersections aren't implemented.
+     */
+    const std::vector<Primitive>& primitives() {
+        static const std::vector<Primitive> primitives = {
+            {"Line", [](Random& random, const Layer_CSPtr& layer) {
+                return std::make_shared<entity::Line>(
+                        geo::Coordinate(random.uniform(-10., -5.), random.uniform(-10., 10.)),
+                        geo::Coordinate(random.uniform(5., 10.), random.uniform(-10., 10.)),
+                        layer
+                );
+            }},
+            {"Circle", [](Random& random, const Layer_CSPtr& layer) {
+                return std::make_shared<entity::Circle>(
+                        geo::Coordinate(random.uniform(-2., 2.), random.uniform(-2., 2.)), random.uniform(3., 6.), layer
+                );
+            }},
+            {"Arc", [](Random& random, const Layer_CSPtr& layer) {
+                return std::make_shared<entity::Arc>(
+                        geo::Coordinate(random.uniform(-2., 2.), random.uniform(-2., 2.)), random.uniform(3., 6.),
+                        random.uniform(0., 1.), random.uniform(3., 5.), true, layer
+                );
+            }},
+            {"Ellipse", [](Random& random, const Layer_CSPtr& layer) {
+                return std::make_shared<entity::Ellipse>(
+                        geo::Coordinate(random.uniform(-2., 2.), random.uniform(-2., 2.)),
+                        geo::Coordinate(random.uniform(4., 8.), random.uniform(-1., 1.)),
+                        random.uniform(2., 4.), 0., 2. * M_PI, false, layer
+                );
+            }},
+            {"LWPolyline", [](Random& random, const Layer_CSPtr& layer) {
+                std::vector<entity::LWVertex2D> vertex;
+                for (int i = 0; i < 10; i++) {
+                    vertex.emplace_back(geo::Coordinate(-9. + i * 2., random.uniform(-5., 5.)), i % 3 == 2 ? 0.5 : 0.);
+                }
+
+                return std::make_shared<entity::LWPolyline>(vertex, 0., 0., 0., false, geo::Coordinate(0., 0., 1.), layer);
+            }}
+        };
+
+        return primitives;
+    }
+}
+
+/**
+ * Intersection of each pair of primitives, dispatched like the snapping and the selection do
+ */
+static void Intersect_Dispatch(benchmark::State& state) {
+    const auto& first = primitives()[state.range(0)];
+    const auto& second = primitives()[state.range(1)];
+    state.SetLabel(std::string(first.name) + "/" + second.name);
+
+    Random random;
+    auto layer = std::make_shared<const Layer>();
+    std::vector<std::pair<entity::CADEntity_CSPtr, entity::CADEntity_CSPtr>> pairs;
+    for (size_t i = 0; i < PAIRS; i++) {
+        pairs.emplace_back(first.create(random, layer), second.create(random, layer));
+    }
+
+    size_t i = 0;
+    size_t points = 0;
+    for (auto _ : state) {
+        const auto& pair = pairs[i++ % PAIRS];
+        Intersect intersect(Intersect::OnEntity, LCTOLERANCE);
+        visitorDispatcher<bool, GeoEntityVisitor>(intersect, *pair.first, *pair.second);
+        points += intersect.result().size();
+    }
+
+    state.counters["points"] = benchmark::Counter(points, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(Intersect_Dispatch)->Apply([](benchmark::internal::Benchmark* benchmark) {
+    const auto& list = primitives();
+
+    for (int first = 0; first < static_cast<int>(list.size()); first++) {
+        for (int second = 0; second < static_cast<int>(list.size()); second++) {
+            // Not implemented
+            const std::string pair = std::string(list[first].name) + list[second].name;
+            if (pair == "EllipseLWPolyline" || pair == "LWPolylineEllipse") {
+                continue;
+            }
+
+            benchmark->Args({first, second});
+        }
+    }
+});
@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+#include <cad/primitive/lwpolyline.h>
+
+#include "benchmarkdata.h"
+
+using namespace lc;
+using namespace lcbenchmark;
+
+namespace {
+    const size_t QUERIES = 1024;
+
+    /**
+     * Random walk of lines and arcs
+     */
+    entity::LWPolyline_CSPtr polyline(Random& random, size_t vertices) {
+        std::vector<entity::LWVertex2D> vertex;
+        geo::Coordinate position(0., 0.);
+
+        for (size_t i = 0; i < vertices; i++) {
+            vertex.emplace_back(position, random.index(4) == 0 ? random.uniform(-1., 1.) : 0.);
+            position = geo::Coordinate(position.x() + random.uniform(1., 10.), position.y() + random.uniform(-10., 10.));
+        }
+
+        return std::make_shared<entity::LWPolyline>(vertex, 0., 0., 0., false, geo::Coordinate(0., 0., 1.),
+                                                    std::make_shared<const Layer>());
+    }
+
+    std::vector<geo::Coordinate> queries(Random& random, const entity::LWPolyline_CSPtr& polyline) {
+        std::vector<geo::Coordinate> coordinates;
+        for (size_t i = 0; i < QUERIES; i++) {
+            coordinates.push_back(random.coordinate(polyline->boundingBox()));
+        }
+
+        return coordinates;
+    }
+}
+
+static void LWPolyline_SnapPoints(benchmark::State& state) {
+    Random random;
+    auto entity = polyline(random, state.range(0));
+    auto coordinates = queries(random, entity);
+    SimpleSnapConstrain constrain(SimpleSnapConstrain::LOGICAL | SimpleSnapConstrain::ON_ENTITY, 0, 0.);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        auto points = entity->snapPoints(coordinates[i++ % QUERIES], constrain, 10., 5);
+        benchmark::DoNotOptimize(points.data());
+    }
+}
+BENCHMARK(LWPolyline_SnapPoints)->RangeMultiplier(10)->Range(10, 100000);
+
+static void LWPolyline_NearestPointOnPath(benchmark::State& state) {
+    Random random;
+    auto entity = polyline(random, state.range(0));
+    auto coordinates = queries(random, entity);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(entity->nearestPointOnPath(coordinates[i++ % QUERIES]));
+    }
+}
+BENCHMARK(LWPolyline_NearestPointOnPath)->RangeMultiplier(10)->Range(10, 100000);
@@ -0,0 +1,25 @@
+/*
+ * All benchmarks should be written in a new file and added to CMakeLists.txt, like the unit tests.
+ * The build and the seed of the generated data are added to the context of the reports, so the JSON output of
+ * two builds can be compared with tools/compare.py of Google Benchmark.
+ */
+#include <string>
+#include <version.h>
+#include <benchmark/benchmark.h>
+
+#include "benchmarkdata.h"
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+
+    benchmark::AddCustomContext("librecad_version", std::to_string(VERSION_MAJOR) + "." + std::to_string(VERSION_MINOR));
+    benchmark::AddCustomContext("librecad_build", BUILD_INFO);
+    benchmark::AddCustomContext("data_seed", std::to_string(lcbenchmark::Random::DEFAULT_SEED));
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
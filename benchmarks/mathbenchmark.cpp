@@ -0,0 +1,90 @@
+#include <benchmark/benchmark.h>
+#include <cad/math/lcmath.h>
+
+#include "benchmarkdata.h"
+
+using namespace lc;
+using namespace lcbenchmark;
+
+namespace {
+    const size_t EQUATIONS = 1024;
+
+    std::vector<std::vector<double>> coefficients(size_t count, uint64_t seed = Random::DEFAULT_SEED) {
+        Random random(seed);
+        std::vector<std::vector<double>> equations(EQUATIONS);
+
+        for (auto& equation : equations) {
+            for (size_t i = 0; i < count; i++) {
+                equation.push_back(random.uniform(-10., 10.));
+            }
+        }
+
+        return equations;
+    }
+
+    /**
+     * Solve equations with random coefficients
+     */
+    template<typename Result>
+    void solve(benchmark::State& state, size_t count, Result (*solver)(const std::vector<double>&)) {
+        auto equations = coefficients(count);
+        size_t i = 0;
+        size_t roots = 0;
+
+        for (auto _ : state) {
+            auto result = solver(equations[i++ % EQUATIONS]);
+            roots += result.size();
+        }
+
+        state.counters["roots"] = benchmark::Counter(roots, benchmark::Counter::kAvgIterations);
+    }
+}
+
+static void Math_QuadraticSolver(benchmark::State& state) {
+    solve(state, 2, &Math::quadraticSolver);
+}
+BENCHMARK(Math_QuadraticSolver);
+
+static void Math_CubicSolver(benchmark::State& state) {
+    solve(state, 3, &Math::cubicSolver);
+}
+BENCHMARK(Math_CubicSolver);
+
+static void Math_QuarticSolver(benchmark::State& state) {
+    solve(state, 4, &Math::quarticSolver);
+}
+BENCHMARK(Math_QuarticSolver);
+
+static void Math_QuarticSolverFull(benchmark::State& state) {
+    solve(state, 5, &Math::quarticSolverFull);
+}
+BENCHMARK(Math_QuarticSolverFull);
+
+static void Math_SexticSolver(benchmark::State& state) {
+    solve(state, 7, &Math::sexticSolver);
+}
+BENCHMARK(Math_SexticSolver);
+
+static void Math_SimultaneousQuadraticSolver(benchmark::State& state) {
+    solve(state, 8, &Math::simultaneousQuadraticSolver);
+}
+BENCHMARK(Math_SimultaneousQuadraticSolver);
+
+/**
+ * Intersection of two random conics, like ellipse/ellipse intersections
+ */
+static void Math_SimultaneousQuadraticSolverFull(benchmark::State& state) {
+    auto first = coefficients(6);
+    auto second = coefficients(6, Random::DEFAULT_SEED + 1);
+    size_t i = 0;
+    size_t roots = 0;
+
+    for (auto _ : state) {
+        auto result = Math::simultaneousQuadraticSolverFull({first[i % EQUATIONS], second[i % EQUATIONS]});
+        roots += result.size();
+        i++;
+    }
+
+    state.counters["roots"] = benchmark::Counter(roots, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(Math_SimultaneousQuadraticSolverFull);
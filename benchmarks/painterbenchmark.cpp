@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>
+#include <cairo.h>
+#include <memory>
+#include <vector>
+
+#include <painters/createpainter.h>
+#include <painters/lchairlinepainter.h>
+
+#include "benchmarkdata.h"
+
+using namespace LCViewer;
+using namespace lcbenchmark;
+
+namespace {
+    const unsigned int SIZE = 1000;
+    const size_t STROKES = 4096;
+
+    struct Stroke {
+        bool circle;
+        double x0, y0, x1, y1;
+    };
+
+    /**
+     * One stroke in four is a circle, the others are lines, all inside the image
+     */
+    std::vector<Stroke> strokes() {
+        Random random;
+        std::vector<Stroke> strokes(STROKES);
+
+        for (size_t i = 0; i < STROKES; i++) {
+            // Device y is the opposite of user y
+            strokes[i] = {i % 4 == 0,
+                          random.uniform(0, SIZE), -random.uniform(0, SIZE),
+                          random.uniform(0, SIZE), -random.uniform(0, SIZE)};
+        }
+
+        return strokes;
+    }
+
+    void strokeThroughput(benchmark::State& state, LcPainter* (*createPainter)(unsigned char*, const unsigned int, const unsigned int)) {
+        const auto data = strokes();
+        std::vector<unsigned char> image(cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, SIZE) * SIZE);
+        std::unique_ptr<LcPainter> painter(createPainter(image.data(), SIZE, SIZE));
+
+        painter->clear(0., 0., 0.);
+        painter->source_rgba(1., 1., 1., 0.9);
+        painter->line_width(1.);
+
+        size_t i = 0;
+        for (auto _ : state) {
+            const auto& stroke = data[i++ % STROKES];
+
+            if (stroke.circle) {
+                painter->circle(stroke.x0, stroke.y0, -stroke.y1 / 10.);
+            }
+            else {
+                painter->move_to(stroke.x0, stroke.y0);
+                painter->line_to(stroke.x1, stroke.y1);
+            }
+            painter->stroke();
+        }
+
+        benchmark::DoNotOptimize(image.data());
+        state.SetItemsProcessed(state.iterations());
+
+        auto hairline = dynamic_cast<LcHairlinePainter*>(painter.get());
+        if (hairline != nullptr && hairline->fallbackStrokes() != 0) {
+            state.SkipWithError("Strokes were drawn by the fallback painter");
+        }
+    }
+}
+
+static void Painter_CairoStroke(benchmark::State& state) {
+    strokeThroughput(state, createCairoImagePainter);
+}
+BENCHMARK(Painter_CairoStroke);
+
+static void Painter_HairlineStroke(benchmark::State& state) {
+    strokeThroughput(state, createHairlineImagePainter);
+}
+BENCHMARK(Painter_HairlineStroke);
@@ -0,0 +1,110 @@
+#include <memory>
+#include <benchmark/benchmark.h>
+#include <cad/dochelpers/quadtree.h>
+
+#include "benchmarkdata.h"
+
+using namespace lcbenchmark;
+
+namespace {
+    using Tree = lc::QuadTree<lc::entity::CADEntity_CSPtr>;
+
+    const size_t BATCH_SIZE = 1000;
+
+    std::vector<lc::entity::CADEntity_CSPtr> entities(size_t count) {
+        Random random;
+        // Short lines, like most entities of a drawing
+        return randomLines(random, count, documentArea(), 500., std::make_shared<const lc::Layer>());
+    }
+
+    std::unique_ptr<Tree> createTree(const std::vector<lc::entity::CADEntity_CSPtr>& entities) {
+        std::unique_ptr<Tree> tree(new Tree(documentArea()));
+        for (const auto& entity : entities) {
+            tree->insert(entity);
+        }
+
+        return tree;
+    }
+}
+
+static void QuadTree_Insert(benchmark::State& state) {
+    auto lines = entities(state.range(0));
+
+    for (auto _ : state) {
+        auto tree = createTree(lines);
+        benchmark::DoNotOptimize(tree.get());
+
+        state.PauseTiming();
+        tree.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * lines.size());
+}
+BENCHMARK(QuadTree_Insert)->RangeMultiplier(10)->Range(10000, 10000000)->Unit(benchmark::kMillisecond);
+
+static void QuadTree_RetrieveOverlapping(benchmark::State& state) {
+    auto tree = createTree(entities(state.range(0)));
+    Random random;
+    size_t found = 0;
+
+    for (auto _ : state) {
+        auto result = tree->retrieveOverlapping(randomWindow(random, tree->bounds(), 0.01));
+        found += result.size();
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    state.counters["entities"] = benchmark::Counter(found, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(QuadTree_RetrieveOverlapping)->RangeMultiplier(10)->Range(10000, 10000000);
+
+static void QuadTree_RetrieveFullWithin(benchmark::State& state) {
+    auto tree = createTree(entities(state.range(0)));
+    Random random;
+    size_t found = 0;
+
+    for (auto _ : state) {
+        auto result = tree->retrieveFullWithin(randomWindow(random, tree->bounds(), 0.01));
+        found += result.size();
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    state.counters["entities"] = benchmark::Counter(found, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(QuadTree_RetrieveFullWithin)->RangeMultiplier(10)->Range(10000, 10000000);
+
+/**
+ * Erase a batch of entities, which are inserted again outside of the measurement
+ */
+static void QuadTree_Erase(benchmark::State& state) {
+    auto lines = entities(state.range(0));
+    auto tree = createTree(lines);
+    Random random;
+
+    std::vector<lc::entity::CADEntity_CSPtr> batch;
+    batch.reserve(BATCH_SIZE);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        batch.clear();
+        for (size_t i = 0; i < BATCH_SIZE; i++) {
+            batch.push_back(lines[random.index(lines.size())]);
+        }
+        state.ResumeTiming();
+
+        for (const auto& entity : batch) {
+            benchmark::DoNotOptimize(tree->erase(entity));
+        }
+
+        state.PauseTiming();
+        for (const auto& entity : batch) {
+            if (tree->entityByID(entity->id()) == nullptr) {
+                tree->insert(entity);
+            }
+        }
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * BATCH_SIZE);
+}
+BENCHMARK(QuadTree_Erase)->RangeMultiplier(10)->Range(10000, 10000000);
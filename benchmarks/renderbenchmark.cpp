@@ -0,0 +1,300 @@
+/**
+ * Render benchmark
+ *
+ * Loads DXF files and renders a scripted sequence of zooms and pans through DocumentCanvas, without any window.
+ * The time of each phase is reported, and the painter statistics when the counting painter is used.
+ * Comparing the null painter with the Cairo painter separates the cost of the traversal from the rasterization.
+ */
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+#include <boost/filesystem.hpp>
+
+#include <cad/dochelpers/documentimpl.h>
+#include <cad/dochelpers/storagemanagerimpl.h>
+#include <documentcanvas.h>
+#include <file.h>
+#include <painters/createpainter.h>
+#include <painters/lccountingpainter.h>
+#include <painters/lcnullpainter.h>
+
+namespace po = boost::program_options;
+
+using namespace LCViewer;
+
+static const int DEFAULT_IMAGE_WIDTH = 1024;
+static const int DEFAULT_IMAGE_HEIGHT = 768;
+static const int DEFAULT_FRAMES = 100;
+static char const* const DEFAULT_RESOURCES = "../unittest/rendering/res";
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Accumulated time of a phase
+     */
+    struct Phase {
+        std::string name;
+        size_t calls;
+        double total;
+    };
+
+    class Timings {
+        public:
+            void add(const std::string& name, Clock::time_point start) {
+                double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+                for (auto& phase : _phases) {
+                    if (phase.name == name) {
+                        phase.calls++;
+                        phase.total += elapsed;
+                        return;
+                    }
+                }
+
+                _phases.push_back({name, 1, elapsed});
+            }
+
+            void print() const {
+                std::cout << std::left << std::setw(12) << "phase"
+                          << std::right << std::setw(8) << "calls"
+                          << std::setw(14) << "total ms"
+                          << std::setw(14) << "mean ms" << std::endl;
+
+                for (const auto& phase : _phases) {
+                    std::cout << std::left << std::setw(12) << phase.name
+                              << std::right << std::setw(8) << phase.calls
+                              << std::setw(14) << std::fixed << std::setprecision(3) << phase.total
+                              << std::setw(14) << phase.total / phase.calls << std::endl;
+                }
+            }
+
+        private:
+            std::vector<Phase> _phases;
+    };
+
+    void printStatistics(const LcCountingPainter::Statistics& statistics, unsigned int frames) {
+        auto perFrame = [frames](size_t value) {
+            return static_cast<double>(value) / frames;
+        };
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << "Painter calls per frame: " << perFrame(statistics.calls) << std::endl
+                  << "  paths " << perFrame(statistics.paths)
+                  << ", segments " << perFrame(statistics.segments)
+                  << ", strokes " << perFrame(statistics.strokes)
+                  << ", fills " << perFrame(statistics.fills) << std::endl
+                  << "  points " << perFrame(statistics.points)
+                  << ", texts " << perFrame(statistics.texts)
+                  << ", images " << perFrame(statistics.images) << std::endl
+                  << "  state changes " << perFrame(statistics.stateChanges)
+                  << ", transformations " << perFrame(statistics.transformations)
+                  << ", saves " << perFrame(statistics.saves) << std::endl;
+    }
+
+    /**
+     * Step of the navigation script, repeated for all the frames
+     */
+    void navigate(DocumentCanvas& canvas, unsigned int frame, unsigned int width, unsigned int height) {
+        switch (frame % 8) {
+            case 0:
+            case 1:
+                canvas.zoom(1.25, true, width / 2, height / 2);
+                break;
+
+            case 2:
+                canvas.transX(static_cast<int>(width / 10));
+                break;
+
+            case 3:
+                canvas.transY(static_cast<int>(height / 10));
+                break;
+
+            case 4:
+            case 5:
+                canvas.zoom(0.8, true, width / 2, height / 2);
+                break;
+
+            case 6:
+                canvas.transX(-static_cast<int>(width / 10));
+                break;
+
+            default:
+                canvas.transY(-static_cast<int>(height / 10));
+                break;
+        }
+    }
+
+    /**
+     * Render a file
+     * @return false if the file couldn't be opened
+     */
+    bool benchmark(const std::string& path, const std::string& painterType,
+                   unsigned int width, unsigned int height, unsigned int frames) {
+        Timings timings;
+        std::vector<unsigned char> image(width * height * 4);
+        LcPainter* painter = nullptr;
+
+        auto storageManager = std::make_shared<lc::StorageManagerImpl>();
+        auto document = std::make_shared<lc::DocumentImpl>(storageManager);
+        auto canvas = std::make_shared<DocumentCanvas>(document);
+
+        // All cached painters are the same one, like the command line interface does
+        canvas->createPainterFunctor([&](const unsigned int w, const unsigned int h) {
+            if (painter == nullptr) {
+                if (painterType == "null") {
+                    painter = new LcNullPainter();
+                }
+                else if (painterType == "cairo") {
+                    painter = createCairoImagePainter(image.data(), w, h);
+                }
+                else if (painterType == "hairline") {
+                    painter = createHairlineImagePainter(image.data(), w, h);
+                }
+                else {
+                    painter = new LcCountingPainter();
+                }
+            }
+
+            return painter;
+        });
+
+        canvas->deletePainterFunctor([&](LcPainter* p) {
+            if (p != nullptr && painter != nullptr) {
+                delete p;
+                painter = nullptr;
+            }
+        });
+
+        canvas->newDeviceSize(width, height);
+
+        auto start = Clock::now();
+        try {
+            lc::File::open(document, path, lc::File::LIBDXFRW);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Cannot open " << path << ": " << e.what() << std::endl;
+            return false;
+        }
+        timings.add("load", start);
+
+        start = Clock::now();
+        canvas->autoScale();
+        timings.add("fit", start);
+
+        // Phases of DocumentCanvas::render, in the order of the calls of before()
+        const char* phases[] = {"background", "document", "foreground"};
+        unsigned int phase = 0;
+        Clock::time_point phaseStart;
+
+        auto before = [&](LcPainter& p) {
+            p.clear(0., 0., 0., 0.);
+            phaseStart = Clock::now();
+        };
+
+        auto after = [&](LcPainter&) {
+            timings.add(phases[phase % 3], phaseStart);
+            phase++;
+        };
+
+        // First render creates the painters
+        canvas->render(before, after);
+
+        auto counting = dynamic_cast<LcCountingPainter*>(painter);
+        if (counting != nullptr) {
+            counting->resetStatistics();
+        }
+
+        for (unsigned int frame = 0; frame < frames; frame++) {
+            start = Clock::now();
+            navigate(*canvas, frame, width, height);
+            timings.add("navigate", start);
+
+            start = Clock::now();
+            canvas->render(before, after);
+            timings.add("frame", start);
+        }
+
+        std::cout << path << ": " << document->entities().size() << " entities, "
+                  << frames << " frames, " << painterType << " painter" << std::endl;
+        timings.print();
+
+        if (counting != nullptr) {
+            printStatistics(counting->statistics(), frames);
+        }
+        std::cout << std::endl;
+
+        canvas->removePainters();
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    int width = DEFAULT_IMAGE_WIDTH;
+    int height = DEFAULT_IMAGE_HEIGHT;
+    int frames = DEFAULT_FRAMES;
+    std::string painterType = "counting";
+    std::vector<std::string> files;
+
+    po::options_description desc("Allowed options");
+    desc.add_options()
+            ("help", "produce help message")
+            ("width,w", po::value<int>(&width), "(optional) Set device width, example -w 1024")
+            ("height,h", po::value<int>(&height), "(optional) Set device height, example -h 768")
+            ("frames,f", po::value<int>(&frames), "(optional) Number of rendered frames per file, example -f 100")
+            ("painter,p", po::value<std::string>(&painterType), "(optional) null, counting, cairo or hairline, default counting")
+            ("input,i", po::value<std::vector<std::string>>(&files), "(optional) DXF files, default the rendering unit tests files");
+
+    po::positional_options_description positional;
+    positional.add("input", -1);
+
+    po::variables_map vm;
+    po::store(po::command_line_parser(argc, argv).options(desc).positional(positional).run(), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << desc << "\n";
+        return 1;
+    }
+
+    if (width <= 0 || height <= 0 || frames <= 0) {
+        std::cerr << "Width, height and frames must be > 0" << std::endl;
+        return 1;
+    }
+
+    if (painterType != "null" && painterType != "counting" && painterType != "cairo" && painterType != "hairline") {
+        std::cerr << "Unknown painter " << painterType << std::endl;
+        std::cout << desc << "\n";
+        return 1;
+    }
+
+    if (files.empty()) {
+        boost::filesystem::path resources(DEFAULT_RESOURCES);
+        if (boost::filesystem::is_directory(resources)) {
+            for (const auto& entry : boost::filesystem::directory_iterator(resources)) {
+                if (entry.path().extension() == ".dxf") {
+                    files.push_back(entry.path().string());
+                }
+            }
+        }
+        std::sort(files.begin(), files.end());
+    }
+
+    if (files.empty()) {
+        std::cerr << "No input file" << std::endl;
+        return 1;
+    }
+
+    bool success = true;
+    for (const auto& file : files) {
+        success &= benchmark(file, painterType, width, height, frames);
+    }
+
+    return success ? 0 : 2;
+}
@@ -0,0 +1,144 @@
+#include <benchmark/benchmark.h>
+#include <cad/math/transform2d.h>
+#include <cad/operations/entityops.h>
+#include <cad/primitive/line.h>
+
+#include "benchmarkdata.h"
+
+using namespace lc;
+using namespace lcbenchmark;
+
+namespace {
+    std::vector<geo::Coordinate> coordinates(size_t count) {
+        Random random;
+        std::vector<geo::Coordinate> coordinates;
+        coordinates.reserve(count);
+
+        for (size_t i = 0; i < count; i++) {
+            coordinates.emplace_back(random.uniform(-1000., 1000.), random.uniform(-1000., 1000.));
+        }
+
+        return coordinates;
+    }
+
+    /**
+     * Rotation and scale around a point, the transformation of a typical modify operation
+     */
+    geo::Transform2D transform() {
+        return geo::Transform2D::rotation(geo::Coordinate(10., 20.), 0.5) *
+               geo::Transform2D::scale(geo::Coordinate(-5., 5.), geo::Coordinate(2., 3.));
+    }
+}
+
+/**
+ * Path of the entities before Transform2D, the rotation is computed again for each point
+ */
+static void Coordinate_Rotate(benchmark::State& state) {
+    const auto in = coordinates(state.range(0));
+    const geo::Coordinate center(10., 20.);
+    std::vector<geo::Coordinate> out(in.size());
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < in.size(); i++) {
+            out[i] = in[i].rotate(center, 0.5);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+BENCHMARK(Coordinate_Rotate)->RangeMultiplier(10)->Range(1000, 1000000);
+
+static void Transform2D_PerPoint(benchmark::State& state) {
+    const auto in = coordinates(state.range(0));
+    const auto t = transform();
+    std::vector<geo::Coordinate> out(in.size());
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < in.size(); i++) {
+            out[i] = t.apply(in[i]);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+BENCHMARK(Transform2D_PerPoint)->RangeMultiplier(10)->Range(1000, 1000000);
+
+static void Transform2D_Coordinates(benchmark::State& state) {
+    const auto in = coordinates(state.range(0));
+    const auto t = transform();
+
+    for (auto _ : state) {
+        auto out = t.apply(in);
+        benchmark::DoNotOptimize(out.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+BENCHMARK(Transform2D_Coordinates)->RangeMultiplier(10)->Range(1000, 1000000);
+
+static void Transform2D_Packed(benchmark::State& state) {
+    const auto t = transform();
+    std::vector<double> in;
+    for (const auto& coordinate : coordinates(state.range(0))) {
+        in.push_back(coordinate.x());
+        in.push_back(coordinate.y());
+    }
+    std::vector<double> out(in.size());
+
+    for (auto _ : state) {
+        t.apply(in.data(), out.data(), in.size() / 2);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * in.size() / 2);
+}
+BENCHMARK(Transform2D_Packed)->RangeMultiplier(10)->Range(1000, 1000000);
+
+/**
+ * Rotate lines one by one with Line::rotate()
+ */
+static void Line_Rotate(benchmark::State& state) {
+    Random random;
+    const auto lines = randomLines(random, state.range(0), documentArea(), 1000., std::make_shared<const Layer>());
+    const geo::Coordinate center(10., 20.);
+
+    for (auto _ : state) {
+        std::vector<entity::CADEntity_CSPtr> rotated;
+        rotated.reserve(lines.size());
+        for (const auto& line : lines) {
+            rotated.push_back(line->rotate(center, 0.5));
+        }
+        benchmark::DoNotOptimize(rotated.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * lines.size());
+}
+BENCHMARK(Line_Rotate)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+
+/**
+ * Rotate lines with the Rotate operation, the points of each chunk go through the batch kernel on the ThreadPool
+ */
+static void EntityOps_Rotate(benchmark::State& state) {
+    Random random;
+    const auto lines = randomLines(random, state.range(0), documentArea(), 1000., std::make_shared<const Layer>());
+    operation::Rotate rotate(geo::Coordinate(10., 20.), 0.5);
+    std::vector<entity::CADEntity_CSPtr> workingBuffer;
+    std::vector<entity::CADEntity_CSPtr> removals;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto entities = lines;
+        state.ResumeTiming();
+
+        auto rotated = rotate.process(nullptr, std::move(entities), workingBuffer, removals, {});
+        benchmark::DoNotOptimize(rotated.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * lines.size());
+}
+BENCHMARK(EntityOps_Rotate)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
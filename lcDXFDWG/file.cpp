@@ -1,40 +1,81 @@
 #include "file.h"
+#include <cad/base/instrumentation.h>
 #include "libdxfrw/dxfimpl.h"
 #include "libopencad_interface/libopencad.h"
+#include "native/librecadbinary.h"
+#include "native/spatialindexcache.h"
 
 using namespace lc;
 
-void File::open(lc::Document_SPtr document, const std::string& path, File::Library library) {
+bool File::open(lc::Document_SPtr document, const std::string& path, File::Library library, bool spatialIndexCache) {
+    instrumentation::ScopedTimer timer("file.open");
+
     auto builder = std::make_shared<operation::Builder>(document, "Open file");
 
+    std::unique_ptr<lc::FileLibs::SpatialIndexCache> cache;
+    bool restored = false;
+    // LibreCAD binary files store the spatial index themselves, their builder restores it
+    if(spatialIndexCache && library != LIBRECAD) {
+        cache.reset(new lc::FileLibs::SpatialIndexCache(path));
+        restored = cache->restore(document);
+    }
+
+    bool opened = false;
+
     switch(library) {
         case LIBDXFRW: {
             DXFimpl F(document, builder);
             dxfRW R(path.c_str());
-            R.read(&F, true);
+            opened = R.read(&F, true);
             break;
         }
 
         case LIBOPENCAD: {
             lc::FileLibs::LibOpenCad opencad(document, builder);
-            opencad.open(path);
+            opened = opencad.open(path);
             break;
         }
+
+        case LIBRECAD: {
+            lc::FileLibs::LibreCadBinary librecad(document, builder);
+            opened = librecad.open(path);
+            break;
+        }
+    }
+
+    // A truncated or corrupt file leaves a partial builder, don't add it to the document
+    if(!opened) {
+        return false;
     }
 
     builder->execute();
+
+    if(cache != nullptr && !restored) {
+        cache->save(document);
+    }
+
+    return true;
 }
 
-void File::save(lc::Document_SPtr document, const std::string& path, File::Type type) {
+bool File::save(lc::Document_SPtr document, const std::string& path, File::Type type) {
+    instrumentation::ScopedTimer timer("file.save");
+
     if(type >= LIBDXFRW_DXF_R12 && type <= LIBDXFRW_DXB_R2013) {
-        DXFimpl* F = new DXFimpl(document);
-        F->writeDXF(path, type);
+        DXFimpl F(document);
+        return F.writeDXF(path, type);
+    }
+    else if(type == LIBRECAD_BINARY) {
+        lc::FileLibs::LibreCadBinary librecad(document);
+        return librecad.save(path);
     }
+
+    return false;
 }
 
 std::map<File::Type, std::string> File::getAvailableFileTypes() {
     std::map<File::Type, std::string> types;
 
+    types.insert(std::pair<File::Type, std::string>(LIBRECAD_BINARY, "LibreCAD binary"));
     types.insert(std::pair<File::Type, std::string>(LIBDXFRW_DXF_R2013, "DXF 2013 (libdxfrw)"));
     types.insert(std::pair<File::Type, std::string>(LIBDXFRW_DXF_R2010, "DXF 2010 (libdxfrw)"));
     types.insert(std::pair<File::Type, std::string>(LIBDXFRW_DXF_R2007, "DXF 2007 (libdxfrw)"));
@@ -64,6 +105,9 @@ std::map<File::Library, std::string> File::getAvailableLibrariesForFormat(std::s
     if(format == "dwg") {
         libraries.insert(std::pair<File::Library, std::string>(LIBOPENCAD, "libopencad"));
     }
+    if(format == "lcb") {
+        libraries.insert(std::pair<File::Library, std::string>(LIBRECAD, "LibreCAD"));
+    }
 
     return libraries;
 }
\ No newline at end of file
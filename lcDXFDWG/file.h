@@ -22,15 +22,28 @@ namespace lc {
                 LIBDXFRW_DXB_R2007,
                 LIBDXFRW_DXB_R2010,
                 LIBDXFRW_DXB_R2013,
+                LIBRECAD_BINARY,
             };
             
             enum Library {
                 LIBDXFRW,
                 LIBOPENCAD,
+                LIBRECAD,
             };
 
-            static void open(lc::Document_SPtr document, const std::string& path, Library library);
-            static void save(lc::Document_SPtr document, const std::string& path, Type type);
+            /**
+             * Open a file
+             * @param spatialIndexCache restore the spatial index from a sidecar file when the file didn't change,
+             * or create the sidecar file after opening it. Not used for LibreCAD binary files, they store the spatial index.
+             * @return false if the file could not be read, nothing is added to the document then
+             */
+            static bool open(lc::Document_SPtr document, const std::string& path, Library library, bool spatialIndexCache = false);
+
+            /**
+             * Save a document
+             * @return false if the file could not be written
+             */
+            static bool save(lc::Document_SPtr document, const std::string& path, Type type);
 
             static std::map<Type, std::string> getAvailableFileTypes();
             static std::map<Library, std::string> getAvailableLibrariesForFormat(std::string format);
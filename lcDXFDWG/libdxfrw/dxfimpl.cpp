@@ -13,6 +13,7 @@
 #include <cad/primitive/point.h>
 #include <cad/primitive/spline.h>
 #include <cad/primitive/lwpolyline.h>
+#include <cad/primitive/image.h>
 #include <cad/operations/entitybuilder.h>
 #include <cad/meta/layer.h>
 #include <cad/operations/layerops.h>
@@ -28,12 +29,16 @@
 #include <cad/primitive/insert.h>
 #include <cad/operations/blockops.h>
 #include <cad/meta/customentitystorage.h>
+#include <cad/base/entitypool.h>
+#include <cad/base/threadpool.h>
+#include <cad/interface/entitydispatch.h>
 
 DXFimpl::DXFimpl(std::shared_ptr<lc::Document> document, lc::operation::Builder_SPtr builder) : 
         _document(document), 
         _builder(builder),
         _entityBuilder(std::make_shared<lc::operation::EntityBuilder>(document)),
-        _currentBlock(nullptr) {
+        _currentBlock(nullptr),
+        _parallelWrite(true) {
     _builder->append(_entityBuilder);
 }
 
@@ -157,15 +162,15 @@ void DXFimpl::addEllipse(const DRW_Ellipse& data) {
     auto layer = _document->layerByName(data.layer);
 
     auto secPoint = coord(data.secPoint);
-    auto lcEllipse = std::make_shared<lc::entity::Ellipse>(coord(data.basePoint),
-                                                           secPoint,
-                                                           secPoint.magnitude() * data.ratio,
-                                                           data.staparam,
-                                                           data.endparam,
-                                                           data.isccw,
-                                                           layer,
-                                                           mf,
-                                                           _currentBlock
+    auto lcEllipse = lc::pool::makeShared<lc::entity::Ellipse>(coord(data.basePoint),
+                                                               secPoint,
+                                                               secPoint.magnitude() * data.ratio,
+                                                               data.staparam,
+                                                               data.endparam,
+                                                               data.isccw,
+                                                               layer,
+                                                               mf,
+                                                               _currentBlock
     );
 
     _entityBuilder->appendEntity(lcEllipse);
@@ -212,19 +217,19 @@ void DXFimpl::addSpline(const DRW_Spline* data) {
         knotList.erase(knotList.begin());
         knotList.pop_back();
     }
-    auto lcSpline = std::make_shared<lc::entity::Spline>(coords(data->controllist),
-                                                         knotList,
-                                                         coords(data->fitlist),
-                                                         data->degree,
-                                                         false,
-                                                         data->tolfit,
-                                                         data->tgStart.x, data->tgStart.y, data->tgStart.z,
-                                                         data->tgEnd.x, data->tgEnd.y, data->tgEnd.z,
-                                                         data->normalVec.x, data->normalVec.y, data->normalVec.z,
-                                                         static_cast<lc::geo::Spline::splineflag>(data->flags),
-                                                         layer,
-                                                         mf,
-                                                         _currentBlock
+    auto lcSpline = lc::pool::makeShared<lc::entity::Spline>(coords(data->controllist),
+                                                             knotList,
+                                                             coords(data->fitlist),
+                                                             data->degree,
+                                                             false,
+                                                             data->tolfit,
+                                                             data->tgStart.x, data->tgStart.y, data->tgStart.z,
+                                                             data->tgEnd.x, data->tgEnd.y, data->tgEnd.z,
+                                                             data->normalVec.x, data->normalVec.y, data->normalVec.z,
+                                                             static_cast<lc::geo::Spline::splineflag>(data->flags),
+                                                             layer,
+                                                             mf,
+                                                             _currentBlock
     );
 
     _entityBuilder->appendEntity(lcSpline);
@@ -236,15 +241,15 @@ void DXFimpl::addText(const DRW_Text& data) {
         return;
     }
     std::shared_ptr<lc::MetaInfo> mf = getMetaInfo(data);
-    auto lcText = std::make_shared<lc::entity::Text>(coord(data.basePoint),
-                                                     data.text, data.height,
-                                                     data.angle, data.style,
-                                                     lc::TextConst::DrawingDirection(data.textgen),
-                                                     lc::TextConst::HAlign(data.alignH),
-                                                     lc::TextConst::VAlign(data.alignV),
-                                                     layer,
-                                                     mf,
-                                                     _currentBlock
+    auto lcText = lc::pool::makeShared<lc::entity::Text>(coord(data.basePoint),
+                                                         data.text, data.height,
+                                                         data.angle, data.style,
+                                                         lc::TextConst::DrawingDirection(data.textgen),
+                                                         lc::TextConst::HAlign(data.alignH),
+                                                         lc::TextConst::VAlign(data.alignV),
+                                                         layer,
+                                                         mf,
+                                                         _currentBlock
     );
 
     _entityBuilder->appendEntity(lcText);
@@ -256,10 +261,10 @@ void DXFimpl::addPoint(const DRW_Point& data) {
         return;
     }
     std::shared_ptr<lc::MetaInfo> mf = getMetaInfo(data);
-    auto lcPoint = std::make_shared<lc::entity::Point>(coord(data.basePoint),
-                                                       layer,
-                                                       mf,
-                                                       _currentBlock
+    auto lcPoint = lc::pool::makeShared<lc::entity::Point>(coord(data.basePoint),
+                                                           layer,
+                                                           mf,
+                                                           _currentBlock
     );
 
     _entityBuilder->appendEntity(lcPoint);
@@ -271,7 +276,7 @@ void DXFimpl::addDimAlign(const DRW_DimAligned* data) {
         return;
     }
     std::shared_ptr<lc::MetaInfo> mf = getMetaInfo(*data);
-    auto lcDimAligned = std::make_shared<lc::entity::DimAligned>(
+    auto lcDimAligned = lc::pool::makeShared<lc::entity::DimAligned>(
             coord(data->getDefPoint()),
             coord(data->getTextPoint()),
             static_cast<lc::TextConst::AttachmentPoint>(data->getAlign()),
@@ -295,7 +300,7 @@ void DXFimpl::addDimLinear(const DRW_DimLinear* data) {
         return;
     }
     std::shared_ptr<lc::MetaInfo> mf = getMetaInfo(*data);
-    auto lcDimLinear = std::make_shared<lc::entity::DimLinear>(
+    auto lcDimLinear = lc::pool::makeShared<lc::entity::DimLinear>(
             coord(data->getDefPoint()),
             coord(data->getTextPoint()),
             static_cast<lc::TextConst::AttachmentPoint>(data->getAlign()),
@@ -321,7 +326,7 @@ void DXFimpl::addDimRadial(const DRW_DimRadial* data) {
         return;
     }
     std::shared_ptr<lc::MetaInfo> mf = getMetaInfo(*data);
-    auto  lcDimRadial = std::make_shared<lc::entity::DimRadial>(
+    auto  lcDimRadial = lc::pool::makeShared<lc::entity::DimRadial>(
              coord(data->getCenterPoint()),
              coord(data->getTextPoint()),
              static_cast<lc::TextConst::AttachmentPoint>(data->getAlign()),
@@ -345,7 +350,7 @@ void DXFimpl::addDimDiametric(const DRW_DimDiametric* data) {
         return;
     }
     std::shared_ptr<lc::MetaInfo> mf = getMetaInfo(*data);
-    auto lcDimDiametric = std::make_shared<lc::entity::DimDiametric>(
+    auto lcDimDiametric = lc::pool::makeShared<lc::entity::DimDiametric>(
              coord(data->getDiameter1Point()),
              coord(data->getTextPoint()),
              static_cast<lc::TextConst::AttachmentPoint>(data->getAlign()),
@@ -369,7 +374,7 @@ void DXFimpl::addDimAngular(const DRW_DimAngular* data) {
         return;
     }
     std::shared_ptr<lc::MetaInfo> mf = getMetaInfo(*data);
-    auto lcDimAngular = std::make_shared<lc::entity::DimAngular>(
+    auto lcDimAngular = lc::pool::makeShared<lc::entity::DimAngular>(
              coord(data->getDefPoint()),
              coord(data->getTextPoint()),
              static_cast<lc::TextConst::AttachmentPoint>(data->getAlign()),
@@ -412,7 +417,7 @@ void DXFimpl::addLWPolyline(const DRW_LWPolyline& data) {
     }
 
     auto isCLosed = data.flags&0x01;
-    auto lcLWPolyline = std::make_shared<lc::entity::LWPolyline>(
+    auto lcLWPolyline = lc::pool::makeShared<lc::entity::LWPolyline>(
             points,
             data.width,
             data.elevation,
@@ -529,7 +534,7 @@ void DXFimpl::linkImage(const DRW_ImageDef *data) {
             const lc::geo::Coordinate uv(coord(image->secPoint));
             const lc::geo::Coordinate vv(coord(image->vVector));
 
-            auto lcImage = std::make_shared<lc::entity::Image>(
+            auto lcImage = lc::pool::makeShared<lc::entity::Image>(
                     data->name,
                     base, uv, vv,
                     image->sizeu, image->sizev,
@@ -563,6 +568,33 @@ void DXFimpl::addInsert(const DRW_Insert& data) {
  * Write DXF Implementation BELOW
  *********************************************/
 
+namespace {
+    /**
+     * libdxfrw needs the file name of a image when writing it, which DRW_Image doesn't hold
+     */
+    class DRWNamedImage : public DRW_Image {
+        public:
+            std::string name;
+    };
+
+    /**
+     * Set the values shared by all dimensions, the definition point is set per type
+     * because radial and diametric dimensions store it in a different place.
+     */
+    void getDimensionAttributes(DRW_Dimension* dim, const lc::entity::Dimension& dimension) {
+        dim->setTextPoint(DRW_Coord(dimension.middleOfText().x(), dimension.middleOfText().y(), 0.));
+        dim->setAlign(dimension.attachmentPoint());
+        dim->setDir(dimension.textAngle());
+        dim->setTextLineFactor(dimension.lineSpacingFactor());
+        dim->setTextLineStyle(dimension.lineSpacingStyle());
+        dim->setText(dimension.explicitValue());
+    }
+
+    DRW_Coord drwCoord(const lc::geo::Coordinate& coordinate) {
+        return DRW_Coord(coordinate.x(), coordinate.y(), coordinate.z());
+    }
+}
+
 void DXFimpl::writeLayers() {
     auto layers = _document->allLayers();
     for(const auto &layer: layers) {
@@ -635,107 +667,235 @@ bool DXFimpl::writeDXF(const std::string& filename, lc::File::Type type) {
     return success;
 }
 
-void DXFimpl::writePoint(const lc::entity::Point_CSPtr p) {
-    DRW_Point point;
-    getEntityAttributes(&point, p);
-    point.basePoint.x = p->x();
-    point.basePoint.y = p->y();
-    dxfW->writePoint(&point);
+std::unique_ptr<DRW_Entity> DXFimpl::convertPoint(const lc::entity::Point_CSPtr p) const {
+    auto point = std::unique_ptr<DRW_Point>(new DRW_Point());
+    getEntityAttributes(point.get(), p);
+    point->basePoint.x = p->x();
+    point->basePoint.y = p->y();
+    return std::move(point);
 }
 
-void DXFimpl::writeLine(const lc::entity::Line_CSPtr l) {
-    DRW_Line line;
-    getEntityAttributes(&line, l);
-    line.basePoint.x = l->start().x();
-    line.basePoint.y = l->start().y();
-    line.secPoint.x = l->end().x();
-    line.secPoint.y = l->end().y();
-    dxfW->writeLine(&line);
+std::unique_ptr<DRW_Entity> DXFimpl::convertLine(const lc::entity::Line_CSPtr l) const {
+    auto line = std::unique_ptr<DRW_Line>(new DRW_Line());
+    getEntityAttributes(line.get(), l);
+    line->basePoint.x = l->start().x();
+    line->basePoint.y = l->start().y();
+    line->secPoint.x = l->end().x();
+    line->secPoint.y = l->end().y();
+    return std::move(line);
 }
 
-void DXFimpl::writeCircle(const lc::entity::Circle_CSPtr c) {
-    DRW_Circle circle;
-    getEntityAttributes(&circle, c);
-    circle.basePoint.x = c->center().x();
-    circle.basePoint.y = c->center().y();
-    circle.radious = c->radius();
-    dxfW->writeCircle(&circle);
+std::unique_ptr<DRW_Entity> DXFimpl::convertCircle(const lc::entity::Circle_CSPtr c) const {
+    auto circle = std::unique_ptr<DRW_Circle>(new DRW_Circle());
+    getEntityAttributes(circle.get(), c);
+    circle->basePoint.x = c->center().x();
+    circle->basePoint.y = c->center().y();
+    circle->radious = c->radius();
+    return std::move(circle);
 }
 
-void DXFimpl::writeArc(const lc::entity::Arc_CSPtr a) {
-    DRW_Arc arc;
-    getEntityAttributes(&arc, a);
-    arc.basePoint.x = a->center().x();
-    arc.basePoint.y = a->center().y();
-    arc.radious = a->radius();
+std::unique_ptr<DRW_Entity> DXFimpl::convertArc(const lc::entity::Arc_CSPtr a) const {
+    auto arc = std::unique_ptr<DRW_Arc>(new DRW_Arc());
+    getEntityAttributes(arc.get(), a);
+    arc->basePoint.x = a->center().x();
+    arc->basePoint.y = a->center().y();
+    arc->radious = a->radius();
     if (a->CCW()) {
-        arc.staangle = a->startAngle();
-        arc.endangle = a->endAngle();
+        arc->staangle = a->startAngle();
+        arc->endangle = a->endAngle();
     } else {
-        arc.staangle = a->endAngle();
-        arc.endangle = a->startAngle();
+        arc->staangle = a->endAngle();
+        arc->endangle = a->startAngle();
     }
-    dxfW->writeArc(&arc);
+    return std::move(arc);
 }
 
-void DXFimpl::writeEllipse(const lc::entity::Ellipse_CSPtr s) {
-    DRW_Ellipse el;
-    getEntityAttributes(&el, s);
-    el.basePoint.x = s->center().x();
-    el.basePoint.y = s->center().y();
-    el.secPoint.x = s->majorP().x();
-    el.secPoint.y = s->majorP().y();
-    el.ratio = 1/s->ratio();
+std::unique_ptr<DRW_Entity> DXFimpl::convertEllipse(const lc::entity::Ellipse_CSPtr s) const {
+    auto el = std::unique_ptr<DRW_Ellipse>(new DRW_Ellipse());
+    getEntityAttributes(el.get(), s);
+    el->basePoint.x = s->center().x();
+    el->basePoint.y = s->center().y();
+    el->secPoint.x = s->majorP().x();
+    el->secPoint.y = s->majorP().y();
+    el->ratio = 1/s->ratio();
     if (s->isReversed()) {
-        el.staparam = s->endAngle();
-        el.endparam = s->startAngle();
+        el->staparam = s->endAngle();
+        el->endparam = s->startAngle();
     } else {
-        el.staparam = s->startAngle();
-        el.endparam = s->endAngle();
+        el->staparam = s->startAngle();
+        el->endparam = s->endAngle();
     }
-    dxfW->writeEllipse(&el);
+    return std::move(el);
 }
 
-void DXFimpl::writeSpline(const lc::entity::Spline_CSPtr s) {
-    DRW_Spline sp;
+std::unique_ptr<DRW_Entity> DXFimpl::convertSpline(const lc::entity::Spline_CSPtr s) const {
+    auto sp = std::unique_ptr<DRW_Spline>(new DRW_Spline());
 
-    getEntityAttributes(&sp, s);
+    getEntityAttributes(sp.get(), s);
 
-    sp.knotslist = s->knotPoints();
-    sp.normalVec = DRW_Coord(s->nX(), s->nY(), s->nZ());
-    sp.tgEnd = DRW_Coord(s->endTanX(), s->endTanY(), s->endTanZ());
-    sp.tgStart = DRW_Coord(s->startTanX(), s->startTanY(), s->startTanZ());
-    sp.degree = s->degree();
+    sp->knotslist = s->knotPoints();
+    sp->normalVec = DRW_Coord(s->nX(), s->nY(), s->nZ());
+    sp->tgEnd = DRW_Coord(s->endTanX(), s->endTanY(), s->endTanZ());
+    sp->tgStart = DRW_Coord(s->startTanX(), s->startTanY(), s->startTanZ());
+    sp->degree = s->degree();
 
     for(const auto & cp : s->controlPoints()) {
-        sp.controllist.push_back(new DRW_Coord(cp.x(), cp.y(), cp.z()));
+        sp->controllist.push_back(new DRW_Coord(cp.x(), cp.y(), cp.z()));
     }
 
     for(const auto & fp : s->fitPoints()) {
-        sp.fitlist.push_back(new DRW_Coord(fp.x(), fp.y(), fp.z()));
+        sp->fitlist.push_back(new DRW_Coord(fp.x(), fp.y(), fp.z()));
     }
 
-    sp.flags = s->flags();
-    sp.nknots = sp.knotslist.size();
-    sp.nfit = sp.fitlist.size();
-    sp.ncontrol = sp.controllist.size();
+    sp->flags = s->flags();
+    sp->nknots = sp->knotslist.size();
+    sp->nfit = sp->fitlist.size();
+    sp->ncontrol = sp->controllist.size();
+
+    return std::move(sp);
+}
+
+std::unique_ptr<DRW_Entity> DXFimpl::convertInsert(const lc::entity::Insert_CSPtr i) const {
+    auto insert = std::unique_ptr<DRW_Insert>(new DRW_Insert());
+    getEntityAttributes(insert.get(), i);
+
+    insert->name = i->displayBlock()->name();
+    insert->basePoint.x = i->position().x();
+    insert->basePoint.y = i->position().y();
+    insert->basePoint.z = i->position().z();
 
-    dxfW->writeSpline(&sp);
+    return std::move(insert);
 }
 
-void DXFimpl::writeInsert(const lc::entity::Insert_CSPtr i) {
-    DRW_Insert insert;
-    getEntityAttributes(&insert, i);
+std::unique_ptr<DRW_Entity> DXFimpl::convertText(const lc::entity::Text_CSPtr t) const {
+    auto text = std::unique_ptr<DRW_Text>(new DRW_Text());
+    getEntityAttributes(text.get(), t);
+
+    text->basePoint = drwCoord(t->insertion_point());
+    // Aligned text is positioned by the second point
+    text->secPoint = text->basePoint;
+    text->text = t->text_value();
+    text->height = t->height();
+    text->angle = t->angle();
+    text->style = t->style();
+    text->textgen = t->textgeneration();
+    text->alignH = static_cast<DRW_Text::HAlign>(t->halign());
+    text->alignV = static_cast<DRW_Text::VAlign>(t->valign());
+
+    return std::move(text);
+}
+
+std::unique_ptr<DRW_Entity> DXFimpl::convertDimAligned(const lc::entity::DimAligned_CSPtr d) const {
+    auto dim = std::unique_ptr<DRW_DimAligned>(new DRW_DimAligned());
+    getEntityAttributes(dim.get(), d);
+    getDimensionAttributes(dim.get(), *d);
 
-    insert.name = i->displayBlock()->name();
-    insert.basePoint.x = i->position().x();
-    insert.basePoint.y = i->position().y();
-    insert.basePoint.z = i->position().z();
+    dim->type = 1;
+    dim->setDefPoint(drwCoord(d->definitionPoint()));
+    dim->setDef1Point(drwCoord(d->definitionPoint2()));
+    dim->setDef2Point(drwCoord(d->definitionPoint3()));
 
-    dxfW->writeInsert(&insert);
+    return std::move(dim);
 }
 
-void DXFimpl::getEntityAttributes(DRW_Entity *ent, lc::entity::CADEntity_CSPtr entity) {
+std::unique_ptr<DRW_Entity> DXFimpl::convertDimAngular(const lc::entity::DimAngular_CSPtr d) const {
+    auto dim = std::unique_ptr<DRW_DimAngular>(new DRW_DimAngular());
+    getEntityAttributes(dim.get(), d);
+    getDimensionAttributes(dim.get(), *d);
+
+    dim->type = 2;
+    dim->setDefPoint(drwCoord(d->definitionPoint()));
+    dim->setFirstLine1(drwCoord(d->defLine11()));
+    dim->setFirstLine2(drwCoord(d->defLine12()));
+    dim->setSecondLine1(drwCoord(d->defLine21()));
+    dim->setSecondLine2(drwCoord(d->defLine22()));
+
+    return std::move(dim);
+}
+
+std::unique_ptr<DRW_Entity> DXFimpl::convertDimDiametric(const lc::entity::DimDiametric_CSPtr d) const {
+    auto dim = std::unique_ptr<DRW_DimDiametric>(new DRW_DimDiametric());
+    getEntityAttributes(dim.get(), d);
+    getDimensionAttributes(dim.get(), *d);
+
+    dim->type = 3;
+    dim->setDiameter1Point(drwCoord(d->definitionPoint()));
+    dim->setDiameter2Point(drwCoord(d->definitionPoint2()));
+    dim->setLeaderLength(d->leader());
+
+    return std::move(dim);
+}
+
+std::unique_ptr<DRW_Entity> DXFimpl::convertDimLinear(const lc::entity::DimLinear_CSPtr d) const {
+    auto dim = std::unique_ptr<DRW_DimLinear>(new DRW_DimLinear());
+    getEntityAttributes(dim.get(), d);
+    getDimensionAttributes(dim.get(), *d);
+
+    dim->type = 0;
+    dim->setDefPoint(drwCoord(d->definitionPoint()));
+    dim->setDef1Point(drwCoord(d->definitionPoint2()));
+    dim->setDef2Point(drwCoord(d->definitionPoint3()));
+    dim->setAngle(d->angle());
+    dim->setOblique(d->oblique());
+
+    return std::move(dim);
+}
+
+std::unique_ptr<DRW_Entity> DXFimpl::convertDimRadial(const lc::entity::DimRadial_CSPtr d) const {
+    auto dim = std::unique_ptr<DRW_DimRadial>(new DRW_DimRadial());
+    getEntityAttributes(dim.get(), d);
+    getDimensionAttributes(dim.get(), *d);
+
+    dim->type = 4;
+    dim->setCenterPoint(drwCoord(d->definitionPoint()));
+    dim->setDiameterPoint(drwCoord(d->definitionPoint2()));
+    dim->setLeaderLength(d->leader());
+
+    return std::move(dim);
+}
+
+std::unique_ptr<DRW_Entity> DXFimpl::convertLWPolyline(const lc::entity::LWPolyline_CSPtr l) const {
+    auto pl = std::unique_ptr<DRW_LWPolyline>(new DRW_LWPolyline());
+    getEntityAttributes(pl.get(), l);
+
+    for(const auto& v : l->vertex()) {
+        DRW_Vertex2D vertex;
+        vertex.x = v.location().x();
+        vertex.y = v.location().y();
+        vertex.stawidth = v.startWidth();
+        vertex.endwidth = v.endWidth();
+        vertex.bulge = v.bulge();
+        pl->addVertex(vertex);
+    }
+
+    pl->vertexnum = pl->vertlist.size();
+    pl->flags = l->closed() ? 0x01 : 0;
+    pl->width = l->width();
+    pl->elevation = l->elevation();
+    pl->thickness = l->tickness();
+    pl->extPoint = drwCoord(l->extrusionDirection());
+
+    return std::move(pl);
+}
+
+std::unique_ptr<DRW_Entity> DXFimpl::convertImage(const lc::entity::Image_CSPtr i) const {
+    auto image = std::unique_ptr<DRWNamedImage>(new DRWNamedImage());
+    getEntityAttributes(image.get(), i);
+
+    image->name = i->name();
+    image->basePoint = drwCoord(i->base());
+    image->secPoint = drwCoord(i->uv());
+    image->vVector = drwCoord(i->vv());
+    image->sizeu = i->width();
+    image->sizev = i->height();
+    image->brightness = i->brightness();
+    image->contrast = i->contrast();
+    image->fade = i->fade();
+
+    return std::move(image);
+}
+
+void DXFimpl::getEntityAttributes(DRW_Entity *ent, lc::entity::CADEntity_CSPtr entity) const {
     auto layer_  = entity->layer();
 
     auto lpByValue = entity->metaInfo<lc::DxfLinePatternByValue>(lc::DxfLinePattern::LCMETANAME());
@@ -1054,85 +1214,145 @@ void DXFimpl::writeAppId(){
     dxfW->writeAppId(&ai);
 }
 
-void DXFimpl::writeDimension(const lc::entity::Dimension_CSPtr d) {
-
+namespace {
+    /**
+     * Selects the conversion of a entity by it's type, using the entity dispatch instead of trying casts.
+     * Entities without a DXF conversion leave the result empty.
+     */
+    class DRWConverter : public lc::EntityDispatch {
+        public:
+            DRWConverter(const DXFimpl& dxfImpl) : _dxfImpl(dxfImpl) {}
+
+            void visit(lc::entity::Line_CSPtr line) override { result = _dxfImpl.convertLine(line); }
+            void visit(lc::entity::Point_CSPtr point) override { result = _dxfImpl.convertPoint(point); }
+            void visit(lc::entity::Circle_CSPtr circle) override { result = _dxfImpl.convertCircle(circle); }
+            void visit(lc::entity::Arc_CSPtr arc) override { result = _dxfImpl.convertArc(arc); }
+            void visit(lc::entity::Ellipse_CSPtr ellipse) override { result = _dxfImpl.convertEllipse(ellipse); }
+            void visit(lc::entity::Text_CSPtr text) override { result = _dxfImpl.convertText(text); }
+            void visit(lc::entity::Spline_CSPtr spline) override { result = _dxfImpl.convertSpline(spline); }
+            void visit(lc::entity::DimAligned_CSPtr dimension) override { result = _dxfImpl.convertDimAligned(dimension); }
+            void visit(lc::entity::DimAngular_CSPtr dimension) override { result = _dxfImpl.convertDimAngular(dimension); }
+            void visit(lc::entity::DimDiametric_CSPtr dimension) override { result = _dxfImpl.convertDimDiametric(dimension); }
+            void visit(lc::entity::DimLinear_CSPtr dimension) override { result = _dxfImpl.convertDimLinear(dimension); }
+            void visit(lc::entity::DimRadial_CSPtr dimension) override { result = _dxfImpl.convertDimRadial(dimension); }
+            void visit(lc::entity::LWPolyline_CSPtr lwPolyline) override { result = _dxfImpl.convertLWPolyline(lwPolyline); }
+            void visit(lc::entity::Image_CSPtr image) override { result = _dxfImpl.convertImage(image); }
+            void visit(lc::entity::Insert_CSPtr insert) override { result = _dxfImpl.convertInsert(insert); }
+
+            std::unique_ptr<DRW_Entity> result;
+
+        private:
+            const DXFimpl& _dxfImpl;
+    };
 }
 
-void DXFimpl::writeLWPolyline(const lc::entity::LWPolyline_CSPtr p) {
+std::unique_ptr<DRW_Entity> DXFimpl::convertEntity(lc::entity::CADEntity_CSPtr entity) const {
+    DRWConverter converter(*this);
+    entity->dispatch(converter);
 
+    return std::move(converter.result);
 }
 
-void DXFimpl::writeImage(const lc::entity::Image_CSPtr i) {
-
+void DXFimpl::writeDRWEntity(DRW_Entity* entity) {
+    switch(entity->eType) {
+        case DRW::POINT:
+            dxfW->writePoint(static_cast<DRW_Point*>(entity));
+            break;
+        case DRW::LINE:
+            dxfW->writeLine(static_cast<DRW_Line*>(entity));
+            break;
+        case DRW::CIRCLE:
+            dxfW->writeCircle(static_cast<DRW_Circle*>(entity));
+            break;
+        case DRW::ARC:
+            dxfW->writeArc(static_cast<DRW_Arc*>(entity));
+            break;
+        case DRW::ELLIPSE:
+            dxfW->writeEllipse(static_cast<DRW_Ellipse*>(entity));
+            break;
+        case DRW::SPLINE:
+            dxfW->writeSpline(static_cast<DRW_Spline*>(entity));
+            break;
+        case DRW::INSERT:
+            dxfW->writeInsert(static_cast<DRW_Insert*>(entity));
+            break;
+        case DRW::TEXT:
+            dxfW->writeText(static_cast<DRW_Text*>(entity));
+            break;
+        case DRW::DIMALIGNED:
+        case DRW::DIMANGULAR:
+        case DRW::DIMDIAMETRIC:
+        case DRW::DIMLINEAR:
+        case DRW::DIMRADIAL:
+            dxfW->writeDimension(static_cast<DRW_Dimension*>(entity));
+            break;
+        case DRW::LWPOLYLINE:
+            dxfW->writeLWPolyline(static_cast<DRW_LWPolyline*>(entity));
+            break;
+        case DRW::IMAGE: {
+            auto image = static_cast<DRWNamedImage*>(entity);
+            auto imageDef = dxfW->writeImage(image, image->name);
+            if(imageDef != nullptr) {
+                imageDef->loaded = 1;
+                imageDef->u = image->sizeu;
+                imageDef->v = image->sizev;
+                imageDef->up = 1;
+                imageDef->vp = 1;
+                imageDef->resolution = 0;
+            }
+            break;
+        }
+        default:
+            break;
+    }
 }
 
-void DXFimpl::writeText(const lc::entity::Text_CSPtr t) {
+void DXFimpl::setParallelWrite(bool parallelWrite) {
+    _parallelWrite = parallelWrite;
+}
 
+void DXFimpl::writeEntities() {
+    writeEntities(_document->entities());
 }
 
-void DXFimpl::writeEntities(){
-    for(const auto e :_document->entityContainer().asVector()) {
-        if(e->block() != nullptr) {
-            continue;
+void DXFimpl::writeEntities(const std::vector<lc::entity::CADEntity_CSPtr>& entities) {
+    // Entities are converted in batches on the thread pool, libdxfrw writes them in document order
+    const size_t batchSize = 16384;
+    std::vector<std::unique_ptr<DRW_Entity>> batch;
+
+    for(size_t begin = 0; begin < entities.size(); begin += batchSize) {
+        const size_t end = std::min(begin + batchSize, entities.size());
+        batch.clear();
+        batch.resize(end - begin);
+
+        auto convert = [&](size_t from, size_t to) {
+            for(size_t i = from; i < to; i++) {
+                if(entities[begin + i]->block() == nullptr) {
+                    batch[i] = convertEntity(entities[begin + i]);
+                }
+            }
+        };
+
+        if(_parallelWrite) {
+            lc::ThreadPool::instance().parallelFor(batch.size(), convert, 256);
+        }
+        else {
+            convert(0, batch.size());
         }
 
-        writeEntity(e);
+        for(const auto& drwEntity : batch) {
+            if(drwEntity != nullptr) {
+                writeDRWEntity(drwEntity.get());
+            }
+        }
     }
 }
 
 void DXFimpl::writeEntity(lc::entity::CADEntity_CSPtr entity) {
-    const auto Line = std::dynamic_pointer_cast<const lc::entity::Line>(entity);
-    if (Line != nullptr) {
-        writeLine(Line);
-        return;
-    }
-
-    const auto Circle = std::dynamic_pointer_cast<const lc::entity::Circle>(entity);
-    if (Circle != nullptr) {
-        writeCircle(Circle);
-        return;
-    }
-
-    const auto Arc = std::dynamic_pointer_cast<const lc::entity::Arc>(entity);
-    if (Arc != nullptr) {
-        writeArc(Arc);
-        return;
-    }
-
-    const auto Ellipse = std::dynamic_pointer_cast<const lc::entity::Ellipse>(entity);
-    if (Ellipse != nullptr) {
-        writeEllipse(Ellipse);
-        return;
-    }
-
-    const auto Image = std::dynamic_pointer_cast<const lc::entity::Image>(entity);
-    if (Image != nullptr) {
-        writeImage(Image);
-        return;
-    }
-
-    const auto LWPolyline = std::dynamic_pointer_cast<const lc::entity::LWPolyline>(entity);
-    if (LWPolyline != nullptr) {
-        writeLWPolyline(LWPolyline);
-        return;
-    }
-
-    const auto Text = std::dynamic_pointer_cast<const lc::entity::Text>(entity);
-    if (Text != nullptr) {
-        writeText(Text);
-        return;
-    }
-
-    const auto ellipse = std::dynamic_pointer_cast<const lc::entity::Ellipse>(entity);
-    if (ellipse != nullptr) {
-        writeEllipse(ellipse);
-        return;
-    }
+    auto drwEntity = convertEntity(entity);
 
-    const auto insert = std::dynamic_pointer_cast<const lc::entity::Insert>(entity);
-    if (insert != nullptr) {
-         writeInsert(insert);
-         return;
+    if(drwEntity != nullptr) {
+        writeDRWEntity(drwEntity.get());
     }
 }
 
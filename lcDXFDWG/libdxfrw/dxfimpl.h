@@ -18,6 +18,7 @@
 #include <cad/base/metainfo.h>
 #include <cad/meta/icolor.h>
 #include <tuple>
+#include <memory>
 #include <cad/meta/block.h>
 #include <cad/operations/builder.h>
 
@@ -36,7 +37,7 @@ class DXFimpl : public DRW_Interface {
     public:
 
     DXFimpl(std::shared_ptr<lc::Document> document, lc::operation::Builder_SPtr builder);
-    DXFimpl(std::shared_ptr<lc::Document> document) : _document(document) {}
+    DXFimpl(std::shared_ptr<lc::Document> document) : _document(document), _parallelWrite(true) {}
 
         // READ FUNCTIONALITY
         virtual void addHeader(const DRW_Header *data) override { }
@@ -95,19 +96,37 @@ class DXFimpl : public DRW_Interface {
         virtual void writeDimstyles() override { }
         virtual void writeAppId() override;
 
-        void getEntityAttributes(DRW_Entity *ent, lc::entity::CADEntity_CSPtr entity);
+        void getEntityAttributes(DRW_Entity *ent, lc::entity::CADEntity_CSPtr entity) const;
         void writeEntity(lc::entity::CADEntity_CSPtr e);
-        void writePoint(const lc::entity::Point_CSPtr p);
-        void writeLine(const lc::entity::Line_CSPtr l);
-        void writeCircle(const lc::entity::Circle_CSPtr c);
-        void writeArc(const lc::entity::Arc_CSPtr a);
-        void writeEllipse(const lc::entity::Ellipse_CSPtr s);
-        void writeSpline(const lc::entity::Spline_CSPtr s);
-        void writeDimension(const lc::entity::Dimension_CSPtr d);
-        void writeLWPolyline(const lc::entity::LWPolyline_CSPtr p);
-        void writeImage(const lc::entity::Image_CSPtr i);
-        void writeText(const lc::entity::Text_CSPtr t);
-        void writeInsert(const lc::entity::Insert_CSPtr i);
+        void writeEntities(const std::vector<lc::entity::CADEntity_CSPtr>& entities);
+
+        /**
+        * Convert entities in batches on multiple threads before writing them (default).
+        * The output is the same as when converting them one by one.
+        */
+        void setParallelWrite(bool parallelWrite);
+
+        /**
+        * Convert a entity to it's libdxfrw counterpart.
+        * The conversion only reads the entity and can be run on any thread.
+        * Returns nullptr when the entity cannot be written.
+        */
+        std::unique_ptr<DRW_Entity> convertEntity(lc::entity::CADEntity_CSPtr entity) const;
+        std::unique_ptr<DRW_Entity> convertPoint(const lc::entity::Point_CSPtr p) const;
+        std::unique_ptr<DRW_Entity> convertLine(const lc::entity::Line_CSPtr l) const;
+        std::unique_ptr<DRW_Entity> convertCircle(const lc::entity::Circle_CSPtr c) const;
+        std::unique_ptr<DRW_Entity> convertArc(const lc::entity::Arc_CSPtr a) const;
+        std::unique_ptr<DRW_Entity> convertEllipse(const lc::entity::Ellipse_CSPtr s) const;
+        std::unique_ptr<DRW_Entity> convertSpline(const lc::entity::Spline_CSPtr s) const;
+        std::unique_ptr<DRW_Entity> convertInsert(const lc::entity::Insert_CSPtr i) const;
+        std::unique_ptr<DRW_Entity> convertText(const lc::entity::Text_CSPtr t) const;
+        std::unique_ptr<DRW_Entity> convertDimAligned(const lc::entity::DimAligned_CSPtr d) const;
+        std::unique_ptr<DRW_Entity> convertDimAngular(const lc::entity::DimAngular_CSPtr d) const;
+        std::unique_ptr<DRW_Entity> convertDimDiametric(const lc::entity::DimDiametric_CSPtr d) const;
+        std::unique_ptr<DRW_Entity> convertDimLinear(const lc::entity::DimLinear_CSPtr d) const;
+        std::unique_ptr<DRW_Entity> convertDimRadial(const lc::entity::DimRadial_CSPtr d) const;
+        std::unique_ptr<DRW_Entity> convertLWPolyline(const lc::entity::LWPolyline_CSPtr l) const;
+        std::unique_ptr<DRW_Entity> convertImage(const lc::entity::Image_CSPtr i) const;
 
         void writeLayer(const std::shared_ptr<const lc::Layer> layer);
         void writeBlock(const lc::Block_CSPtr block);
@@ -155,6 +174,9 @@ class DXFimpl : public DRW_Interface {
         */
 
         dxfRW* dxfW;
+        bool _parallelWrite;
+
+        void writeDRWEntity(DRW_Entity* entity);
 
         lc::MetaInfo_SPtr getMetaInfo(DRW_Entity const&) const;
         /**
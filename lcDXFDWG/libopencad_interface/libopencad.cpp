@@ -11,12 +11,12 @@ lc::FileLibs::LibOpenCad::LibOpenCad(lc::Document_SPtr document, lc::operation::
 
 }
 
-void lc::FileLibs::LibOpenCad::open(const std::string& file) {
+bool lc::FileLibs::LibOpenCad::open(const std::string& file) {
     auto f = OpenCADFile(file.c_str(), CADFile::OpenOptions::READ_ALL);
 
     if(f == nullptr) {
         std::cout << GetLastErrorCode() << std::endl;
-        return;
+        return false;
     }
 
     auto layerCount = f->GetLayersCount();
@@ -34,6 +34,7 @@ void lc::FileLibs::LibOpenCad::open(const std::string& file) {
     }
 
     free(f);
+    return true;
 }
 
 void lc::FileLibs::LibOpenCad::save(const std::string& file) {
@@ -16,8 +16,9 @@ namespace lc {
                 /**
                  * Open a file with libopencad
                  * @param file File to open
+                 * @return false if the file could not be read
                  */
-                void open(const std::string& file);
+                bool open(const std::string& file);
 
                 void save(const std::string& file);
 
@@ -0,0 +1,1489 @@
+#include "librecadbinary.h"
+
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <vector>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cad/base/entitypool.h>
+#include <cad/base/metainfo.h>
+#include <cad/base/threadpool.h>
+#include <cad/builders/insert.h>
+#include <cad/interface/entitydispatch.h>
+#include <cad/meta/customentitystorage.h>
+#include <cad/meta/metacolor.h>
+#include <cad/meta/metalinewidth.h>
+#include <cad/operations/blockops.h>
+#include <cad/operations/layerops.h>
+#include <cad/operations/linepatternops.h>
+#include <cad/primitive/arc.h>
+#include <cad/primitive/circle.h>
+#include <cad/primitive/dimaligned.h>
+#include <cad/primitive/dimangular.h>
+#include <cad/primitive/dimdiametric.h>
+#include <cad/primitive/dimlinear.h>
+#include <cad/primitive/dimradial.h>
+#include <cad/primitive/ellipse.h>
+#include <cad/primitive/image.h>
+#include <cad/primitive/insert.h>
+#include <cad/primitive/line.h>
+#include <cad/primitive/lwpolyline.h>
+#include <cad/primitive/point.h>
+#include <cad/primitive/spline.h>
+#include <cad/primitive/text.h>
+
+using namespace lc;
+using namespace lc::FileLibs;
+
+namespace {
+    const char MAGIC[8] = {'L', 'C', 'A', 'D', 'B', 'I', 'N', '\0'};
+    const int32_t NONE = -1;
+    const int32_t BYBLOCK = -2;
+
+    enum SectionType : uint32_t {
+        STRINGS = 1,
+        DOUBLES = 2,
+        LINEPATTERNS = 3,
+        LAYERS = 4,
+        BLOCKS = 5,
+        BLOCKPARAMS = 6,
+        METAINFO = 7,
+        SPATIALINDEX = 8,
+
+        POINTS = 16,
+        LINES = 17,
+        CIRCLES = 18,
+        ARCS = 19,
+        ELLIPSES = 20,
+        LWPOLYLINES = 21,
+        LWVERTICES = 22,
+        INSERTS = 23,
+        TEXTS = 24,
+        SPLINES = 25,
+        DIMALIGNED = 26,
+        DIMANGULAR = 27,
+        DIMDIAMETRIC = 28,
+        DIMLINEAR = 29,
+        DIMRADIAL = 30,
+        IMAGES = 31
+    };
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t sectionCount;
+        uint64_t sectionTableOffset;
+    };
+
+    struct SectionEntry {
+        uint32_t type;
+        // Number of integer columns in the upper and double columns in the lower 16 bits for entity tables
+        uint32_t columns;
+        uint64_t offset;
+        uint64_t size;
+        uint64_t count;
+    };
+
+    struct StringRef {
+        uint64_t offset;
+        uint64_t length;
+    };
+
+    struct LinePatternRecord {
+        StringRef name;
+        StringRef description;
+        uint64_t pathOffset;
+        uint64_t pathCount;
+        double length;
+    };
+
+    struct LayerRecord {
+        StringRef name;
+        double lineWidth;
+        double color[4];
+        int32_t linePattern;
+        uint32_t frozen;
+    };
+
+    struct BlockRecord {
+        StringRef name;
+        StringRef pluginName;
+        StringRef entityName;
+        double base[3];
+        uint64_t firstParam;
+        uint64_t paramCount;
+    };
+
+    /**
+     * Color, line width and line pattern of a entity.
+     * The kinds are NONE, BYBLOCK or 0 for a value, the line pattern is a index or NONE/BYBLOCK.
+     */
+    struct MetaInfoRecord {
+        int32_t colorKind;
+        int32_t lineWidthKind;
+        int32_t linePattern;
+        int32_t reserved;
+        double color[4];
+        double lineWidth;
+
+        std::tuple<int32_t, int32_t, int32_t, double, double, double, double, double> key() const {
+            return std::make_tuple(colorKind, lineWidthKind, linePattern, color[0], color[1], color[2], color[3], lineWidth);
+        }
+    };
+
+    enum EntityColumns {
+        POINT_INTS = 0, POINT_DOUBLES = 2,
+        LINE_INTS = 0, LINE_DOUBLES = 4,
+        CIRCLE_INTS = 0, CIRCLE_DOUBLES = 3,
+        ARC_INTS = 1, ARC_DOUBLES = 5,
+        ELLIPSE_INTS = 1, ELLIPSE_DOUBLES = 7,
+        LWPOLYLINE_INTS = 3, LWPOLYLINE_DOUBLES = 6,
+        INSERT_INTS = 1, INSERT_DOUBLES = 3,
+        // Strings are a offset and a length in the string section
+        TEXT_INTS = 7, TEXT_DOUBLES = 4,
+        // Control points, knots and fit points are ranges of the double section
+        SPLINE_INTS = 9, SPLINE_DOUBLES = 10,
+        // Columns shared by all dimensions come first
+        DIMENSION_INTS = 4, DIMENSION_DOUBLES = 6,
+        DIMALIGNED_DOUBLES = DIMENSION_DOUBLES + 4,
+        DIMANGULAR_DOUBLES = DIMENSION_DOUBLES + 8,
+        DIMDIAMETRIC_DOUBLES = DIMENSION_DOUBLES + 3,
+        DIMLINEAR_DOUBLES = DIMENSION_DOUBLES + 6,
+        DIMRADIAL_DOUBLES = DIMENSION_DOUBLES + 3,
+        IMAGE_INTS = 2, IMAGE_DOUBLES = 11
+    };
+
+    bool isLittleEndian() {
+        const uint16_t value = 1;
+        return *reinterpret_cast<const uint8_t*>(&value) == 1;
+    }
+
+    /**
+     * Read only view of a file, memory mapped where possible
+     */
+    class MappedFile {
+        public:
+            explicit MappedFile(const std::string& path) : _data(nullptr), _size(0) {
+#ifdef _WIN32
+                std::ifstream file(path, std::ios::binary | std::ios::ate);
+                if (!file) {
+                    return;
+                }
+
+                _size = static_cast<size_t>(file.tellg());
+                // uint64_t storage keeps the arrays aligned like a mapped file
+                _buffer.resize((_size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+                file.seekg(0);
+                file.read(reinterpret_cast<char*>(_buffer.data()), _size);
+                _data = reinterpret_cast<const char*>(_buffer.data());
+#else
+                int fd = ::open(path.c_str(), O_RDONLY);
+                if (fd < 0) {
+                    return;
+                }
+
+                struct stat fileStat;
+                if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0) {
+                    void* data = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (data != MAP_FAILED) {
+                        _data = static_cast<const char*>(data);
+                        _size = fileStat.st_size;
+                    }
+                }
+
+                ::close(fd);
+#endif
+            }
+
+            ~MappedFile() {
+#ifndef _WIN32
+                if (_data != nullptr) {
+                    munmap(const_cast<char*>(_data), _size);
+                }
+#endif
+            }
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            const char* data() const {
+                return _data;
+            }
+
+            size_t size() const {
+                return _size;
+            }
+
+        private:
+            const char* _data;
+            size_t _size;
+#ifdef _WIN32
+            std::vector<uint64_t> _buffer;
+#endif
+    };
+
+    /**
+     * Columns of one entity type, filled while saving
+     */
+    struct EntityTable {
+        EntityTable(uint32_t type, size_t intColumns, size_t doubleColumns) :
+            type(type),
+            ints(intColumns),
+            doubles(doubleColumns) {
+        }
+
+        void add(int32_t layer, int32_t block, int32_t metaInfo) {
+            layers.push_back(layer);
+            blocks.push_back(block);
+            metaInfos.push_back(metaInfo);
+        }
+
+        size_t size() const {
+            return layers.size();
+        }
+
+        uint32_t type;
+        std::vector<int32_t> layers;
+        std::vector<int32_t> blocks;
+        std::vector<int32_t> metaInfos;
+        std::vector<std::vector<int64_t>> ints;
+        std::vector<std::vector<double>> doubles;
+    };
+
+    /**
+     * Appends sections to the file and keeps the section table
+     */
+    class SectionWriter {
+        public:
+            explicit SectionWriter(std::ofstream& stream) : _stream(stream), _offset(0) {
+            }
+
+            template<typename T>
+            void write(const T* data, size_t count) {
+                _stream.write(reinterpret_cast<const char*>(data), count * sizeof(T));
+                _offset += count * sizeof(T);
+            }
+
+            void align() {
+                const char zero[8] = {0};
+                write(zero, (8 - _offset % 8) % 8);
+            }
+
+            void begin(uint32_t type, uint64_t count, uint32_t columns = 0) {
+                align();
+                _current = SectionEntry{type, columns, _offset, 0, count};
+            }
+
+            void end() {
+                _current.size = _offset - _current.offset;
+                _sections.push_back(_current);
+            }
+
+            template<typename T>
+            void section(uint32_t type, const std::vector<T>& data) {
+                begin(type, data.size());
+                write(data.data(), data.size());
+                end();
+            }
+
+            void table(const EntityTable& table) {
+                begin(table.type, table.size(), static_cast<uint32_t>(table.ints.size() << 16 | table.doubles.size()));
+                write(table.layers.data(), table.size());
+                write(table.blocks.data(), table.size());
+                write(table.metaInfos.data(), table.size());
+                align();
+
+                for (const auto& column : table.ints) {
+                    write(column.data(), column.size());
+                }
+
+                for (const auto& column : table.doubles) {
+                    write(column.data(), column.size());
+                }
+
+                end();
+            }
+
+            uint64_t offset() const {
+                return _offset;
+            }
+
+            const std::vector<SectionEntry>& sections() const {
+                return _sections;
+            }
+
+        private:
+            std::ofstream& _stream;
+            uint64_t _offset;
+            SectionEntry _current;
+            std::vector<SectionEntry> _sections;
+    };
+
+    /**
+     * Sorts entities in the table of their type
+     * Strings and arrays of variable size are appended to the string and double sections.
+     */
+    class TableCollector : public EntityDispatch {
+        public:
+            TableCollector(std::unordered_map<std::string, int32_t>& blockIndex,
+                           const std::function<StringRef(const std::string&)>& addString,
+                           std::vector<double>& doubles) :
+                points(POINTS, POINT_INTS, POINT_DOUBLES),
+                lines(LINES, LINE_INTS, LINE_DOUBLES),
+                circles(CIRCLES, CIRCLE_INTS, CIRCLE_DOUBLES),
+                arcs(ARCS, ARC_INTS, ARC_DOUBLES),
+                ellipses(ELLIPSES, ELLIPSE_INTS, ELLIPSE_DOUBLES),
+                lwPolylines(LWPOLYLINES, LWPOLYLINE_INTS, LWPOLYLINE_DOUBLES),
+                inserts(INSERTS, INSERT_INTS, INSERT_DOUBLES),
+                texts(TEXTS, TEXT_INTS, TEXT_DOUBLES),
+                splines(SPLINES, SPLINE_INTS, SPLINE_DOUBLES),
+                dimAligned(DIMALIGNED, DIMENSION_INTS, DIMALIGNED_DOUBLES),
+                dimAngular(DIMANGULAR, DIMENSION_INTS, DIMANGULAR_DOUBLES),
+                dimDiametric(DIMDIAMETRIC, DIMENSION_INTS, DIMDIAMETRIC_DOUBLES),
+                dimLinear(DIMLINEAR, DIMENSION_INTS, DIMLINEAR_DOUBLES),
+                dimRadial(DIMRADIAL, DIMENSION_INTS, DIMRADIAL_DOUBLES),
+                images(IMAGES, IMAGE_INTS, IMAGE_DOUBLES),
+                complete(true),
+                _blockIndex(blockIndex),
+                _addString(addString),
+                _doubles(doubles) {
+            }
+
+            void add(const entity::CADEntity_CSPtr& entity, int32_t layer, int32_t block, int32_t metaInfo) {
+                _layer = layer;
+                _block = block;
+                _metaInfo = metaInfo;
+                entity->dispatch(*this);
+            }
+
+            void visit(entity::Point_CSPtr point) override {
+                points.add(_layer, _block, _metaInfo);
+                points.doubles[0].push_back(point->x());
+                points.doubles[1].push_back(point->y());
+            }
+
+            void visit(entity::Line_CSPtr line) override {
+                lines.add(_layer, _block, _metaInfo);
+                lines.doubles[0].push_back(line->start().x());
+                lines.doubles[1].push_back(line->start().y());
+                lines.doubles[2].push_back(line->end().x());
+                lines.doubles[3].push_back(line->end().y());
+            }
+
+            void visit(entity::Circle_CSPtr circle) override {
+                circles.add(_layer, _block, _metaInfo);
+                circles.doubles[0].push_back(circle->center().x());
+                circles.doubles[1].push_back(circle->center().y());
+                circles.doubles[2].push_back(circle->radius());
+            }
+
+            void visit(entity::Arc_CSPtr arc) override {
+                arcs.add(_layer, _block, _metaInfo);
+                arcs.ints[0].push_back(arc->CCW() ? 1 : 0);
+                arcs.doubles[0].push_back(arc->center().x());
+                arcs.doubles[1].push_back(arc->center().y());
+                arcs.doubles[2].push_back(arc->radius());
+                arcs.doubles[3].push_back(arc->startAngle());
+                arcs.doubles[4].push_back(arc->endAngle());
+            }
+
+            void visit(entity::Ellipse_CSPtr ellipse) override {
+                ellipses.add(_layer, _block, _metaInfo);
+                ellipses.ints[0].push_back(ellipse->isReversed() ? 1 : 0);
+                ellipses.doubles[0].push_back(ellipse->center().x());
+                ellipses.doubles[1].push_back(ellipse->center().y());
+                ellipses.doubles[2].push_back(ellipse->majorP().x());
+                ellipses.doubles[3].push_back(ellipse->majorP().y());
+                ellipses.doubles[4].push_back(ellipse->minorRadius());
+                ellipses.doubles[5].push_back(ellipse->startAngle());
+                ellipses.doubles[6].push_back(ellipse->endAngle());
+            }
+
+            void visit(entity::LWPolyline_CSPtr lwPolyline) override {
+                lwPolylines.add(_layer, _block, _metaInfo);
+                lwPolylines.ints[0].push_back(vertexX.size());
+                lwPolylines.ints[1].push_back(lwPolyline->vertex().size());
+                lwPolylines.ints[2].push_back(lwPolyline->closed() ? 1 : 0);
+                lwPolylines.doubles[0].push_back(lwPolyline->width());
+                lwPolylines.doubles[1].push_back(lwPolyline->elevation());
+                lwPolylines.doubles[2].push_back(lwPolyline->tickness());
+                lwPolylines.doubles[3].push_back(lwPolyline->extrusionDirection().x());
+                lwPolylines.doubles[4].push_back(lwPolyline->extrusionDirection().y());
+                lwPolylines.doubles[5].push_back(lwPolyline->extrusionDirection().z());
+
+                for (const auto& vertex : lwPolyline->vertex()) {
+                    vertexX.push_back(vertex.location().x());
+                    vertexY.push_back(vertex.location().y());
+                    vertexBulge.push_back(vertex.bulge());
+                    vertexStartWidth.push_back(vertex.startWidth());
+                    vertexEndWidth.push_back(vertex.endWidth());
+                }
+            }
+
+            void visit(entity::Insert_CSPtr insert) override {
+                auto block = _blockIndex.find(insert->displayBlock()->name());
+                if (block == _blockIndex.end()) {
+                    complete = false;
+                    return;
+                }
+
+                inserts.add(_layer, _block, _metaInfo);
+                inserts.ints[0].push_back(block->second);
+                inserts.doubles[0].push_back(insert->position().x());
+                inserts.doubles[1].push_back(insert->position().y());
+                inserts.doubles[2].push_back(insert->position().z());
+            }
+
+            void visit(entity::Text_CSPtr text) override {
+                auto value = _addString(text->text_value());
+                auto style = _addString(text->style());
+
+                texts.add(_layer, _block, _metaInfo);
+                texts.ints[0].push_back(value.offset);
+                texts.ints[1].push_back(value.length);
+                texts.ints[2].push_back(style.offset);
+                texts.ints[3].push_back(style.length);
+                texts.ints[4].push_back(text->textgeneration());
+                texts.ints[5].push_back(text->halign());
+                texts.ints[6].push_back(text->valign());
+                texts.doubles[0].push_back(text->insertion_point().x());
+                texts.doubles[1].push_back(text->insertion_point().y());
+                texts.doubles[2].push_back(text->height());
+                texts.doubles[3].push_back(text->angle());
+            }
+
+            void visit(entity::Spline_CSPtr spline) override {
+                splines.add(_layer, _block, _metaInfo);
+                splines.ints[0].push_back(_doubles.size());
+                splines.ints[1].push_back(spline->controlPoints().size());
+                addCoordinates(spline->controlPoints());
+                splines.ints[2].push_back(_doubles.size());
+                splines.ints[3].push_back(spline->knotPoints().size());
+                _doubles.insert(_doubles.end(), spline->knotPoints().begin(), spline->knotPoints().end());
+                splines.ints[4].push_back(_doubles.size());
+                splines.ints[5].push_back(spline->fitPoints().size());
+                addCoordinates(spline->fitPoints());
+                splines.ints[6].push_back(spline->degree());
+                splines.ints[7].push_back(spline->closed() ? 1 : 0);
+                splines.ints[8].push_back(spline->flags());
+                splines.doubles[0].push_back(spline->fitTolerance());
+                splines.doubles[1].push_back(spline->startTanX());
+                splines.doubles[2].push_back(spline->startTanY());
+                splines.doubles[3].push_back(spline->startTanZ());
+                splines.doubles[4].push_back(spline->endTanX());
+                splines.doubles[5].push_back(spline->endTanY());
+                splines.doubles[6].push_back(spline->endTanZ());
+                splines.doubles[7].push_back(spline->nX());
+                splines.doubles[8].push_back(spline->nY());
+                splines.doubles[9].push_back(spline->nZ());
+            }
+
+            void visit(entity::DimAligned_CSPtr dimension) override {
+                addDimension(dimAligned, *dimension);
+                addCoordinate(dimAligned, DIMENSION_DOUBLES, dimension->definitionPoint2());
+                addCoordinate(dimAligned, DIMENSION_DOUBLES + 2, dimension->definitionPoint3());
+            }
+
+            void visit(entity::DimAngular_CSPtr dimension) override {
+                addDimension(dimAngular, *dimension);
+                addCoordinate(dimAngular, DIMENSION_DOUBLES, dimension->defLine11());
+                addCoordinate(dimAngular, DIMENSION_DOUBLES + 2, dimension->defLine12());
+                addCoordinate(dimAngular, DIMENSION_DOUBLES + 4, dimension->defLine21());
+                addCoordinate(dimAngular, DIMENSION_DOUBLES + 6, dimension->defLine22());
+            }
+
+            void visit(entity::DimDiametric_CSPtr dimension) override {
+                addDimension(dimDiametric, *dimension);
+                addCoordinate(dimDiametric, DIMENSION_DOUBLES, dimension->definitionPoint2());
+                dimDiametric.doubles[DIMENSION_DOUBLES + 2].push_back(dimension->leader());
+            }
+
+            void visit(entity::DimLinear_CSPtr dimension) override {
+                addDimension(dimLinear, *dimension);
+                addCoordinate(dimLinear, DIMENSION_DOUBLES, dimension->definitionPoint2());
+                addCoordinate(dimLinear, DIMENSION_DOUBLES + 2, dimension->definitionPoint3());
+                dimLinear.doubles[DIMENSION_DOUBLES + 4].push_back(dimension->angle());
+                dimLinear.doubles[DIMENSION_DOUBLES + 5].push_back(dimension->oblique());
+            }
+
+            void visit(entity::DimRadial_CSPtr dimension) override {
+                addDimension(dimRadial, *dimension);
+                addCoordinate(dimRadial, DIMENSION_DOUBLES, dimension->definitionPoint2());
+                dimRadial.doubles[DIMENSION_DOUBLES + 2].push_back(dimension->leader());
+            }
+
+            void visit(entity::Image_CSPtr image) override {
+                auto name = _addString(image->name());
+
+                images.add(_layer, _block, _metaInfo);
+                images.ints[0].push_back(name.offset);
+                images.ints[1].push_back(name.length);
+                addCoordinate(images, 0, image->base());
+                addCoordinate(images, 2, image->uv());
+                addCoordinate(images, 4, image->vv());
+                images.doubles[6].push_back(image->width());
+                images.doubles[7].push_back(image->height());
+                images.doubles[8].push_back(image->brightness());
+                images.doubles[9].push_back(image->contrast());
+                images.doubles[10].push_back(image->fade());
+            }
+
+            EntityTable points;
+            EntityTable lines;
+            EntityTable circles;
+            EntityTable arcs;
+            EntityTable ellipses;
+            EntityTable lwPolylines;
+            EntityTable inserts;
+            EntityTable texts;
+            EntityTable splines;
+            EntityTable dimAligned;
+            EntityTable dimAngular;
+            EntityTable dimDiametric;
+            EntityTable dimLinear;
+            EntityTable dimRadial;
+            EntityTable images;
+
+            std::vector<double> vertexX;
+            std::vector<double> vertexY;
+            std::vector<double> vertexBulge;
+            std::vector<double> vertexStartWidth;
+            std::vector<double> vertexEndWidth;
+
+            // false if a entity could not be stored
+            bool complete;
+
+        private:
+            void addCoordinate(EntityTable& table, size_t column, const geo::Coordinate& coordinate) {
+                table.doubles[column].push_back(coordinate.x());
+                table.doubles[column + 1].push_back(coordinate.y());
+            }
+
+            void addCoordinates(const std::vector<geo::Coordinate>& coordinates) {
+                for (const auto& coordinate : coordinates) {
+                    _doubles.push_back(coordinate.x());
+                    _doubles.push_back(coordinate.y());
+                    _doubles.push_back(coordinate.z());
+                }
+            }
+
+            void addDimension(EntityTable& table, const entity::Dimension& dimension) {
+                auto value = _addString(dimension.explicitValue());
+
+                table.add(_layer, _block, _metaInfo);
+                table.ints[0].push_back(dimension.attachmentPoint());
+                table.ints[1].push_back(dimension.lineSpacingStyle());
+                table.ints[2].push_back(value.offset);
+                table.ints[3].push_back(value.length);
+                addCoordinate(table, 0, dimension.definitionPoint());
+                addCoordinate(table, 2, dimension.middleOfText());
+                table.doubles[4].push_back(dimension.textAngle());
+                table.doubles[5].push_back(dimension.lineSpacingFactor());
+            }
+
+            std::unordered_map<std::string, int32_t>& _blockIndex;
+            std::function<StringRef(const std::string&)> _addString;
+            std::vector<double>& _doubles;
+            int32_t _layer;
+            int32_t _block;
+            int32_t _metaInfo;
+    };
+
+    /**
+     * Columns of one entity type within the mapped file
+     */
+    struct EntityTableView {
+        size_t count = 0;
+        const int32_t* layers = nullptr;
+        const int32_t* blocks = nullptr;
+        const int32_t* metaInfos = nullptr;
+        std::vector<const int64_t*> ints;
+        std::vector<const double*> doubles;
+    };
+
+    /**
+     * Restores the stored spatial index layout when the builder runs, before the entities are inserted
+     */
+    class RestoreSpatialIndex : public operation::DocumentOperation {
+        public:
+            RestoreSpatialIndex(Document_SPtr document, std::vector<uint8_t> layout, std::shared_ptr<bool> restored) :
+                DocumentOperation(document, "Restore spatial index"),
+                _layout(std::move(layout)),
+                _restored(std::move(restored)) {
+            }
+
+            void undo() const override {
+            }
+
+            void redo() const override {
+            }
+
+        protected:
+            void processInternal() override {
+                // A document which already has entities or a layout of a different tree keeps the normal index
+                *_restored = document()->restoreSpatialIndexLayout(_layout);
+            }
+
+        private:
+            std::vector<uint8_t> _layout;
+            std::shared_ptr<bool> _restored;
+    };
+
+    /**
+     * Checked entity tables of a opened file, with the mapped file they point into
+     */
+    struct EntityTables {
+        std::unique_ptr<MappedFile> mapped;
+        const char* strings = nullptr;
+        size_t stringsSize = 0;
+        const double* doubles = nullptr;
+        // x, y, bulge, start width and end width columns of the polyline vertices
+        const double* vertices = nullptr;
+        size_t vertexCount = 0;
+
+        std::vector<Layer_CSPtr> layers;
+        std::vector<Block_CSPtr> blocks;
+        std::vector<MetaInfo_CSPtr> metaInfos;
+
+        EntityTableView points, lines, circles, arcs, ellipses, lwPolylines, inserts;
+        EntityTableView texts, splines, dimAligned, dimAngular, dimDiametric, dimLinear, dimRadial, images;
+
+        std::string string(const StringRef& ref) const {
+            if (strings == nullptr || ref.offset > stringsSize || ref.length > stringsSize - ref.offset) {
+                return std::string();
+            }
+
+            return std::string(strings + ref.offset, ref.length);
+        }
+    };
+
+    /**
+     * Create the entities of the tables and append them to the entity builder
+     */
+    void createEntities(const EntityTables& tables, const Document_SPtr& document, operation::EntityBuilder& entityBuilder);
+
+    /**
+     * Creates the entities when the builder runs, before the entity builder
+     * Opening a file only checks it, a builder which is never executed doesn't create any entity.
+     * The mapped file is released once the entities exist.
+     */
+    class MaterializeEntities : public operation::DocumentOperation {
+        public:
+            MaterializeEntities(Document_SPtr document, std::shared_ptr<EntityTables> tables,
+                                operation::EntityBuilder_SPtr entityBuilder) :
+                DocumentOperation(document, "Create entities"),
+                _tables(std::move(tables)),
+                _entityBuilder(std::move(entityBuilder)) {
+            }
+
+            void undo() const override {
+            }
+
+            void redo() const override {
+            }
+
+        protected:
+            void processInternal() override {
+                if (_tables != nullptr) {
+                    createEntities(*_tables, document(), *_entityBuilder);
+                    _tables = nullptr;
+                }
+            }
+
+        private:
+            std::shared_ptr<EntityTables> _tables;
+            operation::EntityBuilder_SPtr _entityBuilder;
+    };
+}
+
+LibreCadBinary::LibreCadBinary(Document_SPtr document, lc::operation::Builder_SPtr builder) :
+    _document(document),
+    _builder(builder),
+    _entityBuilder(std::make_shared<lc::operation::EntityBuilder>(document)),
+    _spatialIndexRestored(std::make_shared<bool>(false)) {
+}
+
+bool LibreCadBinary::save(const std::string& file) {
+    if (!isLittleEndian()) {
+        return false;
+    }
+
+    std::string strings;
+    auto addString = [&strings](const std::string& value) {
+        StringRef ref{strings.size(), value.size()};
+        strings += value;
+        return ref;
+    };
+
+    std::vector<double> doubles;
+
+    // Line patterns
+    std::vector<LinePatternRecord> linePatterns;
+    std::map<std::string, int32_t> linePatternIndex;
+    for (const auto& linePattern : _document->linePatterns()) {
+        linePatternIndex[linePattern->name()] = linePatterns.size();
+        linePatterns.push_back(LinePatternRecord{
+            addString(linePattern->name()),
+            addString(linePattern->description()),
+            doubles.size(),
+            linePattern->path().size(),
+            linePattern->length()
+        });
+        doubles.insert(doubles.end(), linePattern->path().begin(), linePattern->path().end());
+    }
+
+    auto linePatternOf = [&linePatternIndex](const DxfLinePatternByValue_CSPtr& linePattern) {
+        if (linePattern == nullptr) {
+            return NONE;
+        }
+
+        auto it = linePatternIndex.find(linePattern->name());
+        return it == linePatternIndex.end() ? NONE : it->second;
+    };
+
+    // Layers
+    std::vector<LayerRecord> layers;
+    std::unordered_map<Layer_CSPtr, int32_t> layerIndex;
+    for (const auto& layer : _document->allLayers()) {
+        auto color = layer.second->color();
+        layerIndex[layer.second] = layers.size();
+        layers.push_back(LayerRecord{
+            addString(layer.second->name()),
+            layer.second->lineWidth().width(),
+            {color.red(), color.green(), color.blue(), color.alpha()},
+            linePatternOf(layer.second->linePattern()),
+            layer.second->isFrozen() ? 1u : 0u
+        });
+    }
+
+    // Blocks
+    std::vector<BlockRecord> blocks;
+    std::vector<StringRef> blockParams;
+    std::unordered_map<std::string, int32_t> blockIndex;
+    auto documentBlocks = _document->blocks();
+    for (const auto& block : documentBlocks) {
+        BlockRecord record{
+            addString(block->name()),
+            StringRef{0, 0},
+            StringRef{0, 0},
+            {block->base().x(), block->base().y(), block->base().z()},
+            blockParams.size(),
+            0
+        };
+
+        auto customEntity = std::dynamic_pointer_cast<const CustomEntityStorage>(block);
+        if (customEntity != nullptr) {
+            record.pluginName = addString(customEntity->pluginName());
+            record.entityName = addString(customEntity->entityName());
+
+            for (const auto& param : customEntity->params()) {
+                blockParams.push_back(addString(param.first));
+                blockParams.push_back(addString(param.second));
+            }
+            record.paramCount = customEntity->params().size();
+        }
+
+        blockIndex[block->name()] = blocks.size();
+        blocks.push_back(record);
+    }
+
+    // Entities, meta info is stored once for each different combination
+    std::vector<MetaInfoRecord> metaInfos;
+    std::map<std::tuple<int32_t, int32_t, int32_t, double, double, double, double, double>, int32_t> metaInfoIndex;
+    std::unordered_map<MetaInfo_CSPtr, int32_t> metaInfoCache;
+
+    auto metaInfoOf = [&](const entity::CADEntity_CSPtr& entity) {
+        auto metaInfo = entity->metaInfo();
+        if (metaInfo == nullptr) {
+            return NONE;
+        }
+
+        auto cached = metaInfoCache.find(metaInfo);
+        if (cached != metaInfoCache.end()) {
+            return cached->second;
+        }
+
+        MetaInfoRecord record{NONE, NONE, NONE, 0, {0., 0., 0., 0.}, 0.};
+
+        auto colorByValue = entity->metaInfo<MetaColorByValue>(MetaColor::LCMETANAME());
+        if (colorByValue != nullptr) {
+            auto color = colorByValue->color();
+            record.colorKind = 0;
+            record.color[0] = color.red();
+            record.color[1] = color.green();
+            record.color[2] = color.blue();
+            record.color[3] = color.alpha();
+        }
+        else if (entity->metaInfo<MetaColorByBlock>(MetaColor::LCMETANAME()) != nullptr) {
+            record.colorKind = BYBLOCK;
+        }
+
+        auto lineWidthByValue = entity->metaInfo<MetaLineWidthByValue>(MetaLineWidth::LCMETANAME());
+        if (lineWidthByValue != nullptr) {
+            record.lineWidthKind = 0;
+            record.lineWidth = lineWidthByValue->width();
+        }
+        else if (entity->metaInfo<MetaLineWidthByBlock>(MetaLineWidth::LCMETANAME()) != nullptr) {
+            record.lineWidthKind = BYBLOCK;
+        }
+
+        auto linePatternByValue = entity->metaInfo<DxfLinePatternByValue>(DxfLinePattern::LCMETANAME());
+        if (linePatternByValue != nullptr) {
+            record.linePattern = linePatternOf(linePatternByValue);
+        }
+        else if (entity->metaInfo<DxfLinePatternByBlock>(DxfLinePattern::LCMETANAME()) != nullptr) {
+            record.linePattern = BYBLOCK;
+        }
+
+        auto inserted = metaInfoIndex.insert(std::make_pair(record.key(), static_cast<int32_t>(metaInfos.size())));
+        if (inserted.second) {
+            metaInfos.push_back(record);
+        }
+
+        metaInfoCache[metaInfo] = inserted.first->second;
+        return inserted.first->second;
+    };
+
+    TableCollector collector(blockIndex, addString, doubles);
+    auto collect = [&](const std::vector<entity::CADEntity_CSPtr>& entities, int32_t block) {
+        for (const auto& entity : entities) {
+            auto layer = layerIndex.find(entity->layer());
+            if (layer == layerIndex.end()) {
+                collector.complete = false;
+                continue;
+            }
+
+            collector.add(entity, layer->second, block, metaInfoOf(entity));
+        }
+    };
+
+    collect(_document->entities(), NONE);
+    for (const auto& block : documentBlocks) {
+        collect(_document->entitiesByBlock(block).asVector(), blockIndex[block->name()]);
+    }
+
+    // Don't write a file which silently misses entities
+    if (!collector.complete) {
+        return false;
+    }
+
+    std::ofstream stream(file, std::ios::binary | std::ios::trunc);
+    if (!stream) {
+        return false;
+    }
+
+    FileHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.sectionCount = 0;
+    header.sectionTableOffset = 0;
+
+    SectionWriter writer(stream);
+    writer.write(&header, 1);
+
+    writer.section(STRINGS, std::vector<char>(strings.begin(), strings.end()));
+    writer.section(DOUBLES, doubles);
+    writer.section(LINEPATTERNS, linePatterns);
+    writer.section(LAYERS, layers);
+    writer.section(BLOCKS, blocks);
+    writer.section(BLOCKPARAMS, blockParams);
+    writer.section(METAINFO, metaInfos);
+    writer.section(SPATIALINDEX, _document->spatialIndexLayout());
+
+    writer.table(collector.points);
+    writer.table(collector.lines);
+    writer.table(collector.circles);
+    writer.table(collector.arcs);
+    writer.table(collector.ellipses);
+    writer.table(collector.lwPolylines);
+    writer.table(collector.inserts);
+    writer.table(collector.texts);
+    writer.table(collector.splines);
+    writer.table(collector.dimAligned);
+    writer.table(collector.dimAngular);
+    writer.table(collector.dimDiametric);
+    writer.table(collector.dimLinear);
+    writer.table(collector.dimRadial);
+    writer.table(collector.images);
+
+    writer.begin(LWVERTICES, collector.vertexX.size());
+    writer.write(collector.vertexX.data(), collector.vertexX.size());
+    writer.write(collector.vertexY.data(), collector.vertexY.size());
+    writer.write(collector.vertexBulge.data(), collector.vertexBulge.size());
+    writer.write(collector.vertexStartWidth.data(), collector.vertexStartWidth.size());
+    writer.write(collector.vertexEndWidth.data(), collector.vertexEndWidth.size());
+    writer.end();
+
+    writer.align();
+    header.sectionCount = writer.sections().size();
+    header.sectionTableOffset = writer.offset();
+    writer.write(writer.sections().data(), writer.sections().size());
+
+    stream.seekp(0);
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    return stream.good();
+}
+
+bool LibreCadBinary::open(const std::string& file) {
+    if (_builder == nullptr || !isLittleEndian()) {
+        return false;
+    }
+
+    // The entity tables keep the file mapped until the builder creates the entities
+    auto tables = std::make_shared<EntityTables>();
+    tables->mapped.reset(new MappedFile(file));
+    const char* data = tables->mapped->data();
+    const size_t size = tables->mapped->size();
+
+    if (data == nullptr || size < sizeof(FileHeader)) {
+        return false;
+    }
+
+    auto header = reinterpret_cast<const FileHeader*>(data);
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION) {
+        return false;
+    }
+
+    if (header->sectionTableOffset % 8 != 0 || header->sectionTableOffset > size ||
+        header->sectionCount > (size - header->sectionTableOffset) / sizeof(SectionEntry)) {
+        return false;
+    }
+
+    std::map<uint32_t, SectionEntry> sections;
+    auto sectionTable = reinterpret_cast<const SectionEntry*>(data + header->sectionTableOffset);
+    for (uint32_t i = 0; i < header->sectionCount; i++) {
+        const auto& section = sectionTable[i];
+        if (section.offset % 8 != 0 || section.offset > size || section.size > size - section.offset) {
+            return false;
+        }
+
+        sections[section.type] = section;
+    }
+
+    // Returns the items of a section, or nullptr when the section is missing or too small
+    auto array = [&](uint32_t type, size_t itemSize, size_t& count) -> const char* {
+        auto it = sections.find(type);
+        if (it == sections.end() || it->second.count > it->second.size / std::max<size_t>(itemSize, 1)) {
+            count = 0;
+            return nullptr;
+        }
+
+        count = it->second.count;
+        return data + it->second.offset;
+    };
+
+    tables->strings = array(STRINGS, sizeof(char), tables->stringsSize);
+    auto string = [&tables](const StringRef& ref) {
+        return tables->string(ref);
+    };
+
+    size_t doublesCount;
+    auto doubles = reinterpret_cast<const double*>(array(DOUBLES, sizeof(double), doublesCount));
+    tables->doubles = doubles;
+
+    // Line patterns
+    size_t linePatternCount;
+    auto linePatternRecords = reinterpret_cast<const LinePatternRecord*>(array(LINEPATTERNS, sizeof(LinePatternRecord), linePatternCount));
+    std::vector<DxfLinePatternByValue_CSPtr> linePatterns;
+    for (size_t i = 0; i < linePatternCount; i++) {
+        const auto& record = linePatternRecords[i];
+        if (record.pathOffset > doublesCount || record.pathCount > doublesCount - record.pathOffset) {
+            return false;
+        }
+
+        auto name = string(record.name);
+        auto linePattern = _document->linePatternByName(name);
+        if (linePattern == nullptr) {
+            linePattern = std::make_shared<DxfLinePatternByValue>(
+                name,
+                string(record.description),
+                std::vector<double>(doubles + record.pathOffset, doubles + record.pathOffset + record.pathCount),
+                record.length
+            );
+            _builder->append(std::make_shared<operation::AddLinePattern>(_document, linePattern));
+        }
+
+        linePatterns.push_back(linePattern);
+    }
+
+    auto linePatternAt = [&linePatterns](int32_t index) -> DxfLinePatternByValue_CSPtr {
+        if (index < 0 || static_cast<size_t>(index) >= linePatterns.size()) {
+            return nullptr;
+        }
+
+        return linePatterns[index];
+    };
+
+    // Layers
+    size_t layerCount;
+    auto layerRecords = reinterpret_cast<const LayerRecord*>(array(LAYERS, sizeof(LayerRecord), layerCount));
+    auto& layers = tables->layers;
+    for (size_t i = 0; i < layerCount; i++) {
+        const auto& record = layerRecords[i];
+        auto name = string(record.name);
+        auto layer = std::make_shared<const Layer>(
+            name,
+            MetaLineWidthByValue(record.lineWidth),
+            Color(record.color[0], record.color[1], record.color[2], record.color[3]),
+            linePatternAt(record.linePattern),
+            record.frozen != 0
+        );
+
+        auto existing = _document->layerByName(name);
+        if (existing != nullptr) {
+            _builder->append(std::make_shared<operation::ReplaceLayer>(_document, existing, layer));
+        }
+        else {
+            _builder->append(std::make_shared<operation::AddLayer>(_document, layer));
+        }
+
+        layers.push_back(layer);
+    }
+
+    // Blocks
+    size_t blockCount;
+    size_t blockParamCount;
+    auto blockRecords = reinterpret_cast<const BlockRecord*>(array(BLOCKS, sizeof(BlockRecord), blockCount));
+    auto blockParams = reinterpret_cast<const StringRef*>(array(BLOCKPARAMS, sizeof(StringRef), blockParamCount));
+    auto& blocks = tables->blocks;
+    for (size_t i = 0; i < blockCount; i++) {
+        const auto& record = blockRecords[i];
+        geo::Coordinate base(record.base[0], record.base[1], record.base[2]);
+        Block_CSPtr block;
+
+        if (record.pluginName.length > 0) {
+            if (record.firstParam > blockParamCount / 2 || record.paramCount > blockParamCount / 2 - record.firstParam / 2) {
+                return false;
+            }
+
+            std::map<std::string, std::string> params;
+            for (size_t j = 0; j < record.paramCount; j++) {
+                params[string(blockParams[record.firstParam + j * 2])] = string(blockParams[record.firstParam + j * 2 + 1]);
+            }
+
+            block = std::make_shared<CustomEntityStorage>(string(record.pluginName), string(record.entityName), base, params);
+        }
+        else {
+            block = std::make_shared<Block>(string(record.name), base);
+        }
+
+        _builder->append(std::make_shared<operation::AddBlock>(_document, block));
+        blocks.push_back(block);
+    }
+
+    // Meta info
+    size_t metaInfoCount;
+    auto metaInfoRecords = reinterpret_cast<const MetaInfoRecord*>(array(METAINFO, sizeof(MetaInfoRecord), metaInfoCount));
+    auto& metaInfos = tables->metaInfos;
+    for (size_t i = 0; i < metaInfoCount; i++) {
+        const auto& record = metaInfoRecords[i];
+        auto metaInfo = MetaInfo::create();
+
+        if (record.colorKind == 0) {
+            metaInfo->add(std::make_shared<MetaColorByValue>(record.color[0], record.color[1], record.color[2], record.color[3]));
+        }
+        else if (record.colorKind == BYBLOCK) {
+            metaInfo->add(std::make_shared<MetaColorByBlock>());
+        }
+
+        if (record.lineWidthKind == 0) {
+            metaInfo->add(std::make_shared<MetaLineWidthByValue>(record.lineWidth));
+        }
+        else if (record.lineWidthKind == BYBLOCK) {
+            metaInfo->add(std::make_shared<MetaLineWidthByBlock>());
+        }
+
+        if (record.linePattern == BYBLOCK) {
+            metaInfo->add(std::make_shared<DxfLinePatternByBlock>());
+        }
+        else if (linePatternAt(record.linePattern) != nullptr) {
+            metaInfo->add(linePatternAt(record.linePattern));
+        }
+
+        metaInfos.push_back(metaInfo);
+    }
+
+    // Entity tables
+    auto table = [&](uint32_t type, size_t intColumns, size_t doubleColumns, EntityTableView& view) {
+        auto it = sections.find(type);
+        if (it == sections.end()) {
+            return true;
+        }
+
+        const auto& section = it->second;
+        const size_t count = section.count;
+        const size_t columnCount = intColumns + doubleColumns;
+
+        if (section.columns != (intColumns << 16 | doubleColumns) || count > section.size / (3 * sizeof(int32_t))) {
+            return false;
+        }
+
+        // The columns start after the padded layer, block and meta info indices
+        const size_t headerSize = (count * 3 * sizeof(int32_t) + 7) / 8 * 8;
+        if (headerSize > section.size ||
+            (columnCount > 0 && count > (section.size - headerSize) / (columnCount * sizeof(double)))) {
+            return false;
+        }
+
+        const char* base = data + section.offset;
+        view.count = count;
+        view.layers = reinterpret_cast<const int32_t*>(base);
+        view.blocks = view.layers + count;
+        view.metaInfos = view.blocks + count;
+
+        base += headerSize;
+        for (size_t i = 0; i < intColumns; i++) {
+            view.ints.push_back(reinterpret_cast<const int64_t*>(base) + i * count);
+        }
+
+        base += intColumns * count * sizeof(int64_t);
+        for (size_t i = 0; i < doubleColumns; i++) {
+            view.doubles.push_back(reinterpret_cast<const double*>(base) + i * count);
+        }
+
+        // Check the references once, so the entities can be created without checks
+        for (size_t i = 0; i < count; i++) {
+            if (view.layers[i] < 0 || static_cast<size_t>(view.layers[i]) >= layers.size() ||
+                view.blocks[i] < NONE || view.blocks[i] >= static_cast<int32_t>(blocks.size()) ||
+                view.metaInfos[i] < NONE || view.metaInfos[i] >= static_cast<int32_t>(metaInfos.size())) {
+                return false;
+            }
+        }
+
+        return true;
+    };
+
+    auto& points = tables->points;
+    auto& lines = tables->lines;
+    auto& circles = tables->circles;
+    auto& arcs = tables->arcs;
+    auto& ellipses = tables->ellipses;
+    auto& lwPolylines = tables->lwPolylines;
+    auto& inserts = tables->inserts;
+    auto& texts = tables->texts;
+    auto& splines = tables->splines;
+    auto& dimAligned = tables->dimAligned;
+    auto& dimAngular = tables->dimAngular;
+    auto& dimDiametric = tables->dimDiametric;
+    auto& dimLinear = tables->dimLinear;
+    auto& dimRadial = tables->dimRadial;
+    auto& images = tables->images;
+    if (!table(POINTS, POINT_INTS, POINT_DOUBLES, points) ||
+        !table(LINES, LINE_INTS, LINE_DOUBLES, lines) ||
+        !table(CIRCLES, CIRCLE_INTS, CIRCLE_DOUBLES, circles) ||
+        !table(ARCS, ARC_INTS, ARC_DOUBLES, arcs) ||
+        !table(ELLIPSES, ELLIPSE_INTS, ELLIPSE_DOUBLES, ellipses) ||
+        !table(LWPOLYLINES, LWPOLYLINE_INTS, LWPOLYLINE_DOUBLES, lwPolylines) ||
+        !table(INSERTS, INSERT_INTS, INSERT_DOUBLES, inserts) ||
+        !table(TEXTS, TEXT_INTS, TEXT_DOUBLES, texts) ||
+        !table(SPLINES, SPLINE_INTS, SPLINE_DOUBLES, splines) ||
+        !table(DIMALIGNED, DIMENSION_INTS, DIMALIGNED_DOUBLES, dimAligned) ||
+        !table(DIMANGULAR, DIMENSION_INTS, DIMANGULAR_DOUBLES, dimAngular) ||
+        !table(DIMDIAMETRIC, DIMENSION_INTS, DIMDIAMETRIC_DOUBLES, dimDiametric) ||
+        !table(DIMLINEAR, DIMENSION_INTS, DIMLINEAR_DOUBLES, dimLinear) ||
+        !table(DIMRADIAL, DIMENSION_INTS, DIMRADIAL_DOUBLES, dimRadial) ||
+        !table(IMAGES, IMAGE_INTS, IMAGE_DOUBLES, images)) {
+        return false;
+    }
+
+    // Ranges of the double section used by the splines
+    auto inDoubles = [doublesCount](int64_t first, int64_t count, size_t itemSize) {
+        return first >= 0 && count >= 0 && static_cast<size_t>(first) <= doublesCount &&
+               static_cast<size_t>(count) <= (doublesCount - first) / itemSize;
+    };
+
+    for (size_t i = 0; i < splines.count; i++) {
+        if (!inDoubles(splines.ints[0][i], splines.ints[1][i], 3) ||
+            !inDoubles(splines.ints[2][i], splines.ints[3][i], 1) ||
+            !inDoubles(splines.ints[4][i], splines.ints[5][i], 3)) {
+            return false;
+        }
+    }
+
+    size_t& vertexCount = tables->vertexCount;
+    tables->vertices = reinterpret_cast<const double*>(array(LWVERTICES, 5 * sizeof(double), vertexCount));
+
+    for (size_t i = 0; i < lwPolylines.count; i++) {
+        auto first = lwPolylines.ints[0][i];
+        auto count = lwPolylines.ints[1][i];
+        if (first < 0 || count < 0 || static_cast<size_t>(first) > vertexCount || static_cast<size_t>(count) > vertexCount - first) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < inserts.count; i++) {
+        if (inserts.ints[0][i] < 0 || static_cast<size_t>(inserts.ints[0][i]) >= blocks.size()) {
+            return false;
+        }
+    }
+
+    // Shape the spatial index when the builder runs, before it inserts the entities
+    size_t layoutSize;
+    auto layout = reinterpret_cast<const uint8_t*>(array(SPATIALINDEX, sizeof(uint8_t), layoutSize));
+    if (layout != nullptr) {
+        _builder->append(std::make_shared<RestoreSpatialIndex>(_document, std::vector<uint8_t>(layout, layout + layoutSize), _spatialIndexRestored));
+    }
+
+    // The file is valid, the entities are created from the mapped tables when the builder runs
+    _builder->append(std::make_shared<MaterializeEntities>(_document, tables, _entityBuilder));
+    _builder->append(_entityBuilder);
+
+    return true;
+}
+
+bool LibreCadBinary::spatialIndexRestored() const {
+    return *_spatialIndexRestored;
+}
+
+namespace {
+    void createEntities(const EntityTables& tables, const Document_SPtr& document, operation::EntityBuilder& entityBuilder) {
+        const auto& layers = tables.layers;
+        const auto& blocks = tables.blocks;
+        const auto& metaInfos = tables.metaInfos;
+        const double* doubles = tables.doubles;
+        const double* vertexX = tables.vertices;
+        const double* vertexY = vertexX + tables.vertexCount;
+        const double* vertexBulge = vertexY + tables.vertexCount;
+        const double* vertexStartWidth = vertexBulge + tables.vertexCount;
+        const double* vertexEndWidth = vertexStartWidth + tables.vertexCount;
+
+        const auto& points = tables.points;
+        const auto& lines = tables.lines;
+        const auto& circles = tables.circles;
+        const auto& arcs = tables.arcs;
+        const auto& ellipses = tables.ellipses;
+        const auto& lwPolylines = tables.lwPolylines;
+        const auto& inserts = tables.inserts;
+        const auto& texts = tables.texts;
+        const auto& splines = tables.splines;
+        const auto& dimAligned = tables.dimAligned;
+        const auto& dimAngular = tables.dimAngular;
+        const auto& dimDiametric = tables.dimDiametric;
+        const auto& dimLinear = tables.dimLinear;
+        const auto& dimRadial = tables.dimRadial;
+        const auto& images = tables.images;
+
+        auto layerOf = [&](const EntityTableView& view, size_t i) {
+            return layers[view.layers[i]];
+        };
+        auto blockOf = [&](const EntityTableView& view, size_t i) {
+            return view.blocks[i] == NONE ? nullptr : blocks[view.blocks[i]];
+        };
+        auto metaInfoOf = [&](const EntityTableView& view, size_t i) {
+            return view.metaInfos[i] == NONE ? nullptr : metaInfos[view.metaInfos[i]];
+        };
+        auto coordinateOf = [](const EntityTableView& view, size_t column, size_t i) {
+            return geo::Coordinate(view.doubles[column][i], view.doubles[column + 1][i]);
+        };
+        auto stringOf = [&](const EntityTableView& view, size_t column, size_t i) {
+            return tables.string(StringRef{static_cast<uint64_t>(view.ints[column][i]), static_cast<uint64_t>(view.ints[column + 1][i])});
+        };
+        auto coordinatesOf = [&](int64_t first, int64_t count) {
+            std::vector<geo::Coordinate> coordinates;
+            coordinates.reserve(count);
+
+            for (int64_t i = 0; i < count; i++) {
+                const double* coordinate = doubles + first + i * 3;
+                coordinates.emplace_back(coordinate[0], coordinate[1], coordinate[2]);
+            }
+
+            return coordinates;
+        };
+
+        // Entities are created on the thread pool, the columns are used directly from the mapped file
+        auto create = [&](const EntityTableView& view, const std::function<entity::CADEntity_CSPtr(size_t)>& factory) {
+            std::vector<entity::CADEntity_CSPtr> entities(view.count);
+
+            ThreadPool::instance().parallelFor(view.count, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    entities[i] = factory(i);
+                }
+            });
+
+            for (auto& entity : entities) {
+                entityBuilder.appendEntity(std::move(entity));
+            }
+        };
+
+        create(points, [&](size_t i) {
+            return pool::makeShared<entity::Point>(
+                geo::Coordinate(points.doubles[0][i], points.doubles[1][i]),
+                layerOf(points, i), metaInfoOf(points, i), blockOf(points, i)
+            );
+        });
+
+        create(lines, [&](size_t i) {
+            return pool::makeShared<entity::Line>(
+                geo::Coordinate(lines.doubles[0][i], lines.doubles[1][i]),
+                geo::Coordinate(lines.doubles[2][i], lines.doubles[3][i]),
+                layerOf(lines, i), metaInfoOf(lines, i), blockOf(lines, i)
+            );
+        });
+
+        create(circles, [&](size_t i) {
+            return pool::makeShared<entity::Circle>(
+                geo::Coordinate(circles.doubles[0][i], circles.doubles[1][i]),
+                circles.doubles[2][i],
+                layerOf(circles, i), metaInfoOf(circles, i), blockOf(circles, i)
+            );
+        });
+
+        create(arcs, [&](size_t i) {
+            return pool::makeShared<entity::Arc>(
+                geo::Coordinate(arcs.doubles[0][i], arcs.doubles[1][i]),
+                arcs.doubles[2][i], arcs.doubles[3][i], arcs.doubles[4][i], arcs.ints[0][i] != 0,
+                layerOf(arcs, i), metaInfoOf(arcs, i), blockOf(arcs, i)
+            );
+        });
+
+        create(ellipses, [&](size_t i) {
+            return pool::makeShared<entity::Ellipse>(
+                geo::Coordinate(ellipses.doubles[0][i], ellipses.doubles[1][i]),
+                geo::Coordinate(ellipses.doubles[2][i], ellipses.doubles[3][i]),
+                ellipses.doubles[4][i], ellipses.doubles[5][i], ellipses.doubles[6][i], ellipses.ints[0][i] != 0,
+                layerOf(ellipses, i), metaInfoOf(ellipses, i), blockOf(ellipses, i)
+            );
+        });
+
+        create(lwPolylines, [&](size_t i) {
+            std::vector<entity::LWVertex2D> vertex;
+            const size_t first = lwPolylines.ints[0][i];
+            const size_t last = first + lwPolylines.ints[1][i];
+
+            vertex.reserve(last - first);
+            for (size_t j = first; j < last; j++) {
+                vertex.emplace_back(geo::Coordinate(vertexX[j], vertexY[j]), vertexBulge[j], vertexStartWidth[j], vertexEndWidth[j]);
+            }
+
+            return pool::makeShared<entity::LWPolyline>(
+                vertex,
+                lwPolylines.doubles[0][i], lwPolylines.doubles[1][i], lwPolylines.doubles[2][i],
+                lwPolylines.ints[2][i] != 0,
+                geo::Coordinate(lwPolylines.doubles[3][i], lwPolylines.doubles[4][i], lwPolylines.doubles[5][i]),
+                layerOf(lwPolylines, i), metaInfoOf(lwPolylines, i), blockOf(lwPolylines, i)
+            );
+        });
+
+        create(texts, [&](size_t i) {
+            return pool::makeShared<entity::Text>(
+                coordinateOf(texts, 0, i),
+                stringOf(texts, 0, i),
+                texts.doubles[2][i], texts.doubles[3][i],
+                stringOf(texts, 2, i),
+                static_cast<TextConst::DrawingDirection>(texts.ints[4][i]),
+                static_cast<TextConst::HAlign>(texts.ints[5][i]),
+                static_cast<TextConst::VAlign>(texts.ints[6][i]),
+                layerOf(texts, i), metaInfoOf(texts, i), blockOf(texts, i)
+            );
+        });
+
+        create(splines, [&](size_t i) {
+            return pool::makeShared<entity::Spline>(
+                coordinatesOf(splines.ints[0][i], splines.ints[1][i]),
+                std::vector<double>(doubles + splines.ints[2][i], doubles + splines.ints[2][i] + splines.ints[3][i]),
+                coordinatesOf(splines.ints[4][i], splines.ints[5][i]),
+                static_cast<int>(splines.ints[6][i]), splines.ints[7][i] != 0,
+                splines.doubles[0][i],
+                splines.doubles[1][i], splines.doubles[2][i], splines.doubles[3][i],
+                splines.doubles[4][i], splines.doubles[5][i], splines.doubles[6][i],
+                splines.doubles[7][i], splines.doubles[8][i], splines.doubles[9][i],
+                static_cast<geo::Spline::splineflag>(splines.ints[8][i]),
+                layerOf(splines, i), metaInfoOf(splines, i), blockOf(splines, i)
+            );
+        });
+
+        // Columns shared by all dimensions
+        auto attachmentPointOf = [](const EntityTableView& view, size_t i) {
+            return static_cast<TextConst::AttachmentPoint>(view.ints[0][i]);
+        };
+        auto lineSpacingStyleOf = [](const EntityTableView& view, size_t i) {
+            return static_cast<TextConst::LineSpacingStyle>(view.ints[1][i]);
+        };
+
+        create(dimAligned, [&](size_t i) {
+            return pool::makeShared<entity::DimAligned>(
+                coordinateOf(dimAligned, 0, i), coordinateOf(dimAligned, 2, i),
+                attachmentPointOf(dimAligned, i), dimAligned.doubles[4][i], dimAligned.doubles[5][i],
+                lineSpacingStyleOf(dimAligned, i), stringOf(dimAligned, 2, i),
+                coordinateOf(dimAligned, DIMENSION_DOUBLES, i), coordinateOf(dimAligned, DIMENSION_DOUBLES + 2, i),
+                layerOf(dimAligned, i), metaInfoOf(dimAligned, i), blockOf(dimAligned, i)
+            );
+        });
+
+        create(dimAngular, [&](size_t i) {
+            return pool::makeShared<entity::DimAngular>(
+                coordinateOf(dimAngular, 0, i), coordinateOf(dimAngular, 2, i),
+                attachmentPointOf(dimAngular, i), dimAngular.doubles[4][i], dimAngular.doubles[5][i],
+                lineSpacingStyleOf(dimAngular, i), stringOf(dimAngular, 2, i),
+                coordinateOf(dimAngular, DIMENSION_DOUBLES, i), coordinateOf(dimAngular, DIMENSION_DOUBLES + 2, i),
+                coordinateOf(dimAngular, DIMENSION_DOUBLES + 4, i), coordinateOf(dimAngular, DIMENSION_DOUBLES + 6, i),
+                layerOf(dimAngular, i), metaInfoOf(dimAngular, i), blockOf(dimAngular, i)
+            );
+        });
+
+        create(dimDiametric, [&](size_t i) {
+            return pool::makeShared<entity::DimDiametric>(
+                coordinateOf(dimDiametric, 0, i), coordinateOf(dimDiametric, 2, i),
+                attachmentPointOf(dimDiametric, i), dimDiametric.doubles[4][i], dimDiametric.doubles[5][i],
+                lineSpacingStyleOf(dimDiametric, i), stringOf(dimDiametric, 2, i),
+                coordinateOf(dimDiametric, DIMENSION_DOUBLES, i), dimDiametric.doubles[DIMENSION_DOUBLES + 2][i],
+                layerOf(dimDiametric, i), metaInfoOf(dimDiametric, i), blockOf(dimDiametric, i)
+            );
+        });
+
+        create(dimLinear, [&](size_t i) {
+            return pool::makeShared<entity::DimLinear>(
+                coordinateOf(dimLinear, 0, i), coordinateOf(dimLinear, 2, i),
+                attachmentPointOf(dimLinear, i), dimLinear.doubles[4][i], dimLinear.doubles[5][i],
+                lineSpacingStyleOf(dimLinear, i), stringOf(dimLinear, 2, i),
+                coordinateOf(dimLinear, DIMENSION_DOUBLES, i), coordinateOf(dimLinear, DIMENSION_DOUBLES + 2, i),
+                dimLinear.doubles[DIMENSION_DOUBLES + 4][i], dimLinear.doubles[DIMENSION_DOUBLES + 5][i],
+                layerOf(dimLinear, i), metaInfoOf(dimLinear, i), blockOf(dimLinear, i)
+            );
+        });
+
+        create(dimRadial, [&](size_t i) {
+            return pool::makeShared<entity::DimRadial>(
+                coordinateOf(dimRadial, 0, i), coordinateOf(dimRadial, 2, i),
+                attachmentPointOf(dimRadial, i), dimRadial.doubles[4][i], dimRadial.doubles[5][i],
+                lineSpacingStyleOf(dimRadial, i), stringOf(dimRadial, 2, i),
+                coordinateOf(dimRadial, DIMENSION_DOUBLES, i), dimRadial.doubles[DIMENSION_DOUBLES + 2][i],
+                layerOf(dimRadial, i), metaInfoOf(dimRadial, i), blockOf(dimRadial, i)
+            );
+        });
+
+        create(images, [&](size_t i) {
+            return pool::makeShared<entity::Image>(
+                stringOf(images, 0, i),
+                coordinateOf(images, 0, i), coordinateOf(images, 2, i), coordinateOf(images, 4, i),
+                images.doubles[6][i], images.doubles[7][i],
+                images.doubles[8][i], images.doubles[9][i], images.doubles[10][i],
+                layerOf(images, i), metaInfoOf(images, i), blockOf(images, i)
+            );
+        });
+
+        // Inserts read the block extents of the document, they are created on this thread
+        for (size_t i = 0; i < inserts.count; i++) {
+            builder::InsertBuilder insertBuilder;
+            insertBuilder.setDocument(document);
+            insertBuilder.setDisplayBlock(blocks[inserts.ints[0][i]]);
+            insertBuilder.setCoordinate(geo::Coordinate(inserts.doubles[0][i], inserts.doubles[1][i], inserts.doubles[2][i]));
+            insertBuilder.setLayer(layerOf(inserts, i));
+            insertBuilder.setMetaInfo(metaInfoOf(inserts, i));
+            insertBuilder.setBlock(blockOf(inserts, i));
+            entityBuilder.appendEntity(insertBuilder.build());
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cad/document/document.h>
+#include <cad/operations/entitybuilder.h>
+#include <cad/operations/builder.h>
+
+namespace lc {
+    namespace FileLibs {
+        /**
+         * Native LibreCAD binary format
+         *
+         * The file starts with a fixed header, followed by sections and a section table describing
+         * the type, position and number of items of each section. Unknown sections are skipped, so sections
+         * can be added without changing the version.
+         * Values are little endian and each section starts at a multiple of 8 bytes, the arrays are used
+         * directly from the memory mapped file without parsing.
+         *
+         * Entities are stored per type as columns (structure of arrays). Layers, line patterns, blocks and
+         * entity meta info are stored once and referenced by index. The shape of the spatial index is stored
+         * so it can be restored before the entities are inserted.
+         */
+        class LibreCadBinary {
+            public:
+                static const uint32_t VERSION = 1;
+
+                /**
+                 * @param document Document to open to or save from
+                 * @param builder Builder used to open a file, not needed to save
+                 */
+                LibreCadBinary(Document_SPtr document, lc::operation::Builder_SPtr builder = nullptr);
+
+                /**
+                 * Open a file
+                 * Layers, line patterns and blocks are appended to the builder. The whole file is checked here,
+                 * the entities are only created from the mapped file when the builder runs.
+                 * The spatial index layout is restored by the builder, before it inserts the entities.
+                 * @param file File to open
+                 * @return false if the file is not a LibreCAD binary file, uses a unsupported version or no builder is given
+                 */
+                bool open(const std::string& file);
+
+                /**
+                 * Save the document
+                 * @param file File to write
+                 * @return false if the file could not be written or a entity could not be stored
+                 */
+                bool save(const std::string& file);
+
+                /**
+                 * @return true if the builder of open() restored the stored spatial index layout,
+                 * false before it ran or when the document was not empty
+                 */
+                bool spatialIndexRestored() const;
+
+            private:
+                Document_SPtr _document;
+                operation::Builder_SPtr _builder;
+                operation::EntityBuilder_SPtr _entityBuilder;
+                std::shared_ptr<bool> _spatialIndexRestored;
+        };
+    }
+}
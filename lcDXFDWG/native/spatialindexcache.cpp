@@ -0,0 +1,115 @@
+#include "spatialindexcache.h"
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+using namespace lc;
+using namespace lc::FileLibs;
+
+namespace {
+    const char MAGIC[8] = {'L', 'C', 'A', 'D', 'I', 'D', 'X', '\0'};
+
+    struct CacheHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t hash;
+        uint64_t layoutSize;
+        uint64_t placementSize;
+    };
+}
+
+SpatialIndexCache::SpatialIndexCache(const std::string& drawing) :
+    _drawing(drawing),
+    _hash(contentHash(drawing)) {
+}
+
+std::string SpatialIndexCache::cachePath(const std::string& drawing) {
+    return drawing + ".lcidx";
+}
+
+uint64_t SpatialIndexCache::contentHash(const std::string& file) {
+    std::ifstream stream(file, std::ios::binary);
+    if (!stream) {
+        return 0;
+    }
+
+    uint64_t hash = 14695981039346656037ull;
+    std::vector<char> buffer(1 << 20);
+
+    while (stream) {
+        stream.read(buffer.data(), buffer.size());
+
+        const auto count = stream.gcount();
+        for (std::streamsize i = 0; i < count; i++) {
+            hash ^= static_cast<uint8_t>(buffer[i]);
+            hash *= 1099511628211ull;
+        }
+    }
+
+    return hash;
+}
+
+bool SpatialIndexCache::restore(Document_SPtr document) const {
+    if (_hash == 0) {
+        return false;
+    }
+
+    std::ifstream stream(cachePath(_drawing), std::ios::binary | std::ios::ate);
+    if (!stream) {
+        return false;
+    }
+
+    const uint64_t size = stream.tellg();
+    stream.seekg(0);
+
+    CacheHeader header;
+    if (size < sizeof(header) || !stream.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        return false;
+    }
+
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION || header.hash != _hash) {
+        return false;
+    }
+
+    const uint64_t available = size - sizeof(header);
+    if (header.layoutSize > available || header.placementSize > (available - header.layoutSize) / sizeof(uint32_t)) {
+        return false;
+    }
+
+    std::vector<uint8_t> layout(header.layoutSize);
+    std::vector<uint32_t> placement(header.placementSize);
+    stream.read(reinterpret_cast<char*>(layout.data()), layout.size());
+    stream.read(reinterpret_cast<char*>(placement.data()), placement.size() * sizeof(uint32_t));
+
+    if (!stream) {
+        return false;
+    }
+
+    return document->restoreSpatialIndexLayout(layout, placement);
+}
+
+bool SpatialIndexCache::save(Document_SPtr document) const {
+    if (_hash == 0) {
+        return false;
+    }
+
+    auto layout = document->spatialIndexLayout();
+    auto placement = document->spatialIndexPlacement();
+
+    CacheHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.reserved = 0;
+    header.hash = _hash;
+    header.layoutSize = layout.size();
+    header.placementSize = placement.size();
+
+    std::ofstream stream(cachePath(_drawing), std::ios::binary | std::ios::trunc);
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    stream.write(reinterpret_cast<const char*>(layout.data()), layout.size());
+    stream.write(reinterpret_cast<const char*>(placement.data()), placement.size() * sizeof(uint32_t));
+
+    return stream.good();
+}
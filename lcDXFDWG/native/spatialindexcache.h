@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <cad/document/document.h>
+
+namespace lc {
+    namespace FileLibs {
+        /**
+         * Spatial index sidecar file
+         *
+         * Stores the layout of the document spatial index and the node of each entity next to a drawing,
+         * together with a hash of the drawing. When the drawing didn't change, the index is restored before the
+         * entities are inserted, so entities go directly to their node and no node is split while opening.
+         * The file is ignored when the hash doesn't match, the index is then built while inserting the entities.
+         * It is a local cache and uses the byte order of the machine.
+         */
+        class SpatialIndexCache {
+            public:
+                static const uint32_t VERSION = 1;
+
+                /**
+                 * @param drawing Path of the drawing, its content is hashed
+                 */
+                explicit SpatialIndexCache(const std::string& drawing);
+
+                /**
+                 * @return path of the sidecar file of a drawing
+                 */
+                static std::string cachePath(const std::string& drawing);
+
+                /**
+                 * @brief 64 bit FNV-1a hash of a file content
+                 * @return hash, 0 if the file can't be read
+                 */
+                static uint64_t contentHash(const std::string& file);
+
+                /**
+                 * @brief Restore the spatial index of a empty document
+                 * Call it before the entities of the drawing are inserted.
+                 * @return false if there is no sidecar file, it doesn't match the drawing or the document isn't empty
+                 */
+                bool restore(Document_SPtr document) const;
+
+                /**
+                 * @brief Store the spatial index of a document
+                 * Call it after opening the drawing, the placement depends on the order the entities were created.
+                 * @return false if the file could not be written
+                 */
+                bool save(Document_SPtr document) const;
+
+            private:
+                std::string _drawing;
+                uint64_t _hash;
+        };
+    }
+}
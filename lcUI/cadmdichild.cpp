@@ -79,6 +79,8 @@ void CadMdiChild::newDocument() {
     _document = std::make_shared<lc::DocumentImpl>(_storageManager);
 
     // Add the document to a LibreCAD Viewer system so we can visualize the document
+    // Thin lines are drawn directly in the image, everything else by Cairo
+    _viewer->setHairlinePainter(true);
     _viewer->setDocument(_document);
 
     _gradientBackground = std::make_shared<GradientBackground>(lc::Color(0x07, 0x15, 0x11), lc::Color(0x06, 0x35, 0x06));
@@ -129,7 +131,10 @@ bool CadMdiChild::openFile() {
     if(availableLibraries.size() > 0) {
         //TODO: if more than once, ask which one to choose
         newDocument();
-        lc::File::open(_document, file.toStdString(), availableLibraries.begin()->first);
+        if(!lc::File::open(_document, file.toStdString(), availableLibraries.begin()->first)) {
+            QMessageBox::critical(nullptr, "Open error", "Cannot read " + file);
+            return false;
+        }
     }
     else {
         QMessageBox::critical(nullptr, "Open error", "Unknown file extension ." + fileInfo.suffix());
@@ -174,7 +179,9 @@ void CadMdiChild::saveFile() {
         }
     }
 
-    lc::File::save(_document, file.toStdString(), type);
+    if(!lc::File::save(_document, file.toStdString(), type)) {
+        QMessageBox::critical(nullptr, "Save error", "Cannot write " + file);
+    }
 }
 
 void CadMdiChild::ctxMenu(const QPoint& pos) {
@@ -223,7 +230,8 @@ LCViewer::TempEntities_SPtr CadMdiChild::tempEntities() {
 }
 
 std::vector<lc::entity::CADEntity_SPtr> CadMdiChild::selection() {
-    return viewer()->documentCanvas()->selection().asVector();
+    auto drawItems = viewer()->documentCanvas()->selectedDrawItems();
+    return std::vector<lc::entity::CADEntity_SPtr>(drawItems.begin(), drawItems.end());
 }
 
 lc::Layer_CSPtr CadMdiChild::activeLayer() const {
@@ -15,7 +15,7 @@
 using namespace LCViewer;
 
 LCADViewer::LCADViewer(QWidget *parent) :
-    QWidget(parent), _docCanvas(nullptr), _mouseScrollKeyActive(false), _operationActive(false), _scale(1.0), _zoomMin(0.05), _zoomMax(20.0), _scaleLineWidth(false) {
+    QWidget(parent), _docCanvas(nullptr), _mouseScrollKeyActive(false), _operationActive(false), _scale(1.0), _zoomMin(0.05), _zoomMax(20.0), _scaleLineWidth(false), _hairlinePainter(false) {
 
     setMouseTracking(true);
     this->_altKeyActive = false;
@@ -38,7 +38,14 @@ void LCADViewer::setDocument(std::shared_ptr<lc::Document> document) {
     _docCanvas->createPainterFunctor(
     [this](const unsigned int width, const unsigned int height) {
         QImage *m_image = new QImage(width, height, QImage::Format_ARGB32);
-        LcPainter* lcPainter = createCairoImagePainter(m_image->bits(), width, height);
+        LcPainter* lcPainter;
+        if (_hairlinePainter) {
+            lcPainter = createHairlineImagePainter(m_image->bits(), width, height);
+        }
+        else {
+            lcPainter = createCairoImagePainter(m_image->bits(), width, height);
+        }
+
         imagemaps.insert(std::make_pair(lcPainter, m_image));
         return lcPainter;
     });
@@ -233,6 +240,10 @@ std::shared_ptr<DocumentCanvas> LCADViewer::documentCanvas() const {
     return _docCanvas;
 }
 
+void LCADViewer::setHairlinePainter(bool hairlinePainter) {
+    _hairlinePainter = hairlinePainter;
+}
+
 void LCADViewer::setOperationActive(bool operationActive) {
     _operationActive = operationActive;
 
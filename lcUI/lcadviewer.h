@@ -73,6 +73,12 @@ class LCADViewer : public QWidget {
 
         void setOperationActive(bool operationActive);
 
+        /**
+         * @brief Draw thin lines with the hairline painter instead of Cairo
+         * Only painters created afterwards are affected, call it before setDocument()
+         */
+        void setHairlinePainter(bool hairlinePainter);
+
     protected:
         void paintEvent(QPaintEvent*);
         virtual void mousePressEvent(QMouseEvent* event);
@@ -118,6 +124,9 @@ class LCADViewer : public QWidget {
         // When set to true, the line width on screen will scale with the zoom factor
         bool _scaleLineWidth;
 
+        // When set to true, painters are created with createHairlineImagePainter()
+        bool _hairlinePainter;
+
         //
         QPoint startSelectPos;
 
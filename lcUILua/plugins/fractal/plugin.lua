@@ -50,7 +50,9 @@ function FractalTree:onEvent(eventName, data)
         local eb = EntityBuilder(active_widget():document())
         b:append(eb)
 
-        createFractalTree(eb, data:x(), data:y(), self.angle, self.depth, active_layer(), active_metaInfo(), block)
+        local coordinates = {}
+        createFractalTree(coordinates, data:x(), data:y(), self.angle, self.depth)
+        eb:appendLines(coordinates, active_layer(), active_metaInfo(), block)
 
         local insertBuilder = InsertBuilder()
         insertBuilder:setLayer(active_layer())
@@ -65,15 +67,21 @@ function FractalTree:onEvent(eventName, data)
     end
 end
 
-function createFractalTree(b, x1, y1, angle, depth, layer, metaInfo, block)
+-- Add the branches to coordinates, 4 values per line for EntityBuilder:appendLines
+function createFractalTree(coordinates, x1, y1, angle, depth)
     if depth == 0 then  return end;
 
     local x2 = x1 +  (math.cos(math.rad(angle)) * depth * 10.0);
     local y2 = y1 + (math.sin(math.rad(angle)) * depth * 10.0);
 
-    b:appendEntity(Line(Coord(x1, y1), Coord(x2, y2), layer, metaInfo, block));
-    createFractalTree(b, x2, y2, angle - 20, depth - 1, layer, metaInfo, block);
-    createFractalTree(b, x2, y2, angle + 20, depth - 1, layer, metaInfo, block);
+    local n = #coordinates
+    coordinates[n + 1] = x1
+    coordinates[n + 2] = y1
+    coordinates[n + 3] = x2
+    coordinates[n + 4] = y2
+
+    createFractalTree(coordinates, x2, y2, angle - 20, depth - 1);
+    createFractalTree(coordinates, x2, y2, angle + 20, depth - 1);
 end
 
 function FractalTree:close()
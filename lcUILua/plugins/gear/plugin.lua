@@ -85,12 +85,11 @@ function Gear:point_on_circle(radius, angle)
     return p
 end
 
---ce CreateEntities object
 --phi = pressure angle
 --PC = Circular Pitch
 --teeth = no of teeth
-function Gear:calc(N, phi, Pc, layer, metaInfo, block)
-    local entities = {}
+--Returns the lines of the outline, 4 values per line for EntityBuilder:appendLines
+function Gear:calc(N, phi, Pc)
 
     -- Pitch Circle
     local D = N * Pc / math.pi
@@ -180,16 +179,18 @@ function Gear:calc(N, phi, Pc, layer, metaInfo, block)
             table.insert(points, r2)
         end
     end
-    local first = points[1]
-    local fKeep = first
-    table.remove(points, 1)
-    for k,v in pairs(points) do
-        table.insert(entities, Line(Coord(first.x,first.y), Coord(v.x,v.y), layer, metaInfo, block))
-        first=v
+    local coordinates = {}
+    local first = points[#points]
+    for k,v in ipairs(points) do
+        local n = #coordinates
+        coordinates[n + 1] = first.x
+        coordinates[n + 2] = first.y
+        coordinates[n + 3] = v.x
+        coordinates[n + 4] = v.y
+        first = v
     end
-    table.insert(entities, Line(Coord(first.x,first.y), Coord(fKeep.x,fKeep.y), layer, metaInfo, block))
 
-    return entities
+    return coordinates
 end
 
 function Gear:drawGear()
@@ -197,16 +198,13 @@ function Gear:drawGear()
     local metaInfo = active_metaInfo()
     local block = Block("Gear_" .. math.random(9999999999), Coordinate(0, 0, 0)) --TODO: get proper ID
 
-    local entities = Gear:calc(self.n, math.rad(self.phi), math.rad(self.pc), layer, metaInfo, block)
+    local coordinates = Gear:calc(self.n, math.rad(self.phi), math.rad(self.pc))
 
     local b = Builder(active_widget():document(), "Gear")
     b:append(AddBlock(active_widget():document(), block))
 
     local eb = EntityBuilder(active_widget():document())
-
-    for k, v in pairs(entities) do
-        eb:appendEntity(v)
-    end
+    eb:appendLines(coordinates, layer, metaInfo, block)
 
     local insertBuilder = InsertBuilder()
     insertBuilder:setLayer(layer)
@@ -247,11 +245,13 @@ function Gear:tempGear(point)
         active_widget():tempEntities():removeEntity(v)
     end
 
-    self.entities = self:calc(n, math.rad(phi), math.rad(pc), active_layer(), active_metaInfo())
-
-    for k, v in pairs(self.entities) do
-        v = v:move(origin):scale(origin, scalePoint)
-        active_widget():tempEntities():addEntity(v)
+    self.entities = {}
+    local coordinates = self:calc(n, math.rad(phi), math.rad(pc))
+    for i = 1, #coordinates, 4 do
+        local line = Line(Coord(coordinates[i], coordinates[i + 1]), Coord(coordinates[i + 2], coordinates[i + 3]), active_layer(), active_metaInfo())
+        line = line:move(origin):scale(origin, scalePoint)
+        table.insert(self.entities, line)
+        active_widget():tempEntities():addEntity(line)
     end
 end
 
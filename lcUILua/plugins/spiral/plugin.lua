@@ -68,10 +68,10 @@ function Spiral:point_on_circle(radius, angle)
     return p
 end
 
-function Spiral:calc(N, R, layer, metaInfo, block)
+-- Half circles of the spiral, 5 values per arc for EntityBuilder:appendArcs
+function Spiral:calc(N, R)
 	local points = {}
-	local arcCenter
-    local entities = {}
+    local values = {}
 	local half = true
 	local kR = (R / (2 * math.pi)) / N
 	
@@ -79,18 +79,23 @@ function Spiral:calc(N, R, layer, metaInfo, block)
 		table.insert(points, self:point_on_circle(kR*i, i))
 	end
 	
-    for k,v in pairs(points) do
+    for k,v in ipairs(points) do
 		half = not half
-		if(half) then			
-			arcCenter = Coordinate(math.pi * kR, 0)
-			table.insert(entities, Arc(arcCenter, math.abs(v.y), 0, math.pi, false, layer, metaInfo, block))
-		else		
-			arcCenter = Coordinate(0, 0)
-			table.insert(entities, Arc(arcCenter, math.abs(v.y), math.pi, math.pi*2, false, layer, metaInfo, block))
+        local n = #values
+		if(half) then
+			values[n + 1] = math.pi * kR
+			values[n + 4] = 0
+			values[n + 5] = math.pi
+		else
+			values[n + 1] = 0
+			values[n + 4] = math.pi
+			values[n + 5] = math.pi * 2
 		end
+		values[n + 2] = 0
+		values[n + 3] = math.abs(v.y)
     end
 
-    return entities
+    return values
 end
 
 function Spiral:drawSpiral()
@@ -98,15 +103,13 @@ function Spiral:drawSpiral()
     local metaInfo = active_metaInfo()
     local block = Block("Spiral_" .. math.random(9999999999), Coordinate(0, 0, 0)) --TODO: get proper ID
 
-    local entities = self:calc(self.n, self.R, layer, metaInfo, block)
+    local values = self:calc(self.n, self.R)
 
-    local b = Builder(active_widget():document(), "Star")
+    local b = Builder(active_widget():document(), "Spiral")
     b:append(AddBlock(active_widget():document(), block))
 
     local eb = EntityBuilder(active_widget():document())
-    for k, v in pairs(entities) do
-        eb:appendEntity(v)
-    end
+    eb:appendArcs(values, false, layer, metaInfo, block)
 
     local insertBuilder = InsertBuilder()
     insertBuilder:setLayer(layer)
@@ -130,11 +133,13 @@ function Spiral:tempSpiral(point)
         active_widget():tempEntities():removeEntity(v)
     end
 
-    self.entities = self:calc(n, R, active_layer(), active_metaInfo())
-
-    for k, v in pairs(self.entities) do
-        v = v:move(origin)
-        active_widget():tempEntities():addEntity(v)
+    self.entities = {}
+    local values = self:calc(n, R)
+    for i = 1, #values, 5 do
+        local arc = Arc(Coordinate(values[i], values[i + 1]), values[i + 2], values[i + 3], values[i + 4], false, active_layer(), active_metaInfo())
+        arc = arc:move(origin)
+        table.insert(self.entities, arc)
+        active_widget():tempEntities():addEntity(arc)
     end
 end
 
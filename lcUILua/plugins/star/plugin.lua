@@ -71,38 +71,39 @@ function Star:point_on_circle(radius, angle)
     return p
 end
 
-function Star:calc(N, innerR, outerR, layer, metaInfo, block)
+-- Lines of the star, 4 values per line for EntityBuilder:appendLines
+function Star:calc(N, innerR, outerR)
 	local points = {}
-    local entities = {}
 	for i=1,N do
 		table.insert(points, self:point_on_circle(outerR, ((i * 360) / N)))
 		table.insert(points, self:point_on_circle(innerR, ((i * 360) / N) + (180 / N)))
 	end
-	
-    local first = points[1]
-	local fKeep = points[1]
-    for k,v in pairs(points) do
-        table.insert(entities, Line(Coord(first.x, first.y), Coord(v.x, v.y), layer, metaInfo, block))
-        first=v
+
+    local coordinates = {}
+    local first = points[#points]
+    for k,v in ipairs(points) do
+        local n = #coordinates
+        coordinates[n + 1] = first.x
+        coordinates[n + 2] = first.y
+        coordinates[n + 3] = v.x
+        coordinates[n + 4] = v.y
+        first = v
     end
-    table.insert(entities, Line(Coord(first.x,first.y), Coord(fKeep.x,fKeep.y), layer, metaInfo, block))
 
-    return entities
+    return coordinates
 end
 
 function Star:drawStar()
     local layer = active_layer()
     local metaInfo = active_metaInfo()
     local block = Block("Star_" .. math.random(9999999999), Coordinate(0, 0, 0)) --TODO: get proper ID
-    local entities = self:calc(self.n, self.innerR, self.outerR, layer, metaInfo, block)
+    local coordinates = self:calc(self.n, self.innerR, self.outerR)
 
     local b = Builder(active_widget():document(), "Star")
     b:append(AddBlock(active_widget():document(), block))
 
     local eb = EntityBuilder(active_widget():document())
-    for k, v in pairs(entities) do
-        eb:appendEntity(v)
-    end
+    eb:appendLines(coordinates, layer, metaInfo, block)
 
     local insertBuilder = InsertBuilder()
     insertBuilder:setLayer(layer)
@@ -145,11 +146,13 @@ function Star:tempStar(point)
         active_widget():tempEntities():removeEntity(v)
     end
 
-    self.entities = self:calc(n, innerR, outerR, active_layer(), active_metaInfo())
-
-    for k, v in pairs(self.entities) do
-        v = v:move(origin)
-        active_widget():tempEntities():addEntity(v)
+    self.entities = {}
+    local coordinates = self:calc(n, innerR, outerR)
+    for i = 1, #coordinates, 4 do
+        local line = Line(Coord(coordinates[i], coordinates[i + 1]), Coord(coordinates[i + 2], coordinates[i + 3]), active_layer(), active_metaInfo())
+        line = line:move(origin)
+        table.insert(self.entities, line)
+        active_widget():tempEntities():addEntity(line)
     end
 end
 
@@ -52,6 +52,25 @@ function text(text)
     luaInterface:triggerEvent('text', text:toStdString())
 end
 
+--Start the Lua profiler, or stop it and show the slowest functions
+--The stacks are written to lua_profile.folded, which can be opened with flamegraph.pl or speedscope
+local function toggle_profiler()
+    if(profiler:running()) then
+        profiler:stop()
+        message(profiler:report())
+
+        if(profiler:writeFoldedStacks("lua_profile.folded")) then
+            message("Profile written to lua_profile.folded")
+        else
+            message("Cannot write lua_profile.folded")
+        end
+    else
+        profiler:reset()
+        profiler:start()
+        message("Profiler started, run PROFILE again to stop it")
+    end
+end
+
 --Create the command line and add it to the main window
 function add_commandline()
     cliCommand = lc.CliCommand(mainWindow)
@@ -82,5 +101,7 @@ function add_commandline()
     add_command("REMOVE", remove_selected_entities)
     add_command("TRIM", trim_entity)
 
+    add_command("PROFILE", toggle_profiler)
+
     luaInterface:registerEvent('point', setLastPoint)
 end
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include <cad/meta/layer.h>
 #include <cad/meta/metacolor.h>
 #include <cad/base/metainfo.h>
+#include <cad/base/instrumentation.h>
+#include <cad/dochelpers/memoryusage.h>
 #include <cad/geometry/geocoordinate.h>
 #include <cad/geometry/geovector.h>
 #include <cad/document/undomanager.h>
@@ -23,9 +25,68 @@
 using namespace LuaIntf;
 using namespace lc;
 
+namespace {
+    /**
+     * Timers and counters of the instrumentation, for lc.stats()
+     * Timers have the fields calls, total, mean, min and max in milliseconds, counters have the field count.
+     */
+    std::map<std::string, std::map<std::string, double>> instrumentationStatistics() {
+        std::map<std::string, std::map<std::string, double>> statistics;
+        const double ms = 1e-6;
+
+        for (const auto& timer : instrumentation::Instrumentation::instance().timers()) {
+            statistics[timer.name] = {
+                {"calls", static_cast<double>(timer.calls)},
+                {"total", timer.total * ms},
+                {"mean", timer.total * ms / timer.calls},
+                {"min", timer.min * ms},
+                {"max", timer.max * ms}
+            };
+        }
+
+        for (const auto& counter : instrumentation::Instrumentation::instance().counters()) {
+            statistics[counter.first] = {
+                {"count", static_cast<double>(counter.second)}
+            };
+        }
+
+        return statistics;
+    }
+
+    /**
+     * Categories of a memory report, for document:memoryUsage() and undoManager:memoryUsage()
+     * Each category has the fields bytes and count.
+     */
+    std::map<std::string, std::map<std::string, double>> memoryUsageTable(const MemoryUsage& usage) {
+        std::map<std::string, std::map<std::string, double>> table;
+
+        for (const auto& category : usage.categories()) {
+            table[category.first] = {
+                {"bytes", static_cast<double>(category.second.bytes)},
+                {"count", static_cast<double>(category.second.count)}
+            };
+        }
+
+        return table;
+    }
+}
 
 
 void LCLua::importLCKernel() {
+    // The instrumentation is shared by all documents of the process
+    LuaBinding(_L)
+        .beginModule("lc")
+            .addFunction("stats", []() {
+                return instrumentationStatistics();
+            })
+            .addFunction("resetStats", []() {
+                instrumentation::Instrumentation::instance().reset();
+            })
+            .addFunction("enableStats", [](bool enabled) {
+                instrumentation::Instrumentation::instance().setEnabled(enabled);
+            })
+        .endModule();
+
     LuaBinding(_L)
         .beginClass<Color>("Color")
             .addConstructor(LUA_ARGS(
@@ -141,6 +202,9 @@ void LCLua::importLCKernel() {
             .addFunction("entitiesByLayer", &Document::entitiesByLayer)
             .addFunction("waitingCustomEntities", &Document::waitingCustomEntities)
             .addFunction("entitiesByBlock", &Document::entitiesByBlock)
+            .addFunction("memoryUsage", [](Document* document) {
+                return memoryUsageTable(document->memoryUsage());
+            })
         .endClass()
 
         .beginExtendClass<DocumentImpl, Document>("DocumentImpl")
@@ -152,6 +216,9 @@ void LCLua::importLCKernel() {
             .addFunction("redo", &UndoManager::redo)
             .addFunction("removeUndoables", &UndoManager::removeUndoables)
             .addFunction("undo", &UndoManager::undo)
+            .addFunction("memoryUsage", [](UndoManager* undoManager) {
+                return memoryUsageTable(undoManager->memoryUsage());
+            })
         .endClass()
 
         .beginExtendClass<UndoManagerImpl, UndoManager>("UndoManagerImpl")
@@ -400,6 +467,26 @@ void LCLua::importLCKernel() {
                     std::shared_ptr<lc::Document>
             ))
             .addFunction("appendEntity", &operation::EntityBuilder::appendEntity)
+            // Bulk creation, the values are converted in a single call instead of one object per entity
+            .addFunction("appendLines", &operation::EntityBuilder::appendLines, LUA_ARGS(
+                       const std::vector<double>&,
+                       const Layer_CSPtr,
+                       LuaIntf::_opt<const MetaInfo_CSPtr>,
+                       LuaIntf::_opt<const Block_CSPtr>
+            ))
+            .addFunction("appendCircles", &operation::EntityBuilder::appendCircles, LUA_ARGS(
+                       const std::vector<double>&,
+                       const Layer_CSPtr,
+                       LuaIntf::_opt<const MetaInfo_CSPtr>,
+                       LuaIntf::_opt<const Block_CSPtr>
+            ))
+            .addFunction("appendArcs", &operation::EntityBuilder::appendArcs, LUA_ARGS(
+                       const std::vector<double>&,
+                       bool,
+                       const Layer_CSPtr,
+                       LuaIntf::_opt<const MetaInfo_CSPtr>,
+                       LuaIntf::_opt<const Block_CSPtr>
+            ))
             .addFunction("appendOperation", &operation::EntityBuilder::appendOperation)
             .addFunction("processStack", &operation::EntityBuilder::processStack)
         .endClass()
@@ -49,6 +49,24 @@ void LCLua::addLuaLibs() {
             })
         .endClass();
 
+    //Profiler, shared with Lua as the global profiler
+    _profiler = std::make_shared<LuaProfiler>(_L);
+    LuaBinding(_L)
+        .beginClass<LuaProfiler>("LuaProfiler")
+            .addFunction("start", &LuaProfiler::start)
+            .addFunction("stop", &LuaProfiler::stop)
+            .addFunction("running", &LuaProfiler::running)
+            .addFunction("reset", &LuaProfiler::reset)
+            .addFunction("report", [](LuaProfiler* profiler) {
+                return profiler->report();
+            })
+            .addFunction("writeFoldedStacks", [](LuaProfiler* profiler, const std::string& path) {
+                return profiler->writeFoldedStacks(path);
+            })
+        .endClass();
+
+    LuaIntf::Lua::setGlobal(_L, "profiler", _profiler);
+
     if(_f_openFileDialog == nullptr) {
         LuaBinding(_L).addFunction("openFileDialog", []() {
             return (FILE*) nullptr;
@@ -75,6 +93,10 @@ std::string LCLua::runString(const char* code) {
     return out;
 }
 
+std::shared_ptr<LuaProfiler> LCLua::profiler() {
+    return _profiler;
+}
+
 FILE* LCLua::openFile(const char* path, const char* mode) {
     //TODO: check if the file can be opened
 
@@ -8,6 +8,7 @@ extern "C" {
 
 #include "lua-intf/LuaIntf/LuaIntf.h"
 #include <cad/document/document.h>
+#include "utils/luaprofiler.h"
 
 namespace LuaIntf {
     LUA_USING_SHARED_PTR_TYPE(std::shared_ptr)
@@ -30,6 +31,12 @@ namespace lc {
             void setDocument(lc::Document_SPtr document);
             std::string runString(const char* code);
 
+            /**
+             * @brief Profiler of the Lua state, created by addLuaLibs() and available in Lua as profiler
+             * @return profiler, nullptr when addLuaLibs() was not called
+             */
+            std::shared_ptr<LuaProfiler> profiler();
+
             void setF_openFileDialog(FILE* (* f_openFileDialog)(bool, const char*, const char*));
 
             static FILE* openFile(const char* path, const char* mode);
@@ -39,5 +46,6 @@ namespace lc {
         private:
             lua_State* _L;
             FILE* (*_f_openFileDialog)(bool, const char*, const char*);
+            std::shared_ptr<LuaProfiler> _profiler;
     };
 }
\ No newline at end of file
@@ -22,12 +22,24 @@ void lc::LuaCustomEntityManager::onNewWaitingEntity(const lc::NewWaitingCustomEn
         return;
     }
 
-    auto it = _plugins.find(ces->pluginName());
-    if(it == _plugins.end()) {
-        return;
+    LuaIntf::LuaRef onNewWaitingEntityFunction;
+    {
+        std::lock_guard<std::mutex> lock(_pluginsMutex);
+
+        auto plugins = _plugins.find(std::this_thread::get_id());
+        if(plugins == _plugins.end()) {
+            return;
+        }
+
+        auto it = plugins->second.find(ces->pluginName());
+        if(it == plugins->second.end()) {
+            return;
+        }
+
+        onNewWaitingEntityFunction = it->second;
     }
 
-    it->second(event.insert());
+    onNewWaitingEntityFunction(event.insert());
 }
 
 void lc::LuaCustomEntityManager::registerPlugin(const std::string& name, LuaIntf::LuaRef onNewWaitingEntityFunction) {
@@ -35,7 +47,10 @@ void lc::LuaCustomEntityManager::registerPlugin(const std::string& name, LuaIntf
         return;
     }
 
-    _plugins[name] = onNewWaitingEntityFunction;
+    {
+        std::lock_guard<std::mutex> lock(_pluginsMutex);
+        _plugins[std::this_thread::get_id()][name] = onNewWaitingEntityFunction;
+    }
 
     for(auto entity : DocumentList::getInstance().waitingCustomEntities(name)) {
         onNewWaitingEntityFunction(entity);
@@ -43,5 +58,6 @@ void lc::LuaCustomEntityManager::registerPlugin(const std::string& name, LuaIntf
 }
 
 void lc::LuaCustomEntityManager::removePlugins() {
-    _plugins.clear();
+    std::lock_guard<std::mutex> lock(_pluginsMutex);
+    _plugins.erase(std::this_thread::get_id());
 }
\ No newline at end of file
@@ -1,8 +1,15 @@
 #pragma once
 
 #include <lclua.h>
+#include <mutex>
+#include <thread>
 
 namespace lc {
+    /**
+     * @brief Forward the custom entities waiting for a plugin to the Lua function handling them
+     * Plugins are registered per thread, each thread running its own Lua state. A entity is given to
+     * the plugins registered by the thread which added it to its document.
+     */
     class LuaCustomEntityManager {
         public:
             static LuaCustomEntityManager& getInstance() {
@@ -24,7 +31,7 @@ namespace lc {
             void registerPlugin(const std::string& name, LuaIntf::LuaRef onNewWaitingEntityFunction);
 
             /**
-             * @brief Remove all registered plugins
+             * @brief Remove all plugins registered by the calling thread
              * This should be called before the Lua instance get deleted
              */
             void removePlugins();
@@ -33,6 +40,8 @@ namespace lc {
             LuaCustomEntityManager();
 
             void onNewWaitingEntity(const lc::NewWaitingCustomEntityEvent& event);
-            std::map<std::string, LuaIntf::LuaRef> _plugins;
+
+            std::mutex _pluginsMutex;
+            std::map<std::thread::id, std::map<std::string, LuaIntf::LuaRef>> _plugins;
     };
 }
\ No newline at end of file
@@ -0,0 +1,375 @@
+#include "luaprofiler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using namespace lc;
+
+namespace {
+    // Address used as key of the profiler in the registry of the Lua state
+    char registryKey;
+
+    // Folded stacks use ';' between the frames
+    std::string frameName(std::string name) {
+        std::replace(name.begin(), name.end(), ';', ',');
+        std::replace(name.begin(), name.end(), '\n', ' ');
+        return name;
+    }
+}
+
+LuaProfiler::LuaProfiler(lua_State* L) :
+    _L(L),
+    _running(false),
+    _current(nullptr) {
+
+    reset();
+
+    lua_pushlightuserdata(_L, this);
+    lua_rawsetp(_L, LUA_REGISTRYINDEX, &registryKey);
+}
+
+LuaProfiler::~LuaProfiler() {
+    stop();
+
+    lua_rawgetp(_L, LUA_REGISTRYINDEX, &registryKey);
+    const bool registered = lua_touserdata(_L, -1) == this;
+    lua_pop(_L, 1);
+
+    if (registered) {
+        lua_pushnil(_L);
+        lua_rawsetp(_L, LUA_REGISTRYINDEX, &registryKey);
+    }
+}
+
+void LuaProfiler::start() {
+    if (_running) {
+        return;
+    }
+
+    _running = true;
+    _current = nullptr;
+    _frames.clear();
+    _last = Clock::now();
+
+    lua_sethook(_L, &LuaProfiler::hook, LUA_MASKCALL | LUA_MASKRET, 0);
+}
+
+void LuaProfiler::stop() {
+    if (!_running) {
+        return;
+    }
+
+    addElapsed(_current);
+    _running = false;
+    _frames.clear();
+
+    // Coroutines keep their copy of the hook, it removes itself on the next event
+    lua_sethook(_L, nullptr, 0, 0);
+}
+
+bool LuaProfiler::running() const {
+    return _running;
+}
+
+void LuaProfiler::reset() {
+    _functions.clear();
+    _luaFunctions.clear();
+    _luaClosures.clear();
+    _nativeFunctions.clear();
+    _children.clear();
+    _frames.clear();
+
+    _nodes.clear();
+    _nodes.push_back(Node {0, 0, 0, 0});
+
+    _current = nullptr;
+    _last = Clock::now();
+}
+
+void LuaProfiler::hook(lua_State* L, lua_Debug* ar) {
+    lua_rawgetp(L, LUA_REGISTRYINDEX, &registryKey);
+    auto profiler = static_cast<LuaProfiler*>(lua_touserdata(L, -1));
+    lua_pop(L, 1);
+
+    if (profiler == nullptr || !profiler->_running) {
+        lua_sethook(L, nullptr, 0, 0);
+        return;
+    }
+
+    switch (ar->event) {
+        case LUA_HOOKCALL:
+            profiler->onCall(L, ar, false);
+            break;
+
+#ifdef LUA_HOOKTAILCALL
+        case LUA_HOOKTAILCALL:
+            profiler->onCall(L, ar, true);
+            break;
+#endif
+
+        case LUA_HOOKRET:
+            profiler->onReturn(L, ar);
+            break;
+
+#ifdef LUA_HOOKTAILRET
+        // Lua 5.1 reports the frames replaced by tail calls when the last one returns
+        case LUA_HOOKTAILRET: {
+            profiler->addElapsed(profiler->_current);
+            auto& stack = profiler->frames(L);
+            if (!stack.empty()) {
+                stack.pop_back();
+            }
+            profiler->removeEmptyFrames(L);
+            break;
+        }
+#endif
+
+        default:
+            break;
+    }
+
+    // Time spent in the hook is not given to the profiled functions
+    profiler->_current = L;
+    profiler->_last = Clock::now();
+}
+
+void LuaProfiler::onCall(lua_State* L, lua_Debug* ar, bool tailCall) {
+    addElapsed(_current);
+
+    auto& stack = frames(L);
+    if (tailCall && !stack.empty()) {
+        stack.pop_back();
+    }
+
+    const void* closure;
+    const size_t parent = stack.empty() ? 0 : stack.back().node;
+    const size_t node = child(parent, function(L, ar, closure));
+    _nodes[node].calls++;
+
+    stack.push_back(Frame {node, closure});
+}
+
+void LuaProfiler::onReturn(lua_State* L, lua_Debug* ar) {
+    addElapsed(_current);
+
+    lua_getinfo(L, "f", ar);
+    const void* closure = lua_topointer(L, -1);
+    lua_pop(L, 1);
+
+    // Errors unwind frames without return events, they are above the returning function (usually pcall).
+    // A function which was called before the profiler started has no frame.
+    auto& stack = frames(L);
+    for (size_t i = stack.size(); i > 0; i--) {
+        if (stack[i - 1].function == closure) {
+            stack.resize(i - 1);
+            break;
+        }
+    }
+
+    removeEmptyFrames(L);
+}
+
+void LuaProfiler::addElapsed(lua_State* L) {
+    const auto now = Clock::now();
+    const uint64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - _last).count();
+    _last = now;
+
+    if (L == nullptr) {
+        return;
+    }
+
+    // A coroutine without stack runs code called before the profiler started
+    auto it = _frames.find(L);
+    _nodes[it == _frames.end() || it->second.empty() ? 0 : it->second.back().node].selfTime += elapsed;
+}
+
+size_t LuaProfiler::function(lua_State* L, lua_Debug* ar, const void*& closure) {
+    // The name is only needed for new functions, "n" is requested then
+    lua_getinfo(L, "Sf", ar);
+    closure = lua_topointer(L, -1);
+    lua_pop(L, 1);
+
+    const bool native = std::strcmp(ar->what, "C") == 0;
+
+    // Bindings share the same C function, the closure with its upvalues identifies the bound method.
+    // A Lua closure can be collected and its address reused, the line where the function is defined is compared too.
+    auto& closures = native ? _nativeFunctions : _luaClosures;
+    auto it = closures.find(closure);
+    if (it != closures.end() && (native || _functions[it->second].lineDefined == ar->linedefined)) {
+        return it->second;
+    }
+
+    size_t id = _functions.size();
+    lua_getinfo(L, "n", ar);
+
+    if (native) {
+        _functions.push_back(Function {
+            frameName(std::string(ar->name != nullptr ? ar->name : "?") + " [C]"), true, ar->linedefined
+        });
+    }
+    else {
+        // Closures created in a loop are the same function
+        auto key = std::string(ar->short_src) + ":" + std::to_string(ar->linedefined);
+
+        auto function = _luaFunctions.find(key);
+        if (function != _luaFunctions.end()) {
+            id = function->second;
+        }
+        else {
+            std::ostringstream name;
+            if (std::strcmp(ar->what, "main") == 0) {
+                name << "main chunk (" << ar->short_src << ")";
+            }
+            else {
+                name << (ar->name != nullptr ? ar->name : "?") << " (" << ar->short_src << ":" << ar->linedefined << ")";
+            }
+
+            _luaFunctions.emplace(std::move(key), id);
+            _functions.push_back(Function {frameName(name.str()), false, ar->linedefined});
+        }
+    }
+
+    closures[closure] = id;
+
+    return id;
+}
+
+size_t LuaProfiler::child(size_t parent, size_t function) {
+    const uint64_t key = (static_cast<uint64_t>(parent) << 32) | function;
+
+    auto it = _children.find(key);
+    if (it != _children.end()) {
+        return it->second;
+    }
+
+    const size_t node = _nodes.size();
+    _nodes.push_back(Node {parent, function, 0, 0});
+    _children.emplace(key, node);
+
+    return node;
+}
+
+std::vector<LuaProfiler::Frame>& LuaProfiler::frames(lua_State* L) {
+    return _frames[L];
+}
+
+void LuaProfiler::removeEmptyFrames(lua_State* L) {
+    auto it = _frames.find(L);
+    if (it != _frames.end() && it->second.empty()) {
+        _frames.erase(it);
+    }
+}
+
+std::vector<LuaProfiler::FunctionStatistics> LuaProfiler::functions() const {
+    std::vector<FunctionStatistics> result;
+    result.reserve(_functions.size());
+
+    for (const auto& function : _functions) {
+        result.push_back(FunctionStatistics {function.name, function.native, 0, 0});
+    }
+
+    // The root node has no function
+    for (size_t i = 1; i < _nodes.size(); i++) {
+        auto& statistics = result[_nodes[i].function];
+        statistics.calls += _nodes[i].calls;
+        statistics.selfTime += _nodes[i].selfTime;
+    }
+
+    std::stable_sort(result.begin(), result.end(), [](const FunctionStatistics& a, const FunctionStatistics& b) {
+        return a.selfTime > b.selfTime;
+    });
+
+    return result;
+}
+
+std::vector<LuaProfiler::FunctionStatistics> LuaProfiler::bindings() const {
+    auto result = functions();
+
+    result.erase(std::remove_if(result.begin(), result.end(), [](const FunctionStatistics& statistics) {
+        return !statistics.native;
+    }), result.end());
+
+    std::stable_sort(result.begin(), result.end(), [](const FunctionStatistics& a, const FunctionStatistics& b) {
+        return a.calls > b.calls;
+    });
+
+    return result;
+}
+
+void LuaProfiler::writeFoldedStacks(std::ostream& stream) const {
+    std::vector<const std::string*> path;
+
+    for (size_t i = 1; i < _nodes.size(); i++) {
+        const uint64_t microseconds = _nodes[i].selfTime / 1000;
+        if (microseconds == 0) {
+            continue;
+        }
+
+        path.clear();
+        for (size_t node = i; node != 0; node = _nodes[node].parent) {
+            path.push_back(&_functions[_nodes[node].function].name);
+        }
+
+        for (auto it = path.rbegin(); it != path.rend(); ++it) {
+            if (it != path.rbegin()) {
+                stream << ';';
+            }
+            stream << **it;
+        }
+
+        stream << ' ' << microseconds << '\n';
+    }
+}
+
+bool LuaProfiler::writeFoldedStacks(const std::string& path) const {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+
+    writeFoldedStacks(file);
+    return static_cast<bool>(file);
+}
+
+void LuaProfiler::writeReport(std::ostream& stream, size_t limit) const {
+    const auto flags = stream.flags();
+    const auto precision = stream.precision();
+
+    auto functionStatistics = functions();
+    functionStatistics.resize(std::min(limit, functionStatistics.size()));
+
+    stream << std::left << std::setw(60) << "function" << std::right
+           << std::setw(12) << "calls"
+           << std::setw(14) << "self ms" << std::endl;
+
+    stream << std::fixed << std::setprecision(3);
+    for (const auto& statistics : functionStatistics) {
+        stream << std::left << std::setw(60) << statistics.name << std::right
+               << std::setw(12) << statistics.calls
+               << std::setw(14) << statistics.selfTime / 1e6 << std::endl;
+    }
+
+    auto bindingStatistics = bindings();
+    bindingStatistics.resize(std::min(limit, bindingStatistics.size()));
+
+    stream << std::endl
+           << std::left << std::setw(60) << "binding" << std::right
+           << std::setw(12) << "calls" << std::endl;
+
+    for (const auto& statistics : bindingStatistics) {
+        stream << std::left << std::setw(60) << statistics.name << std::right
+               << std::setw(12) << statistics.calls << std::endl;
+    }
+
+    stream.flags(flags);
+    stream.precision(precision);
+}
+
+std::string LuaProfiler::report(size_t limit) const {
+    std::ostringstream stream;
+    writeReport(stream, limit);
+    return stream.str();
+}
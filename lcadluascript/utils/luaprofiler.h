@@ -0,0 +1,151 @@
+#pragma once
+
+extern "C" {
+    #include "lua.h"
+}
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lc {
+    /**
+     * @brief Profiler of the Lua code running in a Lua state
+     * A debug hook follows each call and return, the time between two events is given to the function on top
+     * of the stack. Functions called from Lua which are implemented in C++, like the LuaIntf bindings of the
+     * kernel, are profiled the same way and their number of calls is reported separately.
+     *
+     * The call tree can be written as folded stacks, one line per stack with the time in microseconds,
+     * which is the input of flamegraph.pl and speedscope.
+     *
+     * The hook makes each call slower, compare the times of a profile with each other and not with a run
+     * without profiler.
+     */
+    class LuaProfiler {
+        public:
+            struct FunctionStatistics {
+                // Function name and location, for example "create_line (actions/line.lua:12)" or "appendEntity [C]"
+                std::string name;
+                bool native;
+                uint64_t calls;
+                // Nanoseconds spent in the function itself, without the functions it called
+                uint64_t selfTime;
+            };
+
+            explicit LuaProfiler(lua_State* L);
+            ~LuaProfiler();
+
+            LuaProfiler(const LuaProfiler&) = delete;
+            LuaProfiler& operator = (const LuaProfiler&) = delete;
+
+            /**
+             * @brief Install the hook, coroutines created afterwards are profiled too
+             */
+            void start();
+
+            /**
+             * @brief Remove the hook, collected data is kept
+             */
+            void stop();
+
+            bool running() const;
+
+            /**
+             * @brief Remove the collected data
+             */
+            void reset();
+
+            /**
+             * @return functions sorted by self time, the longest first
+             */
+            std::vector<FunctionStatistics> functions() const;
+
+            /**
+             * @return C++ functions sorted by number of calls, the most called first
+             */
+            std::vector<FunctionStatistics> bindings() const;
+
+            /**
+             * @brief Write the call tree as folded stacks, for flame graphs
+             */
+            void writeFoldedStacks(std::ostream& stream) const;
+            bool writeFoldedStacks(const std::string& path) const;
+
+            /**
+             * @brief Write the functions and bindings as tables
+             * @param limit maximum number of lines of each table
+             */
+            void writeReport(std::ostream& stream, size_t limit = 20) const;
+            std::string report(size_t limit = 20) const;
+
+        private:
+            using Clock = std::chrono::steady_clock;
+
+            struct Function {
+                std::string name;
+                bool native;
+                int lineDefined;
+            };
+
+            // Node of the call tree, the root has no function
+            struct Node {
+                size_t parent;
+                size_t function;
+                uint64_t calls;
+                uint64_t selfTime;
+            };
+
+            struct Frame {
+                size_t node;
+                // Called closure, a return pops the frames above it which were left by errors
+                const void* function;
+            };
+
+            static void hook(lua_State* L, lua_Debug* ar);
+
+            /**
+             * @param tailCall the function replaces the one on top of the stack
+             */
+            void onCall(lua_State* L, lua_Debug* ar, bool tailCall);
+            void onReturn(lua_State* L, lua_Debug* ar);
+
+            /**
+             * @brief Give the time since the last event to the function on top of the stack which was running
+             */
+            void addElapsed(lua_State* L);
+
+            /**
+             * @param closure set to the called closure
+             * @return index of the function in _functions
+             */
+            size_t function(lua_State* L, lua_Debug* ar, const void*& closure);
+            size_t child(size_t parent, size_t function);
+            std::vector<Frame>& frames(lua_State* L);
+
+            /**
+             * @brief Forget the stack of a coroutine which returned from all its functions
+             */
+            void removeEmptyFrames(lua_State* L);
+
+            lua_State* _L;
+            bool _running;
+
+            std::vector<Function> _functions;
+            // Lua functions by "short_src:linedefined", only used the first time a closure is called
+            std::unordered_map<std::string, size_t> _luaFunctions;
+            std::unordered_map<const void*, size_t> _luaClosures;
+            std::unordered_map<const void*, size_t> _nativeFunctions;
+
+            std::vector<Node> _nodes;
+            std::unordered_map<uint64_t, size_t> _children;
+
+            // Stack of each coroutine, its size is the call depth since the profiler started.
+            // Coroutines are removed when their stack is empty, so finished coroutines don't accumulate.
+            std::unordered_map<lua_State*, std::vector<Frame>> _frames;
+            lua_State* _current;
+            Clock::time_point _last;
+    };
+}
@@ -14,6 +14,29 @@ namespace lc {
         class CADEntityBuilder;
     }
     namespace entity {
+        /**
+         * Type of a entity, used to select a implementation without trying casts
+         */
+        enum class EntityKind {
+            Point,
+            Line,
+            Circle,
+            Arc,
+            Ellipse,
+            Text,
+            Spline,
+            DimAligned,
+            DimAngular,
+            DimDiametric,
+            DimLinear,
+            DimRadial,
+            LWPolyline,
+            Image,
+            Insert,
+            CustomEntity,
+            Other
+        };
+
         /**
          *Class that all CAD entities must inherit
          *
@@ -128,6 +151,14 @@ namespace lc {
 
             virtual void dispatch(EntityDispatch &) const = 0;
 
+            /**
+             * @brief Return the type of this entity
+             * @return EntityKind::Other for entities which are not part of the kernel
+             */
+            virtual EntityKind kind() const {
+                return EntityKind::Other;
+            }
+
             /**
              * @brief Return the current entity block
              * @return Entity block or nullptr if not defined
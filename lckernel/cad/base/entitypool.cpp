@@ -0,0 +1,322 @@
+#include "entitypool.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+
+using namespace lc;
+using namespace lc::pool;
+
+namespace {
+    const size_t SlabSize = 64 * 1024;
+    const size_t NumberOfPools = FixedSizePool::MaxBlockSize / FixedSizePool::Alignment;
+
+    size_t roundUp(size_t size) {
+        return (size + FixedSizePool::Alignment - 1) / FixedSizePool::Alignment * FixedSizePool::Alignment;
+    }
+
+    using Pools = std::array<FixedSizePool*, NumberOfPools>;
+
+    Pools& pools() {
+        // Never destroyed, entities held in static objects can still be released after main()
+        static Pools* pools = []() {
+            auto pools = new Pools();
+
+            for (size_t i = 0; i < NumberOfPools; i++) {
+                auto blockSize = (i + 1) * FixedSizePool::Alignment;
+                (*pools)[i] = new FixedSizePool(blockSize, SlabSize / blockSize);
+            }
+
+            return pools;
+        }();
+
+        return *pools;
+    }
+
+    std::atomic<size_t> nextPoolId(0);
+
+    // Guards the cache lists of the pools and the pool of each cache.
+    // Lock order: registry mutex, cache mutex, pool mutex.
+    std::mutex& registryMutex() {
+        static std::mutex* mutex = new std::mutex();
+        return *mutex;
+    }
+
+    // Set when the caches of the thread were destroyed, blocks released later go straight to the pool
+    thread_local bool threadCachesDestroyed = false;
+}
+
+namespace lc {
+    namespace pool {
+        /**
+         * Caches of the current thread, indexed by pool ID
+         */
+        struct ThreadCaches {
+            std::vector<std::unique_ptr<FixedSizePool::ThreadCache>> caches;
+
+            ~ThreadCaches() {
+                std::lock_guard<std::mutex> registryLock(registryMutex());
+
+                for (auto& cache : caches) {
+                    if (cache == nullptr || cache->pool == nullptr) {
+                        continue;
+                    }
+
+                    auto pool = cache->pool;
+                    std::lock_guard<std::mutex> cacheLock(cache->mutex);
+                    pool->flush(*cache, 0);
+                    pool->_caches.erase(std::find(pool->_caches.begin(), pool->_caches.end(), cache.get()));
+                }
+
+                threadCachesDestroyed = true;
+            }
+        };
+    }
+}
+
+const size_t FixedSizePool::MaxBlockSize;
+const size_t FixedSizePool::Alignment;
+const size_t FixedSizePool::CacheBatch;
+
+FixedSizePool::FixedSizePool(size_t blockSize, size_t blocksPerSlab) :
+    _id(nextPoolId++),
+    _blockSize(roundUp(std::max(blockSize, sizeof(FreeBlock)))),
+    _blocksPerSlab(std::max<size_t>(1, blocksPerSlab)),
+    _blocksOut(0),
+    _freeList(nullptr) {
+}
+
+FixedSizePool::~FixedSizePool() {
+    std::lock_guard<std::mutex> registryLock(registryMutex());
+
+    // The caches stay with their threads, IDs are not reused so they are never used again
+    for (auto cache : _caches) {
+        std::lock_guard<std::mutex> cacheLock(cache->mutex);
+        cache->pool = nullptr;
+        cache->freeList = nullptr;
+        cache->count = 0;
+    }
+}
+
+FixedSizePool::ThreadCache* FixedSizePool::threadCache() {
+    if (threadCachesDestroyed) {
+        return nullptr;
+    }
+
+    thread_local ThreadCaches threadCaches;
+    auto& caches = threadCaches.caches;
+
+    if (_id < caches.size() && caches[_id] != nullptr) {
+        return caches[_id].get();
+    }
+
+    if (_id >= caches.size()) {
+        caches.resize(_id + 1);
+    }
+
+    caches[_id].reset(new ThreadCache());
+    auto cache = caches[_id].get();
+    cache->pool = this;
+    cache->freeList = nullptr;
+    cache->count = 0;
+
+    std::lock_guard<std::mutex> registryLock(registryMutex());
+    _caches.push_back(cache);
+
+    return cache;
+}
+
+void* FixedSizePool::allocate() {
+    auto cache = threadCache();
+
+    if (cache == nullptr) {
+        std::lock_guard<std::mutex> lck(_mutex);
+
+        if (_freeList == nullptr) {
+            addSlab();
+        }
+
+        auto block = _freeList;
+        _freeList = block->next;
+        _blocksOut++;
+        return block;
+    }
+
+    // Only contended when releaseUnused() runs
+    std::lock_guard<std::mutex> cacheLock(cache->mutex);
+
+    if (cache->freeList == nullptr) {
+        refill(*cache);
+    }
+
+    auto block = cache->freeList;
+    cache->freeList = block->next;
+    cache->count--;
+
+    return block;
+}
+
+void FixedSizePool::deallocate(void* block) {
+    auto freeBlock = static_cast<FreeBlock*>(block);
+    auto cache = threadCache();
+
+    if (cache == nullptr) {
+        std::lock_guard<std::mutex> lck(_mutex);
+        freeBlock->next = _freeList;
+        _freeList = freeBlock;
+        _blocksOut--;
+        return;
+    }
+
+    std::lock_guard<std::mutex> cacheLock(cache->mutex);
+
+    freeBlock->next = cache->freeList;
+    cache->freeList = freeBlock;
+    cache->count++;
+
+    if (cache->count > 2 * CacheBatch) {
+        flush(*cache, CacheBatch);
+    }
+}
+
+void FixedSizePool::refill(ThreadCache& cache) {
+    std::lock_guard<std::mutex> lck(_mutex);
+
+    if (_freeList == nullptr) {
+        addSlab();
+    }
+
+    while (_freeList != nullptr && cache.count < CacheBatch) {
+        auto block = _freeList;
+        _freeList = block->next;
+        block->next = cache.freeList;
+        cache.freeList = block;
+        cache.count++;
+        _blocksOut++;
+    }
+}
+
+void FixedSizePool::flush(ThreadCache& cache, size_t keep) {
+    std::lock_guard<std::mutex> lck(_mutex);
+
+    while (cache.count > keep) {
+        auto block = cache.freeList;
+        cache.freeList = block->next;
+        cache.count--;
+        block->next = _freeList;
+        _freeList = block;
+        _blocksOut--;
+    }
+}
+
+bool FixedSizePool::releaseUnused() {
+    std::lock_guard<std::mutex> registryLock(registryMutex());
+
+    std::vector<std::unique_lock<std::mutex>> cacheLocks;
+    for (auto cache : _caches) {
+        cacheLocks.emplace_back(cache->mutex);
+        flush(*cache, 0);
+    }
+
+    std::lock_guard<std::mutex> lck(_mutex);
+
+    // Count the free blocks of each slab, slabs sorted by address to find the slab of a block
+    std::sort(_slabs.begin(), _slabs.end(), [](const std::unique_ptr<char[]>& a, const std::unique_ptr<char[]>& b) {
+        return std::less<char*>()(a.get(), b.get());
+    });
+
+    auto slabOf = [this](FreeBlock* block) {
+        auto address = reinterpret_cast<char*>(block);
+        auto it = std::upper_bound(_slabs.begin(), _slabs.end(), address, [](char* a, const std::unique_ptr<char[]>& slab) {
+            return std::less<char*>()(a, slab.get());
+        });
+        return static_cast<size_t>(it - _slabs.begin()) - 1;
+    };
+
+    std::vector<size_t> freeBlocks(_slabs.size(), 0);
+    for (auto block = _freeList; block != nullptr; block = block->next) {
+        freeBlocks[slabOf(block)]++;
+    }
+
+    if (std::find(freeBlocks.begin(), freeBlocks.end(), _blocksPerSlab) == freeBlocks.end()) {
+        return false;
+    }
+
+    // Keep the free blocks of the slabs still in use
+    FreeBlock* freeList = nullptr;
+    for (auto block = _freeList; block != nullptr;) {
+        auto next = block->next;
+
+        if (freeBlocks[slabOf(block)] != _blocksPerSlab) {
+            block->next = freeList;
+            freeList = block;
+        }
+
+        block = next;
+    }
+    _freeList = freeList;
+
+    std::vector<std::unique_ptr<char[]>> slabs;
+    for (size_t i = 0; i < _slabs.size(); i++) {
+        if (freeBlocks[i] != _blocksPerSlab) {
+            slabs.push_back(std::move(_slabs[i]));
+        }
+    }
+    _slabs = std::move(slabs);
+
+    return true;
+}
+
+size_t FixedSizePool::blockSize() const {
+    return _blockSize;
+}
+
+size_t FixedSizePool::blocksInUse() const {
+    std::lock_guard<std::mutex> registryLock(registryMutex());
+
+    size_t cached = 0;
+    for (auto cache : _caches) {
+        std::lock_guard<std::mutex> cacheLock(cache->mutex);
+        cached += cache->count;
+    }
+
+    std::lock_guard<std::mutex> lck(_mutex);
+    return _blocksOut - cached;
+}
+
+size_t FixedSizePool::bytesReserved() const {
+    std::lock_guard<std::mutex> lck(_mutex);
+    return _slabs.size() * _blocksPerSlab * _blockSize;
+}
+
+void FixedSizePool::addSlab() {
+    // new char[] returns memory aligned for any fundamental type
+    std::unique_ptr<char[]> slab(new char[_blocksPerSlab * _blockSize]);
+
+    for (size_t i = _blocksPerSlab; i > 0; i--) {
+        auto block = reinterpret_cast<FreeBlock*>(slab.get() + (i - 1) * _blockSize);
+        block->next = _freeList;
+        _freeList = block;
+    }
+
+    _slabs.push_back(std::move(slab));
+}
+
+FixedSizePool& FixedSizePool::forSize(size_t size) {
+    return *pools()[roundUp(std::max<size_t>(1, size)) / Alignment - 1];
+}
+
+size_t FixedSizePool::allocationSize(size_t size) {
+    if (size > MaxBlockSize) {
+        return size;
+    }
+
+    return forSize(size).blockSize();
+}
+
+void FixedSizePool::releaseAllUnused() {
+    for (auto& pool : pools()) {
+        pool->releaseUnused();
+    }
+}
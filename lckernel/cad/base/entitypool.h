@@ -0,0 +1,207 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace lc {
+    namespace pool {
+        /**
+         * @brief The FixedSizePool class
+         * Slab allocator for blocks of a single size.
+         * Memory is taken from the system in large slabs and recycled through a free list,
+         * this avoids fragmenting the heap when millions of entities are created and destroyed.
+         *
+         * Each thread keeps a small free list per pool, allocate() and deallocate() only lock the pool
+         * to move a batch of blocks between that list and the pool. Threads creating entities at the same time,
+         * like the parallel EntityOps transforms, don't serialize on every block.
+         * The blocks cached by a thread go back to the pool when the thread exits.
+         */
+        class FixedSizePool {
+            public:
+                FixedSizePool(size_t blockSize, size_t blocksPerSlab);
+
+                ~FixedSizePool();
+
+                FixedSizePool(const FixedSizePool&) = delete;
+                FixedSizePool& operator = (const FixedSizePool&) = delete;
+
+                void* allocate();
+                void deallocate(void* block);
+
+                /**
+                 * @brief Give the slabs without any block in use back to the system
+                 * The blocks cached by the threads are returned to the pool first.
+                 * @return true if at least one slab was released
+                 */
+                bool releaseUnused();
+
+                size_t blockSize() const;
+
+                /**
+                 * @brief Number of blocks currently handed out, without the blocks cached by the threads
+                 */
+                size_t blocksInUse() const;
+
+                /**
+                 * @brief Number of bytes reserved from the system
+                 */
+                size_t bytesReserved() const;
+
+                /**
+                 * @brief Return the shared pool for the given block size
+                 * Sizes are rounded up so types of nearly the same size share a pool.
+                 */
+                static FixedSizePool& forSize(size_t size);
+
+                /**
+                 * @brief Bytes taken by an allocation of size bytes with PoolAllocator
+                 * Pooled sizes are rounded up to the block size of their pool.
+                 */
+                static size_t allocationSize(size_t size);
+
+                /**
+                 * @brief Call releaseUnused() on all shared pools
+                 */
+                static void releaseAllUnused();
+
+                /**
+                 * @brief Pools bigger than this are not used, the default allocator is used instead
+                 */
+                static const size_t MaxBlockSize = 1024;
+                static const size_t Alignment = alignof(std::max_align_t);
+
+                /**
+                 * @brief Number of blocks moved at once between the pool and a thread cache
+                 */
+                static const size_t CacheBatch = 32;
+
+            private:
+                struct FreeBlock {
+                    FreeBlock* next;
+                };
+
+                struct ThreadCache {
+                    std::mutex mutex;
+                    FixedSizePool* pool;
+                    FreeBlock* freeList;
+                    size_t count;
+                };
+
+                friend struct ThreadCaches;
+
+                /**
+                 * @return cache of the current thread, nullptr once the thread is exiting
+                 */
+                ThreadCache* threadCache();
+
+                /**
+                 * @brief Move up to CacheBatch blocks from the pool to the cache
+                 * Must be called with the cache mutex locked.
+                 */
+                void refill(ThreadCache& cache);
+
+                /**
+                 * @brief Move all but keep blocks from the cache to the pool
+                 * Must be called with the cache mutex locked.
+                 */
+                void flush(ThreadCache& cache, size_t keep);
+
+                void addSlab();
+
+                size_t _id;
+                size_t _blockSize;
+                size_t _blocksPerSlab;
+                // Blocks handed out by the pool, including the blocks in the thread caches
+                size_t _blocksOut;
+                FreeBlock* _freeList;
+                std::vector<std::unique_ptr<char[]>> _slabs;
+                // Caches of the threads which used this pool, guarded by the registry mutex
+                std::vector<ThreadCache*> _caches;
+                mutable std::mutex _mutex;
+        };
+
+        /**
+         * @brief Allocator using the shared FixedSizePool of sizeof(T)
+         * Only single objects are pooled, arrays go to the default allocator.
+         */
+        template<typename T>
+        class PoolAllocator {
+            public:
+                using value_type = T;
+
+                PoolAllocator() = default;
+
+                template<typename U>
+                PoolAllocator(const PoolAllocator<U>&) {
+                }
+
+                T* allocate(size_t n) {
+                    if (n == 1 && sizeof(T) <= FixedSizePool::MaxBlockSize && alignof(T) <= FixedSizePool::Alignment) {
+                        return static_cast<T*>(FixedSizePool::forSize(sizeof(T)).allocate());
+                    }
+
+                    return static_cast<T*>(::operator new(n * sizeof(T)));
+                }
+
+                void deallocate(T* p, size_t n) {
+                    if (n == 1 && sizeof(T) <= FixedSizePool::MaxBlockSize && alignof(T) <= FixedSizePool::Alignment) {
+                        FixedSizePool::forSize(sizeof(T)).deallocate(p);
+                        return;
+                    }
+
+                    ::operator delete(p);
+                }
+
+                template<typename U>
+                bool operator == (const PoolAllocator<U>&) const {
+                    return true;
+                }
+
+                template<typename U>
+                bool operator != (const PoolAllocator<U>&) const {
+                    return false;
+                }
+        };
+
+        /**
+         * @brief Pooled replacement of std::make_shared
+         * The object and the shared_ptr control block are stored in one pooled block.
+         * Example: auto line = lc::pool::makeShared<lc::entity::Line>(start, end, layer);
+         */
+        template<typename T, typename... Args>
+        std::shared_ptr<T> makeShared(Args&&... args) {
+            return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Pooled shared_ptr for types with a non public constructor
+         * construct gets the memory and must return the object created with placement new in it.
+         * The object and the control block are two separate pooled blocks, the object exists before the shared_ptr.
+         * This allows builders to keep using protected constructors.
+         * Example: lc::pool::constructShared<Line>([this](void* memory) { return new (memory) Line(*this); });
+         */
+        template<typename T, typename Construct>
+        std::shared_ptr<T> constructShared(Construct construct) {
+            PoolAllocator<T> allocator;
+            T* memory = allocator.allocate(1);
+            T* object;
+
+            try {
+                object = construct(static_cast<void*>(memory));
+            }
+            catch (...) {
+                allocator.deallocate(memory, 1);
+                throw;
+            }
+
+            return std::shared_ptr<T>(object, [](T* p) {
+                p->~T();
+                PoolAllocator<T>().deallocate(p, 1);
+            }, allocator);
+        }
+    }
+}
@@ -0,0 +1,252 @@
+#include "instrumentation.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <unordered_map>
+
+using namespace lc::instrumentation;
+
+namespace {
+    struct Timer {
+        uint64_t calls;
+        uint64_t total;
+        uint64_t min;
+        uint64_t max;
+    };
+
+    struct TraceEvent {
+        const char* name;
+        // Microseconds since the creation of the instrumentation
+        double start;
+        double duration;
+    };
+
+    void writeJsonString(std::ostream& stream, const std::string& value) {
+        stream << '"';
+        for (auto c : value) {
+            if (c == '"' || c == '\\') {
+                stream << '\\';
+            }
+            stream << c;
+        }
+        stream << '"';
+    }
+}
+
+struct Instrumentation::ThreadData {
+    unsigned int id;
+    std::mutex mutex;
+    std::unordered_map<const char*, Timer> timers;
+    std::unordered_map<const char*, int64_t> counters;
+    std::vector<TraceEvent> events;
+};
+
+const size_t Instrumentation::DEFAULT_MAX_TRACE_EVENTS;
+std::atomic<bool> Instrumentation::_enabled(false);
+
+Instrumentation::Instrumentation() :
+    _tracing(false),
+    _traceEvents(0),
+    _maxTraceEvents(DEFAULT_MAX_TRACE_EVENTS),
+    _epoch(Clock::now()) {
+}
+
+Instrumentation& Instrumentation::instance() {
+    static Instrumentation instrumentation;
+    return instrumentation;
+}
+
+void Instrumentation::setEnabled(bool enabled) {
+    _enabled = enabled;
+}
+
+void Instrumentation::setTracing(bool tracing, size_t maxEvents) {
+    _maxTraceEvents = maxEvents;
+    _tracing = tracing;
+    if (tracing) {
+        setEnabled(true);
+    }
+}
+
+bool Instrumentation::tracing() const {
+    return _tracing;
+}
+
+Instrumentation::ThreadData& Instrumentation::threadData() {
+    thread_local std::shared_ptr<ThreadData> data;
+
+    if (data == nullptr) {
+        data = std::make_shared<ThreadData>();
+
+        // Kept after the end of the thread, its times are still part of the statistics
+        std::lock_guard<std::mutex> lock(_mutex);
+        data->id = static_cast<unsigned int>(_threads.size()) + 1;
+        _threads.push_back(data);
+    }
+
+    return *data;
+}
+
+void Instrumentation::addTime(const char* name, Clock::time_point start, Clock::time_point end) {
+    auto& data = threadData();
+    const uint64_t duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+    std::lock_guard<std::mutex> lock(data.mutex);
+
+    auto it = data.timers.find(name);
+    if (it == data.timers.end()) {
+        data.timers.emplace(name, Timer {1, duration, duration, duration});
+    }
+    else {
+        auto& timer = it->second;
+        timer.calls++;
+        timer.total += duration;
+        timer.min = std::min(timer.min, duration);
+        timer.max = std::max(timer.max, duration);
+    }
+
+    if (_tracing.load(std::memory_order_relaxed)) {
+        if (_traceEvents.fetch_add(1, std::memory_order_relaxed) < _maxTraceEvents.load(std::memory_order_relaxed)) {
+            data.events.push_back(TraceEvent {
+                name,
+                std::chrono::duration<double, std::micro>(start - _epoch).count(),
+                std::chrono::duration<double, std::micro>(end - start).count()
+            });
+        }
+        else {
+            data.counters["instrumentation.droppedEvents"]++;
+        }
+    }
+}
+
+void Instrumentation::addCount(const char* name, int64_t value) {
+    auto& data = threadData();
+
+    std::lock_guard<std::mutex> lock(data.mutex);
+    data.counters[name] += value;
+}
+
+std::vector<TimerStatistics> Instrumentation::timers() const {
+    // The same name can have a different pointer in each library
+    std::map<std::string, TimerStatistics> merged;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const auto& data : _threads) {
+        std::lock_guard<std::mutex> threadLock(data->mutex);
+
+        for (const auto& timer : data->timers) {
+            auto it = merged.find(timer.first);
+            if (it == merged.end()) {
+                merged.emplace(timer.first, TimerStatistics {
+                    timer.first, timer.second.calls, timer.second.total, timer.second.min, timer.second.max
+                });
+            }
+            else {
+                auto& statistics = it->second;
+                statistics.calls += timer.second.calls;
+                statistics.total += timer.second.total;
+                statistics.min = std::min(statistics.min, timer.second.min);
+                statistics.max = std::max(statistics.max, timer.second.max);
+            }
+        }
+    }
+
+    std::vector<TimerStatistics> result;
+    result.reserve(merged.size());
+    for (auto& statistics : merged) {
+        result.push_back(std::move(statistics.second));
+    }
+
+    return result;
+}
+
+std::map<std::string, int64_t> Instrumentation::counters() const {
+    std::map<std::string, int64_t> result;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const auto& data : _threads) {
+        std::lock_guard<std::mutex> threadLock(data->mutex);
+
+        for (const auto& counter : data->counters) {
+            result[counter.first] += counter.second;
+        }
+    }
+
+    return result;
+}
+
+void Instrumentation::reset() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const auto& data : _threads) {
+        std::lock_guard<std::mutex> threadLock(data->mutex);
+        data->timers.clear();
+        data->counters.clear();
+        data->events.clear();
+    }
+
+    _traceEvents = 0;
+}
+
+void Instrumentation::writeChromeTrace(std::ostream& stream) const {
+    double end = 0.;
+    bool first = true;
+
+    auto separator = [&stream, &first]() {
+        if (!first) {
+            stream << ",\n";
+        }
+        first = false;
+    };
+
+    // Microseconds with a nanosecond precision
+    const auto flags = stream.flags();
+    const auto precision = stream.precision();
+    stream << std::fixed << std::setprecision(3);
+
+    stream << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (const auto& data : _threads) {
+            std::lock_guard<std::mutex> threadLock(data->mutex);
+
+            separator();
+            stream << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << data->id
+                   << ", \"args\": {\"name\": \"thread " << data->id << "\"}}";
+
+            for (const auto& event : data->events) {
+                separator();
+                stream << "{\"name\": ";
+                writeJsonString(stream, event.name);
+                stream << ", \"cat\": \"librecad\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << data->id
+                       << ", \"ts\": " << event.start << ", \"dur\": " << event.duration << "}";
+
+                end = std::max(end, event.start + event.duration);
+            }
+        }
+    }
+
+    for (const auto& counter : counters()) {
+        separator();
+        stream << "{\"name\": ";
+        writeJsonString(stream, counter.first);
+        stream << ", \"cat\": \"librecad\", \"ph\": \"C\", \"pid\": 1, \"tid\": 1, \"ts\": " << end
+               << ", \"args\": {\"value\": " << counter.second << "}}";
+    }
+
+    stream << "\n]}\n";
+
+    stream.flags(flags);
+    stream.precision(precision);
+}
+
+bool Instrumentation::writeChromeTrace(const std::string& path) const {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+
+    writeChromeTrace(file);
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace lc {
+    namespace instrumentation {
+        using Clock = std::chrono::steady_clock;
+
+        /**
+         * @brief Accumulated time of a named timer, over all threads
+         */
+        struct TimerStatistics {
+            std::string name;
+            uint64_t calls;
+            // Nanoseconds
+            uint64_t total;
+            uint64_t min;
+            uint64_t max;
+        };
+
+        /**
+         * @brief The Instrumentation class
+         * Collects the time spent in the hot paths of LibreCAD and named counters, to profile real sessions
+         * without a profiler attached.
+         *
+         * Collection is disabled by default, a disabled ScopedTimer or count() only reads an atomic flag.
+         * Each thread writes in its own buffers, so threads don't wait on each other.
+         * Names must be string literals, they are stored as pointers.
+         *
+         * When tracing is enabled every timer is also kept as an event, which can be written as Chrome trace JSON
+         * and opened in chrome://tracing. The number of events is limited so a long session can't take all the memory.
+         */
+        class Instrumentation {
+            public:
+                static const size_t DEFAULT_MAX_TRACE_EVENTS = 1000000;
+
+                static Instrumentation& instance();
+
+                static bool enabled() {
+                    return _enabled.load(std::memory_order_relaxed);
+                }
+
+                void setEnabled(bool enabled);
+
+                /**
+                 * @brief Keep the timers as trace events, also enables the collection
+                 * @param maxEvents events after this number are dropped and counted in instrumentation.droppedEvents
+                 */
+                void setTracing(bool tracing, size_t maxEvents = DEFAULT_MAX_TRACE_EVENTS);
+                bool tracing() const;
+
+                void addTime(const char* name, Clock::time_point start, Clock::time_point end);
+                void addCount(const char* name, int64_t value);
+
+                /**
+                 * @return timers of all threads, sorted by name
+                 */
+                std::vector<TimerStatistics> timers() const;
+
+                /**
+                 * @return counters of all threads
+                 */
+                std::map<std::string, int64_t> counters() const;
+
+                /**
+                 * @brief Remove the collected timers, counters and events
+                 */
+                void reset();
+
+                /**
+                 * @brief Write the trace events in the Chrome trace event format
+                 * Counters are added as counter events at the end of the trace.
+                 */
+                void writeChromeTrace(std::ostream& stream) const;
+                bool writeChromeTrace(const std::string& path) const;
+
+            private:
+                struct ThreadData;
+
+                Instrumentation();
+
+                ThreadData& threadData();
+
+                static std::atomic<bool> _enabled;
+
+                std::atomic<bool> _tracing;
+                std::atomic<size_t> _traceEvents;
+                std::atomic<size_t> _maxTraceEvents;
+                const Clock::time_point _epoch;
+
+                mutable std::mutex _mutex;
+                std::vector<std::shared_ptr<ThreadData>> _threads;
+        };
+
+        /**
+         * @brief Measure the time until the end of the scope
+         * Example: ScopedTimer timer("document.process");
+         */
+        class ScopedTimer {
+            public:
+                explicit ScopedTimer(const char* name) :
+                    _name(Instrumentation::enabled() ? name : nullptr) {
+                    if (_name != nullptr) {
+                        _start = Clock::now();
+                    }
+                }
+
+                ~ScopedTimer() {
+                    if (_name != nullptr) {
+                        Instrumentation::instance().addTime(_name, _start, Clock::now());
+                    }
+                }
+
+                ScopedTimer(const ScopedTimer&) = delete;
+                ScopedTimer& operator = (const ScopedTimer&) = delete;
+
+            private:
+                const char* _name;
+                Clock::time_point _start;
+        };
+
+        /**
+         * @brief Add a value to a counter
+         */
+        inline void count(const char* name, int64_t value = 1) {
+            if (Instrumentation::enabled()) {
+                Instrumentation::instance().addCount(name, value);
+            }
+        }
+    }
+}
@@ -0,0 +1,124 @@
+#include "threadpool.h"
+
+#include <algorithm>
+
+using namespace lc;
+
+namespace {
+    thread_local bool inWorker = false;
+}
+
+ThreadPool::ThreadPool(unsigned int numThreads) :
+    _stop(false) {
+    if (numThreads == 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (unsigned int i = 0; i < numThreads; i++) {
+        _workers.emplace_back(&ThreadPool::worker, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lck(_mutex);
+        _stop = true;
+    }
+
+    _condition.notify_all();
+
+    for (auto& thread : _workers) {
+        thread.join();
+    }
+}
+
+ThreadPool& ThreadPool::instance() {
+    static ThreadPool pool;
+    return pool;
+}
+
+unsigned int ThreadPool::size() const {
+    return _workers.size();
+}
+
+std::future<void> ThreadPool::submit(std::function<void()> task) {
+    std::packaged_task<void()> packagedTask(std::move(task));
+    auto future = packagedTask.get_future();
+
+    {
+        std::lock_guard<std::mutex> lck(_mutex);
+        _tasks.push(std::move(packagedTask));
+    }
+
+    _condition.notify_one();
+    return future;
+}
+
+void ThreadPool::worker() {
+    inWorker = true;
+
+    while (true) {
+        std::packaged_task<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lck(_mutex);
+            _condition.wait(lck, [this] { return _stop || !_tasks.empty(); });
+
+            if (_stop && _tasks.empty()) {
+                return;
+            }
+
+            task = std::move(_tasks.front());
+            _tasks.pop();
+        }
+
+        task();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t, size_t)>& func, size_t minChunk) {
+    minChunk = std::max<size_t>(1, minChunk);
+    size_t numChunks = std::min<size_t>(size() + 1, count / minChunk);
+
+    // Nested calls would block a worker waiting for other workers
+    if (numChunks < 2 || inWorker) {
+        if (count > 0) {
+            func(0, count);
+        }
+        return;
+    }
+
+    size_t chunkSize = (count + numChunks - 1) / numChunks;
+    std::vector<std::future<void>> futures;
+
+    for (size_t begin = chunkSize; begin < count; begin += chunkSize) {
+        size_t end = std::min(count, begin + chunkSize);
+        futures.push_back(submit([&func, begin, end]() {
+            func(begin, end);
+        }));
+    }
+
+    std::exception_ptr exception;
+    try {
+        func(0, std::min(count, chunkSize));
+    }
+    catch (...) {
+        exception = std::current_exception();
+    }
+
+    // Always wait for all chunks, func and the data it uses live on our stack
+    for (auto& future : futures) {
+        try {
+            future.get();
+        }
+        catch (...) {
+            if (!exception) {
+                exception = std::current_exception();
+            }
+        }
+    }
+
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
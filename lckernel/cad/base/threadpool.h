@@ -0,0 +1,69 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace lc {
+    /**
+     * @brief The ThreadPool class
+     * Small fixed size pool of worker threads shared by the kernel.
+     * Operations that work on large sets of entities can split their work in chunks
+     * and hand them to the pool with parallelFor().
+     *
+     * Tasks must not depend on each other, there is no work stealing.
+     */
+    class ThreadPool {
+        public:
+            /**
+             * @brief Create a pool
+             * @param numThreads number of worker threads, 0 uses std::thread::hardware_concurrency()
+             */
+            explicit ThreadPool(unsigned int numThreads = 0);
+            ~ThreadPool();
+
+            ThreadPool(const ThreadPool&) = delete;
+            ThreadPool& operator = (const ThreadPool&) = delete;
+
+            /**
+             * @brief Shared pool used by the kernel
+             */
+            static ThreadPool& instance();
+
+            /**
+             * @brief Queue a task
+             * @return future which becomes ready once the task was executed
+             */
+            std::future<void> submit(std::function<void()> task);
+
+            /**
+             * @brief Number of worker threads
+             */
+            unsigned int size() const;
+
+            /**
+             * @brief Call func(begin, end) for consecutive ranges of [0, count)
+             * The calling thread processes the first range itself and waits for the others.
+             * When the amount of work is smaller than minChunk, or when called from a worker thread,
+             * everything is processed on the calling thread.
+             * Exceptions thrown by func are rethrown in the calling thread.
+             * @param count number of items
+             * @param func function receiving a [begin, end) range
+             * @param minChunk minimum number of items per range
+             */
+            void parallelFor(size_t count, const std::function<void(size_t, size_t)>& func, size_t minChunk = 1024);
+
+        private:
+            void worker();
+
+            std::vector<std::thread> _workers;
+            std::queue<std::packaged_task<void()>> _tasks;
+            std::mutex _mutex;
+            std::condition_variable _condition;
+            bool _stop;
+    };
+}
@@ -1,5 +1,6 @@
 #include "arc.h"
 #include <cad/primitive/arc.h>
+#include <cad/base/entitypool.h>
 
 using namespace lc::builder;
 
@@ -52,5 +53,7 @@ ArcBuilder* ArcBuilder::setIsCCW(bool isCCW) {
 }
 
 lc::entity::Arc_CSPtr ArcBuilder::build() {
-    return entity::Arc_CSPtr(new entity::Arc(*this));
+    return lc::pool::constructShared<entity::Arc>([this](void* memory) {
+        return new (memory) entity::Arc(*this);
+    });
 }
@@ -1,5 +1,6 @@
 #include "circle.h"
 #include <cad/primitive/circle.h>
+#include <cad/base/entitypool.h>
 
 lc::builder::CircleBuilder::CircleBuilder() {
 
@@ -24,5 +25,7 @@ lc::builder::CircleBuilder* lc::builder::CircleBuilder::setRadius(double radius)
 }
 
 lc::entity::Circle_CSPtr lc::builder::CircleBuilder::build() {
-    return entity::Circle_CSPtr(new entity::Circle(*this));
+    return lc::pool::constructShared<entity::Circle>([this](void* memory) {
+        return new (memory) entity::Circle(*this);
+    });
 }
@@ -1,5 +1,6 @@
 #include "insert.h"
 #include <cad/primitive/insert.h>
+#include <cad/base/entitypool.h>
 
 using namespace lc;
 using namespace builder;
@@ -39,7 +40,9 @@ entity::Insert_CSPtr InsertBuilder::build() {
         throw "Missing values";
     }
 
-    return entity::Insert_CSPtr(new entity::Insert(*this));
+    return lc::pool::constructShared<entity::Insert>([this](void* memory) {
+        return new (memory) entity::Insert(*this);
+    });
 }
 
 const geo::Coordinate& InsertBuilder::coordinate() const {
@@ -1,5 +1,6 @@
 #include "line.h"
 #include <cad/primitive/line.h>
+#include <cad/base/entitypool.h>
 
 using namespace lc::builder;
 
@@ -27,5 +28,7 @@ LineBuilder* LineBuilder::setEnd(const lc::geo::Coordinate& end) {
 }
 
 lc::entity::Line_CSPtr LineBuilder::build() {
-    return entity::Line_CSPtr(new entity::Line(*this));
+    return lc::pool::constructShared<entity::Line>([this](void* memory) {
+        return new (memory) entity::Line(*this);
+    });
 }
\ No newline at end of file
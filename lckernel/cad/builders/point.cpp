@@ -1,5 +1,6 @@
 #include "point.h"
 #include <cad/primitive/point.h>
+#include <cad/base/entitypool.h>
 
 using namespace lc;
 using namespace builder;
@@ -15,5 +16,7 @@ PointBuilder* PointBuilder::setCoordinate(const geo::Coordinate& coordinate) {
 }
 
 entity::Point_CSPtr PointBuilder::build() {
-    return entity::Point_CSPtr(new entity::Point(*this));
+    return lc::pool::constructShared<entity::Point>([this](void* memory) {
+        return new (memory) entity::Point(*this);
+    });
 }
@@ -5,6 +5,8 @@
 #include "documentimpl.h"
 #include <cad/primitive/insert.h>
 #include <cad/primitive/customentity.h>
+#include <cad/base/entitypool.h>
+#include <cad/base/instrumentation.h>
 
 using namespace lc;
 
@@ -14,13 +16,24 @@ DocumentImpl::DocumentImpl(const StorageManager_SPtr storageManager) : Document(
 
 DocumentImpl::~DocumentImpl() {
     // LOG4CXX_DEBUG(logger, "DocumentImpl removed");
+
+    // Release the entities first so the entity pools can be given back to the system when this was the last document
+    _storageManager = nullptr;
+    pool::FixedSizePool::releaseAllUnused();
 }
 
 void DocumentImpl::execute(operation::DocumentOperation_SPtr operation) {
+    instrumentation::ScopedTimer timer("document.execute");
+
     {
         std::lock_guard<std::mutex> lck(_documentMutex);
         begin(operation);
-        this->operationProcess(operation);
+
+        {
+            instrumentation::ScopedTimer processTimer("document.execute.process");
+            this->operationProcess(operation);
+        }
+
         commit(operation);
 
         _documentMutex.unlock();
@@ -35,13 +48,24 @@ void DocumentImpl::execute(operation::DocumentOperation_SPtr operation) {
 }
 
 void DocumentImpl::begin(operation::DocumentOperation_SPtr operation) {
+    instrumentation::ScopedTimer timer("document.execute.begin");
     this->operationStart(operation);
     BeginProcessEvent event;
     beginProcessEvent()(event);
 }
 
 void DocumentImpl::commit(operation::DocumentOperation_SPtr operation) {
-    _storageManager->optimise();
+    {
+        instrumentation::ScopedTimer timer("document.execute.blocks");
+        _storageManager->updateBlocks();
+    }
+
+    {
+        instrumentation::ScopedTimer timer("document.execute.optimise");
+        _storageManager->optimise();
+    }
+
+    instrumentation::ScopedTimer timer("document.execute.commit");
     CommitProcessEvent event(operation);
     commitProcessEvent()(event);
 }
@@ -55,8 +79,8 @@ void DocumentImpl::insertEntity(const entity::CADEntity_CSPtr cadEntity) {
     AddEntityEvent event(cadEntity);
     addEntityEvent()(event);
 
-    auto insert = std::dynamic_pointer_cast<const entity::Insert>(cadEntity);
-    if(insert != nullptr && std::dynamic_pointer_cast<const entity::CustomEntity>(cadEntity) == nullptr) {
+    if(cadEntity->kind() == entity::EntityKind::Insert) {
+        auto insert = std::static_pointer_cast<const entity::Insert>(cadEntity);
         auto ces = std::dynamic_pointer_cast<const CustomEntityStorage>(insert->displayBlock());
 
         if(ces != nullptr) {
@@ -67,8 +91,8 @@ void DocumentImpl::insertEntity(const entity::CADEntity_CSPtr cadEntity) {
 }
 
 void DocumentImpl::removeEntity(const entity::CADEntity_CSPtr entity) {
-    auto insert = std::dynamic_pointer_cast<const entity::Insert>(entity);
-    if(insert != nullptr && std::dynamic_pointer_cast<const entity::CustomEntity>(entity) == nullptr) {
+    if(entity->kind() == lc::entity::EntityKind::Insert) {
+        auto insert = std::static_pointer_cast<const lc::entity::Insert>(entity);
         auto ces = std::dynamic_pointer_cast<const CustomEntityStorage>(insert->displayBlock());
         if(ces != nullptr) {
             _waitingCustomEntities[ces->pluginName()].erase(insert);
@@ -145,6 +169,10 @@ EntityContainer<entity::CADEntity_CSPtr> DocumentImpl::entitiesByLayer(const Lay
     return _storageManager->entitiesByLayer(layer);
 }
 
+EntityContainer<entity::CADEntity_CSPtr> DocumentImpl::_entitiesByLayer(const Layer_CSPtr layer) {
+    return _storageManager->entitiesByLayer(layer);
+}
+
 StorageManager_SPtr DocumentImpl::storageManager() const {
     return _storageManager;
 }
@@ -155,6 +183,32 @@ EntityContainer<entity::CADEntity_CSPtr> DocumentImpl::entityContainer()  {
     return _storageManager->entityContainer();
 }
 
+std::vector<entity::CADEntity_CSPtr> DocumentImpl::entities() {
+    return _storageManager->entities();
+}
+
+const EntityContainer<entity::CADEntity_CSPtr>& DocumentImpl::spatialIndex() {
+    return _storageManager->spatialIndex();
+}
+
+std::vector<uint8_t> DocumentImpl::spatialIndexLayout() {
+    return _storageManager->spatialIndexLayout();
+}
+
+std::vector<uint32_t> DocumentImpl::spatialIndexPlacement() {
+    return _storageManager->spatialIndexPlacement();
+}
+
+bool DocumentImpl::restoreSpatialIndexLayout(const std::vector<uint8_t>& layout, const std::vector<uint32_t>& placement) {
+    return _storageManager->restoreSpatialIndexLayout(layout, placement);
+}
+
+MemoryUsage DocumentImpl::memoryUsage() {
+    MemoryUsage usage;
+    _storageManager->memoryUsage(usage);
+    return usage;
+}
+
 std::map<std::string, Layer_CSPtr> DocumentImpl::allLayers() const {
     return _storageManager->allLayers();
 }
@@ -179,6 +233,10 @@ EntityContainer<entity::CADEntity_CSPtr> DocumentImpl::entitiesByBlock(const Blo
     return _storageManager->entitiesByBlock(block);
 }
 
+geo::Area DocumentImpl::blockExtents(const Block_CSPtr block) {
+    return _storageManager->blockExtents(block);
+}
+
 std::vector<Block_CSPtr> DocumentImpl::blocks() const {
     return _storageManager->metaTypes<const Block>();
 }
@@ -32,8 +32,22 @@ namespace lc {
 
             EntityContainer<entity::CADEntity_CSPtr> entitiesByBlock(const Block_CSPtr block) override;
 
+            geo::Area blockExtents(const Block_CSPtr block) override;
+
             virtual EntityContainer<entity::CADEntity_CSPtr> entityContainer() override;
 
+            virtual std::vector<entity::CADEntity_CSPtr> entities() override;
+
+            virtual const EntityContainer<entity::CADEntity_CSPtr>& spatialIndex() override;
+
+            virtual std::vector<uint8_t> spatialIndexLayout() override;
+
+            virtual std::vector<uint32_t> spatialIndexPlacement() override;
+
+            virtual bool restoreSpatialIndexLayout(const std::vector<uint8_t>& layout, const std::vector<uint32_t>& placement = std::vector<uint32_t>()) override;
+
+            virtual MemoryUsage memoryUsage() override;
+
             virtual std::map<std::string, Layer_CSPtr> allLayers() const override;
 
             virtual Layer_CSPtr layerByName(const std::string& layerName) const override;
@@ -69,6 +83,8 @@ namespace lc {
             std::vector<Block_CSPtr> blocks() const override;
 
         private:
+            EntityContainer<entity::CADEntity_CSPtr> _entitiesByLayer(const Layer_CSPtr layer) override;
+
             std::mutex _documentMutex;
             // AI am considering remove the shared_ptr from this one so we can never get a shared object from it
             StorageManager_SPtr _storageManager;
@@ -7,12 +7,18 @@ DocumentList::DocumentList() {
 }
 
 void DocumentList::addDocument(lc::Document* document) {
-    _documents.insert(document);
+    {
+        std::lock_guard<std::mutex> lock(_documentsMutex);
+        _documents.insert(document);
+    }
+
     document->newWaitingCustomEntityEvent().connect<DocumentList, &DocumentList::onNewWaitingCustomEntity>(this);
 }
 
 void DocumentList::removeDocument(lc::Document* document) {
     document->newWaitingCustomEntityEvent().disconnect<DocumentList, &DocumentList::onNewWaitingCustomEntity>(this);
+
+    std::lock_guard<std::mutex> lock(_documentsMutex);
     _documents.erase(document);
 }
 
@@ -27,6 +33,7 @@ Nano::Signal<void(const NewWaitingCustomEntityEvent&)>& DocumentList::newWaiting
 std::unordered_set<entity::Insert_CSPtr> DocumentList::waitingCustomEntities(const std::string& pluginName) {
     std::unordered_set<entity::Insert_CSPtr> result;
 
+    std::lock_guard<std::mutex> lock(_documentsMutex);
     for(auto document : _documents) {
         auto entities = document->waitingCustomEntities(pluginName);
         result.insert(entities.begin(), entities.end());
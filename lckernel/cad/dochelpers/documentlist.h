@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cad/document/document.h>
+#include <mutex>
 #include <unordered_set>
 
 namespace lc {
@@ -32,6 +33,8 @@ namespace lc {
 
             void onNewWaitingCustomEntity(const NewWaitingCustomEntityEvent& event);
 
+            // Documents can be created and destroyed by several threads, for example when rendering in batch
+            std::mutex _documentsMutex;
             std::unordered_set<Document*> _documents;
             Nano::Signal<void(const lc::NewWaitingCustomEntityEvent&)> _newWaitingCustomEntityEvent;
     };
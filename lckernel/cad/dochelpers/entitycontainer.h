@@ -108,6 +108,14 @@ namespace lc {
 
                 return _tree->retrieve(maxLevel);
             }
+            /**
+             * @brief size
+             * @return number of entities in this container
+             */
+            unsigned int size() const {
+                return _tree->size();
+            }
+
             /**
              * @brief entityByID
              * return a entity by it's id, return's a empty shared ptr when not found
@@ -175,18 +183,24 @@ namespace lc {
              */
             EntityContainer entitiesFullWithinArea(const geo::Area& area, const short maxLevel = std::numeric_limits<short>::max()) const {
                 EntityContainer container;
-                std::vector<CT> entities = _tree->retrieve(area, maxLevel);
 
-                for (auto i : entities) {
-                    // If the item fully with's with the selection area sinmply add it
-                    if (i->boundingBox().inArea(area)) {
-                        container.insert(i);
-                    }
+                for (const auto& i : entitiesFullWithin(area, maxLevel)) {
+                    container.insert(i);
                 }
 
                 return container;
             }
 
+            /**
+             * @brief entitiesFullWithin
+             * Same as entitiesFullWithinArea() without building a container for the result
+             * @return entities which bounding box is within the area
+             */
+            std::vector<CT> entitiesFullWithin(const geo::Area& area, const short maxLevel = std::numeric_limits<short>::max()) const {
+                // The tree tests the bounding boxes it stored during insert
+                return _tree->retrieveFullWithin(area, maxLevel);
+            }
+
             /**
              * Calculate boundingBox of all entities in this container
              */
@@ -215,60 +229,76 @@ namespace lc {
              */
             EntityContainer entitiesWithinAndCrossingArea(const geo::Area& area, const short maxLevel = std::numeric_limits<short>::max()) const {
                 EntityContainer container;
-                std::vector<CT> entities = _tree->retrieve(area, maxLevel);
 
-                for (auto i : entities) {
+                for (const auto& i : entitiesWithinAndCrossing(area, maxLevel)) {
+                    container.insert(i);
+                }
 
-                    // If the item fully with's with the selection area sinmply add it
-                    if (i->boundingBox().inArea(area)) {
-                        container.insert(i);
-                        continue;
-                    }
+                return container;
+            }
 
-                    // if it has 2 corners inside area, we know for 100% sure that the entity, or
-                    // at least part of it is located within area
-                    // We test for 2 (not 1) because for exampke with a arc we can have one corner inside
-                    // The area, but still not intersecting with area
-                    auto c = i->boundingBox().numCornersInside(area);
+            /**
+             * @brief entitiesWithinAndCrossing
+             * Same as entitiesWithinAndCrossingArea() without building a container for the result
+             * @return entities within the area or which path crosses the area
+             */
+            std::vector<CT> entitiesWithinAndCrossing(const geo::Area& area, const short maxLevel = std::numeric_limits<short>::max()) const {
+                std::vector<CT> result;
 
-                    if (c == 2) {
-                        container.insert(i);
-                        continue;
+                for (const auto& i : _tree->retrieve(area, maxLevel)) {
+                    if (withinOrCrossing(i, area)) {
+                        result.push_back(i);
                     }
+                }
 
-                    // Path to area intersection testing
-                    lc::Intersect intersect(Intersect::OnEntity, 10e-4);
+                return result;
+            }
 
-                    auto &&v = area.top();
-                    visitorDispatcher<bool, lc::GeoEntityVisitor>(intersect, v, *i.get());
-                    if (intersect.result().size() != 0) {
-                        container.insert(i);
-                        continue;
-                    }
+            /**
+             * @brief withinOrCrossing
+             * Test used by entitiesWithinAndCrossingArea() for a single entity
+             * @return true if the entity is within the area or its path crosses the area bounderies
+             */
+            static bool withinOrCrossing(const CT& i, const geo::Area& area) {
+                // If the item fully with's with the selection area sinmply add it
+                if (i->boundingBox().inArea(area)) {
+                    return true;
+                }
 
-                    v = area.left();
-                    visitorDispatcher<bool, GeoEntityVisitor>(intersect, v, *i.get());
-                    if (intersect.result().size() != 0) {
-                        container.insert(i);
-                        continue;
-                    }
+                // if it has 2 corners inside area, we know for 100% sure that the entity, or
+                // at least part of it is located within area
+                // We test for 2 (not 1) because for exampke with a arc we can have one corner inside
+                // The area, but still not intersecting with area
+                auto c = i->boundingBox().numCornersInside(area);
 
-                    v = area.bottom();
-                    visitorDispatcher<bool, GeoEntityVisitor>(intersect, v, *i.get());
-                    if (intersect.result().size() != 0) {
-                        container.insert(i);
-                        continue;
-                    }
+                if (c == 2) {
+                    return true;
+                }
 
-                    v = area.right();
-                    visitorDispatcher<bool, GeoEntityVisitor>(intersect, v, *i.get());
-                    if (intersect.result().size() != 0) {
-                        container.insert(i);
-                        continue;
-                    }
+                // Path to area intersection testing
+                lc::Intersect intersect(Intersect::OnEntity, 10e-4);
+
+                auto &&v = area.top();
+                visitorDispatcher<bool, lc::GeoEntityVisitor>(intersect, v, *i.get());
+                if (intersect.result().size() != 0) {
+                    return true;
                 }
 
-                return container;
+                v = area.left();
+                visitorDispatcher<bool, GeoEntityVisitor>(intersect, v, *i.get());
+                if (intersect.result().size() != 0) {
+                    return true;
+                }
+
+                v = area.bottom();
+                visitorDispatcher<bool, GeoEntityVisitor>(intersect, v, *i.get());
+                if (intersect.result().size() != 0) {
+                    return true;
+                }
+
+                v = area.right();
+                visitorDispatcher<bool, GeoEntityVisitor>(intersect, v, *i.get());
+                return intersect.result().size() != 0;
             }
 
             /**
@@ -283,18 +313,23 @@ namespace lc {
             EntityContainer entitiesWithinAndCrossingAreaFast(const geo::Area& area, const short maxLevel = std::numeric_limits<short>::max()) const {
                 EntityContainer container;
 
-                std::vector<CT> &&entities = _tree->retrieve(area, maxLevel);
-
-                for (auto &i : entities) {
-                    // If the item fully with's with the selection area simply add it
-                    if (i->boundingBox().overlaps(area)) {
-                        container.insert(i);
-                    }
+                for (const auto& i : _tree->retrieveOverlapping(area, maxLevel)) {
+                    container.insert(i);
                 }
 
                 return container;
             }
 
+            /**
+             * @brief entitiesOverlapping
+             * Same as entitiesWithinAndCrossingAreaFast() without building a container for the result,
+             * use it when the entities are only visited, for example during drawing.
+             * @return entities which bounding box overlaps the area
+             */
+            std::vector<CT> entitiesOverlapping(const geo::Area& area, const short maxLevel = std::numeric_limits<short>::max()) const {
+                return _tree->retrieveOverlapping(area, maxLevel);
+            }
+
             /*!
              * \brief getEntityPathsNearCoordinate
              * \param point point where to look for entities
@@ -361,6 +396,55 @@ namespace lc {
                 return _tree->bounds();
             }
 
+            /**
+             * @brief splitLayout
+             * Shape of the underlying spatial index
+             * @see QuadTreeSub::splitLayout()
+             */
+            std::vector<uint8_t> splitLayout() const {
+                return _tree->splitLayout();
+            }
+
+            /**
+             * @brief placement
+             * Node of each entity in the spatial index
+             * @see QuadTreeSub::placement()
+             */
+            std::vector<uint32_t> placement() const {
+                return _tree->placement();
+            }
+
+            /**
+             * @brief restoreSplitLayout
+             * Restore the shape of the spatial index of a empty container, before inserting entities.
+             * When a placement is given the entities inserted next are stored directly in their node.
+             * @see QuadTree::restorePlacement()
+             * @return false if the container is not empty or the layout doesn't fit
+             */
+            bool restoreSplitLayout(const std::vector<uint8_t>& layout, const std::vector<uint32_t>& placement = std::vector<uint32_t>()) {
+                if (size() != 0) {
+                    return false;
+                }
+
+                return _tree->restorePlacement(layout, placement);
+            }
+
+            /**
+             * @brief memorySize
+             * Bytes used by the spatial index, the entities themselves are not included
+             */
+            size_t memorySize() const {
+                return sizeof(EntityContainer<CT>) + _tree->memorySize();
+            }
+
+            /**
+             * @brief nodeCount
+             * Number of nodes of the spatial index
+             */
+            size_t nodeCount() const {
+                return _tree->nodeCount();
+            }
+
             /**
              * @brief optimise
              * this container
@@ -0,0 +1,199 @@
+#include "memoryusage.h"
+
+#include <iomanip>
+
+#include "cad/base/entitypool.h"
+#include "cad/primitive/arc.h"
+#include "cad/primitive/circle.h"
+#include "cad/primitive/customentity.h"
+#include "cad/primitive/dimaligned.h"
+#include "cad/primitive/dimangular.h"
+#include "cad/primitive/dimdiametric.h"
+#include "cad/primitive/dimlinear.h"
+#include "cad/primitive/dimradial.h"
+#include "cad/primitive/ellipse.h"
+#include "cad/primitive/image.h"
+#include "cad/primitive/insert.h"
+#include "cad/primitive/line.h"
+#include "cad/primitive/lwpolyline.h"
+#include "cad/primitive/point.h"
+#include "cad/primitive/spline.h"
+#include "cad/primitive/text.h"
+
+using namespace lc;
+
+namespace {
+    struct EntityKindInfo {
+        const char* name;
+        size_t size;
+    };
+
+    // Name and size of each entity kind, in the order of lc::entity::EntityKind
+    const EntityKindInfo entityKinds[] = {
+        {"Point", sizeof(entity::Point)},
+        {"Line", sizeof(entity::Line)},
+        {"Circle", sizeof(entity::Circle)},
+        {"Arc", sizeof(entity::Arc)},
+        {"Ellipse", sizeof(entity::Ellipse)},
+        {"Text", sizeof(entity::Text)},
+        {"Spline", sizeof(entity::Spline)},
+        {"DimAligned", sizeof(entity::DimAligned)},
+        {"DimAngular", sizeof(entity::DimAngular)},
+        {"DimDiametric", sizeof(entity::DimDiametric)},
+        {"DimLinear", sizeof(entity::DimLinear)},
+        {"DimRadial", sizeof(entity::DimRadial)},
+        {"LWPolyline", sizeof(entity::LWPolyline)},
+        {"Image", sizeof(entity::Image)},
+        {"Insert", sizeof(entity::Insert)},
+        // Plugins add their own data, which is not known here
+        {"CustomEntity", sizeof(entity::CustomEntity)},
+        {"Other", sizeof(entity::CADEntity)}
+    };
+
+    static_assert(sizeof(entityKinds) / sizeof(entityKinds[0]) == static_cast<size_t>(entity::EntityKind::Other) + 1,
+                  "entityKinds must have a entry for each entity kind");
+
+    const size_t ENTITY_KINDS = sizeof(entityKinds) / sizeof(entityKinds[0]);
+}
+
+void MemoryUsage::add(const std::string& category, size_t bytes, size_t count) {
+    auto& c = _categories[category];
+    c.bytes += bytes;
+    c.count += count;
+}
+
+void MemoryUsage::addEntities(const std::string& prefix, const std::vector<entity::CADEntity_CSPtr>& entities) {
+    // Summed per kind first, documents can contain millions of entities
+    Category kinds[ENTITY_KINDS];
+
+    for (const auto& entity : entities) {
+        auto& kind = kinds[static_cast<size_t>(entity->kind())];
+        kind.bytes += memory::entitySize(*entity);
+        kind.count++;
+    }
+
+    for (size_t i = 0; i < ENTITY_KINDS; i++) {
+        if (kinds[i].count > 0) {
+            add(prefix + entityKinds[i].name, kinds[i].bytes, kinds[i].count);
+        }
+    }
+}
+
+void MemoryUsage::merge(const MemoryUsage& other) {
+    for (const auto& category : other._categories) {
+        add(category.first, category.second.bytes, category.second.count);
+    }
+}
+
+const std::map<std::string, MemoryUsage::Category>& MemoryUsage::categories() const {
+    return _categories;
+}
+
+MemoryUsage::Category MemoryUsage::category(const std::string& name) const {
+    auto it = _categories.find(name);
+    if (it == _categories.end()) {
+        return Category();
+    }
+
+    return it->second;
+}
+
+size_t MemoryUsage::totalBytes(const std::string& prefix) const {
+    size_t total = 0;
+
+    for (auto it = _categories.lower_bound(prefix); it != _categories.end(); ++it) {
+        if (it->first.compare(0, prefix.size(), prefix) != 0) {
+            break;
+        }
+
+        total += it->second.bytes;
+    }
+
+    return total;
+}
+
+void MemoryUsage::write(std::ostream& stream) const {
+    const auto flags = stream.flags();
+    const auto precision = stream.precision();
+
+    stream << std::left << std::setw(32) << "category" << std::right
+           << std::setw(12) << "objects"
+           << std::setw(14) << "KiB" << std::endl;
+
+    stream << std::fixed << std::setprecision(1);
+    for (const auto& category : _categories) {
+        stream << std::left << std::setw(32) << category.first << std::right
+               << std::setw(12) << category.second.count
+               << std::setw(14) << category.second.bytes / 1024. << std::endl;
+    }
+
+    stream << std::left << std::setw(32) << "total" << std::right
+           << std::setw(12) << ""
+           << std::setw(14) << totalBytes() / 1024. << std::endl;
+
+    stream.flags(flags);
+    stream.precision(precision);
+}
+
+size_t memory::containerSize(const std::string& string) {
+    // Short strings are stored in the object itself
+    const char* begin = reinterpret_cast<const char*>(&string);
+    if (string.data() >= begin && string.data() < begin + sizeof(std::string)) {
+        return 0;
+    }
+
+    return string.capacity() + 1;
+}
+
+const char* memory::entityKindName(entity::EntityKind kind) {
+    return entityKinds[static_cast<size_t>(kind)].name;
+}
+
+size_t memory::entitySize(const entity::CADEntity& entity) {
+    const auto kind = entity.kind();
+    size_t size = pool::FixedSizePool::allocationSize(entityKinds[static_cast<size_t>(kind)].size + SHARED_CONTROL_BLOCK);
+
+    // Casts are checked, draw items return the kind of the entity they draw
+    switch (kind) {
+        case entity::EntityKind::Text:
+            if (auto text = dynamic_cast<const entity::Text*>(&entity)) {
+                size += containerSize(text->text_value()) + containerSize(text->style());
+            }
+            break;
+
+        case entity::EntityKind::Spline:
+            if (auto spline = dynamic_cast<const entity::Spline*>(&entity)) {
+                size += containerSize(spline->controlPoints()) +
+                        containerSize(spline->knotPoints()) +
+                        containerSize(spline->fitPoints());
+            }
+            break;
+
+        case entity::EntityKind::DimAligned:
+        case entity::EntityKind::DimAngular:
+        case entity::EntityKind::DimDiametric:
+        case entity::EntityKind::DimLinear:
+        case entity::EntityKind::DimRadial:
+            if (auto dimension = dynamic_cast<const entity::Dimension*>(&entity)) {
+                size += containerSize(dimension->explicitValue());
+            }
+            break;
+
+        case entity::EntityKind::LWPolyline:
+            if (auto polyline = dynamic_cast<const entity::LWPolyline*>(&entity)) {
+                size += containerSize(polyline->vertex()) + polyline->generatedSize();
+            }
+            break;
+
+        case entity::EntityKind::Image:
+            if (auto image = dynamic_cast<const entity::Image*>(&entity)) {
+                size += containerSize(image->name());
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return size;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cad/base/cadentity.h"
+
+namespace lc {
+    /**
+     * @brief The MemoryUsage class
+     * Bytes and number of objects per category, filled by a document, its undo history and its viewers.
+     * Categories are dotted names like entity.Line, index.spatial, undo.entities or canvas.drawItems.
+     *
+     * Sizes are estimates: the objects, their containers and the allocations they own, without the
+     * allocator overhead. They are meant to compare drawings and versions, they won't match the RSS exactly.
+     * Objects shared with a other category, like the layer of a entity, are counted once where they are stored.
+     */
+    class MemoryUsage {
+        public:
+            struct Category {
+                size_t bytes = 0;
+                size_t count = 0;
+            };
+
+            /**
+             * @brief Add bytes and objects to a category, the category is created when needed
+             */
+            void add(const std::string& category, size_t bytes, size_t count = 1);
+
+            /**
+             * @brief Add entities to the category prefix + kind, for example entity.Line
+             */
+            void addEntities(const std::string& prefix, const std::vector<entity::CADEntity_CSPtr>& entities);
+
+            void merge(const MemoryUsage& other);
+
+            /**
+             * @return categories sorted by name
+             */
+            const std::map<std::string, Category>& categories() const;
+
+            /**
+             * @return category, empty when it doesn't exist
+             */
+            Category category(const std::string& name) const;
+
+            /**
+             * @brief Sum of the categories starting with prefix
+             * @param prefix for example "entity.", all categories when empty
+             */
+            size_t totalBytes(const std::string& prefix = std::string()) const;
+
+            /**
+             * @brief Write the categories and the total as a table
+             */
+            void write(std::ostream& stream) const;
+
+        private:
+            std::map<std::string, Category> _categories;
+    };
+
+    /**
+     * Estimation of the memory used by the containers and objects of LibreCAD
+     */
+    namespace memory {
+        // Reference counts and virtual table of a shared_ptr created with make_shared, stored with the object
+        const size_t SHARED_CONTROL_BLOCK = sizeof(void*) + 2 * sizeof(int);
+
+        template<typename T, typename A>
+        size_t containerSize(const std::vector<T, A>& vector) {
+            return vector.capacity() * sizeof(T);
+        }
+
+        /**
+         * @return allocated characters, 0 when the string is stored in the object
+         */
+        size_t containerSize(const std::string& string);
+
+        template<typename K, typename V, typename H, typename E, typename A>
+        size_t containerSize(const std::unordered_map<K, V, H, E, A>& map) {
+            // Bucket array, and a node with the next pointer, the value and the hash for each element
+            return map.bucket_count() * sizeof(void*) +
+                   map.size() * (2 * sizeof(void*) + sizeof(typename std::unordered_map<K, V, H, E, A>::value_type));
+        }
+
+        template<typename K, typename H, typename E, typename A>
+        size_t containerSize(const std::unordered_set<K, H, E, A>& set) {
+            return set.bucket_count() * sizeof(void*) + set.size() * (2 * sizeof(void*) + sizeof(K));
+        }
+
+        template<typename K, typename V, typename C, typename A>
+        size_t containerSize(const std::map<K, V, C, A>& map) {
+            // Red black tree node with the colour, the parent and both children
+            return map.size() * (4 * sizeof(void*) + sizeof(typename std::map<K, V, C, A>::value_type));
+        }
+
+        /**
+         * @return name of the kind of entity, for example Line
+         */
+        const char* entityKindName(entity::EntityKind kind);
+
+        /**
+         * @brief Estimated bytes of a entity, with the data it owns
+         * The entity is counted as created by lc::pool::makeShared: the object and its control block in one pool
+         * block. The builders store the object and the control block in two pool blocks, and entities created with
+         * std::make_shared are not rounded to the pool block sizes, so their real size differs by a few bytes.
+         * Layers, blocks and MetaInfo are shared between entities and not included.
+         */
+        size_t entitySize(const entity::CADEntity& entity);
+    }
+}
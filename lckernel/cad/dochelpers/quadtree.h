@@ -6,8 +6,12 @@
 #include <vector>
 #include <climits>
 #include <array>
+#include <cstdint>
 #include "cad/geometry/geoarea.h"
+#include "cad/geometry/geoaabb.h"
 #include "cad/base/cadentity.h"
+#include "cad/base/instrumentation.h"
+#include "cad/dochelpers/memoryusage.h"
 #include <typeinfo>
 #include <iostream>
 #include "cad/const.h"
@@ -23,30 +27,37 @@ namespace lc {
      */
     template<typename E>
     class QuadTreeSub {
+        template<typename> friend class QuadTree;
+
         //static_assert(
         //        std::is_base_of<CADEntity, E>::value,
         //        "E must be a descendant of CADEntity"
         //);
         public:
-            QuadTreeSub(int level, const geo::Area& pBounds, short maxLevels, short maxObjects) :
+            QuadTreeSub(int level, const geo::AABB& pBounds, short maxLevels, short maxObjects) :
                 _level(level) ,
-                _verticalMidpoint(pBounds.minP().x() + (pBounds.width() / 2.)),
-                _horizontalMidpoint(pBounds.minP().y() + (pBounds.height() / 2.)),
+                _verticalMidpoint(pBounds.min.x + (pBounds.width() / 2.)),
+                _horizontalMidpoint(pBounds.min.y + (pBounds.height() / 2.)),
                 _bounds(pBounds), _maxLevels(maxLevels),
                 _maxObjects(maxObjects) {
                 _objects.reserve(maxObjects / 2);
+                _objectBounds.reserve(maxObjects / 2);
                 _nodes[0] = nullptr;
                 _nodes[1] = nullptr;
                 _nodes[2] = nullptr;
                 _nodes[3] = nullptr;
 
 
+            }
+            QuadTreeSub(int level, const geo::Area& pBounds, short maxLevels, short maxObjects) :
+                QuadTreeSub(level, geo::AABB::fromArea(pBounds), maxLevels, maxObjects) {
             }
             QuadTreeSub(const geo::Area& bounds) : QuadTreeSub(0, bounds, 10, 25) {}
-            QuadTreeSub(const QuadTreeSub& other) : QuadTreeSub(0, other.bounds(), other.maxLevels(), other.maxObjects()) {
-                for (auto i : other.retrieve()) {
-                    insert(i);
-                }
+            QuadTreeSub(const QuadTreeSub& other) : QuadTreeSub(0, other._bounds, other.maxLevels(), other.maxObjects()) {
+                // Re-use the stored bounding boxes, asking each entity for it's bounding box again is expensive
+                other._eachWithBounds([this](const E& entity, const geo::AABB& entityBounds) {
+                    _insert(entity, entityBounds);
+                });
             }
             QuadTreeSub() : QuadTreeSub(0, geo::Area(geo::Coordinate(0., 0.), geo::Coordinate(1., 1.)), 10, 25) {}
             virtual ~QuadTreeSub() {
@@ -85,46 +96,9 @@ namespace lc {
              * @param entity
              */
             void insert(const E entity, const lc::geo::Area& entityBoundingBox) {
-                // Find a Quad Tree area where this item fits
-                if (_nodes[0] != nullptr) {
-                    short entityIndex = quadrantIndex(entityBoundingBox);
-
-                    if (entityIndex != -1) {
-                        _nodes[entityIndex]->insert(entity, entityBoundingBox);
-                        return;
-                    }
-                }
-
-                _objects.push_back(entity);
-
-                // If it fits in this box, see if we can/must split this area into sub area's
-                // loop over the current container and see if the entities fit at a lower level
-                // So each entity is only tried once
-                if (_nodes[0] == nullptr && _objects.size() >= _maxObjects && _level < _maxLevels) {
-
-                    split();
-                    // Split two level's deep to reduce the number of object iterations
-                    // This will help mostly when adding lots of little objects that would fit in 1/8 of the quad
-                    _nodes[0]->split();
-                    _nodes[1]->split();
-                    _nodes[2]->split();
-                    _nodes[3]->split();
-
-                    // std::cout << "size:" << _objects.size() << " level:" << _level << "\n";
-
-                    for (auto it = _objects.begin() ; it != _objects.end();) {
-                        auto sentityBoundingBox = (*it)->boundingBox();
-                        short index = quadrantIndex(sentityBoundingBox);
-
-                        if (index != -1) {
-                            _nodes[index]->insert(*it, sentityBoundingBox);
-                            it = _objects.erase(it);
-                        } else {
-                            it++;
-                        }
-                    }
-                }
+                _insert(entity, geo::AABB::fromArea(entityBoundingBox));
             }
+
             /**
             * Insert a nide into the quad tree,
             * @see insert(const E entity, const lc::geo::Area &entityBoundingBox)
@@ -152,9 +126,10 @@ namespace lc {
                     }
                 }
 
-                for (typename std::vector<E>::iterator it = _objects.begin(); it != _objects.end(); it++) {
-                    if ((*it)->id() == entity->id()) {
-                        _objects.erase(it);
+                for (size_t i = 0; i < _objects.size(); i++) {
+                    if (_objects[i]->id() == entity->id()) {
+                        _objects.erase(_objects.begin() + i);
+                        _objectBounds.erase(_objectBounds.begin() + i);
                         return true;
                     }
                 }
@@ -170,8 +145,45 @@ namespace lc {
              * @param area
              */
             std::vector<E> retrieve(const geo::Area& area, const short maxLevel = SHRT_MAX) const {
+                instrumentation::ScopedTimer timer("quadtree.retrieve");
+                std::vector<E> list;
+                _retrieve(list, geo::AABB::fromArea(area), maxLevel);
+                instrumentation::count("quadtree.retrieved", list.size());
+                return list;
+            }
+
+            /**
+             * @brief retrieveOverlapping
+             * all object's where the bounding box overlaps area
+             * Unlike retrieve(area) the stored bounding boxes are tested, so only the matching objects are returned
+             * @param area
+             * @param maxLevel
+             */
+            std::vector<E> retrieveOverlapping(const geo::Area& area, const short maxLevel = SHRT_MAX) const {
+                instrumentation::ScopedTimer timer("quadtree.retrieveOverlapping");
+                std::vector<E> list;
+                const auto aabb = geo::AABB::fromArea(area);
+                _retrieve(list, aabb, maxLevel, [&aabb](const geo::AABB& entityBounds) {
+                    return entityBounds.overlaps(aabb);
+                });
+                instrumentation::count("quadtree.retrieved", list.size());
+                return list;
+            }
+
+            /**
+             * @brief retrieveFullWithin
+             * all object's where the bounding box is fully within area
+             * @param area
+             * @param maxLevel
+             */
+            std::vector<E> retrieveFullWithin(const geo::Area& area, const short maxLevel = SHRT_MAX) const {
+                instrumentation::ScopedTimer timer("quadtree.retrieveFullWithin");
                 std::vector<E> list;
-                _retrieve(list, area, maxLevel);
+                const auto aabb = geo::AABB::fromArea(area);
+                _retrieve(list, aabb, maxLevel, [&aabb](const geo::AABB& entityBounds) {
+                    return entityBounds.inArea(aabb);
+                });
+                instrumentation::count("quadtree.retrieved", list.size());
                 return list;
             }
 
@@ -221,7 +233,7 @@ namespace lc {
              * @return
              */
             geo::Area bounds() const {
-                return _bounds;
+                return _bounds.toArea();
             }
 
             /**
@@ -252,6 +264,38 @@ namespace lc {
                 return _maxObjects;
             }
 
+            /**
+             * @brief memorySize
+             * Bytes used by this node and its sub nodes, the stored objects themselves are not included
+             * @return bytes
+             */
+            size_t memorySize() const {
+                size_t size = sizeof(QuadTreeSub<E>) +
+                              _objects.capacity() * sizeof(E) +
+                              _objectBounds.capacity() * sizeof(geo::AABB);
+
+                if (_nodes[0] != nullptr) {
+                    size += _nodes[0]->memorySize();
+                    size += _nodes[1]->memorySize();
+                    size += _nodes[2]->memorySize();
+                    size += _nodes[3]->memorySize();
+                }
+
+                return size;
+            }
+
+            /**
+             * @brief nodeCount
+             * @return number of nodes, this node included
+             */
+            size_t nodeCount() const {
+                if (_nodes[0] == nullptr) {
+                    return 1;
+                }
+
+                return 1 + _nodes[0]->nodeCount() + _nodes[1]->nodeCount() + _nodes[2]->nodeCount() + _nodes[3]->nodeCount();
+            }
+
             /**
              * @brief walk
              * Allows to walk over each node within the tree specifying a function that can be called for each QuadTreeSub
@@ -316,7 +360,193 @@ namespace lc {
                 return _objects.size() == 0;
             }
 
+            /**
+             * @brief splitLayout
+             * Shape of the tree, depth first with 1 for each node that has sub nodes and 0 for a leaf.
+             * It can be stored with the entities and given to restoreSplitLayout() before inserting them again.
+             * @return layout
+             */
+            std::vector<uint8_t> splitLayout() const {
+                std::vector<uint8_t> layout;
+                _splitLayout(layout);
+                return layout;
+            }
+
+            /**
+             * @brief restoreSplitLayout
+             * Create the nodes described by layout, entities inserted afterwards go to their node directly
+             * instead of being moved down when a node splits. Nodes are only added, never removed.
+             * @param layout created by splitLayout() of a tree with the same bounds and maximum level
+             * @return false if the layout doesn't fit this tree
+             */
+            bool restoreSplitLayout(const std::vector<uint8_t>& layout) {
+                size_t position = 0;
+                return _restoreSplitLayout(layout, position) && position == layout.size();
+            }
+
+            /**
+             * @brief placement
+             * Depth first index (same order as splitLayout()) of the node storing each entity, ordered by entity ID.
+             * Entities get their ID when they are created, so this is the order in which a file creates them again.
+             * @return node index of each entity
+             */
+            std::vector<uint32_t> placement() const {
+                std::vector<std::pair<ID_DATATYPE, uint32_t>> entityNodes;
+                uint32_t index = 0;
+                _placement(entityNodes, index);
+
+                std::sort(entityNodes.begin(), entityNodes.end());
+
+                std::vector<uint32_t> placement;
+                placement.reserve(entityNodes.size());
+                for (const auto& entityNode : entityNodes) {
+                    placement.push_back(entityNode.second);
+                }
+
+                return placement;
+            }
+
         private:
+            void _placement(std::vector<std::pair<ID_DATATYPE, uint32_t>>& entityNodes, uint32_t& index) const {
+                const uint32_t node = index++;
+
+                for (const auto& entity : _objects) {
+                    entityNodes.emplace_back(entity->id(), node);
+                }
+
+                if (_nodes[0] != nullptr) {
+                    for (int i = 0; i < 4; i++) {
+                        _nodes[i]->_placement(entityNodes, index);
+                    }
+                }
+            }
+
+            void _nodeList(std::vector<QuadTreeSub*>& nodes) {
+                nodes.push_back(this);
+
+                if (_nodes[0] != nullptr) {
+                    for (int i = 0; i < 4; i++) {
+                        _nodes[i]->_nodeList(nodes);
+                    }
+                }
+            }
+
+            /**
+             * Store the entity in this node without looking for a sub node
+             * Only entities strictly within the node are accepted, erase() always finds those when walking down the tree.
+             * @return false if the entity doesn't fit in this node
+             */
+            bool _insertInNode(const E& entity, const geo::AABB& entityBoundingBox) {
+                if (entityBoundingBox.min.x <= _bounds.min.x || entityBoundingBox.min.y <= _bounds.min.y ||
+                    entityBoundingBox.max.x >= _bounds.max.x || entityBoundingBox.max.y >= _bounds.max.y) {
+                    return false;
+                }
+
+                _objects.push_back(entity);
+                _objectBounds.push_back(entityBoundingBox);
+                return true;
+            }
+
+            void _splitLayout(std::vector<uint8_t>& layout) const {
+                layout.push_back(_nodes[0] != nullptr ? 1 : 0);
+
+                if (_nodes[0] != nullptr) {
+                    for (int i = 0; i < 4; i++) {
+                        _nodes[i]->_splitLayout(layout);
+                    }
+                }
+            }
+
+            bool _restoreSplitLayout(const std::vector<uint8_t>& layout, size_t& position) {
+                if (position >= layout.size()) {
+                    return false;
+                }
+
+                if (layout[position++] == 0) {
+                    return true;
+                }
+
+                if (_level >= _maxLevels) {
+                    return false;
+                }
+
+                split();
+
+                for (int i = 0; i < 4; i++) {
+                    if (!_nodes[i]->_restoreSplitLayout(layout, position)) {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            void _insert(const E& entity, const geo::AABB& entityBoundingBox) {
+                // Find a Quad Tree area where this item fits
+                if (_nodes[0] != nullptr) {
+                    short entityIndex = quadrantIndex(entityBoundingBox);
+
+                    if (entityIndex != -1) {
+                        _nodes[entityIndex]->_insert(entity, entityBoundingBox);
+                        return;
+                    }
+                }
+
+                _objects.push_back(entity);
+                _objectBounds.push_back(entityBoundingBox);
+
+                // If it fits in this box, see if we can/must split this area into sub area's
+                // loop over the current container and see if the entities fit at a lower level
+                // So each entity is only tried once
+                if (_nodes[0] == nullptr && _objects.size() >= _maxObjects && _level < _maxLevels) {
+
+                    split();
+                    // Split two level's deep to reduce the number of object iterations
+                    // This will help mostly when adding lots of little objects that would fit in 1/8 of the quad
+                    _nodes[0]->split();
+                    _nodes[1]->split();
+                    _nodes[2]->split();
+                    _nodes[3]->split();
+
+                    // std::cout << "size:" << _objects.size() << " level:" << _level << "\n";
+
+                    size_t keep = 0;
+
+                    for (size_t i = 0; i < _objects.size(); i++) {
+                        short index = quadrantIndex(_objectBounds[i]);
+
+                        if (index != -1) {
+                            _nodes[index]->_insert(_objects[i], _objectBounds[i]);
+                        } else {
+                            if (keep != i) {
+                                _objects[keep] = std::move(_objects[i]);
+                                _objectBounds[keep] = _objectBounds[i];
+                            }
+                            keep++;
+                        }
+                    }
+
+                    _objects.resize(keep);
+                    _objectBounds.resize(keep);
+                }
+            }
+
+            /**
+             * Call func(entity, boundingBox) for each entity within this node and it's sub nodes
+             */
+            template<typename T> void _eachWithBounds(T func) const {
+                if (_nodes[0] != nullptr) {
+                    _nodes[0]->_eachWithBounds(func);
+                    _nodes[1]->_eachWithBounds(func);
+                    _nodes[2]->_eachWithBounds(func);
+                    _nodes[3]->_eachWithBounds(func);
+                }
+
+                for (size_t i = 0; i < _objects.size(); i++) {
+                    func(_objects[i], _objectBounds[i]);
+                }
+            }
+
             /**
              * @brief retrieve
              * all object's that are located within a given area
@@ -339,7 +569,7 @@ namespace lc {
              * @param list
              * @param area
              */
-            void _retrieve(std::vector<E>& list, const geo::Area& area, const short maxLevel) const {
+            void _retrieve(std::vector<E>& list, const geo::AABB& area, const short maxLevel) const {
                 if (_nodes[0] != nullptr && maxLevel > _level) {
                     if (_nodes[0] -> includes(area)) {
                         _nodes[0]->_retrieve(list, area, maxLevel);
@@ -360,12 +590,33 @@ namespace lc {
 
                 list.insert(list.end(), _objects.begin(), _objects.end());
             }
+            /**
+             * @brief retrieve
+             * all object's located within the nodes overlapping area for which filter(boundingBox) returns true
+             */
+            template<typename F>
+            void _retrieve(std::vector<E>& list, const geo::AABB& area, const short maxLevel, const F& filter) const {
+                if (_nodes[0] != nullptr && maxLevel > _level) {
+                    for (int i = 0; i < 4; i++) {
+                        if (_nodes[i]->includes(area)) {
+                            _nodes[i]->_retrieve(list, area, maxLevel, filter);
+                        }
+                    }
+                }
+
+                for (size_t i = 0; i < _objects.size(); i++) {
+                    if (filter(_objectBounds[i])) {
+                        list.push_back(_objects[i]);
+                    }
+                }
+            }
+
             /**
             * Retur the number of items inthis andlower nodes
             */
             unsigned int _size(unsigned int c) const {
                 if (_nodes[0] != nullptr) {
-                    c += _nodes[0]->_size(_nodes[1]->_size(_nodes[2]->_size(_nodes[3]->_size(c))));
+                    c = _nodes[0]->_size(_nodes[1]->_size(_nodes[2]->_size(_nodes[3]->_size(c))));
                 }
 
                 return c + _objects.size();
@@ -378,16 +629,20 @@ namespace lc {
             * @return -1 if it doesn't fit in any of the quadrants
             */
             short quadrantIndex(const geo::Area& pRect) const {
+                return quadrantIndex(geo::AABB::fromArea(pRect));
+            }
+
+            short quadrantIndex(const geo::AABB& pRect) const {
 
-                bool topQuadrant = (pRect.minP().y() >= _horizontalMidpoint) && (pRect.maxP().y() < _bounds.maxP().y());
-                bool bottomQuadrant = (pRect.minP().y() > _bounds.minP().y()) && (pRect.maxP().y() <= _horizontalMidpoint);
+                bool topQuadrant = (pRect.min.y >= _horizontalMidpoint) && (pRect.max.y < _bounds.max.y);
+                bool bottomQuadrant = (pRect.min.y > _bounds.min.y) && (pRect.max.y <= _horizontalMidpoint);
 
                 if ((topQuadrant || bottomQuadrant) == false) {
                     return -1;
                 }
 
-                bool leftQuadrant = (pRect.minP().x() > _bounds.minP().x()) && (pRect.maxP().x() <= _verticalMidpoint);
-                bool rightQuandrant = (pRect.minP().x() >= _verticalMidpoint) && (pRect.maxP().x() < _bounds.maxP().x());
+                bool leftQuadrant = (pRect.min.x > _bounds.min.x) && (pRect.max.x <= _verticalMidpoint);
+                bool rightQuandrant = (pRect.min.x >= _verticalMidpoint) && (pRect.max.x < _bounds.max.x);
 
                 if ((leftQuadrant || rightQuandrant) == false) {
                     return -1;
@@ -404,12 +659,12 @@ namespace lc {
             /**
             * This if this node overlaps or includes a given area
             */
-            bool includes(const geo::Area& area) const {
+            bool includes(const geo::AABB& area) const {
 
-                if (area.maxP().x() <= _bounds.minP().x() ||
-                    area.minP().x() >= _bounds.maxP().x() ||
-                    area.maxP().y() <= _bounds.minP().y() ||
-                    area.minP().y() >= _bounds.maxP().y()
+                if (area.max.x <= _bounds.min.x ||
+                    area.min.x >= _bounds.max.x ||
+                    area.max.y <= _bounds.min.y ||
+                    area.min.y >= _bounds.max.y
                    ) {
                     return false;
                 } else {
@@ -424,17 +679,19 @@ namespace lc {
             void split() {
                 double subWidth = _bounds.width() / 2.;
                 double subHeight = _bounds.height() / 2.;
-                double x = _bounds.minP().x();
-                double y = _bounds.minP().y();
+                double x = _bounds.min.x;
+                double y = _bounds.min.y;
+                double maxX = _bounds.max.x;
+                double maxY = _bounds.max.y;
 
                 if (_nodes[0] != nullptr) {
                     // // LOG4CXX_DEBUG(logger, "Split is called on a already splitted node, please fix!");
                 } else {
-                    _nodes[0] = new QuadTreeSub(_level + 1, geo::Area(geo::Coordinate(x + subWidth, y + subHeight), geo::Coordinate(_bounds.maxP().x(), _bounds.maxP().y())), _maxLevels, _maxObjects);
-                    _nodes[1] = new QuadTreeSub(_level + 1, geo::Area(geo::Coordinate(x, y + subHeight), geo::Coordinate(x + subWidth, _bounds.maxP().y())), _maxLevels, _maxObjects);
+                    _nodes[0] = new QuadTreeSub(_level + 1, geo::AABB{{x + subWidth, y + subHeight}, {maxX, maxY}}, _maxLevels, _maxObjects);
+                    _nodes[1] = new QuadTreeSub(_level + 1, geo::AABB{{x, y + subHeight}, {x + subWidth, maxY}}, _maxLevels, _maxObjects);
 
-                    _nodes[2] = new QuadTreeSub(_level + 1, geo::Area(geo::Coordinate(x, y), geo::Coordinate(x + subWidth, y + subHeight)), _maxLevels, _maxObjects);
-                    _nodes[3] = new QuadTreeSub(_level + 1, geo::Area(geo::Coordinate(x + subWidth, y), geo::Coordinate(_bounds.maxP().x(), y + subHeight)), _maxLevels, _maxObjects);
+                    _nodes[2] = new QuadTreeSub(_level + 1, geo::AABB{{x, y}, {x + subWidth, y + subHeight}}, _maxLevels, _maxObjects);
+                    _nodes[3] = new QuadTreeSub(_level + 1, geo::AABB{{x + subWidth, y}, {maxX, y + subHeight}}, _maxLevels, _maxObjects);
                 }
 
             }
@@ -442,9 +699,11 @@ namespace lc {
         private:
             const short _level;
             std::vector<E> _objects;
+            // Bounding box of each object, same order as _objects
+            std::vector<geo::AABB> _objectBounds;
             const double _verticalMidpoint;
             const double _horizontalMidpoint;
-            const geo::Area _bounds;
+            const geo::AABB _bounds;
             QuadTreeSub* _nodes[4];
             const unsigned short _maxLevels;
             const unsigned short _maxObjects;
@@ -470,7 +729,7 @@ namespace lc {
         public:
             QuadTree(int level, const geo::Area& pBounds, short maxLevels, short maxObjects) : QuadTreeSub<E>(level, pBounds, maxLevels, maxObjects) {}
             QuadTree(const geo::Area& bounds) : QuadTreeSub<E>(bounds) {}
-            QuadTree(const QuadTree& other) : QuadTreeSub<E>(other), _cadentities(other._cadentities) {}
+            QuadTree(const QuadTree& other) : QuadTreeSub<E>(other), _cadentities(other._cadentities), _placementPosition(0) {}
             QuadTree() : QuadTreeSub<E>(0, geo::Area(geo::Coordinate(0., 0.), geo::Coordinate(1., 1.)), 8, 25) {}
 
             /**
@@ -478,10 +737,55 @@ namespace lc {
              * Clear the quad tree by removing all levels and removing all stored entities
              */
             void clear() {
+                clearPlacement();
                 QuadTreeSub<E>::clear();
                 _cadentities.clear();
             }
 
+            /**
+             * @brief restorePlacement
+             * Restore the layout of a empty tree and the node of the entities inserted next.
+             * The n-th inserted entity is stored directly in the node given by the n-th placement, without
+             * walking down the tree. Entities that don't fit in their node are inserted normally.
+             * @param layout from splitLayout()
+             * @param placement from placement()
+             * @return false if the layout doesn't fit this tree
+             */
+            bool restorePlacement(const std::vector<uint8_t>& layout, const std::vector<uint32_t>& placement) {
+                clearPlacement();
+
+                if (!QuadTreeSub<E>::restoreSplitLayout(layout)) {
+                    return false;
+                }
+
+                if (!placement.empty()) {
+                    this->_nodeList(_placementNodes);
+                    _placement = placement;
+                }
+
+                return true;
+            }
+
+            /**
+             * @brief clearPlacement
+             * Forget the placement given to restorePlacement(), entities are inserted normally again
+             */
+            void clearPlacement() {
+                _placementNodes.clear();
+                _placement.clear();
+                _placementPosition = 0;
+            }
+
+            /**
+             * @brief optimise
+             * @see QuadTreeSub::optimise()
+             */
+            bool optimise() {
+                // Nodes can be removed
+                clearPlacement();
+                return QuadTreeSub<E>::optimise();
+            }
+
             /**
              * @brief insert
              * Insert entity into the quad tree
@@ -497,6 +801,20 @@ namespace lc {
 
                 _cadentities.insert(std::make_pair(entity->id(), entity));
 
+                if (_placementPosition < _placement.size()) {
+                    auto node = _placement[_placementPosition++];
+                    bool placed = node < _placementNodes.size() &&
+                                  _placementNodes[node]->_insertInNode(entity, geo::AABB::fromArea(entity->boundingBox()));
+
+                    if (_placementPosition == _placement.size()) {
+                        clearPlacement();
+                    }
+
+                    if (placed) {
+                        return;
+                    }
+                }
+
                 QuadTreeSub<E>::insert(entity);
             }
 
@@ -530,6 +848,25 @@ namespace lc {
                 return QuadTreeSub<E>::erase(work);
             }
 
+            /**
+             * @brief size
+             * Number of entities stored in the tree, taken from the cache
+             */
+            unsigned int size() const {
+                return _cadentities.size();
+            }
+
+            /**
+             * @brief memorySize
+             * @see QuadTreeSub::memorySize(), with the ID cache of the root
+             */
+            size_t memorySize() const {
+                return QuadTreeSub<E>::memorySize() + sizeof(QuadTree<E>) - sizeof(QuadTreeSub<E>) +
+                       memory::containerSize(_cadentities) +
+                       memory::containerSize(_placementNodes) +
+                       memory::containerSize(_placement);
+            }
+
             const E entityByID(const ID_DATATYPE id) const {
                 if (_cadentities.count(id) > 0) {
                     return _cadentities.at(id);
@@ -543,6 +880,11 @@ namespace lc {
             // This will allow is to quickly lookup a CAD entity from the root
             // SHould we consider using https://github.com/attractivechaos/klib I didn't do integer testing but this lib seems faster
             std::unordered_map<ID_DATATYPE, const E> _cadentities;
+
+            // Set by restorePlacement() and cleared when all entities are placed or the nodes change
+            std::vector<QuadTreeSub<E>*> _placementNodes;
+            std::vector<uint32_t> _placement;
+            size_t _placementPosition = 0;
     };
 
 }
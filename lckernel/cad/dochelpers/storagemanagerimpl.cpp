@@ -1,5 +1,9 @@
 #include "storagemanagerimpl.h"
 
+#include <unordered_set>
+
+#include "cad/primitive/insert.h"
+
 
 
 
@@ -20,6 +24,11 @@ StorageManagerImpl::StorageManagerImpl() : StorageManager() {
 }
 
 void StorageManagerImpl::insertEntity(const entity::CADEntity_CSPtr entity) {
+    if(entity->kind() == entity::EntityKind::Insert) {
+        auto insert = std::static_pointer_cast<const entity::Insert>(entity);
+        _blockInserts[insert->displayBlock()->name()][insert->id()] = entity;
+    }
+
     if(entity->block() != nullptr) {
         auto it = _blocksEntities.find(entity->block()->name());
 
@@ -31,18 +40,77 @@ void StorageManagerImpl::insertEntity(const entity::CADEntity_CSPtr entity) {
         else {
             it->second.insert(entity);
         }
+
+        // The first entity of a block gives its extents, so building a block never needs a recalculation
+        auto& extents = _blocksExtents[entity->block()->name()];
+        if(extents.valid) {
+            extents.box = extents.box.merge(geo::AABB::fromArea(entity->boundingBox()));
+        }
+        else if(it == _blocksEntities.end() || it->second.size() == 1) {
+            extents.box = geo::AABB::fromArea(entity->boundingBox());
+            extents.valid = true;
+        }
+
+        _changedBlocks.insert(entity->block()->name());
     }
     else {
         _entities.insert(entity);
+        _layersEntities[entity->layer()].insert(entity->id());
     }
 }
 
 void StorageManagerImpl::removeEntity(const entity::CADEntity_CSPtr entity) {
-    _entities.remove(entity);
+    if(entity->block() != nullptr) {
+        auto it = _blocksEntities.find(entity->block()->name());
+        if(it == _blocksEntities.end()) {
+            return;
+        }
+
+        // Same as below, the extents must be checked against the stored version
+        auto stored = it->second.entityByID(entity->id());
+        if(stored == nullptr) {
+            return;
+        }
+
+        it->second.remove(stored);
+        removeInsert(stored);
+        _changedBlocks.insert(entity->block()->name());
+
+        // Removing a entity within the extents cannot make them smaller
+        auto& extents = _blocksExtents[entity->block()->name()];
+        auto box = geo::AABB::fromArea(stored->boundingBox());
+        if(extents.valid && !(box.min.x > extents.box.min.x && box.min.y > extents.box.min.y &&
+                              box.max.x < extents.box.max.x && box.max.y < extents.box.max.y)) {
+            extents.valid = false;
+        }
+        return;
+    }
+
+    // The given entity can be a newer version with the same ID, the stored one knows in which layer it was indexed
+    auto stored = _entities.entityByID(entity->id());
+    if(stored == nullptr) {
+        return;
+    }
+
+    _entities.remove(stored);
+    removeInsert(stored);
+
+    auto it = _layersEntities.find(stored->layer());
+    if(it != _layersEntities.end()) {
+        it->second.erase(stored->id());
+
+        if(it->second.empty()) {
+            _layersEntities.erase(it);
+        }
+    }
 }
 
 void StorageManagerImpl::insertEntityContainer(const EntityContainer<entity::CADEntity_CSPtr>& entities) {
     _entities.combine(entities);
+
+    for(const auto& entity : entities.asVector()) {
+        _layersEntities[entity->layer()].insert(entity->id());
+    }
     // TODO add metadata types where they do not exists
 }
 
@@ -51,7 +119,18 @@ entity::CADEntity_CSPtr StorageManagerImpl::entityByID(const ID_DATATYPE id) con
 }
 
 EntityContainer<entity::CADEntity_CSPtr> StorageManagerImpl::entitiesByLayer(const Layer_CSPtr layer) const {
-    return _entities.entitiesByLayer(layer);
+    EntityContainer<entity::CADEntity_CSPtr> container;
+
+    auto it = _layersEntities.find(layer);
+    if(it == _layersEntities.end()) {
+        return container;
+    }
+
+    for(auto id : it->second) {
+        container.insert(_entities.entityByID(id));
+    }
+
+    return container;
 }
 
 Layer_CSPtr StorageManagerImpl::layerByName(const std::string& layerName) const {
@@ -78,13 +157,75 @@ EntityContainer<entity::CADEntity_CSPtr> StorageManagerImpl::entityContainer() c
     return _entities;
 }
 
+std::vector<entity::CADEntity_CSPtr> StorageManagerImpl::entities() const {
+    return _entities.asVector();
+}
+
+const EntityContainer<entity::CADEntity_CSPtr>& StorageManagerImpl::spatialIndex() const {
+    return _entities;
+}
+
+std::vector<uint8_t> StorageManagerImpl::spatialIndexLayout() const {
+    return _entities.splitLayout();
+}
+
+std::vector<uint32_t> StorageManagerImpl::spatialIndexPlacement() const {
+    return _entities.placement();
+}
+
+bool StorageManagerImpl::restoreSpatialIndexLayout(const std::vector<uint8_t>& layout, const std::vector<uint32_t>& placement) {
+    return _entities.restoreSplitLayout(layout, placement);
+}
+
 void StorageManagerImpl::optimise() {
     _entities.optimise();
-    for(auto ec : _blocksEntities) {
+    for(auto& ec : _blocksEntities) {
         ec.second.optimise();
     }
 }
 
+void StorageManagerImpl::memoryUsage(MemoryUsage& usage) const {
+    auto entities = _entities.asVector();
+    for(const auto& ec : _blocksEntities) {
+        auto blockEntities = ec.second.asVector();
+        entities.insert(entities.end(), blockEntities.begin(), blockEntities.end());
+    }
+
+    usage.addEntities("entity.", entities);
+
+    // MetaInfo is usually shared by many entities
+    std::unordered_set<const MetaInfo*> metaInfos;
+    for(const auto& entity : entities) {
+        auto metaInfo = entity->metaInfo();
+
+        if(metaInfo != nullptr && metaInfos.insert(metaInfo.get()).second) {
+            usage.add("metaInfo", sizeof(MetaInfo) + memory::SHARED_CONTROL_BLOCK + memory::containerSize(*metaInfo));
+        }
+    }
+
+    usage.add("metaTypes", memory::containerSize(_documentMetaData), _documentMetaData.size());
+
+    usage.add("index.spatial", _entities.memorySize(), _entities.nodeCount());
+
+    size_t bytes = memory::containerSize(_layersEntities);
+    for(const auto& ids : _layersEntities) {
+        bytes += memory::containerSize(ids.second);
+    }
+    usage.add("index.layers", bytes, _layersEntities.size());
+
+    size_t nodes = 0;
+    bytes = memory::containerSize(_blocksEntities) + memory::containerSize(_blocksExtents) + memory::containerSize(_blockInserts);
+    for(const auto& inserts : _blockInserts) {
+        bytes += memory::containerSize(inserts.second);
+    }
+    nodes = 0;
+    for(const auto& ec : _blocksEntities) {
+        bytes += ec.second.memorySize();
+        nodes += ec.second.nodeCount();
+    }
+    usage.add("index.blocks", bytes, nodes);
+}
+
 
 void StorageManagerImpl::addDocumentMetaType(const DocumentMetaType_CSPtr dmt) {
     _documentMetaData.emplace(std::make_pair(dmt->id(), dmt));
@@ -125,3 +266,93 @@ EntityContainer<entity::CADEntity_CSPtr> StorageManagerImpl::entitiesByBlock(con
         return EntityContainer<entity::CADEntity_CSPtr>();
     }
 }
+
+geo::Area StorageManagerImpl::blockExtents(const Block_CSPtr block) const {
+    auto it = _blocksEntities.find(block->name());
+    if(it == _blocksEntities.end() || it->second.size() == 0) {
+        return geo::Area(block->base(), block->base());
+    }
+
+    auto extents = _blocksExtents.find(block->name());
+    if(extents != _blocksExtents.end() && extents->second.valid) {
+        return extents->second.box.toArea();
+    }
+
+    // Not stored, this is called by other threads reading the document
+    return it->second.boundingBox();
+}
+
+void StorageManagerImpl::updateBlocks() {
+    std::set<std::string> updated;
+
+    while(!_changedBlocks.empty()) {
+        const auto name = *_changedBlocks.begin();
+        _changedBlocks.erase(_changedBlocks.begin());
+
+        // A block inserting itself is updated once
+        if(!updated.insert(name).second) {
+            continue;
+        }
+
+        auto& extents = _blocksExtents[name];
+        auto entities = _blocksEntities.find(name);
+        if(!extents.valid && entities != _blocksEntities.end() && entities->second.size() != 0) {
+            extents.box = geo::AABB::fromArea(entities->second.boundingBox());
+            extents.valid = true;
+        }
+
+        auto inserts = _blockInserts.find(name);
+        if(inserts == _blockInserts.end()) {
+            continue;
+        }
+
+        for(const auto& i : inserts->second) {
+            auto insert = std::static_pointer_cast<const entity::Insert>(i.second);
+
+            // The indexes find their objects through the bounding box, the insert is placed again with the new one
+            std::vector<EntityContainer<entity::CADEntity_CSPtr>*> indexes;
+            if(insert->block() == nullptr) {
+                indexes.push_back(&_entities);
+            }
+            else {
+                auto block = _blocksEntities.find(insert->block()->name());
+                if(block != _blocksEntities.end()) {
+                    indexes.push_back(&block->second);
+                }
+            }
+
+            for(auto index : indexes) {
+                index->remove(i.second);
+            }
+
+            insert->updateBoundingBox();
+
+            for(auto index : indexes) {
+                index->insert(i.second);
+            }
+
+            // The extents of the block containing the insert depend on it
+            if(insert->block() != nullptr) {
+                _blocksExtents[insert->block()->name()].valid = false;
+                _changedBlocks.insert(insert->block()->name());
+            }
+        }
+    }
+}
+
+void StorageManagerImpl::removeInsert(const entity::CADEntity_CSPtr& entity) {
+    if(entity->kind() != entity::EntityKind::Insert) {
+        return;
+    }
+
+    auto insert = std::static_pointer_cast<const entity::Insert>(entity);
+    auto it = _blockInserts.find(insert->displayBlock()->name());
+    if(it == _blockInserts.end()) {
+        return;
+    }
+
+    it->second.erase(insert->id());
+    if(it->second.empty()) {
+        _blockInserts.erase(it);
+    }
+}
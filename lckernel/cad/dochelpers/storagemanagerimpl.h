@@ -10,11 +10,16 @@
 #include "cad/events/replacelayerevent.h"
 #include "cad/events/removeentityevent.h"
 #include "entitycontainer.h"
+#include "cad/geometry/geoaabb.h"
 
 #include "cad/events/replaceentityevent.h"
 #include "cad/meta/dxflinepattern.h"
 #include "cad/functions/string_helper.h"
 
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+
 namespace lc {
     /**
      * A default storage manager for document's.
@@ -58,9 +63,10 @@ namespace lc {
 
             /**
              * @brief Returns entities By Layer
+             * The IDs of the entities of each layer are maintained during insert and remove, the entities
+             * are looked up in the main container. The cost depends on the number of entities on the layer only.
              * @param layer
              * @return EntityContainer<entity::CADEntity_CSPtr> entities on layer
-             * @Deprecated use entityContainer()->entitiesByLayer()
              */
             virtual lc::EntityContainer<entity::CADEntity_CSPtr> entitiesByLayer(const Layer_CSPtr layer) const override;
 
@@ -90,6 +96,20 @@ namespace lc {
              */
             virtual lc::EntityContainer<entity::CADEntity_CSPtr> entityContainer() const override;
 
+            /**
+             * @brief returns all entities
+             * @return std::vector<entity::CADEntity_CSPtr>
+             */
+            virtual std::vector<entity::CADEntity_CSPtr> entities() const override;
+
+            virtual const EntityContainer<entity::CADEntity_CSPtr>& spatialIndex() const override;
+
+            virtual std::vector<uint8_t> spatialIndexLayout() const override;
+
+            virtual std::vector<uint32_t> spatialIndexPlacement() const override;
+
+            virtual bool restoreSpatialIndexLayout(const std::vector<uint8_t>& layout, const std::vector<uint32_t>& placement) override;
+
             /**
             *  \brief add a document meta type
             *  \param layer layer to be added.
@@ -111,19 +131,52 @@ namespace lc {
 
             lc::EntityContainer<entity::CADEntity_CSPtr> entitiesByBlock(const Block_CSPtr block) const override;
 
+            /**
+             * @brief Returns the extents of a block
+             * The extents are extended when entities are added to the block. When a entity on the border
+             * of the block was removed they are calculated on each call until updateBlocks() stores them.
+             * @param block
+             * @return geo::Area
+             */
+            geo::Area blockExtents(const Block_CSPtr block) const override;
+
+            /**
+             * @brief Update the blocks changed since the last call
+             * Each insert of a changed block is updated once and placed again in the indexes containing it.
+             * Inserts within blocks update the extents of their own block too.
+             */
+            virtual void updateBlocks() override;
+
             /**
              * @brief optimise the quadtree
              */
             virtual void optimise() override;
 
+            virtual void memoryUsage(MemoryUsage& usage) const override;
+
 
     private:
+            struct BlockExtents {
+                geo::AABB box;
+                bool valid = false;
+            };
+
             virtual DocumentMetaType_CSPtr _metaDataTypeByName(const std::string id) const override;
 
+            // Forget a stored insert, when the entity is one
+            void removeInsert(const entity::CADEntity_CSPtr& entity);
+
     private:
 
             EntityContainer<entity::CADEntity_CSPtr> _entities;
+            // IDs of the entities of _entities by layer, only layers which contain entities are present
+            std::unordered_map<Layer_CSPtr, std::unordered_set<ID_DATATYPE>> _layersEntities;
             std::map<std::string, DocumentMetaType_CSPtr, StringHelper::cmpCaseInsensetive> _documentMetaData;
             std::map<std::string, lc::EntityContainer<entity::CADEntity_CSPtr>> _blocksEntities;
+            std::map<std::string, BlockExtents> _blocksExtents;
+            // Inserts by the name of the block they display
+            std::map<std::string, std::unordered_map<ID_DATATYPE, entity::CADEntity_CSPtr>> _blockInserts;
+            // Blocks which entities changed since the last updateBlocks()
+            std::set<std::string> _changedBlocks;
     };
 }
@@ -71,3 +71,20 @@ void UndoManagerImpl::removeUndoables() {
         _reDoables.pop();
     }
 }
+
+MemoryUsage UndoManagerImpl::memoryUsage() const {
+    MemoryUsage usage;
+
+    for (const auto& undoable : _unDoables) {
+        undoable->memoryUsage(usage);
+    }
+
+    // A stack can't be iterated, only the pointers are copied
+    auto reDoables = _reDoables;
+    while (!reDoables.empty()) {
+        reDoables.top()->memoryUsage(usage);
+        reDoables.pop();
+    }
+
+    return usage;
+}
@@ -61,6 +61,12 @@ namespace lc {
              */
             virtual void removeUndoables();
 
+            /*!
+             * \brief Memory used by the operations in the undo and redo stacks
+             * \return undo.operations and undo.entities.<kind> categories
+             */
+            virtual MemoryUsage memoryUsage() const;
+
         private:
             std::vector<operation::Undoable_SPtr> _unDoables; /*!< Undo list */
             std::stack<operation::Undoable_SPtr> _reDoables; /*!< Redo stack */
@@ -185,6 +185,13 @@ namespace lc {
              */
             virtual EntityContainer<entity::CADEntity_CSPtr> entitiesByBlock(const Block_CSPtr block) = 0;
 
+            /**
+             * @brief Bounding box of the entities in a given block, in block coordinates
+             * @param block
+             * @return geo::Area
+             */
+            virtual geo::Area blockExtents(const Block_CSPtr block) = 0;
+
             /**
              * @brief entityContainer
              * Return a copy of all entities within the document
@@ -192,6 +199,53 @@ namespace lc {
              */
             virtual EntityContainer<entity::CADEntity_CSPtr> entityContainer() = 0;
 
+            /**
+             * @brief entities
+             * Return all entities within the document. Unlike entityContainer() this doesn't copy
+             * the spatial index, use it when all entities are visited once, for example when saving.
+             * @return entities in the order of the spatial index
+             */
+            virtual std::vector<entity::CADEntity_CSPtr> entities() = 0;
+
+            /**
+             * @brief spatialIndex
+             * Spatial index of the model space entities, shared with viewers so each change updates a single index.
+             * The reference stays valid as long as the document exists. It is not locked, use it from the thread
+             * that changes the document.
+             * @return model space entities
+             */
+            virtual const EntityContainer<entity::CADEntity_CSPtr>& spatialIndex() = 0;
+
+            /**
+             * @brief Shape of the spatial index of the document
+             * File formats can store it to restore the index when opening the file again
+             * @return layout
+             */
+            virtual std::vector<uint8_t> spatialIndexLayout() = 0;
+
+            /**
+             * @brief Node of each entity in the spatial index, in order of entity ID
+             * Stored with the layout, entities can be placed directly in their node when inserted again in the same order
+             * @return placement
+             */
+            virtual std::vector<uint32_t> spatialIndexPlacement() = 0;
+
+            /**
+             * @brief Restore the shape of the spatial index
+             * Call it on a empty document, before the entities are inserted
+             * @param layout from spatialIndexLayout()
+             * @param placement from spatialIndexPlacement(), can be empty
+             * @return true if the layout was restored
+             */
+            virtual bool restoreSpatialIndexLayout(const std::vector<uint8_t>& layout, const std::vector<uint32_t>& placement = std::vector<uint32_t>()) = 0;
+
+            /**
+             * @brief Memory used by the entities, meta types and indexes of the document
+             * The undo history and the viewers report their own usage, merge them for a complete report.
+             * @return bytes and number of objects per category
+             */
+            virtual MemoryUsage memoryUsage() = 0;
+
 
             /**
              * @brief Returns all layers
@@ -229,6 +283,12 @@ namespace lc {
             friend class lc::operation::DocumentOperation;
 
         private:
+            /**
+             * @brief entitiesByLayer without locking the document
+             * For operations, they run while the document is locked
+             */
+            virtual EntityContainer<entity::CADEntity_CSPtr> _entitiesByLayer(const Layer_CSPtr layer) = 0;
+
             Nano::Signal<void(const lc::BeginProcessEvent&)>  _beginProcessEvent;
             Nano::Signal<void(const lc::CommitProcessEvent&)>  _commitProcessEvent;
 
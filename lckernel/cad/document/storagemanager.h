@@ -4,6 +4,7 @@
 #include "cad/base/cadentity.h"
 #include "cad/meta/layer.h"
 #include "cad/dochelpers/entitycontainer.h"
+#include "cad/dochelpers/memoryusage.h"
 #include <cad/functions/string_helper.h>
 #include <map>
 #include <cad/meta/dxflinepattern.h>
@@ -23,6 +24,14 @@ namespace lc {
 
             virtual EntityContainer<entity::CADEntity_CSPtr> entitiesByBlock(const Block_CSPtr block) const = 0;
 
+            /*!
+             * \brief blockExtents
+             * Return the bounding box of all entities within a block, in block coordinates
+             * \param block
+             * \return extents, or a area at the base point of the block when it's empty
+             */
+            virtual geo::Area blockExtents(const Block_CSPtr block) const = 0;
+
             /*!
              * \brief layer
              * Return a single document layer
@@ -51,6 +60,39 @@ namespace lc {
              */
             virtual EntityContainer<entity::CADEntity_CSPtr> entityContainer() const = 0;
 
+            /*!
+             * \brief entities
+             * return all entities managed within the storage manager, without copying the spatial index
+             * \return entities in the order of the spatial index
+             */
+            virtual std::vector<entity::CADEntity_CSPtr> entities() const = 0;
+
+            /*!
+             * \brief spatialIndex
+             * Model space entities and their spatial index, without copying them
+             */
+            virtual const EntityContainer<entity::CADEntity_CSPtr>& spatialIndex() const = 0;
+
+            /*!
+             * \brief spatialIndexLayout
+             * Shape of the spatial index, to be stored with the entities
+             */
+            virtual std::vector<uint8_t> spatialIndexLayout() const = 0;
+
+            /*!
+             * \brief spatialIndexPlacement
+             * Node of each entity in the spatial index, in order of entity ID
+             */
+            virtual std::vector<uint32_t> spatialIndexPlacement() const = 0;
+
+            /*!
+             * \brief restoreSpatialIndexLayout
+             * Restore the shape of the spatial index before the entities are inserted
+             * \param placement optional node of each entity, in order of insertion
+             * \return false when the storage is not empty or the layout doesn't fit
+             */
+            virtual bool restoreSpatialIndexLayout(const std::vector<uint8_t>& layout, const std::vector<uint32_t>& placement) = 0;
+
             /**
             *  \brief add a document meta type
             *  \param layer layer to be added.
@@ -70,12 +112,26 @@ namespace lc {
 
             virtual std::map<std::string, DocumentMetaType_CSPtr, lc::StringHelper::cmpCaseInsensetive> allMetaTypes() const = 0;
 
+            /**
+             * @brief updateBlocks
+             * Recalculate the extents of the blocks changed since the last call and the bounding boxes
+             * of the inserts which display them. Run this once at the end of each operation.
+             */
+            virtual void updateBlocks() = 0;
+
             /**
              * @brief optimise
              * the underlaying data store. Run this at a regular base, for example after each task
              */
             virtual void optimise() = 0;
 
+            /**
+             * @brief memoryUsage
+             * Add the memory used by the entities, meta types and indexes
+             * @param usage filled with the entity.<kind>, metaInfo, metaTypes and index.* categories
+             */
+            virtual void memoryUsage(MemoryUsage& usage) const = 0;
+
 
             template <typename T>
             const std::shared_ptr<const T> metaDataTypeByName(const std::string & name) const {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "cad/const.h"
+#include "cad/dochelpers/memoryusage.h"
 
 namespace lc {
     /**
@@ -29,6 +30,11 @@ namespace lc {
              */
             virtual void removeUndoables() = 0;
 
+            /*!
+             * \brief Memory used by the undo and redo stacks
+             */
+            virtual MemoryUsage memoryUsage() const = 0;
+
     };
 
     DECLARE_SHORT_SHARED_PTR(UndoManager)
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+#include "geoarea.h"
+#include "geocoordinate.h"
+
+namespace lc {
+    namespace geo {
+        /**
+         * @brief Compact 2D point
+         * Plain data (no vptr, no z) used where many points or boxes are stored.
+         * Use geo::Coordinate in the public API and convert at the boundaries.
+         */
+        struct Point2D {
+            double x;
+            double y;
+
+            static inline Point2D fromCoordinate(const Coordinate& coordinate) {
+                return Point2D{coordinate.x(), coordinate.y()};
+            }
+
+            inline Coordinate toCoordinate() const {
+                return Coordinate(x, y);
+            }
+        };
+
+        /**
+         * @brief Axis aligned bounding box
+         * Plain data counterpart of geo::Area, used internally by the quad tree and entities caching
+         * their bounding box. Storing them in contiguous arrays allows the compiler to vectorize bounding box tests.
+         */
+        struct AABB {
+            Point2D min;
+            Point2D max;
+
+            static inline AABB fromArea(const Area& area) {
+                return AABB{Point2D::fromCoordinate(area.minP()), Point2D::fromCoordinate(area.maxP())};
+            }
+
+            static inline AABB fromPoints(const Coordinate& a, const Coordinate& b) {
+                return AABB{
+                    Point2D{std::min(a.x(), b.x()), std::min(a.y(), b.y())},
+                    Point2D{std::max(a.x(), b.x()), std::max(a.y(), b.y())}
+                };
+            }
+
+            inline Area toArea() const {
+                return Area(min.toCoordinate(), max.toCoordinate());
+            }
+
+            inline double width() const {
+                return max.x - min.x;
+            }
+
+            inline double height() const {
+                return max.y - min.y;
+            }
+
+            /**
+             * @brief Same as Area::inArea(const Area&), true if this box fits fully in other
+             */
+            inline bool inArea(const AABB& other) const {
+                return min.x >= other.min.x && min.y >= other.min.y && max.x <= other.max.x && max.y <= other.max.y;
+            }
+
+            /**
+             * @brief Same as Area::overlaps(), touching boxes overlap
+             */
+            inline bool overlaps(const AABB& other) const {
+                return !(other.max.x < min.x || other.min.x > max.x || other.max.y < min.y || other.min.y > max.y);
+            }
+
+            /**
+             * @brief Same as Area::merge()
+             */
+            inline AABB merge(const AABB& other) const {
+                return AABB{
+                    Point2D{std::min(min.x, other.min.x), std::min(min.y, other.min.y)},
+                    Point2D{std::max(max.x, other.max.x), std::max(max.y, other.max.y)}
+                };
+            }
+        };
+    }
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <algorithm>
+#include <vector>
+
 #include "cad/const.h"
 
 #include "geocoordinate.h"
@@ -190,6 +193,48 @@ namespace lc {
                     return ret;
                 }
 
+                /**
+                 * @brief difference
+                 * parts of this area which are not in other, as at most 4 non overlapping area's
+                 * The parts include their edges, they can touch other.
+                 * @param other
+                 * @return empty when this area fits in other
+                 */
+                inline std::vector<Area> difference(const Area& other) const {
+                    std::vector<Area> parts;
+
+                    if (!overlaps(other)) {
+                        parts.push_back(*this);
+                        return parts;
+                    }
+
+                    const double minY = std::max(_minP.y(), other._minP.y());
+                    const double maxY = std::min(_maxP.y(), other._maxP.y());
+
+                    // Full height strips left and right of other
+                    if (_minP.x() < other._minP.x()) {
+                        parts.push_back(Area(_minP, Coordinate(other._minP.x(), _maxP.y())));
+                    }
+
+                    if (_maxP.x() > other._maxP.x()) {
+                        parts.push_back(Area(Coordinate(other._maxP.x(), _minP.y()), _maxP));
+                    }
+
+                    // Strips below and above other, between the left and right strip
+                    const double minX = std::max(_minP.x(), other._minP.x());
+                    const double maxX = std::min(_maxP.x(), other._maxP.x());
+
+                    if (_minP.y() < minY) {
+                        parts.push_back(Area(Coordinate(minX, _minP.y()), Coordinate(maxX, minY)));
+                    }
+
+                    if (_maxP.y() > maxY) {
+                        parts.push_back(Area(Coordinate(minX, maxY), Coordinate(maxX, _maxP.y())));
+                    }
+
+                    return parts;
+                }
+
                 /**
                  * @brief top
                  * vector of this area
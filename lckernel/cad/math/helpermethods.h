@@ -5,6 +5,8 @@
 #pragma once
 
 #include <cad/geometry/geocoordinate.h>
+#include <cad/math/transform2d.h>
+#include <type_traits>
 #include <vector>
 
 #include <Eigen/Core>
@@ -25,15 +27,8 @@ namespace lc {
                                           double yy,
                                           double x0,
                                           double y0) {
-            // TODO
-            // you can transform all points at once, essentially by using a Eigen::Map<const Eigen::Matrix<double, 2, Eigen::Dynamic> >,
-            // initialized with the address of the first coordinate of the first element of the vector
-
-            std::vector<T> out;
-            for (auto c : in) {
-                out.emplace_back(c.transform2d(xx, yx, xy, yy, x0, y0));
-            }
-            return out;
+            static_assert(std::is_same<T, geo::Coordinate>::value, "transform2d is only implemented for geo::Coordinate");
+            return geo::Transform2D(xx, yx, xy, yy, x0, y0).apply(in);
         }
 
     };
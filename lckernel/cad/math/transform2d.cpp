@@ -0,0 +1,149 @@
+#include "transform2d.h"
+
+#include <cmath>
+#include <type_traits>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace lc;
+using namespace geo;
+
+static_assert(std::is_standard_layout<Coordinate>::value && sizeof(Coordinate) == 3 * sizeof(double),
+              "Transform2D::apply expects Coordinate to be stored as x, y, z");
+
+Transform2D::Transform2D(double xx, double yx, double xy, double yy, double x0, double y0) :
+    _xx(xx),
+    _yx(yx),
+    _xy(xy),
+    _yy(yy),
+    _x0(x0),
+    _y0(y0) {
+}
+
+Transform2D Transform2D::identity() {
+    return Transform2D(1., 0., 0., 1., 0., 0.);
+}
+
+Transform2D Transform2D::translation(const Coordinate& offset) {
+    return Transform2D(1., 0., 0., 1., offset.x(), offset.y());
+}
+
+Transform2D Transform2D::rotation(const Coordinate& center, double angle) {
+    double c = std::cos(angle);
+    double s = std::sin(angle);
+
+    return Transform2D(c, s, -s, c,
+                       center.x() - c * center.x() + s * center.y(),
+                       center.y() - s * center.x() - c * center.y());
+}
+
+Transform2D Transform2D::scale(const Coordinate& center, const Coordinate& factor) {
+    return Transform2D(factor.x(), 0., 0., factor.y(),
+                       center.x() - factor.x() * center.x(),
+                       center.y() - factor.y() * center.y());
+}
+
+Transform2D Transform2D::mirror(const Coordinate& axis1, const Coordinate& axis2) {
+    // Reflection over the line through axis1 with direction d: p' = 2 * proj(p) - p
+    double dx = axis2.x() - axis1.x();
+    double dy = axis2.y() - axis1.y();
+    double a = dx * dx + dy * dy;
+
+    double xx = (dx * dx - dy * dy) / a;
+    double xy = 2. * dx * dy / a;
+    double yy = -xx;
+
+    return Transform2D(xx, xy, xy, yy,
+                       axis1.x() - xx * axis1.x() - xy * axis1.y(),
+                       axis1.y() - xy * axis1.x() - yy * axis1.y());
+}
+
+Transform2D Transform2D::operator * (const Transform2D& o) const {
+    return Transform2D(_xx * o._xx + _xy * o._yx,
+                       _yx * o._xx + _yy * o._yx,
+                       _xx * o._xy + _xy * o._yy,
+                       _yx * o._xy + _yy * o._yy,
+                       _xx * o._x0 + _xy * o._y0 + _x0,
+                       _yx * o._x0 + _yy * o._y0 + _y0);
+}
+
+std::vector<Coordinate> Transform2D::apply(const std::vector<Coordinate>& in) const {
+    // Copy first so z is kept, then transform x and y in place
+    std::vector<Coordinate> out(in);
+
+    if (!out.empty()) {
+        auto data = reinterpret_cast<double*>(out.data());
+        apply(data, data, out.size(), 3);
+    }
+
+    return out;
+}
+
+void Transform2D::apply(const double* in, double* out, size_t count, size_t stride) const {
+#ifdef __SSE2__
+    // Each point is one register: [x', y'] = x * [xx, yx] + y * [xy, yy] + [x0, y0]
+    const __m128d col0 = _mm_set_pd(_yx, _xx);
+    const __m128d col1 = _mm_set_pd(_yy, _xy);
+    const __m128d translation = _mm_set_pd(_y0, _x0);
+
+    size_t i = 0;
+
+    // Two points per iteration to hide the latency of the multiplications
+    for (; i + 1 < count; i += 2) {
+        const double* p0 = in + i * stride;
+        const double* p1 = p0 + stride;
+
+        __m128d r0 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(_mm_set1_pd(p0[0]), col0),
+                                           _mm_mul_pd(_mm_set1_pd(p0[1]), col1)),
+                                translation);
+        __m128d r1 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(_mm_set1_pd(p1[0]), col0),
+                                           _mm_mul_pd(_mm_set1_pd(p1[1]), col1)),
+                                translation);
+
+        _mm_storeu_pd(out + i * stride, r0);
+        _mm_storeu_pd(out + (i + 1) * stride, r1);
+    }
+
+    if (i < count) {
+        const double* p = in + i * stride;
+        __m128d r = _mm_add_pd(_mm_add_pd(_mm_mul_pd(_mm_set1_pd(p[0]), col0),
+                                          _mm_mul_pd(_mm_set1_pd(p[1]), col1)),
+                               translation);
+        _mm_storeu_pd(out + i * stride, r);
+    }
+#else
+    for (size_t i = 0; i < count; i++) {
+        const double x = in[i * stride];
+        const double y = in[i * stride + 1];
+
+        out[i * stride] = _xx * x + _xy * y + _x0;
+        out[i * stride + 1] = _yx * x + _yy * y + _y0;
+    }
+#endif
+}
+
+double Transform2D::xx() const {
+    return _xx;
+}
+
+double Transform2D::yx() const {
+    return _yx;
+}
+
+double Transform2D::xy() const {
+    return _xy;
+}
+
+double Transform2D::yy() const {
+    return _yy;
+}
+
+double Transform2D::x0() const {
+    return _x0;
+}
+
+double Transform2D::y0() const {
+    return _y0;
+}
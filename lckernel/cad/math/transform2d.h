@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cad/geometry/geocoordinate.h>
+#include <cstddef>
+#include <vector>
+
+namespace lc {
+    namespace geo {
+        /**
+         * @brief Affine 2D transformation
+         * x' = xx * x + xy * y + x0
+         * y' = yx * x + yy * y + y0
+         * z is left untouched.
+         *
+         * Entities transforming many points (splines, polylines) should build one Transform2D
+         * and apply it on all points at once, instead of calling Coordinate::rotate() and friends
+         * for each point, which recompute the same sin/cos and offsets every time.
+         */
+        class Transform2D {
+            public:
+                Transform2D(double xx, double yx, double xy, double yy, double x0, double y0);
+
+                static Transform2D identity();
+                static Transform2D translation(const Coordinate& offset);
+                static Transform2D rotation(const Coordinate& center, double angle);
+                static Transform2D scale(const Coordinate& center, const Coordinate& factor);
+                static Transform2D mirror(const Coordinate& axis1, const Coordinate& axis2);
+
+                /**
+                 * @brief Combine two transformations
+                 * @return transformation applying other first, then this
+                 */
+                Transform2D operator * (const Transform2D& other) const;
+
+                inline Coordinate apply(const Coordinate& c) const {
+                    return Coordinate(_xx * c.x() + _xy * c.y() + _x0, _yx * c.x() + _yy * c.y() + _y0, c.z());
+                }
+
+                /**
+                 * @brief Transform a vector of coordinates
+                 * Uses a SSE2 kernel when available
+                 */
+                std::vector<Coordinate> apply(const std::vector<Coordinate>& in) const;
+
+                /**
+                 * @brief Transform count points stored as x,y pairs
+                 * in and out may point to the same memory.
+                 * @param in first x of the input
+                 * @param out first x of the output
+                 * @param count number of points
+                 * @param stride number of doubles between two points, 2 for packed x,y arrays, 3 for x,y,z
+                 */
+                void apply(const double* in, double* out, size_t count, size_t stride = 2) const;
+
+                double xx() const;
+                double yx() const;
+                double xy() const;
+                double yy() const;
+                double x0() const;
+                double y0() const;
+
+            private:
+                double _xx;
+                double _yx;
+                double _xy;
+                double _yy;
+                double _x0;
+                double _y0;
+        };
+    }
+}
@@ -32,4 +32,12 @@ void Builder::processInternal() {
     for(auto operation : _operations) {
         operation->processInternal();
     }
-}
\ No newline at end of file
+}
+void Builder::memoryUsage(MemoryUsage& usage) const {
+    Undoable::memoryUsage(usage);
+    usage.add("undo.operations", sizeof(*this) - sizeof(Undoable) + memory::containerSize(_operations), 0);
+
+    for(const auto& operation : _operations) {
+        operation->memoryUsage(usage);
+    }
+}
@@ -24,6 +24,8 @@ namespace lc {
                 virtual void undo() const override;
                 virtual void redo() const override;
 
+                virtual void memoryUsage(MemoryUsage& usage) const override;
+
             protected:
                 virtual void processInternal() override;
 
@@ -17,6 +17,10 @@ void DocumentOperation::process() {
     processInternal();
 }
 
+EntityContainer<entity::CADEntity_CSPtr> DocumentOperation::entitiesByLayer(const Layer_CSPtr layer) const {
+    return _document->_entitiesByLayer(layer);
+}
+
 void DocumentOperation::execute() {
     _document->execute(shared_from_this());
 }
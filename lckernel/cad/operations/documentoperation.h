@@ -60,6 +60,11 @@ namespace lc {
                  */
                 virtual void processInternal() = 0;
 
+                /**
+                 * @brief Entities on a layer, for processInternal() which can't lock the document again
+                 */
+                EntityContainer<entity::CADEntity_CSPtr> entitiesByLayer(const Layer_CSPtr layer) const;
+
         };
 
         DECLARE_SHORT_SHARED_PTR(DocumentOperation)
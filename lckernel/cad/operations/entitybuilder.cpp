@@ -1,6 +1,11 @@
 #include "entitybuilder.h"
 #include "cad/document/document.h"
+#include "cad/base/entitypool.h"
+#include "cad/primitive/arc.h"
+#include "cad/primitive/circle.h"
+#include "cad/primitive/line.h"
 #include <memory>
+#include <stdexcept>
 
 using namespace lc;
 using namespace operation;
@@ -14,6 +19,58 @@ EntityBuilder* EntityBuilder::appendEntity(entity::CADEntity_CSPtr cadEntity) {
     return this;
 }
 
+EntityBuilder* EntityBuilder::appendLines(const std::vector<double>& coordinates, const Layer_CSPtr layer,
+                                          const MetaInfo_CSPtr metaInfo, const Block_CSPtr block) {
+    if (coordinates.size() % 4 != 0) {
+        throw std::runtime_error("The number of values must be a multiple of 4");
+    }
+
+    _workingBuffer.reserve(_workingBuffer.size() + coordinates.size() / 4);
+    for (size_t i = 0; i < coordinates.size(); i += 4) {
+        _workingBuffer.push_back(lc::pool::makeShared<const entity::Line>(
+                geo::Coordinate(coordinates[i], coordinates[i + 1]),
+                geo::Coordinate(coordinates[i + 2], coordinates[i + 3]),
+                layer, metaInfo, block
+        ));
+    }
+
+    return this;
+}
+
+EntityBuilder* EntityBuilder::appendCircles(const std::vector<double>& values, const Layer_CSPtr layer,
+                                            const MetaInfo_CSPtr metaInfo, const Block_CSPtr block) {
+    if (values.size() % 3 != 0) {
+        throw std::runtime_error("The number of values must be a multiple of 3");
+    }
+
+    _workingBuffer.reserve(_workingBuffer.size() + values.size() / 3);
+    for (size_t i = 0; i < values.size(); i += 3) {
+        _workingBuffer.push_back(lc::pool::makeShared<const entity::Circle>(
+                geo::Coordinate(values[i], values[i + 1]), values[i + 2],
+                layer, metaInfo, block
+        ));
+    }
+
+    return this;
+}
+
+EntityBuilder* EntityBuilder::appendArcs(const std::vector<double>& values, bool CCW, const Layer_CSPtr layer,
+                                         const MetaInfo_CSPtr metaInfo, const Block_CSPtr block) {
+    if (values.size() % 5 != 0) {
+        throw std::runtime_error("The number of values must be a multiple of 5");
+    }
+
+    _workingBuffer.reserve(_workingBuffer.size() + values.size() / 5);
+    for (size_t i = 0; i < values.size(); i += 5) {
+        _workingBuffer.push_back(lc::pool::makeShared<const entity::Arc>(
+                geo::Coordinate(values[i], values[i + 1]), values[i + 2], values[i + 3], values[i + 4], CCW,
+                layer, metaInfo, block
+        ));
+    }
+
+    return this;
+}
+
 EntityBuilder* EntityBuilder::appendOperation(Base_SPtr operation) {
     _stack.push_back(operation);
     return this;
@@ -74,10 +131,24 @@ void EntityBuilder::processStack() {
     for (auto it = _stack.begin(); it != _stack.end(); ++it) {
         // Get looping stack, we currently support only one single loop!!
         std::vector<Base_SPtr> stack(_stack.begin(), it);
-        entitySet = (*it)->process(document(), entitySet, _workingBuffer, _entitiesThatNeedsRemoval, stack);
+        entitySet = (*it)->process(document(), std::move(entitySet), _workingBuffer, _entitiesThatNeedsRemoval, stack);
     }
 
     _stack.clear();
 
-    _workingBuffer.insert(_workingBuffer.end(), entitySet.begin(), entitySet.end());
-}
\ No newline at end of file
+    _workingBuffer.insert(_workingBuffer.end(),
+                          std::make_move_iterator(entitySet.begin()),
+                          std::make_move_iterator(entitySet.end()));
+}
+void EntityBuilder::memoryUsage(MemoryUsage& usage) const {
+    Undoable::memoryUsage(usage);
+    usage.add("undo.operations", sizeof(*this) - sizeof(Undoable) +
+                                 memory::containerSize(_stack) +
+                                 memory::containerSize(_workingBuffer) +
+                                 memory::containerSize(_entitiesThatWhereUpdated) +
+                                 memory::containerSize(_entitiesThatNeedsRemoval), 0);
+
+    // Previous versions of updated entities and removed entities are no longer in the document
+    usage.addEntities("undo.entities.", _entitiesThatWhereUpdated);
+    usage.addEntities("undo.entities.", _entitiesThatNeedsRemoval);
+}
@@ -29,6 +29,42 @@ namespace lc {
                  */
                 EntityBuilder* appendEntity(entity::CADEntity_CSPtr cadEntity);
 
+                /**
+                 * @brief Append lines given as a flat list of values
+                 * Each line takes 4 values: start x, start y, end x and end y.
+                 * Used by scripts to create many entities in a single call.
+                 * @param coordinates number of values must be a multiple of 4
+                 * @param layer layer, meta info and block are shared by all lines
+                 * @return EntityBuilder
+                 * @throw std::runtime_error when the number of values is wrong
+                 */
+                EntityBuilder* appendLines(const std::vector<double>& coordinates,
+                                           const Layer_CSPtr layer,
+                                           const MetaInfo_CSPtr metaInfo = nullptr,
+                                           const Block_CSPtr block = nullptr);
+
+                /**
+                 * @brief Append circles given as a flat list of values
+                 * Each circle takes 3 values: center x, center y and radius.
+                 * @see appendLines()
+                 */
+                EntityBuilder* appendCircles(const std::vector<double>& values,
+                                             const Layer_CSPtr layer,
+                                             const MetaInfo_CSPtr metaInfo = nullptr,
+                                             const Block_CSPtr block = nullptr);
+
+                /**
+                 * @brief Append arcs given as a flat list of values
+                 * Each arc takes 5 values: center x, center y, radius, start angle and end angle.
+                 * @param CCW direction of all arcs
+                 * @see appendLines()
+                 */
+                EntityBuilder* appendArcs(const std::vector<double>& values,
+                                          bool CCW,
+                                          const Layer_CSPtr layer,
+                                          const MetaInfo_CSPtr metaInfo = nullptr,
+                                          const Block_CSPtr block = nullptr);
+
                 /**
                  * @brief Append operation to the stack
                  * @param operation
@@ -45,6 +81,11 @@ namespace lc {
                  */
                 void processStack();
 
+                /**
+                 * @brief Add the entity lists and the removed entities, which are only kept by this operation
+                 */
+                virtual void memoryUsage(MemoryUsage& usage) const override;
+
             protected:
                 virtual void processInternal();
 
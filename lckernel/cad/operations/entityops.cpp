@@ -2,21 +2,108 @@
 #include "cad/document/document.h"
 
 #include "cad/document/storagemanager.h"
+#include "cad/base/threadpool.h"
+#include "cad/primitive/insert.h"
+#include "cad/primitive/line.h"
+
+#include <algorithm>
+
 using namespace lc;
 using namespace lc::operation;
 
+namespace {
+    /**
+     * Call apply on ranges of the entities, on the kernel ThreadPool when possible
+     */
+    void forEachChunk(const std::vector<entity::CADEntity_CSPtr>& entities,
+                      const std::function<void(size_t, size_t)>& apply) {
+        // Inserts connect to the document events when they are created, this can't be done from multiple threads
+        bool threadSafe = std::none_of(entities.begin(), entities.end(), [](const entity::CADEntity_CSPtr& entity) {
+            // Custom entities are inserts too
+            auto kind = entity->kind();
+            return kind == entity::EntityKind::Insert || kind == entity::EntityKind::CustomEntity;
+        });
+
+        if (threadSafe) {
+            // Each chunk writes in its own range, so the result order doesn't depend on scheduling
+            ThreadPool::instance().parallelFor(entities.size(), apply);
+        }
+        else {
+            apply(0, entities.size());
+        }
+    }
+}
+
 /********************************************************************************************************/
 /** Base                                                                                              ***/
 /********************************************************************************************************/
+std::vector<entity::CADEntity_CSPtr> Base::transform(
+    const std::vector<entity::CADEntity_CSPtr>& entities,
+    const std::function<entity::CADEntity_CSPtr(const entity::CADEntity_CSPtr&)>& func) {
+    std::vector<entity::CADEntity_CSPtr> newQueue(entities.size());
+
+    forEachChunk(entities, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            newQueue[i] = func(entities[i]);
+        }
+    });
+
+    return newQueue;
+}
+
+std::vector<entity::CADEntity_CSPtr> Base::transform(
+    const std::vector<entity::CADEntity_CSPtr>& entities,
+    const geo::Transform2D& matrix,
+    const std::function<entity::CADEntity_CSPtr(const entity::CADEntity_CSPtr&)>& func) {
+    std::vector<entity::CADEntity_CSPtr> newQueue(entities.size());
+
+    forEachChunk(entities, [&](size_t begin, size_t end) {
+        std::vector<size_t> lines;
+        std::vector<geo::Coordinate> points;
+        lines.reserve(end - begin);
+        points.reserve((end - begin) * 2);
+
+        for (size_t i = begin; i < end; i++) {
+            const auto& entity = entities[i];
+
+            if (entity->kind() == entity::EntityKind::Line) {
+                const auto& line = static_cast<const entity::Line&>(*entity);
+                lines.push_back(i);
+                points.push_back(line.start());
+                points.push_back(line.end());
+            }
+            else {
+                newQueue[i] = func(entity);
+            }
+        }
+
+        if (lines.empty()) {
+            return;
+        }
+
+        // Start and end point of each line, one call of the kernel for the whole chunk
+        auto transformed = matrix.apply(points);
+        for (size_t j = 0; j < lines.size(); j++) {
+            const auto& line = static_cast<const entity::Line&>(*entities[lines[j]]);
+            newQueue[lines[j]] = line.withPoints(transformed[j * 2], transformed[j * 2 + 1]);
+        }
+    });
+
+    return newQueue;
+}
+
+/********************************************************************************************************/
+/** Begin                                                                                             ***/
+/********************************************************************************************************/
 Begin::Begin() :  Base() {
 }
 
 std::vector<entity::CADEntity_CSPtr> Begin::process(
     const std::shared_ptr<Document> document,
-    const std::vector<entity::CADEntity_CSPtr> entitySet,
+    std::vector<entity::CADEntity_CSPtr> entitySet,
     std::vector<entity::CADEntity_CSPtr>& workingBuffer,
     std::vector<entity::CADEntity_CSPtr>& removals,
-    const std::vector<Base_SPtr>) {
+    const std::vector<Base_SPtr>&) {
     _entities.insert(_entities.end(), entitySet.begin(), entitySet.end());
     return entitySet;
 }
@@ -33,10 +120,10 @@ Loop::Loop(const int numTimes) :  Base(), _numTimes(numTimes) {
 
 std::vector<entity::CADEntity_CSPtr> Loop::process(
     const std::shared_ptr<Document> document,
-    const std::vector<entity::CADEntity_CSPtr> entitySet,
+    std::vector<entity::CADEntity_CSPtr> entitySet,
     std::vector<entity::CADEntity_CSPtr>& _workingBuffer,
     std::vector<entity::CADEntity_CSPtr>& removals,
-    const std::vector<Base_SPtr> _stack) {
+    const std::vector<Base_SPtr>& _stack) {
     std::vector<entity::CADEntity_CSPtr> final;
 
     // Find the start
@@ -54,15 +141,13 @@ std::vector<entity::CADEntity_CSPtr> Loop::process(
 
 
     // run the operation queue
-    std::vector<entity::CADEntity_CSPtr> entitySet2(entitySet);
-
     for (int n = 0; n < _numTimes - 1; n++) {
         for (auto base : _stack) {
-            entitySet2 = base->process(document, entitySet2, _workingBuffer, removals, _stack);
+            entitySet = base->process(document, std::move(entitySet), _workingBuffer, removals, _stack);
         }
     }
 
-    return entitySet2;
+    return entitySet;
 }
 
 /********************************************************************************************************/
@@ -73,18 +158,13 @@ Move::Move(const geo::Coordinate& offset) :  Base(), _offset(offset) {
 
 std::vector<entity::CADEntity_CSPtr>  Move::process(
     const std::shared_ptr<Document> document,
-    const std::vector<entity::CADEntity_CSPtr> entitySet,
+    std::vector<entity::CADEntity_CSPtr> entitySet,
     std::vector<entity::CADEntity_CSPtr>&,
     std::vector<entity::CADEntity_CSPtr>&,
-    const std::vector<Base_SPtr>) {
-    std::vector<entity::CADEntity_CSPtr> newQueue;
-
-    for (auto entity : entitySet) {
-        auto e = entity->move(_offset);
-        newQueue.push_back(e);
-    }
-
-    return newQueue;
+    const std::vector<Base_SPtr>&) {
+    return transform(entitySet, geo::Transform2D::translation(_offset), [this](const entity::CADEntity_CSPtr& entity) {
+        return entity->move(_offset);
+    });
 }
 
 /********************************************************************************************************/
@@ -95,17 +175,17 @@ Copy::Copy(const geo::Coordinate& offset) : Base(), _offset(offset) {
 
 std::vector<entity::CADEntity_CSPtr> Copy::process(
     const std::shared_ptr<Document> document,
-    const std::vector<entity::CADEntity_CSPtr> entitySet,
+    std::vector<entity::CADEntity_CSPtr> entitySet,
     std::vector<entity::CADEntity_CSPtr>& workingBuffer,
     std::vector<entity::CADEntity_CSPtr>&,
-    const std::vector<Base_SPtr>) {
-    std::vector<entity::CADEntity_CSPtr> newQueue;
+    const std::vector<Base_SPtr>&) {
+    auto newQueue = transform(entitySet, [this](const entity::CADEntity_CSPtr& entity) {
+        return entity->copy(_offset);
+    });
 
-    for (auto entity : entitySet) {
-        auto e = entity->copy(_offset);
-        workingBuffer.push_back(entity);
-        newQueue.push_back(e);
-    }
+    workingBuffer.insert(workingBuffer.end(),
+                         std::make_move_iterator(entitySet.begin()),
+                         std::make_move_iterator(entitySet.end()));
 
     return newQueue;
 }
@@ -118,18 +198,13 @@ Scale::Scale(const geo::Coordinate& scale_center, const geo::Coordinate& scale_f
 
 std::vector<entity::CADEntity_CSPtr> Scale::process(
     const std::shared_ptr<Document> document,
-    const std::vector<entity::CADEntity_CSPtr> entitySet,
+    std::vector<entity::CADEntity_CSPtr> entitySet,
     std::vector<entity::CADEntity_CSPtr>&,
     std::vector<entity::CADEntity_CSPtr>&,
-    const std::vector<Base_SPtr>) {
-    std::vector<entity::CADEntity_CSPtr> newQueue;
-
-    for (auto entity : entitySet) {
-        auto e = entity->scale(_scale_center, _scale_factor);
-        newQueue.push_back(e);
-    }
-
-    return newQueue;
+    const std::vector<Base_SPtr>&) {
+    return transform(entitySet, geo::Transform2D::scale(_scale_center, _scale_factor), [this](const entity::CADEntity_CSPtr& entity) {
+        return entity->scale(_scale_center, _scale_factor);
+    });
 }
 
 /********************************************************************************************************/
@@ -140,18 +215,13 @@ Rotate::Rotate(const geo::Coordinate& rotation_center, const double rotation_ang
 
 std::vector<entity::CADEntity_CSPtr> Rotate::process(
     const std::shared_ptr<Document> document,
-    const std::vector<entity::CADEntity_CSPtr> entitySet,
+    std::vector<entity::CADEntity_CSPtr> entitySet,
     std::vector<entity::CADEntity_CSPtr>&,
     std::vector<entity::CADEntity_CSPtr>&,
-    const std::vector<Base_SPtr>) {
-    std::vector<entity::CADEntity_CSPtr> newQueue;
-
-    for (auto entity : entitySet) {
-        auto e = entity->rotate(_rotation_center, _rotation_angle);
-        newQueue.push_back(e);
-    }
-
-    return newQueue;
+    const std::vector<Base_SPtr>&) {
+    return transform(entitySet, geo::Transform2D::rotation(_rotation_center, _rotation_angle), [this](const entity::CADEntity_CSPtr& entity) {
+        return entity->rotate(_rotation_center, _rotation_angle);
+    });
 }
 
 /********************************************************************************************************/
@@ -162,13 +232,15 @@ Push::Push() : Base() {
 
 std::vector<entity::CADEntity_CSPtr> Push::process(
     const std::shared_ptr<Document> document,
-    const std::vector<entity::CADEntity_CSPtr> entitySet,
+    std::vector<entity::CADEntity_CSPtr> entitySet,
     std::vector<entity::CADEntity_CSPtr>& workingBuffer,
     std::vector<entity::CADEntity_CSPtr>&,
-    const std::vector<Base_SPtr>) {
-    std::vector<entity::CADEntity_CSPtr> newQueue(workingBuffer);
-    newQueue.insert(newQueue.end(), entitySet.begin(), entitySet.end());
-    workingBuffer.clear();
+    const std::vector<Base_SPtr>&) {
+    std::vector<entity::CADEntity_CSPtr> newQueue;
+    newQueue.swap(workingBuffer);
+    newQueue.insert(newQueue.end(),
+                    std::make_move_iterator(entitySet.begin()),
+                    std::make_move_iterator(entitySet.end()));
     return newQueue;
 }
 
@@ -180,10 +252,10 @@ SelectByLayer::SelectByLayer(const Layer_CSPtr layer) : Base(), _layer(layer) {
 
 std::vector<entity::CADEntity_CSPtr> SelectByLayer::process(
     const std::shared_ptr<Document> document,
-    const std::vector<entity::CADEntity_CSPtr>,
+    std::vector<entity::CADEntity_CSPtr>,
     std::vector<entity::CADEntity_CSPtr>& workingBuffer,
     std::vector<entity::CADEntity_CSPtr>&,
-    const std::vector<Base_SPtr>) {
+    const std::vector<Base_SPtr>&) {
 
     std::vector<entity::CADEntity_CSPtr> e;
 
@@ -208,11 +280,13 @@ Remove::Remove() : Base() {
 
 std::vector<entity::CADEntity_CSPtr> Remove::process(
     const std::shared_ptr<Document> document,
-    const std::vector<entity::CADEntity_CSPtr> entitySet,
+    std::vector<entity::CADEntity_CSPtr> entitySet,
     std::vector<entity::CADEntity_CSPtr>&,
     std::vector<entity::CADEntity_CSPtr>& removals,
-    const std::vector<Base_SPtr>) {
-    removals.insert(removals.end(), entitySet.begin(), entitySet.end());
+    const std::vector<Base_SPtr>&) {
+    removals.insert(removals.end(),
+                    std::make_move_iterator(entitySet.begin()),
+                    std::make_move_iterator(entitySet.end()));
     std::vector<entity::CADEntity_CSPtr> e;
     return e;
 }
@@ -1,9 +1,11 @@
 #pragma once
 
 #include "documentoperation.h"
+#include <functional>
 #include <vector>
 
 #include <cad/base/cadentity.h>
+#include <cad/math/transform2d.h>
 
 namespace lc {
     class Document;
@@ -19,13 +21,51 @@ namespace lc {
 
         class Base {
             public:
+                virtual ~Base() = default;
+
+                /**
+                 * @brief Process the current set of entities
+                 * @param entities current set, passed by value so operations can take ownership of it
+                 * @param workingBuffer entities that will be added/updated in the document
+                 * @param removals entities that will be removed from the document
+                 * @param operationStack all operations that came before this one
+                 * @return new set of entities for the next operation
+                 */
                 virtual std::vector<entity::CADEntity_CSPtr> process(
                     const std::shared_ptr<Document>,
-                    const std::vector<entity::CADEntity_CSPtr> entities,
+                    std::vector<entity::CADEntity_CSPtr> entities,
                     std::vector<entity::CADEntity_CSPtr>& workingBuffer,
                     std::vector<entity::CADEntity_CSPtr>& removals,
-                    const std::vector<Base_SPtr> operationStack
+                    const std::vector<Base_SPtr>& operationStack
                 ) = 0;
+
+            protected:
+                /**
+                 * @brief Apply a function on each entity
+                 * Large sets are split in chunks which are processed on the kernel ThreadPool.
+                 * The order of the result is the same as the order of the input.
+                 * @param entities input entities
+                 * @param func function returning the new entity, must be thread safe
+                 * @return new entities
+                 */
+                static std::vector<entity::CADEntity_CSPtr> transform(
+                    const std::vector<entity::CADEntity_CSPtr>& entities,
+                    const std::function<entity::CADEntity_CSPtr(const entity::CADEntity_CSPtr&)>& func
+                );
+
+                /**
+                 * @brief Apply a transformation on each entity
+                 * The points of the lines of a chunk are transformed together by the batch kernel of Transform2D,
+                 * the other entities by func.
+                 * @param matrix transformation applied on the lines
+                 * @param func function returning the new entity, must be thread safe
+                 * @return new entities
+                 */
+                static std::vector<entity::CADEntity_CSPtr> transform(
+                    const std::vector<entity::CADEntity_CSPtr>& entities,
+                    const geo::Transform2D& matrix,
+                    const std::function<entity::CADEntity_CSPtr(const entity::CADEntity_CSPtr&)>& func
+                );
         };
 
         /**
@@ -54,7 +94,7 @@ namespace lc {
                     std::vector<entity::CADEntity_CSPtr> entities,
                     std::vector<entity::CADEntity_CSPtr>& workingBuffer,
                     std::vector<entity::CADEntity_CSPtr>& removals,
-                    const std::vector<Base_SPtr> operationStack);
+                    const std::vector<Base_SPtr>& operationStack);
 
             private:
                 int _numTimes;
@@ -88,7 +128,7 @@ namespace lc {
                     std::vector<entity::CADEntity_CSPtr> entities,
                     std::vector<entity::CADEntity_CSPtr>& workingBuffer,
                     std::vector<entity::CADEntity_CSPtr>& removals,
-                    const std::vector<Base_SPtr> operationStack);
+                    const std::vector<Base_SPtr>& operationStack);
 
                 std::vector<entity::CADEntity_CSPtr> getEntities() const;
 
@@ -124,7 +164,7 @@ namespace lc {
                     std::vector<entity::CADEntity_CSPtr> entities,
                     std::vector<entity::CADEntity_CSPtr>& workingBuffer,
                     std::vector<entity::CADEntity_CSPtr>& removals,
-                    const std::vector<Base_SPtr> operationStack);
+                    const std::vector<Base_SPtr>& operationStack);
 
             private:
                 geo::Coordinate _offset;
@@ -158,7 +198,7 @@ namespace lc {
                     std::vector<entity::CADEntity_CSPtr> entities,
                     std::vector<entity::CADEntity_CSPtr>& workingBuffer,
                     std::vector<entity::CADEntity_CSPtr>& removals,
-                    const std::vector<Base_SPtr> operationStack);
+                    const std::vector<Base_SPtr>& operationStack);
 
             private:
                 geo::Coordinate
@@ -193,7 +233,7 @@ namespace lc {
                     std::vector<entity::CADEntity_CSPtr> entities,
                     std::vector<entity::CADEntity_CSPtr>& workingBuffer,
                     std::vector<entity::CADEntity_CSPtr>& removals,
-                    const std::vector<Base_SPtr> operationStack);
+                    const std::vector<Base_SPtr>& operationStack);
 
             private:
 
@@ -211,7 +251,7 @@ namespace lc {
                     std::vector<entity::CADEntity_CSPtr> entities,
                     std::vector<entity::CADEntity_CSPtr>& workingBuffer,
                     std::vector<entity::CADEntity_CSPtr>& removals,
-                    const std::vector<Base_SPtr> operationStack);
+                    const std::vector<Base_SPtr>& operationStack);
 
             private:
                 geo::Coordinate
@@ -248,7 +288,7 @@ namespace lc {
                     std::vector<entity::CADEntity_CSPtr> entities,
                     std::vector<entity::CADEntity_CSPtr>& workingBuffer,
                     std::vector<entity::CADEntity_CSPtr>& removals,
-                    const std::vector<Base_SPtr> operationStack);
+                    const std::vector<Base_SPtr>& operationStack);
         };
         DECLARE_SHORT_SHARED_PTR(Push)
 
@@ -278,7 +318,7 @@ namespace lc {
                     std::vector<entity::CADEntity_CSPtr> entities,
                     std::vector <entity::CADEntity_CSPtr>& workingBuffer,
                     std::vector<entity::CADEntity_CSPtr>& removals,
-                    const std::vector<Base_SPtr> operationStack);
+                    const std::vector<Base_SPtr>& operationStack);
 
             private:
                 Layer_CSPtr _layer;
@@ -311,7 +351,7 @@ namespace lc {
                     std::vector<entity::CADEntity_CSPtr> entities,
                     std::vector <entity::CADEntity_CSPtr>& workingBuffer,
                     std::vector<entity::CADEntity_CSPtr>& removals,
-                    const std::vector<Base_SPtr> operationStack);
+                    const std::vector<Base_SPtr>& operationStack);
 
             private:
                 Layer_CSPtr _layer;
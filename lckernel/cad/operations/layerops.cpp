@@ -38,7 +38,7 @@ RemoveLayer::RemoveLayer(std::shared_ptr<Document> document, const Layer_CSPtr l
 }
 
 void RemoveLayer::processInternal() {
-    auto le = document()->entityContainer().entitiesByLayer(_layer).asVector();
+    auto le = entitiesByLayer(_layer).asVector();
     _entities.insert(_entities.end(), le.begin(), le.end());
 
     for (auto i : _entities) {
@@ -75,7 +75,7 @@ ReplaceLayer::ReplaceLayer(std::shared_ptr<Document> document, const Layer_CSPtr
 }
 
 void ReplaceLayer::processInternal() {
-    auto le = document()->entityContainer().entitiesByLayer(_oldLayer).asVector();
+    auto le = entitiesByLayer(_oldLayer).asVector();
 
     for (auto i : le) {
         document()->removeEntity(i);
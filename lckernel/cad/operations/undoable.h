@@ -2,6 +2,7 @@
 
 #include <string>
 #include "cad/const.h"
+#include "cad/dochelpers/memoryusage.h"
 #include <memory>
 namespace lc {
     class Document;
@@ -58,6 +59,15 @@ namespace lc {
                     return _text;
                 }
 
+                /*!
+                 * \brief Memory kept by the operation to undo or redo it
+                 *
+                 * Operations storing entities should override it and add them to undo.entities.
+                 */
+                virtual void memoryUsage(MemoryUsage& usage) const {
+                    usage.add("undo.operations", sizeof(Undoable) + memory::containerSize(_text));
+                }
+
             private:
                 std::string _text;
         };
@@ -1,4 +1,6 @@
 #include "arc.h"
+#include "cad/base/entitypool.h"
+#include "cad/math/transform2d.h"
 
 using namespace lc;
 using namespace entity;
@@ -91,30 +93,30 @@ geo::Coordinate Arc::nearestPointOnPath(const geo::Coordinate &coord) const {
 }
 
 CADEntity_CSPtr Arc::move(const geo::Coordinate &offset) const {
-    auto newArc = std::make_shared<Arc>(this->center() + offset, this->radius(), this->startAngle(), this->endAngle(),
-                                        this->CCW(), layer());
+    auto newArc = lc::pool::makeShared<Arc>(this->center() + offset, this->radius(), this->startAngle(), this->endAngle(),
+                                            this->CCW(), layer());
     newArc->setID(this->id());
     return newArc;
 }
 
 CADEntity_CSPtr Arc::copy(const geo::Coordinate &offset) const {
-    auto newArc = std::make_shared<Arc>(this->center() + offset, this->radius(), this->startAngle(), this->endAngle(),
-                                        this->CCW(), layer());
+    auto newArc = lc::pool::makeShared<Arc>(this->center() + offset, this->radius(), this->startAngle(), this->endAngle(),
+                                            this->CCW(), layer());
     return newArc;
 }
 
 CADEntity_CSPtr Arc::rotate(const geo::Coordinate &rotation_center, const double rotation_angle) const {
-    auto newArc = std::make_shared<Arc>(this->center().rotate(rotation_center, rotation_angle),
-                                        this->radius(), this->startAngle() + rotation_angle,
-                                        this->endAngle() + rotation_angle, this->CCW(), layer());
+    auto newArc = lc::pool::makeShared<Arc>(geo::Transform2D::rotation(rotation_center, rotation_angle).apply(this->center()),
+                                            this->radius(), this->startAngle() + rotation_angle,
+                                            this->endAngle() + rotation_angle, this->CCW(), layer());
     newArc->setID(this->id());
     return newArc;
 }
 
 CADEntity_CSPtr Arc::scale(const geo::Coordinate &scale_center, const geo::Coordinate &scale_factor) const {
-    auto newArc = std::make_shared<Arc>(this->center().scale(scale_center, scale_factor),
-                                        this->radius() * fabs(scale_factor.x()),
-                                        this->startAngle(), this->endAngle(), this->CCW(), layer());
+    auto newArc = lc::pool::makeShared<Arc>(geo::Transform2D::scale(scale_center, scale_factor).apply(this->center()),
+                                            this->radius() * fabs(scale_factor.x()),
+                                            this->startAngle(), this->endAngle(), this->CCW(), layer());
     newArc->setID(this->id());
     return newArc;
 
@@ -123,11 +125,11 @@ CADEntity_CSPtr Arc::scale(const geo::Coordinate &scale_center, const geo::Coord
 CADEntity_CSPtr Arc::mirror(const geo::Coordinate &axis1, const geo::Coordinate &axis2) const {
     double a= (axis2- axis1).angle()*2;
 
-    auto newArc = std::make_shared<Arc>(this->center().mirror(axis1,axis2),
-                                        this->radius(),
-                                        lc::Math::correctAngle(a - this->startAngle()),
-                                        lc::Math::correctAngle(a - this->endAngle()),
-                                        !this->CCW(), layer());
+    auto newArc = lc::pool::makeShared<Arc>(geo::Transform2D::mirror(axis1, axis2).apply(this->center()),
+                                            this->radius(),
+                                            lc::Math::correctAngle(a - this->startAngle()),
+                                            lc::Math::correctAngle(a - this->endAngle()),
+                                            !this->CCW(), layer());
     newArc->setID(this->id());
     return newArc;
 
@@ -138,8 +140,8 @@ const geo::Area Arc::boundingBox() const {
 }
 
 CADEntity_CSPtr Arc::modify(Layer_CSPtr layer, const MetaInfo_CSPtr metaInfo, Block_CSPtr block) const {
-    auto newArc = std::make_shared<Arc>(this->center(), this->radius(), this->startAngle(), this->endAngle(),
-                                        this->CCW(), layer, metaInfo, block);
+    auto newArc = lc::pool::makeShared<Arc>(this->center(), this->radius(), this->startAngle(), this->endAngle(),
+                                            this->CCW(), layer, metaInfo, block);
     newArc->setID(this->id());
     return newArc;
 }
@@ -157,7 +159,7 @@ std::map<unsigned int, lc::geo::Coordinate> Arc::dragPoints() const {
 
 CADEntity_CSPtr Arc::setDragPoints(std::map<unsigned int, lc::geo::Coordinate> dragPoints) const {
     try {
-        auto newEntity = std::make_shared<Arc>(geo::Arc::createArcBulge(dragPoints.at(0), dragPoints.at(1), bulge()), layer(), metaInfo());
+        auto newEntity = lc::pool::makeShared<Arc>(geo::Arc::createArcBulge(dragPoints.at(0), dragPoints.at(1), bulge()), layer(), metaInfo());
         newEntity->setID(id());
         return newEntity;
     }
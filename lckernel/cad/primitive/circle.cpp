@@ -2,6 +2,8 @@
 #include <cmath>
 #include <algorithm>
 #include "cad/interface/metatype.h"
+#include "cad/base/entitypool.h"
+#include "cad/math/transform2d.h"
 
 using namespace lc;
 using namespace entity;
@@ -60,19 +62,19 @@ geo::Coordinate Circle::nearestPointOnPath(const geo::Coordinate &coord) const {
 }
 
 CADEntity_CSPtr Circle::move(const geo::Coordinate &offset) const {
-    auto newCircle = std::make_shared<Circle>(this->center() + offset, this->radius(), layer(), metaInfo());
+    auto newCircle = lc::pool::makeShared<Circle>(this->center() + offset, this->radius(), layer(), metaInfo());
     newCircle->setID(this->id());
     return newCircle;
 }
 
 CADEntity_CSPtr Circle::copy(const geo::Coordinate &offset) const {
-    auto newCircle = std::make_shared<Circle>(this->center() + offset, this->radius(), layer(), metaInfo());
+    auto newCircle = lc::pool::makeShared<Circle>(this->center() + offset, this->radius(), layer(), metaInfo());
     return newCircle;
 }
 
 CADEntity_CSPtr Circle::rotate(const geo::Coordinate &rotation_center, const double rotation_angle) const {
-    auto newCircle = std::make_shared<Circle>(this->center().rotate(rotation_center, rotation_angle), this->radius(),
-                                              layer(), metaInfo());
+    auto newCircle = lc::pool::makeShared<Circle>(geo::Transform2D::rotation(rotation_center, rotation_angle).apply(this->center()), this->radius(),
+                                                  layer(), metaInfo());
     newCircle->setID(this->id());
     return newCircle;
 }
@@ -80,15 +82,15 @@ CADEntity_CSPtr Circle::rotate(const geo::Coordinate &rotation_center, const dou
 CADEntity_CSPtr Circle::scale(const geo::Coordinate &scale_center, const geo::Coordinate &scale_factor) const {
     // TODO return ellipse if scalefactor.x != scalefactor.y
 
-    auto newCircle = std::make_shared<Circle>(this->center().scale(scale_center, scale_factor),
-                                              this->radius() * fabs(scale_factor.x()), layer(), metaInfo());
+    auto newCircle = lc::pool::makeShared<Circle>(geo::Transform2D::scale(scale_center, scale_factor).apply(this->center()),
+                                                  this->radius() * fabs(scale_factor.x()), layer(), metaInfo());
     newCircle->setID(this->id());
     return newCircle;
 }
 
 CADEntity_CSPtr Circle::mirror(const geo::Coordinate &axis1, const geo::Coordinate &axis2) const {
-    auto newCircle = std::make_shared<Circle>(this->center().mirror(axis1, axis2),
-                                              this->radius(), layer(), metaInfo());
+    auto newCircle = lc::pool::makeShared<Circle>(geo::Transform2D::mirror(axis1, axis2).apply(this->center()),
+                                                  this->radius(), layer(), metaInfo());
     newCircle->setID(this->id());
     return newCircle;
 }
@@ -99,7 +101,7 @@ const geo::Area Circle::boundingBox() const {
 }
 
 CADEntity_CSPtr Circle::modify(Layer_CSPtr layer, const MetaInfo_CSPtr metaInfo, Block_CSPtr block) const {
-    auto newEntity = std::make_shared<Circle>(this->center(), this->radius(), layer, metaInfo, block);
+    auto newEntity = lc::pool::makeShared<Circle>(this->center(), this->radius(), layer, metaInfo, block);
     newEntity->setID(this->id());
     return newEntity;
 }
@@ -88,6 +88,10 @@ namespace lc {
                 ed.visit(shared_from_this());
             }
 
+            virtual EntityKind kind() const override {
+                return EntityKind::Circle;
+            }
+
         private:
             Circle(const builder::CircleBuilder& builder);
 
@@ -11,3 +11,7 @@ lc::entity::CustomEntity::CustomEntity(lc::entity::Insert_CSPtr insert, bool sam
 lc::entity::CADEntity_CSPtr lc::entity::CustomEntity::setDragPoints(std::map<unsigned int, lc::geo::Coordinate> dragPoints) const {
     return shared_from_this();
 }
+
+lc::entity::EntityKind lc::entity::CustomEntity::kind() const {
+    return EntityKind::CustomEntity;
+}
@@ -1,5 +1,6 @@
 #include <map>
 #include "cad/primitive/dimaligned.h"
+#include "cad/base/entitypool.h"
 
 
 using namespace lc;
@@ -52,51 +53,51 @@ DimAligned_SPtr DimAligned::dimAuto(geo::Coordinate const& p1,
 
     geo::Coordinate p0 = p2.move(dir, distance);
 
-    return std::make_shared<DimAligned>(p0,
-                                        middleOfText,
-                                        TextConst::AttachmentPoint::Top_center,
-                                        0.,
-                                        0.,
-                                        TextConst::LineSpacingStyle::AtLeast,
-                                        explicitValue,
-                                        p1,
-                                        p2,
-                                        layer,
-                                        metaInfo,
-                                        block
+    return lc::pool::makeShared<DimAligned>(p0,
+                                            middleOfText,
+                                            TextConst::AttachmentPoint::Top_center,
+                                            0.,
+                                            0.,
+                                            TextConst::LineSpacingStyle::AtLeast,
+                                            explicitValue,
+                                            p1,
+                                            p2,
+                                            layer,
+                                            metaInfo,
+                                            block
     );
 }
 
 
 
 CADEntity_CSPtr DimAligned::move(const geo::Coordinate& offset) const {
-    auto newDimAligned = std::make_shared<DimAligned>(this->definitionPoint() + offset, this->middleOfText() + offset, this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(),  this->_definitionPoint2 + offset,  this->_definitionPoint3 + offset,  this->layer(), this->metaInfo());
+    auto newDimAligned = lc::pool::makeShared<DimAligned>(this->definitionPoint() + offset, this->middleOfText() + offset, this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(),  this->_definitionPoint2 + offset,  this->_definitionPoint3 + offset,  this->layer(), this->metaInfo());
     newDimAligned->setID(this->id());
     return newDimAligned;
 }
 
 CADEntity_CSPtr DimAligned::copy(const geo::Coordinate& offset) const {
-    auto newDimAligned = std::make_shared<DimAligned>(this->definitionPoint() + offset, this->middleOfText() + offset, this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(),  this->_definitionPoint2 + offset, this->_definitionPoint3 + offset,  this->layer(), this->metaInfo());
+    auto newDimAligned = lc::pool::makeShared<DimAligned>(this->definitionPoint() + offset, this->middleOfText() + offset, this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(),  this->_definitionPoint2 + offset, this->_definitionPoint3 + offset,  this->layer(), this->metaInfo());
     return newDimAligned;
 }
 
 CADEntity_CSPtr DimAligned::rotate(const geo::Coordinate& rotation_center, const double rotation_angle) const {
-    auto newDimAligned = std::make_shared<DimAligned>(this->definitionPoint().rotate(rotation_center, rotation_angle),
-                                                      this->middleOfText().rotate(rotation_center, rotation_angle), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_definitionPoint2.rotate(rotation_center, rotation_angle), this->_definitionPoint3.rotate(rotation_center, rotation_angle),  this->layer(), this->metaInfo());
+    auto newDimAligned = lc::pool::makeShared<DimAligned>(this->definitionPoint().rotate(rotation_center, rotation_angle),
+                                                          this->middleOfText().rotate(rotation_center, rotation_angle), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_definitionPoint2.rotate(rotation_center, rotation_angle), this->_definitionPoint3.rotate(rotation_center, rotation_angle),  this->layer(), this->metaInfo());
     return newDimAligned;
 }
 
 CADEntity_CSPtr DimAligned::scale(const geo::Coordinate& scale_center, const geo::Coordinate& scale_factor) const {
-    auto newDimAligned = std::make_shared<DimAligned>(this->definitionPoint().scale(scale_center, scale_factor),
-                                                      this->middleOfText().scale(scale_center, scale_factor), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_definitionPoint2.scale(scale_center, scale_factor), this->_definitionPoint3.scale(scale_center, scale_factor),  this->layer(), this->metaInfo());
+    auto newDimAligned = lc::pool::makeShared<DimAligned>(this->definitionPoint().scale(scale_center, scale_factor),
+                                                          this->middleOfText().scale(scale_center, scale_factor), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_definitionPoint2.scale(scale_center, scale_factor), this->_definitionPoint3.scale(scale_center, scale_factor),  this->layer(), this->metaInfo());
     return newDimAligned;
 }
 
 CADEntity_CSPtr DimAligned::mirror(const geo::Coordinate& axis1,
                     const geo::Coordinate& axis2) const {
 
-    auto newDimAligned = std::make_shared<DimAligned>(this->definitionPoint().mirror(axis1, axis2),
-                                                      this->middleOfText().mirror(axis1, axis2), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_definitionPoint2.mirror(axis1, axis2), this->_definitionPoint3.mirror(axis1, axis2),  this->layer(), this->metaInfo());
+    auto newDimAligned = lc::pool::makeShared<DimAligned>(this->definitionPoint().mirror(axis1, axis2),
+                                                          this->middleOfText().mirror(axis1, axis2), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_definitionPoint2.mirror(axis1, axis2), this->_definitionPoint3.mirror(axis1, axis2),  this->layer(), this->metaInfo());
     return newDimAligned;
 }
 
@@ -106,7 +107,7 @@ const geo::Area DimAligned::boundingBox() const {
 }
 
 CADEntity_CSPtr DimAligned::modify(Layer_CSPtr layer, const MetaInfo_CSPtr metaInfo, Block_CSPtr block) const {
-    auto newDimAligned = std::make_shared<DimAligned>(
+    auto newDimAligned = lc::pool::makeShared<DimAligned>(
                              this->definitionPoint(),
                              this->middleOfText(),
                              this->attachmentPoint(),
@@ -145,17 +146,17 @@ std::map<unsigned int, geo::Coordinate> DimAligned::dragPoints() const {
 
 CADEntity_CSPtr DimAligned::setDragPoints(std::map<unsigned int, lc::geo::Coordinate> dragPoints) const {
     try {
-        auto newEntity = std::make_shared<DimAligned>(dragPoints.at(0),
-                                                      dragPoints.at(1),
-                                                      attachmentPoint(),
-                                                      textAngle(),
-                                                      lineSpacingFactor(),
-                                                      lineSpacingStyle(),
-                                                      explicitValue(),
-                                                      dragPoints.at(2),
-                                                      dragPoints.at(3),
-                                                      layer(),
-                                                      metaInfo());
+        auto newEntity = lc::pool::makeShared<DimAligned>(dragPoints.at(0),
+                                                          dragPoints.at(1),
+                                                          attachmentPoint(),
+                                                          textAngle(),
+                                                          lineSpacingFactor(),
+                                                          lineSpacingStyle(),
+                                                          explicitValue(),
+                                                          dragPoints.at(2),
+                                                          dragPoints.at(3),
+                                                          layer(),
+                                                          metaInfo());
         newEntity->setID(id());
         return newEntity;
     }
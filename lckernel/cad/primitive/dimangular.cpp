@@ -1,4 +1,5 @@
 #include "cad/primitive/dimangular.h"
+#include "cad/base/entitypool.h"
 
 
 using namespace lc;
@@ -48,50 +49,50 @@ DimAngular_SPtr DimAngular::dimAuto(
         const Block_CSPtr block) {
     geo::Coordinate middletext(p1.mid(p2));
 
-    return std::make_shared<DimAngular>(center,
-                                        middletext,
-                                        TextConst::AttachmentPoint::Top_center,
-                                        0.,
-                                        0.,
-                                        TextConst::LineSpacingStyle::AtLeast,
-                                        explicitValue,
-                                        center,
-                                        p1,
-                                        center,
-                                        p2,
-                                        layer,
-                                        metaInfo,
-                                        block
+    return lc::pool::makeShared<DimAngular>(center,
+                                            middletext,
+                                            TextConst::AttachmentPoint::Top_center,
+                                            0.,
+                                            0.,
+                                            TextConst::LineSpacingStyle::AtLeast,
+                                            explicitValue,
+                                            center,
+                                            p1,
+                                            center,
+                                            p2,
+                                            layer,
+                                            metaInfo,
+                                            block
     );
 }
 
 
 CADEntity_CSPtr DimAngular::move(const geo::Coordinate& offset) const {
-    auto newDimAngular = std::make_shared<DimAngular>(this->definitionPoint() + offset, this->middleOfText() + offset, this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_defLine11 + offset, this->_defLine12 + offset, this->_defLine21 + offset, this->_defLine22 + offset, this->layer(), this->metaInfo());
+    auto newDimAngular = lc::pool::makeShared<DimAngular>(this->definitionPoint() + offset, this->middleOfText() + offset, this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_defLine11 + offset, this->_defLine12 + offset, this->_defLine21 + offset, this->_defLine22 + offset, this->layer(), this->metaInfo());
     newDimAngular->setID(this->id());
     return newDimAngular;
 }
 
 CADEntity_CSPtr DimAngular::copy(const geo::Coordinate& offset) const {
-    auto newDimAngular = std::make_shared<DimAngular>(this->definitionPoint() + offset, this->middleOfText() + offset, this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_defLine11 + offset, this->_defLine12 + offset, this->_defLine21 + offset, this->_defLine22 + offset, this->layer(), this->metaInfo());
+    auto newDimAngular = lc::pool::makeShared<DimAngular>(this->definitionPoint() + offset, this->middleOfText() + offset, this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_defLine11 + offset, this->_defLine12 + offset, this->_defLine21 + offset, this->_defLine22 + offset, this->layer(), this->metaInfo());
     return newDimAngular;
 }
 
 CADEntity_CSPtr DimAngular::rotate(const geo::Coordinate& rotation_center, const double rotation_angle) const {
-    auto newDimAngular = std::make_shared<DimAngular>(this->definitionPoint().rotate(rotation_center, rotation_angle),
-                                                      this->middleOfText().rotate(rotation_center, rotation_angle), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_defLine11.rotate(rotation_center, rotation_angle), this->_defLine12.rotate(rotation_center, rotation_angle), this->_defLine21.rotate(rotation_center, rotation_angle), this->_defLine22.rotate(rotation_center, rotation_angle), this->layer(), this->metaInfo());
+    auto newDimAngular = lc::pool::makeShared<DimAngular>(this->definitionPoint().rotate(rotation_center, rotation_angle),
+                                                          this->middleOfText().rotate(rotation_center, rotation_angle), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_defLine11.rotate(rotation_center, rotation_angle), this->_defLine12.rotate(rotation_center, rotation_angle), this->_defLine21.rotate(rotation_center, rotation_angle), this->_defLine22.rotate(rotation_center, rotation_angle), this->layer(), this->metaInfo());
     return newDimAngular;
 }
 
 CADEntity_CSPtr DimAngular::scale(const geo::Coordinate& scale_center, const geo::Coordinate& scale_factor) const {
-    auto newDimAngular = std::make_shared<DimAngular>(this->definitionPoint().scale(scale_center, scale_factor),
-                                                      this->middleOfText().scale(scale_center, scale_factor), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_defLine11.scale(scale_center, scale_factor), this->_defLine12.scale(scale_center, scale_factor), this->_defLine21.scale(scale_center, scale_factor), this->_defLine22.scale(scale_center, scale_factor), this->layer(), this->metaInfo());
+    auto newDimAngular = lc::pool::makeShared<DimAngular>(this->definitionPoint().scale(scale_center, scale_factor),
+                                                          this->middleOfText().scale(scale_center, scale_factor), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_defLine11.scale(scale_center, scale_factor), this->_defLine12.scale(scale_center, scale_factor), this->_defLine21.scale(scale_center, scale_factor), this->_defLine22.scale(scale_center, scale_factor), this->layer(), this->metaInfo());
     return newDimAngular;
 }
 
 CADEntity_CSPtr DimAngular::mirror(const geo::Coordinate& axis1, const geo::Coordinate& axis2) const {
-    auto newDimAngular = std::make_shared<DimAngular>(this->definitionPoint().mirror(axis1,axis2),
-                                                      this->middleOfText().mirror(axis1,axis2), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_defLine11.mirror(axis1,axis2), this->_defLine12.mirror(axis1,axis2), this->_defLine21.mirror(axis1,axis2), this->_defLine22.mirror(axis1,axis2), this->layer(), this->metaInfo());
+    auto newDimAngular = lc::pool::makeShared<DimAngular>(this->definitionPoint().mirror(axis1,axis2),
+                                                          this->middleOfText().mirror(axis1,axis2), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_defLine11.mirror(axis1,axis2), this->_defLine12.mirror(axis1,axis2), this->_defLine21.mirror(axis1,axis2), this->_defLine22.mirror(axis1,axis2), this->layer(), this->metaInfo());
     return newDimAngular;
 }
 
@@ -101,7 +102,7 @@ const geo::Area DimAngular::boundingBox() const {
 }
 
 CADEntity_CSPtr DimAngular::modify(Layer_CSPtr layer, const MetaInfo_CSPtr metaInfo, Block_CSPtr block) const {
-    auto newDimAngular = std::make_shared<DimAngular>(
+    auto newDimAngular = lc::pool::makeShared<DimAngular>(
                              this->definitionPoint(),
                              this->middleOfText(),
                              this->attachmentPoint(),
@@ -153,19 +154,19 @@ std::map<unsigned int, geo::Coordinate> DimAngular::dragPoints() const {
 
 CADEntity_CSPtr DimAngular::setDragPoints(std::map<unsigned int, lc::geo::Coordinate> dragPoints) const {
     try {
-        auto newEntity = std::make_shared<DimAngular>(dragPoints.at(0),
-                                                      dragPoints.at(1),
-                                                      attachmentPoint(),
-                                                      textAngle(),
-                                                      lineSpacingFactor(),
-                                                      lineSpacingStyle(),
-                                                      explicitValue(),
-                                                      dragPoints.at(2),
-                                                      dragPoints.at(3),
-                                                      dragPoints.at(4),
-                                                      dragPoints.at(5),
-                                                      layer(),
-                                                      metaInfo());
+        auto newEntity = lc::pool::makeShared<DimAngular>(dragPoints.at(0),
+                                                          dragPoints.at(1),
+                                                          attachmentPoint(),
+                                                          textAngle(),
+                                                          lineSpacingFactor(),
+                                                          lineSpacingStyle(),
+                                                          explicitValue(),
+                                                          dragPoints.at(2),
+                                                          dragPoints.at(3),
+                                                          dragPoints.at(4),
+                                                          dragPoints.at(5),
+                                                          layer(),
+                                                          metaInfo());
         newEntity->setID(id());
         return newEntity;
     }
@@ -1,4 +1,5 @@
 #include "cad/primitive/dimdiametric.h"
+#include "cad/base/entitypool.h"
 
 using namespace lc;
 using namespace entity;
@@ -47,31 +48,31 @@ DimDiametric::DimDiametric(const DimDiametric_CSPtr other, bool sameID) :
 }
 
 CADEntity_CSPtr DimDiametric::move(const geo::Coordinate& offset) const {
-    auto newDimDiametric = std::make_shared<DimDiametric>(this->definitionPoint() + offset, this->middleOfText() + offset, this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(),  this->_definitionPoint2 + offset, this->_leader, this->layer(), this->metaInfo());
+    auto newDimDiametric = lc::pool::makeShared<DimDiametric>(this->definitionPoint() + offset, this->middleOfText() + offset, this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(),  this->_definitionPoint2 + offset, this->_leader, this->layer(), this->metaInfo());
     newDimDiametric->setID(this->id());
     return newDimDiametric;
 }
 
 CADEntity_CSPtr DimDiametric::copy(const geo::Coordinate& offset) const {
-    auto newDimDiametric = std::make_shared<DimDiametric>(this->definitionPoint() + offset, this->middleOfText() + offset, this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(),  this->_definitionPoint2 + offset, this->_leader, this->layer(), this->metaInfo());
+    auto newDimDiametric = lc::pool::makeShared<DimDiametric>(this->definitionPoint() + offset, this->middleOfText() + offset, this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(),  this->_definitionPoint2 + offset, this->_leader, this->layer(), this->metaInfo());
     return newDimDiametric;
 }
 
 CADEntity_CSPtr DimDiametric::rotate(const geo::Coordinate& rotation_center, const double rotation_angle) const {
-    auto newDimDiametric = std::make_shared<DimDiametric>(this->definitionPoint().rotate(rotation_center, rotation_angle),
-                                                          this->middleOfText().rotate(rotation_center, rotation_angle), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_definitionPoint2.rotate(rotation_center, rotation_angle), this->_leader, this->layer(), this->metaInfo());
+    auto newDimDiametric = lc::pool::makeShared<DimDiametric>(this->definitionPoint().rotate(rotation_center, rotation_angle),
+                                                              this->middleOfText().rotate(rotation_center, rotation_angle), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_definitionPoint2.rotate(rotation_center, rotation_angle), this->_leader, this->layer(), this->metaInfo());
     return newDimDiametric;
 }
 
 CADEntity_CSPtr DimDiametric::scale(const geo::Coordinate& scale_center, const geo::Coordinate& scale_factor) const {
-    auto newDimDiametric = std::make_shared<DimDiametric>(this->definitionPoint().scale(scale_center, scale_factor),
-                                                          this->middleOfText().scale(scale_center, scale_factor), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_definitionPoint2.scale(scale_center, scale_factor), this->_leader, this->layer(), this->metaInfo());
+    auto newDimDiametric = lc::pool::makeShared<DimDiametric>(this->definitionPoint().scale(scale_center, scale_factor),
+                                                              this->middleOfText().scale(scale_center, scale_factor), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_definitionPoint2.scale(scale_center, scale_factor), this->_leader, this->layer(), this->metaInfo());
     return newDimDiametric;
 }
 
 CADEntity_CSPtr DimDiametric::mirror(const geo::Coordinate& axis1, const geo::Coordinate& axis2) const {
-    auto newDimDiametric = std::make_shared<DimDiametric>(this->definitionPoint().mirror(axis1, axis2),
-                                                          this->middleOfText().mirror(axis1, axis2), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_definitionPoint2.mirror(axis1, axis2), this->_leader, this->layer(), this->metaInfo());
+    auto newDimDiametric = lc::pool::makeShared<DimDiametric>(this->definitionPoint().mirror(axis1, axis2),
+                                                              this->middleOfText().mirror(axis1, axis2), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_definitionPoint2.mirror(axis1, axis2), this->_leader, this->layer(), this->metaInfo());
     return newDimDiametric;
 }
 
@@ -81,7 +82,7 @@ const geo::Area DimDiametric::boundingBox() const {
 }
 
 CADEntity_CSPtr DimDiametric::modify(Layer_CSPtr layer, const MetaInfo_CSPtr metaInfo, Block_CSPtr block) const {
-    auto newDimDiametric = std::make_shared<DimDiametric>(
+    auto newDimDiametric = lc::pool::makeShared<DimDiametric>(
                                this->definitionPoint(),
                                this->middleOfText(),
                                this->attachmentPoint(),
@@ -120,7 +121,7 @@ std::map<unsigned int, geo::Coordinate> DimDiametric::dragPoints() const {
 
 CADEntity_CSPtr DimDiametric::setDragPoints(std::map<unsigned int, lc::geo::Coordinate> dragPoints) const {
     try {
-        auto newEntity = std::make_shared<DimDiametric>(dragPoints.at(0),
+        auto newEntity = lc::pool::makeShared<DimDiametric>(dragPoints.at(0),
                                                       dragPoints.at(1),
                                                       attachmentPoint(),
                                                       textAngle(),
@@ -109,6 +109,10 @@ namespace lc {
                 ed.visit(shared_from_this());
             }
 
+            virtual EntityKind kind() const override {
+                return EntityKind::DimDiametric;
+            }
+
         public:
             virtual std::map<unsigned int, lc::geo::Coordinate> dragPoints() const override;
             virtual CADEntity_CSPtr setDragPoints(std::map<unsigned int, lc::geo::Coordinate> dragPoints) const override;
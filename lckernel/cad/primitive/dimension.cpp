@@ -1,5 +1,6 @@
 #include "cad/math/lcmath.h"
 #include "cad/primitive/dimension.h"
+#include "cad/base/entitypool.h"
 
 using namespace lc;
 using namespace entity;
@@ -38,31 +39,31 @@ Dimension::Dimension(Dimension const& other)  : _definitionPoint(other.definitio
 }
 /*
 CADEntity_CSPtr Dimension::move(const Coordinate& offset) const {
-    auto newDimension = std::make_shared<Dimension>(this->definitionPoint() + offset, this->middleOfText() + offset,this->attachmentPoint(), this->angle(),
-                                                    this->lineSpacingFactor(), this->lineSpacingStyle(), explicitValue());
+    auto newDimension = lc::pool::makeShared<Dimension>(this->definitionPoint() + offset, this->middleOfText() + offset,this->attachmentPoint(), this->angle(),
+                                                        this->lineSpacingFactor(), this->lineSpacingStyle(), explicitValue());
     return newDimension;
 }
 
 CADEntity_CSPtr Dimension::copy(const Coordinate& offset) const {
-    auto newDimension = std::make_shared<Dimension>(this->definitionPoint() + offset, this->middleOfText() + offset,this->attachmentPoint(), this->angle(),
+    auto newDimension = lc::pool::makeShared<Dimension>(this->definitionPoint() + offset, this->middleOfText() + offset,this->attachmentPoint(), this->angle(),
             this->lineSpacingFactor(), this->lineSpacingStyle(), explicitValue());
     return newDimension;
 }
 
 CADEntity_CSPtr Dimension::rotate(const Coordinate& rotation_center, const double rotation_angle) const {
-    auto newDimension = std::make_shared<Dimension>(this->definitionPoint().rotate(rotation_center, rotation_angle), this->middleOfText().rotate(rotation_center, rotation_angle),
+    auto newDimension = lc::pool::makeShared<Dimension>(this->definitionPoint().rotate(rotation_center, rotation_angle), this->middleOfText().rotate(rotation_center, rotation_angle),
             Math::correctAngle(this->angle() + rotation_angle), this->lineSpacingFactor(), this->lineSpacingStyle(), explicitValue());
     return newDimension;
 }
 
 CADEntity_CSPtr Dimension::scale(const Coordinate& scale_center, const Coordinate& scale_factor) const {
-    auto newDimension = std::make_shared<Dimension>(this->definitionPoint().scale(scale_center, scale_factor), this->middleOfText().scale(scale_center, scale_factor),
+    auto newDimension = lc::pool::makeShared<Dimension>(this->definitionPoint().scale(scale_center, scale_factor), this->middleOfText().scale(scale_center, scale_factor),
             , this->angle(), this->lineSpacingFactor(), this->lineSpacingStyle(), explicitValue());
     return newDimension;
 }
 
 CADEntity_CSPtr Dimension::modify(Layer_CSPtr layer, const MetaInfo_CSPtr metaInfo) const {
-    auto newEntity = std::make_shared<Dimension>(this->definitionPoint(), this->middleOfText(),this->attachmentPoint(), this->angle(),
+    auto newEntity = lc::pool::makeShared<Dimension>(this->definitionPoint(), this->middleOfText(),this->attachmentPoint(), this->angle(),
             this->lineSpacingFactor(), this->lineSpacingStyle(), explicitValue());
     return newEntity;
 }
@@ -1,4 +1,5 @@
 #include "cad/primitive/dimlinear.h"
+#include "cad/base/entitypool.h"
 
 using namespace lc;
 using namespace entity;
@@ -43,45 +44,45 @@ DimLinear_SPtr DimLinear::dimAuto(geo::Coordinate const& p1,
                                   const Layer_CSPtr layer,
                                   const MetaInfo_CSPtr metaInfo,
                                   const Block_CSPtr block) {
-    return std::make_shared<DimLinear>(p1,
-                                       middleOfText,
-                                       TextConst::AttachmentPoint::Middle_center,
-                                       0.,
-                                       0.,
-                                       TextConst::LineSpacingStyle::AtLeast,
-                                       explicitValue,
-                                       p1,
-                                       p2,
-                                       0.,
-                                       0.,
-                                       layer,
-                                       metaInfo,
-                                       block
+    return lc::pool::makeShared<DimLinear>(p1,
+                                           middleOfText,
+                                           TextConst::AttachmentPoint::Middle_center,
+                                           0.,
+                                           0.,
+                                           TextConst::LineSpacingStyle::AtLeast,
+                                           explicitValue,
+                                           p1,
+                                           p2,
+                                           0.,
+                                           0.,
+                                           layer,
+                                           metaInfo,
+                                           block
     );
 }
 
 
 
 CADEntity_CSPtr DimLinear::move(const geo::Coordinate& offset) const {
-    auto newDimLinear = std::make_shared<DimLinear>(this->definitionPoint() + offset, this->middleOfText() + offset, this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(),  this->_definitionPoint2 + offset,  this->_definitionPoint3 + offset, this->_angle, this->_oblique, this->layer(), this->metaInfo());
+    auto newDimLinear = lc::pool::makeShared<DimLinear>(this->definitionPoint() + offset, this->middleOfText() + offset, this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(),  this->_definitionPoint2 + offset,  this->_definitionPoint3 + offset, this->_angle, this->_oblique, this->layer(), this->metaInfo());
     newDimLinear->setID(this->id());
     return newDimLinear;
 }
 
 CADEntity_CSPtr DimLinear::copy(const geo::Coordinate& offset) const {
-    auto newDimLinear = std::make_shared<DimLinear>(this->definitionPoint() + offset, this->middleOfText() + offset, this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(),  this->_definitionPoint2 + offset, this->_definitionPoint3 + offset, this->_angle, this->_oblique, this->layer(), this->metaInfo());
+    auto newDimLinear = lc::pool::makeShared<DimLinear>(this->definitionPoint() + offset, this->middleOfText() + offset, this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(),  this->_definitionPoint2 + offset, this->_definitionPoint3 + offset, this->_angle, this->_oblique, this->layer(), this->metaInfo());
     return newDimLinear;
 }
 
 CADEntity_CSPtr DimLinear::rotate(const geo::Coordinate& rotation_center, const double rotation_angle) const {
-    auto newDimLinear = std::make_shared<DimLinear>(this->definitionPoint().rotate(rotation_center, rotation_angle),
-                                                    this->middleOfText().rotate(rotation_center, rotation_angle), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_definitionPoint2.rotate(rotation_center, rotation_angle), this->_definitionPoint3.rotate(rotation_center, rotation_angle), this->_angle, this->_oblique, this->layer(), this->metaInfo());
+    auto newDimLinear = lc::pool::makeShared<DimLinear>(this->definitionPoint().rotate(rotation_center, rotation_angle),
+                                                        this->middleOfText().rotate(rotation_center, rotation_angle), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_definitionPoint2.rotate(rotation_center, rotation_angle), this->_definitionPoint3.rotate(rotation_center, rotation_angle), this->_angle, this->_oblique, this->layer(), this->metaInfo());
     return newDimLinear;
 }
 
 CADEntity_CSPtr DimLinear::scale(const geo::Coordinate& scale_center, const geo::Coordinate& scale_factor) const {
-    auto newDimLinear = std::make_shared<DimLinear>(this->definitionPoint().scale(scale_center, scale_factor),
-                                                    this->middleOfText().scale(scale_center, scale_factor), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_definitionPoint2.scale(scale_center, scale_factor), this->_definitionPoint3.scale(scale_center, scale_factor), this->_angle, this->_oblique, this->layer(), this->metaInfo());
+    auto newDimLinear = lc::pool::makeShared<DimLinear>(this->definitionPoint().scale(scale_center, scale_factor),
+                                                        this->middleOfText().scale(scale_center, scale_factor), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_definitionPoint2.scale(scale_center, scale_factor), this->_definitionPoint3.scale(scale_center, scale_factor), this->_angle, this->_oblique, this->layer(), this->metaInfo());
     return newDimLinear;
 }
 
@@ -91,7 +92,7 @@ const geo::Area DimLinear::boundingBox() const {
 }
 
 CADEntity_CSPtr DimLinear::modify(Layer_CSPtr layer, const MetaInfo_CSPtr metaInfo, Block_CSPtr block) const {
-    auto newDimLinear = std::make_shared<DimLinear>(
+    auto newDimLinear = lc::pool::makeShared<DimLinear>(
                             this->definitionPoint(),
                             this->middleOfText(),
                             this->attachmentPoint(),
@@ -139,7 +140,7 @@ std::map<unsigned int, geo::Coordinate> DimLinear::dragPoints() const {
 
 CADEntity_CSPtr DimLinear::setDragPoints(std::map<unsigned int, lc::geo::Coordinate> dragPoints) const {
     try {
-        auto newEntity = std::make_shared<DimLinear>(dragPoints.at(0),
+        auto newEntity = lc::pool::makeShared<DimLinear>(dragPoints.at(0),
                                                       dragPoints.at(1),
                                                       attachmentPoint(),
                                                       textAngle(),
@@ -1,4 +1,5 @@
 #include "cad/primitive/dimradial.h"
+#include "cad/base/entitypool.h"
 
 using namespace lc;
 using namespace entity;
@@ -43,31 +44,31 @@ DimRadial::DimRadial(const DimRadial_CSPtr other, bool sameID) : CADEntity(other
 }
 
 CADEntity_CSPtr DimRadial::move(const geo::Coordinate& offset) const {
-    auto newDimRadial = std::make_shared<DimRadial>(this->definitionPoint() + offset, this->middleOfText() + offset, this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(),  this->_definitionPoint2 + offset, this->_leader, this->layer(), this->metaInfo());
+    auto newDimRadial = lc::pool::makeShared<DimRadial>(this->definitionPoint() + offset, this->middleOfText() + offset, this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(),  this->_definitionPoint2 + offset, this->_leader, this->layer(), this->metaInfo());
     newDimRadial->setID(this->id());
     return newDimRadial;
 }
 
 CADEntity_CSPtr DimRadial::copy(const geo::Coordinate& offset) const {
-    auto newDimRadial = std::make_shared<DimRadial>(this->definitionPoint() + offset, this->middleOfText() + offset, this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(),  this->_definitionPoint2 + offset, this->_leader, this->layer(), this->metaInfo());
+    auto newDimRadial = lc::pool::makeShared<DimRadial>(this->definitionPoint() + offset, this->middleOfText() + offset, this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(),  this->_definitionPoint2 + offset, this->_leader, this->layer(), this->metaInfo());
     return newDimRadial;
 }
 
 CADEntity_CSPtr DimRadial::rotate(const geo::Coordinate& rotation_center, const double rotation_angle) const {
-    auto newDimRadial = std::make_shared<DimRadial>(this->definitionPoint().rotate(rotation_center, rotation_angle),
-                                                    this->middleOfText().rotate(rotation_center, rotation_angle), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_definitionPoint2.rotate(rotation_center, rotation_angle), this->_leader, this->layer(), this->metaInfo());
+    auto newDimRadial = lc::pool::makeShared<DimRadial>(this->definitionPoint().rotate(rotation_center, rotation_angle),
+                                                        this->middleOfText().rotate(rotation_center, rotation_angle), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_definitionPoint2.rotate(rotation_center, rotation_angle), this->_leader, this->layer(), this->metaInfo());
     return newDimRadial;
 }
 
 CADEntity_CSPtr DimRadial::scale(const geo::Coordinate& scale_center, const geo::Coordinate& scale_factor) const {
-    auto newDimRadial = std::make_shared<DimRadial>(this->definitionPoint().scale(scale_center, scale_factor),
-                                                    this->middleOfText().scale(scale_center, scale_factor), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_definitionPoint2.scale(scale_center, scale_factor), this->_leader, this->layer(), this->metaInfo());
+    auto newDimRadial = lc::pool::makeShared<DimRadial>(this->definitionPoint().scale(scale_center, scale_factor),
+                                                        this->middleOfText().scale(scale_center, scale_factor), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_definitionPoint2.scale(scale_center, scale_factor), this->_leader, this->layer(), this->metaInfo());
     return newDimRadial;
 }
 
 CADEntity_CSPtr DimRadial::mirror(const geo::Coordinate& axis1, const geo::Coordinate& axis2) const {
-    auto newDimRadial = std::make_shared<DimRadial>(this->definitionPoint().mirror(axis1,axis2),
-                                                    this->middleOfText().mirror(axis1,axis2), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_definitionPoint2.mirror(axis1,axis2), this->_leader, this->layer(), this->metaInfo());
+    auto newDimRadial = lc::pool::makeShared<DimRadial>(this->definitionPoint().mirror(axis1,axis2),
+                                                        this->middleOfText().mirror(axis1,axis2), this->attachmentPoint(), this->textAngle(), this->lineSpacingFactor(), this->lineSpacingStyle(), this->explicitValue(), this->_definitionPoint2.mirror(axis1,axis2), this->_leader, this->layer(), this->metaInfo());
     return newDimRadial;
 }
 
@@ -77,7 +78,7 @@ const geo::Area DimRadial::boundingBox() const {
 }
 
 CADEntity_CSPtr DimRadial::modify(Layer_CSPtr layer, const MetaInfo_CSPtr metaInfo, Block_CSPtr block) const {
-    auto newDimRadial = std::make_shared<DimRadial>(
+    auto newDimRadial = lc::pool::makeShared<DimRadial>(
                             this->definitionPoint(),
                             this->middleOfText(),
                             this->attachmentPoint(),
@@ -115,7 +116,7 @@ std::map<unsigned int, geo::Coordinate> DimRadial::dragPoints() const {
 
 CADEntity_CSPtr DimRadial::setDragPoints(std::map<unsigned int, lc::geo::Coordinate> dragPoints) const {
     try {
-        auto newEntity = std::make_shared<DimRadial>(dragPoints.at(0),
+        auto newEntity = lc::pool::makeShared<DimRadial>(dragPoints.at(0),
                                                       dragPoints.at(1),
                                                       attachmentPoint(),
                                                       textAngle(),
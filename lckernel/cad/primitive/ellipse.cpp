@@ -2,6 +2,7 @@
 #include <cad/interface/snapconstrain.h>
 #include <cad/interface/snapable.h>
 #include "ellipse.h"
+#include "cad/base/entitypool.h"
 
 using namespace lc;
 using namespace entity;
@@ -27,41 +28,41 @@ Ellipse::Ellipse(const Ellipse_CSPtr other, bool sameID) :
 
 
 CADEntity_CSPtr Ellipse::move(const geo::Coordinate &offset) const {
-    auto newellipse = std::make_shared<Ellipse>(this->center() + offset,
-                                                this->majorP(),
-                                                this->minorRadius(),
-                                                this->startAngle(), this->endAngle(),
-                                                isReversed(),
-                                                layer(),
-                                                metaInfo(),
-                                                block());
+    auto newellipse = lc::pool::makeShared<Ellipse>(this->center() + offset,
+                                                    this->majorP(),
+                                                    this->minorRadius(),
+                                                    this->startAngle(), this->endAngle(),
+                                                    isReversed(),
+                                                    layer(),
+                                                    metaInfo(),
+                                                    block());
     newellipse->setID(this->id());
     return newellipse;
 }
 
 CADEntity_CSPtr Ellipse::copy(const geo::Coordinate &offset) const {
-    auto newEllipse = std::make_shared<Ellipse>(this->center() + offset,
-                                                this->majorP(),
-                                                this->minorRadius(),
-                                                this->startAngle(), this->endAngle(),
-                                                isReversed(),
-                                                layer(),
-                                                metaInfo(),
-                                                block());
+    auto newEllipse = lc::pool::makeShared<Ellipse>(this->center() + offset,
+                                                    this->majorP(),
+                                                    this->minorRadius(),
+                                                    this->startAngle(), this->endAngle(),
+                                                    isReversed(),
+                                                    layer(),
+                                                    metaInfo(),
+                                                    block());
     return newEllipse;
 }
 
 CADEntity_CSPtr Ellipse::rotate(const geo::Coordinate &rotation_center, const double rotation_angle) const {
     auto rotated = this->georotate(rotation_center, rotation_angle);
-    auto newEllipse = std::make_shared<Ellipse>(rotated.center(),
-                                                rotated.majorP(),
-                                                rotated.minorRadius(),
-                                                rotated.startAngle(),
-                                                rotated.endAngle(),
-                                                isReversed(),
-                                                layer(),
-                                                metaInfo(),
-                                                block()
+    auto newEllipse = lc::pool::makeShared<Ellipse>(rotated.center(),
+                                                    rotated.majorP(),
+                                                    rotated.minorRadius(),
+                                                    rotated.startAngle(),
+                                                    rotated.endAngle(),
+                                                    isReversed(),
+                                                    layer(),
+                                                    metaInfo(),
+                                                    block()
     );
     newEllipse->setID(this->id());
     return newEllipse;
@@ -69,15 +70,15 @@ CADEntity_CSPtr Ellipse::rotate(const geo::Coordinate &rotation_center, const do
 
 CADEntity_CSPtr Ellipse::scale(const geo::Coordinate &scale_center, const geo::Coordinate &scale_factor) const {
     auto scaled = this->geoscale(scale_center, scale_factor);
-    auto newEllipse = std::make_shared<Ellipse>(scaled.center(),
-                                                scaled.majorP(),
-                                                scaled.minorRadius(),
-                                                scaled.startAngle(),
-                                                scaled.endAngle(),
-                                                isReversed(),
-                                                layer(),
-                                                metaInfo(),
-                                                block()
+    auto newEllipse = lc::pool::makeShared<Ellipse>(scaled.center(),
+                                                    scaled.majorP(),
+                                                    scaled.minorRadius(),
+                                                    scaled.startAngle(),
+                                                    scaled.endAngle(),
+                                                    isReversed(),
+                                                    layer(),
+                                                    metaInfo(),
+                                                    block()
     );
 
     newEllipse->setID(this->id());
@@ -95,14 +96,14 @@ CADEntity_CSPtr Ellipse::mirror(const geo::Coordinate &axis1, const geo::Coordin
         endP = endPoint().mirror(axis1, axis2);
     }
 
-    auto newEllipse = std::make_shared<Ellipse>(cen, majP,
-                                                minorRadius(),
-                                                getEllipseAngle(startP),
-                                                getEllipseAngle(endP),
-                                                !isReversed(),
-                                                layer(),
-                                                metaInfo(),
-                                                block()
+    auto newEllipse = lc::pool::makeShared<Ellipse>(cen, majP,
+                                                    minorRadius(),
+                                                    getEllipseAngle(startP),
+                                                    getEllipseAngle(endP),
+                                                    !isReversed(),
+                                                    layer(),
+                                                    metaInfo(),
+                                                    block()
     );
     newEllipse->setID(this->id());
 
@@ -138,7 +139,7 @@ const geo::Area Ellipse::boundingBox() const {
 }
 
 CADEntity_CSPtr Ellipse::modify(Layer_CSPtr layer, const MetaInfo_CSPtr metaInfo, Block_CSPtr block) const {
-    auto newEntity = std::make_shared<Ellipse>(
+    auto newEntity = lc::pool::makeShared<Ellipse>(
             this->center(),
             this->majorP(),
             this->minorRadius(),
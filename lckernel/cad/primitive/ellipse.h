@@ -119,6 +119,10 @@ namespace lc {
             virtual void dispatch(EntityDispatch &ed) const override {
                 ed.visit(shared_from_this());
             }
+
+            virtual EntityKind kind() const override {
+                return EntityKind::Ellipse;
+            }
         };
 
         DECLARE_SHORT_SHARED_PTR(Ellipse)
@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <cad/math/helpermethods.h>
 #include "cad/geometry/geoarea.h"
+#include "cad/base/entitypool.h"
 
 using namespace lc;
 using namespace entity;
@@ -85,25 +86,25 @@ geo::Coordinate Image::nearestPointOnPath(const geo::Coordinate& coord) const {
 }
 
 CADEntity_CSPtr Image::move(const geo::Coordinate& offset) const {
-    auto newImage = std::make_shared<Image>(_name, _base + offset, _uv, _vv, _width, _height, _brightness, _contrast, _fade, layer(), metaInfo());
+    auto newImage = lc::pool::makeShared<Image>(_name, _base + offset, _uv, _vv, _width, _height, _brightness, _contrast, _fade, layer(), metaInfo());
     newImage->setID(this->id());
     return newImage;
 }
 
 CADEntity_CSPtr Image::copy(const geo::Coordinate& offset) const {
-    auto newImage = std::make_shared<Image>(_name, _base + offset, _uv, _vv, _width, _height, _brightness, _contrast, _fade, layer(), metaInfo());
+    auto newImage = lc::pool::makeShared<Image>(_name, _base + offset, _uv, _vv, _width, _height, _brightness, _contrast, _fade, layer(), metaInfo());
     return newImage;
 }
 
 CADEntity_CSPtr Image::rotate(const geo::Coordinate& rotation_center, const double rotation_angle) const {
- //   auto newImage = std::make_shared<Image>(_bottomLeft.rotate(rotation_center, rotation_angle),
+ //   auto newImage = lc::pool::makeShared<Image>(_bottomLeft.rotate(rotation_center, rotation_angle),
     //                                           _topRight.rotate(rotation_center, rotation_angle), layer());
     // newImage->setID(this->id());
     return nullptr;
 }
 
 CADEntity_CSPtr Image::scale(const geo::Coordinate& scale_center, const geo::Coordinate& scale_factor) const {
- //   auto newImage = std::make_shared<Image>(_bottomLeft.scale(scale_center, scale_factor),
+ //   auto newImage = lc::pool::makeShared<Image>(_bottomLeft.scale(scale_center, scale_factor),
     //                                           _topRight.scale(scale_center, scale_factor), layer());
     //newImage->setID(this->id());
     return nullptr;
@@ -133,7 +134,7 @@ const geo::Area Image::boundingBox() const {
 }
 
 CADEntity_CSPtr Image::modify(Layer_CSPtr layer, const MetaInfo_CSPtr metaInfo, Block_CSPtr block) const {
-    auto newImage = std::make_shared<Image>(
+    auto newImage = lc::pool::makeShared<Image>(
             _name,
             _base,
             _uv,
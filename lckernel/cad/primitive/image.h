@@ -142,6 +142,10 @@ namespace lc {
                 ed.visit(shared_from_this());
             }
 
+            virtual EntityKind kind() const override {
+                return EntityKind::Image;
+            }
+
         private:
             std::string _name;
             geo::Coordinate _base;
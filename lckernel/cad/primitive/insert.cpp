@@ -1,4 +1,6 @@
 #include "insert.h"
+#include "cad/base/entitypool.h"
+#include "cad/interface/entitydispatch.h"
 
 using namespace lc;
 using namespace entity;
@@ -10,9 +12,6 @@ Insert::Insert(Insert_CSPtr other, bool sameID) :
     _displayBlock(other->_displayBlock) {
 
     calculateBoundingBox();
-
-    _document->addEntityEvent().connect<Insert, &Insert::on_addEntityEvent>(this);
-    _document->removeEntityEvent().connect<Insert, &Insert::on_removeEntityEvent>(this);
 }
 
 Insert::Insert(const builder::InsertBuilder& builder) :
@@ -22,14 +21,6 @@ Insert::Insert(const builder::InsertBuilder& builder) :
     _displayBlock(builder.displayBlock()) {
 
     calculateBoundingBox();
-
-    _document->addEntityEvent().connect<Insert, &Insert::on_addEntityEvent>(this);
-    _document->removeEntityEvent().connect<Insert, &Insert::on_removeEntityEvent>(this);
-}
-
-Insert::~Insert() {
-    document()->addEntityEvent().disconnect<Insert, &Insert::on_addEntityEvent>(this);
-    document()->removeEntityEvent().disconnect<Insert, &Insert::on_removeEntityEvent>(this);
 }
 
 const Block_CSPtr& Insert::displayBlock() const {
@@ -41,15 +32,17 @@ const geo::Coordinate& Insert::position() const {
 }
 
 CADEntity_CSPtr Insert::move(const geo::Coordinate& offset) const {
-    auto newEntity = std::make_shared<Insert>(shared_from_this(), true);
+    auto newEntity = lc::pool::makeShared<Insert>(shared_from_this(), true);
     newEntity->_position = _position + offset;
+    newEntity->calculateBoundingBox();
 
     return newEntity;
 }
 
 CADEntity_CSPtr Insert::copy(const geo::Coordinate& offset) const {
-    auto newEntity = std::make_shared<Insert>(shared_from_this());
+    auto newEntity = lc::pool::makeShared<Insert>(shared_from_this());
     newEntity->_position = _position + offset;
+    newEntity->calculateBoundingBox();
 
     return newEntity;
 }
@@ -70,7 +63,7 @@ CADEntity_CSPtr Insert::mirror(const geo::Coordinate& axis1, const geo::Coordina
 }
 
 const geo::Area Insert::boundingBox() const {
-    return _boundingBox;
+    return _boundingBox.toArea();
 }
 
 CADEntity_CSPtr Insert::modify(Layer_CSPtr layer, const MetaInfo_CSPtr metaInfo, Block_CSPtr block) const {
@@ -85,7 +78,11 @@ CADEntity_CSPtr Insert::modify(Layer_CSPtr layer, const MetaInfo_CSPtr metaInfo,
 }
 
 void Insert::dispatch(EntityDispatch& dispatch) const {
-    //TODO
+    dispatch.visit(shared_from_this());
+}
+
+EntityKind Insert::kind() const {
+    return EntityKind::Insert;
 }
 
 std::map<unsigned int, geo::Coordinate> entity::Insert::dragPoints() const {
@@ -98,8 +95,9 @@ std::map<unsigned int, geo::Coordinate> entity::Insert::dragPoints() const {
 
 entity::CADEntity_CSPtr entity::Insert::setDragPoints(std::map<unsigned int, lc::geo::Coordinate> dragPoints) const {
     try {
-        auto newEntity = std::make_shared<Insert>(shared_from_this(), true);
+        auto newEntity = lc::pool::makeShared<Insert>(shared_from_this(), true);
         newEntity->_position = dragPoints.at(0);
+        newEntity->calculateBoundingBox();
 
         return newEntity;
     }
@@ -130,34 +128,17 @@ const Document_SPtr& Insert::document() const {
     return _document;
 }
 
-void Insert::calculateBoundingBox() {
-    auto entities = _document->entitiesByBlock(_displayBlock).asVector();
-
-    if(entities.empty()) {
-        _boundingBox = geo::Area(_position, _position);
-        return;
-    }
+void Insert::updateBoundingBox() const {
+    calculateBoundingBox();
+}
 
+void Insert::calculateBoundingBox() const {
+    // The document keeps the extents of each block, so only the translation is applied here
+    auto extents = geo::AABB::fromArea(_document->blockExtents(_displayBlock));
     auto offset = _position - displayBlock()->base();
-    auto it = entities.begin();
-
-    _boundingBox = (*it)->move(offset)->boundingBox();
-    it++;
 
-    while (it != entities.end()) {
-        _boundingBox = _boundingBox.merge((*it)->move(offset)->boundingBox());
-        it++;
-    }
+    _boundingBox = geo::AABB{
+        geo::Point2D{extents.min.x + offset.x(), extents.min.y + offset.y()},
+        geo::Point2D{extents.max.x + offset.x(), extents.max.y + offset.y()}
+    };
 }
-
-void Insert::on_addEntityEvent(const lc::AddEntityEvent& event) {
-    if(event.entity()->block() == _displayBlock) {
-        calculateBoundingBox();
-    }
-}
-
-void Insert::on_removeEntityEvent(const lc::RemoveEntityEvent& event) {
-    if(event.entity()->block() == _displayBlock) {
-        calculateBoundingBox();
-    }
-}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cad/geometry/geocoordinate.h>
+#include <cad/geometry/geoaabb.h>
 #include <cad/base/cadentity.h>
 #include <cad/builders/insert.h>
 #include <cad/interface/snapable.h>
@@ -14,7 +15,6 @@ namespace lc {
 
             public:
                 Insert(Insert_CSPtr other, bool sameID = false);
-                ~Insert();
 
                 const Block_CSPtr& displayBlock() const;
                 const geo::Coordinate& position() const;
@@ -31,6 +31,8 @@ namespace lc {
 
                 void dispatch(EntityDispatch& dispatch) const override;
 
+                EntityKind kind() const override;
+
                 std::map<unsigned int, geo::Coordinate> dragPoints() const override;
                 CADEntity_CSPtr setDragPoints(std::map<unsigned int, lc::geo::Coordinate> dragPoints) const override;
 
@@ -39,19 +41,22 @@ namespace lc {
 
                 virtual geo::Coordinate nearestPointOnPath(const geo::Coordinate& coord) const override;
 
+                /**
+                 * @brief Recalculate the bounding box from the extents of the block
+                 * Called by the storage manager at the end of a operation which changed the block.
+                 */
+                void updateBoundingBox() const;
+
             protected:
                 Insert(const builder::InsertBuilder& builder);
 
             private:
-                void calculateBoundingBox();
-
-                void on_addEntityEvent(const lc::AddEntityEvent&);
-                void on_removeEntityEvent(const lc::RemoveEntityEvent&);
+                void calculateBoundingBox() const;
 
                 Document_SPtr _document;
                 geo::Coordinate _position;
                 Block_CSPtr _displayBlock;
-                geo::Area _boundingBox;
+                mutable geo::AABB _boundingBox;
         };
 
         DECLARE_SHORT_SHARED_PTR(Insert)
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include "cad/geometry/geoarea.h"
+#include "cad/base/entitypool.h"
 
 using namespace lc;
 using namespace entity;
@@ -62,62 +63,51 @@ geo::Coordinate Line::nearestPointOnPath(const geo::Coordinate& coord) const {
 }
 
 CADEntity_CSPtr Line::move(const geo::Coordinate& offset) const {
-    auto newLine = std::make_shared<Line>(this->start() + offset,
-                                          this->end() + offset,
-                                          layer(),
-                                          metaInfo(),
-                                          block()
-    );
-    newLine->setID(this->id());
-    return newLine;
+    return withPoints(this->start() + offset, this->end() + offset);
 }
 
 CADEntity_CSPtr Line::copy(const geo::Coordinate& offset) const {
-    auto newLine = std::make_shared<Line>(this->start() + offset,
-                                          this->end() + offset,
-                                          layer(),
-                                          metaInfo(),
-                                          block());
+    auto newLine = lc::pool::makeShared<Line>(this->start() + offset,
+                                              this->end() + offset,
+                                              layer(),
+                                              metaInfo(),
+                                              block());
     return newLine;
 }
 
 CADEntity_CSPtr Line::rotate(const geo::Coordinate& rotation_center, const double rotation_angle) const {
-    auto newLine = std::make_shared<Line>(this->start().rotate(rotation_center, rotation_angle),
-                                          this->end().rotate(rotation_center, rotation_angle),
-                                          layer(),
-                                          metaInfo(),
-                                          block());
-    newLine->setID(this->id());
-    return newLine;
+    return transform(geo::Transform2D::rotation(rotation_center, rotation_angle));
 }
 
 CADEntity_CSPtr Line::scale(const geo::Coordinate& scale_center, const geo::Coordinate& scale_factor) const {
-    auto newLine = std::make_shared<Line>(this->start().scale(scale_center, scale_factor),
-                                          this->end().scale(scale_center, scale_factor),
-                                          layer(),
-                                          metaInfo(),
-                                          block());
-    newLine->setID(this->id());
-    return newLine;
+    return transform(geo::Transform2D::scale(scale_center, scale_factor));
 }
 
 CADEntity_CSPtr Line::mirror(const geo::Coordinate& axis1,
                              const geo::Coordinate& axis2) const {
-    auto newLine = std::make_shared<Line>(this->start().mirror(axis1, axis2),
-                                          this->end().mirror(axis1, axis2),
-                                          layer(),
-                                          metaInfo(),
-                                          block());
+    return transform(geo::Transform2D::mirror(axis1, axis2));
+}
+
+CADEntity_CSPtr Line::withPoints(const geo::Coordinate& start, const geo::Coordinate& end) const {
+    auto newLine = lc::pool::makeShared<Line>(start,
+                                              end,
+                                              layer(),
+                                              metaInfo(),
+                                              block());
     newLine->setID(this->id());
     return newLine;
 }
 
+CADEntity_CSPtr Line::transform(const geo::Transform2D& transform) const {
+    return withPoints(transform.apply(this->start()), transform.apply(this->end()));
+}
+
 const geo::Area Line::boundingBox() const {
     return geo::Area(start(), end());
 }
 
 CADEntity_CSPtr Line::modify(Layer_CSPtr layer, const MetaInfo_CSPtr metaInfo, Block_CSPtr block) const {
-    auto newEntity = std::make_shared<Line>(
+    auto newEntity = lc::pool::makeShared<Line>(
             this->start(),
             this->end(),
             layer,
@@ -140,7 +130,7 @@ std::map<unsigned int, lc::geo::Coordinate> Line::dragPoints() const {
 
 CADEntity_CSPtr Line::setDragPoints(std::map<unsigned int, lc::geo::Coordinate> dragPoints) const {
     try {
-	    auto newEntity = std::make_shared<Line>(dragPoints.at(0),
+	    auto newEntity = lc::pool::makeShared<Line>(dragPoints.at(0),
                                                 dragPoints.at(1),
                                                 layer(),
                                                 metaInfo(),
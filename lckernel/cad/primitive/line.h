@@ -8,6 +8,7 @@
 
 #include "cad/geometry/geocoordinate.h"
 #include "cad/geometry/geovector.h"
+#include "cad/math/transform2d.h"
 #include "cad/interface/snapable.h"
 #include "cad/interface/draggable.h"
 #include "cad/vo/entitycoordinate.h"
@@ -106,6 +107,18 @@ namespace lc {
             virtual CADEntity_CSPtr mirror(const geo::Coordinate& axis1,
                     const geo::Coordinate& axis2) const override;
 
+            /**
+             * @brief Line with the same ID, layer, meta info and block between other points
+             * Used by the operations which transform the points of many lines at once.
+             */
+            CADEntity_CSPtr withPoints(const geo::Coordinate& start, const geo::Coordinate& end) const;
+
+            /**
+             * @brief transform, applies a transformation on both points
+             * @return line with the same ID
+             */
+            CADEntity_CSPtr transform(const geo::Transform2D& transform) const;
+
             /**
              * @brief boundingBox of the entity
              * @return geo::Area area
@@ -121,6 +134,10 @@ namespace lc {
                 ed.visit(shared_from_this());
             }
 
+            virtual EntityKind kind() const override {
+                return EntityKind::Line;
+            }
+
         private:
             Line(const builder::LineBuilder& builder);
         };
@@ -7,6 +7,8 @@
 #include <cad/interface/snapable.h>
 #include <cad/primitive/arc.h>
 #include <cad/primitive/line.h>
+#include "cad/base/entitypool.h"
+#include "cad/dochelpers/memoryusage.h"
 
 using namespace lc;
 using namespace entity;
@@ -39,75 +41,84 @@ LWPolyline::LWPolyline(const LWPolyline_CSPtr other, bool sameID) : CADEntity(ot
                                                                     _elevation(other->_elevation),
                                                                     _tickness(other->_tickness),
                                                                     _closed(other->_closed),
-                                                                    _extrusionDirection(other->_extrusionDirection) {
-    generateEntities();
+                                                                    _extrusionDirection(other->_extrusionDirection),
+                                                                    _entities(other->_entities),
+                                                                    _segments(other->_segments),
+                                                                    _boundingBox(other->_boundingBox) {
+    // The vertices, layer and meta info are the same, so the generated geometry is shared
 }
 
-CADEntity_CSPtr LWPolyline::move(const geo::Coordinate &offset) const {
+std::vector<LWVertex2D> LWPolyline::transformVertex(const geo::Transform2D& transform, double bulgeFactor) const {
+    // Packed x,y pairs for the batch kernel
+    std::vector<double> points;
+    points.reserve(_vertex.size() * 2);
+
+    for (const auto& vertex : _vertex) {
+        points.push_back(vertex.location().x());
+        points.push_back(vertex.location().y());
+    }
+
+    transform.apply(points.data(), points.data(), _vertex.size());
+
     std::vector<LWVertex2D> newVertex;
-    for (auto vertex : _vertex) {
-        newVertex.emplace_back(vertex.location() + offset, vertex.bulge(), vertex.startWidth(), vertex.endWidth());
+    newVertex.reserve(_vertex.size());
+
+    for (size_t i = 0; i < _vertex.size(); i++) {
+        const auto& vertex = _vertex[i];
+        newVertex.emplace_back(geo::Coordinate(points[i * 2], points[i * 2 + 1], vertex.location().z()),
+                               vertex.bulge() * bulgeFactor, vertex.startWidth(), vertex.endWidth());
     }
-    auto newEntity = std::make_shared<LWPolyline>(newVertex, width(), elevation(), tickness(), closed(),
-                                                  extrusionDirection(), layer(), metaInfo());
+
+    return newVertex;
+}
+
+CADEntity_CSPtr LWPolyline::move(const geo::Coordinate &offset) const {
+    auto newVertex = transformVertex(geo::Transform2D::translation(offset));
+    auto newEntity = lc::pool::makeShared<LWPolyline>(newVertex, width(), elevation(), tickness(), closed(),
+                                                      extrusionDirection(), layer(), metaInfo());
     newEntity->setID(this->id());
     return newEntity;
 }
 
 CADEntity_CSPtr LWPolyline::copy(const geo::Coordinate &offset) const {
-    std::vector<LWVertex2D> newVertex;
-    for (auto vertex : _vertex) {
-        newVertex.emplace_back(vertex.location() + offset, vertex.bulge(), vertex.startWidth(), vertex.endWidth());
-    }
-    auto newEntity = std::make_shared<LWPolyline>(newVertex, width(), elevation(), tickness(), closed(),
-                                                  extrusionDirection(), layer(), metaInfo());
+    auto newVertex = transformVertex(geo::Transform2D::translation(offset));
+    auto newEntity = lc::pool::makeShared<LWPolyline>(newVertex, width(), elevation(), tickness(), closed(),
+                                                      extrusionDirection(), layer(), metaInfo());
     return newEntity;
 }
 
 CADEntity_CSPtr LWPolyline::rotate(const geo::Coordinate &rotation_center, const double rotation_angle) const {
-    std::vector<LWVertex2D> newVertex;
-    for (auto vertex : _vertex) {
-        newVertex.emplace_back(vertex.location().rotate(rotation_center, rotation_angle), vertex.bulge(),
-                               vertex.startWidth(), vertex.endWidth());
-    }
-    auto newEntity = std::make_shared<LWPolyline>(newVertex, width(), elevation(), tickness(), closed(),
-                                                  extrusionDirection(), layer(), metaInfo());
+    auto newVertex = transformVertex(geo::Transform2D::rotation(rotation_center, rotation_angle));
+    auto newEntity = lc::pool::makeShared<LWPolyline>(newVertex, width(), elevation(), tickness(), closed(),
+                                                      extrusionDirection(), layer(), metaInfo());
     return newEntity;
 }
 
 CADEntity_CSPtr LWPolyline::scale(const geo::Coordinate &scale_center, const geo::Coordinate &scale_factor) const {
-    std::vector<LWVertex2D> newVertex;
     if (scale_factor.x() != scale_factor.y()) {
         // TODO decide what to do with non-uniform scale factors
     }
-    for (auto vertex : _vertex) {
-        newVertex.emplace_back(vertex.location().scale(scale_center, scale_factor), vertex.bulge() * scale_factor.x(),
-                               vertex.startWidth(), vertex.endWidth());
-    }
-    auto newEntity = std::make_shared<LWPolyline>(newVertex, width(), elevation(), tickness(), closed(),
-                                                  extrusionDirection(), layer(), metaInfo());
+    auto newVertex = transformVertex(geo::Transform2D::scale(scale_center, scale_factor), scale_factor.x());
+    auto newEntity = lc::pool::makeShared<LWPolyline>(newVertex, width(), elevation(), tickness(), closed(),
+                                                      extrusionDirection(), layer(), metaInfo());
     return newEntity;
 }
 
-const geo::Area LWPolyline::boundingBox() const {
-    if(_entities.size() == 0) {
-        return geo::Area();
-    }
-
-    auto it = _entities.begin();
-    geo::Area area = (*it)->boundingBox();
-    it++;
-
-    while(it != _entities.end()) {
-        area = area.merge((*it)->boundingBox());
-        it++;
-    }
+CADEntity_CSPtr LWPolyline::mirror(const geo::Coordinate& axis1, const geo::Coordinate& axis2) const {
+    // Mirroring reverses the direction of the arcs
+    auto newVertex = transformVertex(geo::Transform2D::mirror(axis1, axis2), -1.);
+    auto newEntity = lc::pool::makeShared<LWPolyline>(newVertex, width(), elevation(), tickness(), closed(),
+                                                      extrusionDirection(), layer(), metaInfo());
+    newEntity->setID(this->id());
+    return newEntity;
+}
 
-    return area;
+const geo::Area LWPolyline::boundingBox() const {
+    return _boundingBox;
 }
 
 CADEntity_CSPtr LWPolyline::modify(Layer_CSPtr layer, const MetaInfo_CSPtr metaInfo, Block_CSPtr block) const {
-    auto newEntity = std::make_shared<LWPolyline>(
+    auto newEntity = lc::pool::makeShared<LWPolyline>(
             _vertex,
             _width,
             _elevation,
@@ -129,7 +140,7 @@ void LWPolyline::generateEntities() {
     itr++;
     while (itr != vertex().end()) {
         if (lastPoint->bulge() != 0.) {
-            _entities.push_back(std::make_shared<const Arc>(
+            _entities.push_back(lc::pool::makeShared<const Arc>(
                     geo::Arc::createArcBulge(lastPoint->location(), itr->location(), lastPoint->bulge()),
                     layer(),
                     metaInfo(),
@@ -137,7 +148,7 @@ void LWPolyline::generateEntities() {
             ));
         }
         else {
-            _entities.push_back(std::make_shared<const Line>(lastPoint->location(), itr->location(), layer(), metaInfo(), block()));
+            _entities.push_back(lc::pool::makeShared<const Line>(lastPoint->location(), itr->location(), layer(), metaInfo(), block()));
         }
         lastPoint = itr;
         itr++;
@@ -146,7 +157,7 @@ void LWPolyline::generateEntities() {
     if (_closed) {
         auto firstP = _vertex.begin();
         if (lastPoint->bulge() != 0.) {
-            _entities.push_back(std::make_shared<const Arc>(
+            _entities.push_back(lc::pool::makeShared<const Arc>(
                     geo::Arc::createArcBulge(lastPoint->location(), firstP->location(), lastPoint->bulge()),
                     layer(),
                     metaInfo(),
@@ -154,7 +165,30 @@ void LWPolyline::generateEntities() {
             ));
         }
         else {
-            _entities.push_back(std::make_shared<const Line>(lastPoint->location(), firstP->location(), layer(), metaInfo(), block()));
+            _entities.push_back(lc::pool::makeShared<const Line>(lastPoint->location(), firstP->location(), layer(), metaInfo(), block()));
+        }
+    }
+
+    _segments.reserve(_entities.size());
+    for (const auto& entity : _entities) {
+        Segment segment;
+        segment.boundingBox = entity->boundingBox();
+
+        if (entity->kind() == EntityKind::Arc) {
+            segment.arc = std::static_pointer_cast<const Arc>(entity);
+        }
+        else {
+            segment.vector = std::static_pointer_cast<const Line>(entity);
+        }
+
+        _segments.push_back(segment);
+    }
+
+    if (!_segments.empty()) {
+        _boundingBox = _segments.front().boundingBox;
+
+        for (const auto& segment : _segments) {
+            _boundingBox = _boundingBox.merge(segment.boundingBox);
         }
     }
 }
@@ -164,12 +198,11 @@ std::vector<EntityCoordinate> LWPolyline::snapPoints(const geo::Coordinate &coor
                                                      int maxNumberOfSnapPoints) const {
     std::vector<EntityCoordinate> points;
     if (constrain.constrain() & SimpleSnapConstrain::LOGICAL) {
-        const auto &&entities = asEntities();
-        for (auto &geoItem : entities) {
-            if (auto vector = std::dynamic_pointer_cast<const geo::Vector>(geoItem)) {
+        for (const auto& segment : _segments) {
+            if (auto& vector = segment.vector) {
                 points.emplace_back(vector->start(), -1);
                 points.emplace_back(vector->end(), -2);
-            } else if (auto arc = std::dynamic_pointer_cast<const geo::Arc>(geoItem)) {
+            } else if (auto& arc = segment.arc) {
                 points.emplace_back(arc->startP(), -3);
                 points.emplace_back(arc->endP(), -4);
                 points.emplace_back(arc->center(), -5);
@@ -195,8 +228,6 @@ std::vector<EntityCoordinate> LWPolyline::snapPoints(const geo::Coordinate &coor
                     const auto coord = arc->center() + lc::geo::Coordinate(0., -arc->radius());
                     points.emplace_back(coord, 4);
                 }
-            } else {
-                std::cerr << "Unknown entity found in LWPolyline during snapPoints generation" << std::endl;
             }
         }
     }
@@ -231,33 +262,49 @@ geo::Coordinate LWPolyline::nearestPointOnPath(const geo::Coordinate &coord) con
     return std::get<0>(info);
 }
 
+namespace {
+    /**
+     * @return distance between the coordinate and the nearest point of the area, 0 inside the area
+     */
+    double distanceToArea(const geo::Coordinate& coord, const geo::Area& area) {
+        const double dx = std::max(std::max(area.minP().x() - coord.x(), coord.x() - area.maxP().x()), 0.);
+        const double dy = std::max(std::max(area.minP().y() - coord.y(), coord.y() - area.maxP().y()), 0.);
+
+        return std::sqrt(dx * dx + dy * dy);
+    }
+}
+
 std::tuple<geo::Coordinate, std::shared_ptr<const geo::Vector>, std::shared_ptr<const geo::Arc>>  LWPolyline::nearestPointOnPath2(
         const geo::Coordinate &coord) const {
-    const auto &&entities = asEntities();
-
     double minimumDistance = std::numeric_limits<double>::max();
     std::shared_ptr<const geo::Vector> nearestVector = nullptr;
     std::shared_ptr<const geo::Arc> nearestArc = nullptr;
     geo::Coordinate nearestCoordinate;
-    for (auto &geoItem : entities) {
-        if (auto vector = std::dynamic_pointer_cast<const geo::Vector>(geoItem)) {
-            auto npoe = vector->nearestPointOnPath(coord);
+
+    for (const auto& segment : _segments) {
+        // The segment can't be closer than its bounding box
+        if (distanceToArea(coord, segment.boundingBox) >= minimumDistance) {
+            continue;
+        }
+
+        if (segment.vector) {
+            auto npoe = segment.vector->nearestPointOnEntity(coord);
             auto thisDistance = npoe.distanceTo(coord);
             if (thisDistance < minimumDistance) {
                 minimumDistance = thisDistance;
                 nearestCoordinate = npoe;
-                nearestVector = vector;
+                nearestVector = segment.vector;
+                nearestArc = nullptr;
             }
-        } else if (auto arc = std::dynamic_pointer_cast<const geo::Arc>(geoItem)) {
-            auto npoe = arc->nearestPointOnPath(coord);
+        } else {
+            auto npoe = segment.arc->nearestPointOnEntity(coord);
             auto thisDistance = npoe.distanceTo(coord);
             if (thisDistance < minimumDistance) {
                 minimumDistance = thisDistance;
                 nearestCoordinate = npoe;
-                nearestArc = arc;
+                nearestArc = segment.arc;
+                nearestVector = nullptr;
             }
-        } else {
-            std::cerr << "Unknown entity found in LWPolyline during boundingBox generation" << std::endl;
         }
     }
     return std::make_tuple(nearestCoordinate, nearestVector, nearestArc);
@@ -287,7 +334,7 @@ CADEntity_CSPtr LWPolyline::setDragPoints(std::map<unsigned int, lc::geo::Coordi
             i++;
         }
 
-        auto newEntity = std::make_shared<LWPolyline>(newVertex, width(), elevation(), tickness(), closed(), extrusionDirection(), layer(), metaInfo());
+        auto newEntity = lc::pool::makeShared<LWPolyline>(newVertex, width(), elevation(), tickness(), closed(), extrusionDirection(), layer(), metaInfo());
         newEntity->setID(id());
         return newEntity;
     }
@@ -296,6 +343,17 @@ CADEntity_CSPtr LWPolyline::setDragPoints(std::map<unsigned int, lc::geo::Coordi
     }
 }
 
-std::vector<CADEntity_CSPtr> const LWPolyline::asEntities() const {
+const std::vector<CADEntity_CSPtr>& LWPolyline::asEntities() const {
     return _entities;
 }
+
+size_t LWPolyline::generatedSize() const {
+    // Segments point to the entities
+    size_t size = memory::containerSize(_entities) + memory::containerSize(_segments);
+
+    for (const auto& entity : _entities) {
+        size += memory::entitySize(*entity);
+    }
+
+    return size;
+}
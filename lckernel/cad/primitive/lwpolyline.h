@@ -7,6 +7,7 @@
 
 #include "cad/vo/entitycoordinate.h"
 #include "cad/geometry/geobase.h"
+#include "cad/math/transform2d.h"
 #include "cad/interface/snapable.h"
 #include "cad/interface/draggable.h"
 #include <vector>
@@ -141,14 +142,36 @@ namespace lc {
                                                              int maxNumberOfSnapPoints) const override;
 
             virtual geo::Coordinate nearestPointOnPath(const geo::Coordinate &coord) const override;
+            /**
+             * @brief Find the nearest point on the segments of the polyline
+             * Segments which bounding box is further away than the nearest point found are skipped.
+             * @return nearest point and the line or arc segment it is on
+             */
             std::tuple<geo::Coordinate, std::shared_ptr<const geo::Vector>, std::shared_ptr<const geo::Arc>> nearestPointOnPath2(const geo::Coordinate &coord) const;
 
         private:
             /**
-             * @brief Generate entities of the polyline
+             * Geometry of a line or arc segment, calculated once
+             */
+            struct Segment {
+                geo::Area boundingBox;
+                // One of both is set
+                std::shared_ptr<const geo::Vector> vector;
+                std::shared_ptr<const geo::Arc> arc;
+            };
+
+            /**
+             * @brief Generate entities and segments of the polyline
              */
             void generateEntities();
 
+            /**
+             * @brief Apply transform on the location of each vertex
+             * @param transform transformation matrix, build once for all vertices
+             * @param bulgeFactor factor applied to the bulge of each vertex
+             */
+            std::vector<LWVertex2D> transformVertex(const geo::Transform2D& transform, double bulgeFactor = 1.) const;
+
             const std::vector<LWVertex2D> _vertex;
             const double _width;
             const double _elevation;
@@ -156,6 +179,8 @@ namespace lc {
             const bool _closed; // If we had more 'flag' options we should consider using an enum instead of separate variables to make constructors easier
             const geo::Coordinate _extrusionDirection;
             std::vector<CADEntity_CSPtr> _entities;
+            std::vector<Segment> _segments;
+            geo::Area _boundingBox;
 
         public:
             /**
@@ -191,9 +216,7 @@ namespace lc {
 
 
             virtual CADEntity_CSPtr mirror(const geo::Coordinate& axis1,
-                    const geo::Coordinate& axis2) const override {
-                return NULL; // TODO: no return statement, not implemented in lwpolyline.cpp
-            }
+                    const geo::Coordinate& axis2) const override;
             /**
         * @brief boundingBox of the entity
         * @return geo::Area area
@@ -206,7 +229,12 @@ namespace lc {
              * Return a vector of entities for this polyline
              * The vector will contain entity::vector and entity::Arc items
              */
-            std::vector<CADEntity_CSPtr> const asEntities() const;
+            const std::vector<CADEntity_CSPtr>& asEntities() const;
+
+            /**
+             * @brief Bytes used by the entities and segments generated from the vertices
+             */
+            size_t generatedSize() const;
 
 
         public:
@@ -216,6 +244,10 @@ namespace lc {
                 ed.visit(shared_from_this());
             }
 
+            virtual EntityKind kind() const override {
+                return EntityKind::LWPolyline;
+            }
+
         public:
             virtual std::map<unsigned int, lc::geo::Coordinate> dragPoints() const override;
             virtual CADEntity_CSPtr setDragPoints(std::map<unsigned int, lc::geo::Coordinate> dragPoints) const override;
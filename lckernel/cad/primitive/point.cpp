@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include "cad/geometry/geoarea.h"
+#include "cad/base/entitypool.h"
 
 using namespace lc;
 using namespace entity;
@@ -29,33 +30,33 @@ Point::Point(const builder::PointBuilder& builder) :
 }
 
 CADEntity_CSPtr Point::move(const geo::Coordinate& offset) const {
-    auto newCoordinate = std::make_shared<Point>(this->x() + offset.x(), this->y() + offset.y(), layer());
+    auto newCoordinate = lc::pool::makeShared<Point>(this->x() + offset.x(), this->y() + offset.y(), layer());
     newCoordinate->setID(this->id());
     return newCoordinate;
 }
 
 CADEntity_CSPtr Point::copy(const geo::Coordinate& offset) const {
-    auto newCoordinate = std::make_shared<Point>(this->x() + offset.x(), this->y() + offset.y(), layer());
+    auto newCoordinate = lc::pool::makeShared<Point>(this->x() + offset.x(), this->y() + offset.y(), layer());
     return newCoordinate;
 }
 
 CADEntity_CSPtr Point::rotate(const geo::Coordinate& rotation_center, const double rotation_angle) const {
     auto rotcord = geo::Coordinate(this->x(), this->y()).rotate(rotation_center, rotation_angle);
-    auto newCoordinate = std::make_shared<Point>(rotcord.x(), rotcord.y(), layer());
+    auto newCoordinate = lc::pool::makeShared<Point>(rotcord.x(), rotcord.y(), layer());
     newCoordinate->setID(this->id());
     return newCoordinate;
 }
 
 CADEntity_CSPtr Point::scale(const geo::Coordinate& scale_center, const geo::Coordinate& scale_factor) const {
     auto rotcord = geo::Coordinate(this->x(), this->y()).scale(scale_center, scale_factor);
-    auto newCoordinate = std::make_shared<Point>(rotcord.x(), rotcord.y(), layer());
+    auto newCoordinate = lc::pool::makeShared<Point>(rotcord.x(), rotcord.y(), layer());
     newCoordinate->setID(this->id());
     return newCoordinate;
 }
 
 CADEntity_CSPtr Point::mirror(const geo::Coordinate& axis1, const geo::Coordinate& axis2) const {
     auto rotcord = geo::Coordinate(this->x(), this->y()).rotate(axis1, axis2);
-    auto newCoordinate = std::make_shared<Point>(rotcord.x(), rotcord.y(), layer());
+    auto newCoordinate = lc::pool::makeShared<Point>(rotcord.x(), rotcord.y(), layer());
     newCoordinate->setID(this->id());
     return newCoordinate;
 }
@@ -65,10 +66,10 @@ const geo::Area Point::boundingBox() const {
 }
 
 CADEntity_CSPtr Point::modify(Layer_CSPtr layer, const MetaInfo_CSPtr metaInfo, Block_CSPtr block) const {
-    auto newEntity = std::make_shared<Point>(this->x(), this->y(),
-                                             layer,
-                                             metaInfo,
-                                             block
+    auto newEntity = lc::pool::makeShared<Point>(this->x(), this->y(),
+                                                 layer,
+                                                 metaInfo,
+                                                 block
     );
     newEntity->setID(this->id());
 
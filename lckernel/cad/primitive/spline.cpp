@@ -1,6 +1,8 @@
 #include "cad/primitive/spline.h"
 #include <algorithm>
 #include "cad/geometry/geoarea.h"
+#include "cad/base/entitypool.h"
+#include "cad/math/transform2d.h"
 
 using namespace lc;
 using namespace entity;
@@ -46,7 +48,7 @@ Spline::Spline(const Spline_CSPtr other, bool sameID) :
                 other->nX(), other->nY(), other->nZ(),
                 other->flags()
         ),
-        _boundingBox(other->boundingBox()) {
+        _boundingBox(other->_boundingBox) {
 }
 
 std::vector<EntityCoordinate> Spline::snapPoints(const geo::Coordinate& coord, const SimpleSnapConstrain & constrain, double minDistanceToSnap, int maxNumberOfSnapPoints) const {
@@ -64,72 +66,52 @@ geo::Coordinate Spline::nearestPointOnPath(const geo::Coordinate& coord) const {
 }
 
 CADEntity_CSPtr Spline::move(const geo::Coordinate& offset) const {
-    std::vector<geo::Coordinate> control_pts;
+    auto control_pts = geo::Transform2D::translation(offset).apply(this->controlPoints());
 
-    for (auto point : this->controlPoints()) {
-        control_pts.push_back(point + offset);
-    }
-
-    auto newSpline = std::make_shared<Spline>(control_pts, knotPoints(), fitPoints(), degree(), closed(), fitTolerance(), startTanX(), startTanY(), startTanZ(), endTanX(), endTanY(), endTanZ(), nX(), nY(), nZ(), flags(), layer(), metaInfo());
+    auto newSpline = lc::pool::makeShared<Spline>(control_pts, knotPoints(), fitPoints(), degree(), closed(), fitTolerance(), startTanX(), startTanY(), startTanZ(), endTanX(), endTanY(), endTanZ(), nX(), nY(), nZ(), flags(), layer(), metaInfo());
     newSpline->setID(this->id());
     return newSpline;
 }
 
 CADEntity_CSPtr Spline::copy(const geo::Coordinate& offset) const {
-    std::vector<geo::Coordinate> control_pts;
-
-    for (auto point : this->controlPoints()) {
-        control_pts.push_back(point + offset);
-    }
+    auto control_pts = geo::Transform2D::translation(offset).apply(this->controlPoints());
 
-    auto newSpline = std::make_shared<Spline>(control_pts, knotPoints(), fitPoints(), degree(), closed(), fitTolerance(), startTanX(), startTanY(), startTanZ(), endTanX(), endTanY(), endTanZ(), nX(), nY(), nZ(), flags(), layer(), metaInfo());
+    auto newSpline = lc::pool::makeShared<Spline>(control_pts, knotPoints(), fitPoints(), degree(), closed(), fitTolerance(), startTanX(), startTanY(), startTanZ(), endTanX(), endTanY(), endTanZ(), nX(), nY(), nZ(), flags(), layer(), metaInfo());
     return newSpline;
 }
 
 CADEntity_CSPtr Spline::rotate(const geo::Coordinate& rotation_center, const double rotation_angle) const {
-    std::vector<geo::Coordinate> control_pts;
-
-    for (auto point : this->controlPoints()) {
-        control_pts.push_back(point.rotate(rotation_center, rotation_angle));
-    }
+    auto control_pts = geo::Transform2D::rotation(rotation_center, rotation_angle).apply(this->controlPoints());
 
     auto normal = geo::Coordinate(nX(), nY(), nZ()).rotate(rotation_angle);
 
-    auto newSpline = std::make_shared<Spline>(control_pts, knotPoints(), fitPoints(), degree(), closed(), fitTolerance(), startTanX(), startTanY(), startTanZ(), endTanX(), endTanY(), endTanZ(), normal.x(), normal.y(), normal.z(), flags(), layer(), metaInfo());
+    auto newSpline = lc::pool::makeShared<Spline>(control_pts, knotPoints(), fitPoints(), degree(), closed(), fitTolerance(), startTanX(), startTanY(), startTanZ(), endTanX(), endTanY(), endTanZ(), normal.x(), normal.y(), normal.z(), flags(), layer(), metaInfo());
     newSpline->setID(this->id());
     return newSpline;
 }
 
 CADEntity_CSPtr Spline::scale(const geo::Coordinate& scale_center, const geo::Coordinate& scale_factor) const {
-    std::vector<geo::Coordinate> control_pts;
+    auto control_pts = geo::Transform2D::scale(scale_center, scale_factor).apply(this->controlPoints());
 
-    for (auto point : this->controlPoints()) {
-        control_pts.push_back(point.scale(scale_center, scale_factor));
-    }
-
-    auto newSpline = std::make_shared<Spline>(control_pts, knotPoints(), fitPoints(), degree(), closed(), fitTolerance(), startTanX(), startTanY(), startTanZ(), endTanX(), endTanY(), endTanZ(), nX(), nY(), nZ(), flags(), layer(), metaInfo());
+    auto newSpline = lc::pool::makeShared<Spline>(control_pts, knotPoints(), fitPoints(), degree(), closed(), fitTolerance(), startTanX(), startTanY(), startTanZ(), endTanX(), endTanY(), endTanZ(), nX(), nY(), nZ(), flags(), layer(), metaInfo());
     newSpline->setID(this->id());
     return newSpline;
 }
 
 CADEntity_CSPtr Spline::mirror(const geo::Coordinate& axis1, const geo::Coordinate& axis2) const {
-    std::vector<geo::Coordinate> control_pts;
+    auto control_pts = geo::Transform2D::mirror(axis1, axis2).apply(this->controlPoints());
 
-    for (auto point : this->controlPoints()) {
-        control_pts.push_back(point.mirror(axis1, axis2));
-    }
-
-    auto newSpline = std::make_shared<Spline>(control_pts, knotPoints(), fitPoints(), degree(), closed(), fitTolerance(), startTanX(), startTanY(), startTanZ(), endTanX(), endTanY(), endTanZ(), nX(), nY(), nZ(), flags(), layer(), metaInfo());
+    auto newSpline = lc::pool::makeShared<Spline>(control_pts, knotPoints(), fitPoints(), degree(), closed(), fitTolerance(), startTanX(), startTanY(), startTanZ(), endTanX(), endTanY(), endTanZ(), nX(), nY(), nZ(), flags(), layer(), metaInfo());
     newSpline->setID(this->id());
     return newSpline;
 }
 
 const geo::Area Spline::boundingBox() const {
-    return this->_boundingBox;
+    return this->_boundingBox.toArea();
 }
 
 CADEntity_CSPtr Spline::modify(Layer_CSPtr layer, const MetaInfo_CSPtr metaInfo, Block_CSPtr block) const {
-    auto newSpline = std::make_shared<Spline>(
+    auto newSpline = lc::pool::makeShared<Spline>(
             controlPoints(),
             knotPoints(),
             fitPoints(),
@@ -150,10 +132,11 @@ CADEntity_CSPtr Spline::modify(Layer_CSPtr layer, const MetaInfo_CSPtr metaInfo,
 
 void Spline::calculateBoundingBox() {
 	//TODO: better bounding box generation
-	_boundingBox = geo::Area(this->controlPoints()[0], this->controlPoints()[0]);
-	
-	for(auto cp : this->controlPoints()) {
-		_boundingBox = _boundingBox.merge(cp);
+	const auto& controlPoints = this->controlPoints();
+	_boundingBox = geo::AABB::fromPoints(controlPoints[0], controlPoints[0]);
+
+	for(const auto& cp : controlPoints) {
+		_boundingBox = _boundingBox.merge(geo::AABB::fromPoints(cp, cp));
 	}
 }
 
@@ -194,7 +177,7 @@ CADEntity_CSPtr Spline::setDragPoints(std::map<unsigned int, lc::geo::Coordinate
             i++;
         }
 
-        auto newEntity = std::make_shared<Spline>(controlPoints,
+        auto newEntity = lc::pool::makeShared<Spline>(controlPoints,
                                                     knotPoints(),
                                                     fitPoints,
                                                     degree(),
@@ -5,6 +5,7 @@
 
 
 #include "cad/geometry/geocoordinate.h"
+#include "cad/geometry/geoaabb.h"
 #include "cad/geometry/geospline.h"
 #include "cad/base/cadentity.h"
 #include "cad/vo/entitycoordinate.h"
@@ -106,13 +107,17 @@ namespace lc {
                 ed.visit(shared_from_this());
             }
 
+            virtual EntityKind kind() const override {
+                return EntityKind::Spline;
+            }
+
         public:
             virtual std::map<unsigned int, lc::geo::Coordinate> dragPoints() const override;
             virtual CADEntity_CSPtr setDragPoints(std::map<unsigned int, lc::geo::Coordinate> dragPoints) const override;
 
         private:
             void calculateBoundingBox();
-			geo::Area _boundingBox;
+			geo::AABB _boundingBox;
         };
 
         DECLARE_SHORT_SHARED_PTR(Spline)
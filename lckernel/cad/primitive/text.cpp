@@ -1,6 +1,7 @@
 #include "text.h"
 #include <algorithm>
 #include "cad/geometry/geoarea.h"
+#include "cad/base/entitypool.h"
 
 
 using namespace lc;
@@ -40,22 +41,22 @@ Text::Text(const Text_CSPtr& other, bool sameID) : CADEntity(other, sameID),
 }
 
 CADEntity_CSPtr Text::move(const geo::Coordinate& offset) const {
-    auto newText = std::make_shared<Text>(this->_insertion_point + offset,
-                                          this->_text_value,
-                                          this->_height,
-                                          this->_angle,
-                                          this->_style,
-                                          this->_textgeneration,
-                                          this->_halign,
-                                          this->_valign,
-                                          layer(),
-                                          metaInfo());
+    auto newText = lc::pool::makeShared<Text>(this->_insertion_point + offset,
+                                              this->_text_value,
+                                              this->_height,
+                                              this->_angle,
+                                              this->_style,
+                                              this->_textgeneration,
+                                              this->_halign,
+                                              this->_valign,
+                                              layer(),
+                                              metaInfo());
     newText->setID(this->id());
     return newText;
 }
 
 CADEntity_CSPtr Text::copy(const geo::Coordinate& offset) const {
-    auto newText = std::make_shared<Text>(
+    auto newText = lc::pool::makeShared<Text>(
                        this->_insertion_point + offset,
                        this->_text_value,
                        this->_height,
@@ -71,7 +72,7 @@ CADEntity_CSPtr Text::copy(const geo::Coordinate& offset) const {
 }
 
 CADEntity_CSPtr Text::rotate(const geo::Coordinate& rotation_center, const double rotation_angle) const {
-    auto newText = std::make_shared<Text>(
+    auto newText = lc::pool::makeShared<Text>(
                        this->_insertion_point.rotate(rotation_center, rotation_angle),
                        this->_text_value,
                        this->_height,
@@ -86,7 +87,7 @@ CADEntity_CSPtr Text::rotate(const geo::Coordinate& rotation_center, const doubl
 }
 
 CADEntity_CSPtr Text::scale(const geo::Coordinate& scale_center, const geo::Coordinate& scale_factor) const {
-    auto newText = std::make_shared<Text>(
+    auto newText = lc::pool::makeShared<Text>(
                        this->_insertion_point.scale(scale_center, scale_factor),
                        this->_text_value,
                        this->_height * std::sqrt(scale_factor.x() * scale_factor.y()),  // Does this make sense?
@@ -107,7 +108,7 @@ const geo::Area Text::boundingBox() const {
 }
 
 CADEntity_CSPtr Text::modify(Layer_CSPtr layer, const MetaInfo_CSPtr metaInfo, Block_CSPtr block) const {
-    auto newText = std::make_shared<Text>(
+    auto newText = lc::pool::makeShared<Text>(
                        this->_insertion_point,
                        this->_text_value,
                        this->_height,
@@ -135,7 +136,7 @@ std::map<unsigned int, lc::geo::Coordinate> Text::dragPoints() const {
 
 CADEntity_CSPtr Text::setDragPoints(std::map<unsigned int, lc::geo::Coordinate> dragPoints) const {
     try {
-        auto newEntity = std::make_shared<Text>(dragPoints.at(0), text_value(), height(), angle(), style(), textgeneration(), halign(), valign(), layer(), metaInfo());
+        auto newEntity = lc::pool::makeShared<Text>(dragPoints.at(0), text_value(), height(), angle(), style(), textgeneration(), halign(), valign(), layer(), metaInfo());
         newEntity->setID(id());
         return newEntity;
     }
@@ -1,6 +1,7 @@
 #include "documentcanvas.h"
 #include <cad/meta/metacolor.h>
 #include <cad/document/document.h>
+#include <cad/base/instrumentation.h>
 #include <cad/dochelpers/quadtree.h>
 #include <cad/geometry/geoarea.h>
 #include <cad/primitive/line.h>
@@ -35,16 +36,25 @@
 #include <cad/const.h>
 #include <math.h>
 
+#include <set>
 #include <typeinfo>
 
 using namespace LCViewer;
 
-DocumentCanvas::DocumentCanvas(std::shared_ptr<lc::Document> document) : _document(document), _zoomMin(0.005), _zoomMax(200.0), _deviceWidth(-1), _deviceHeight(-1), _selectedArea(nullptr), _selectedAreaIntersects(false) {
+DocumentCanvas::DocumentCanvas(std::shared_ptr<lc::Document> document) : _document(document), _zoomMin(0.005), _zoomMax(200.0), _deviceWidth(-1), _deviceHeight(-1), _selectedArea(nullptr), _selectedAreaIntersects(false), _newSelectionValid(false) {
 
 
     document->addEntityEvent().connect<DocumentCanvas, &DocumentCanvas::on_addEntityEvent>(this);
     document->removeEntityEvent().connect<DocumentCanvas, &DocumentCanvas::on_removeEntityEvent>(this);
-    document->commitProcessEvent().connect<DocumentCanvas, &DocumentCanvas::on_commitProcessEvent>(this);
+
+    // Entities which were in the document before the canvas was created, for example by a file import
+    for (const auto& entity : document->entities()) {
+        auto drawable = asDrawable(entity);
+
+        if (drawable != nullptr) {
+            _drawItems[entity->id()] = drawable;
+        }
+    }
 
     // Render code for selected area
     _selectedAreaPainter = [](LcPainter & painter, lc::geo::Area area , bool occupies) {
@@ -80,7 +90,6 @@ DocumentCanvas::DocumentCanvas(std::shared_ptr<lc::Document> document) : _docume
 DocumentCanvas::~DocumentCanvas() {
     _document->addEntityEvent().disconnect<DocumentCanvas, &DocumentCanvas::on_addEntityEvent>(this);
     _document->removeEntityEvent().disconnect<DocumentCanvas, &DocumentCanvas::on_removeEntityEvent>(this);
-    _document->commitProcessEvent().disconnect<DocumentCanvas, &DocumentCanvas::on_commitProcessEvent>(this);
 
     for (auto i = _cachedPainters.begin(); i != _cachedPainters.end(); i++) {
         this->_deletePainterFunctor(i->second);
@@ -228,6 +237,11 @@ void DocumentCanvas::zoom(double factor, bool relativezoom, double userCenterX,
     }
 }
 
+void DocumentCanvas::setZoomLimits(double zoomMin, double zoomMax) {
+    _zoomMin = zoomMin;
+    _zoomMax = zoomMax;
+}
+
 void DocumentCanvas::transX(int x) {
     for (auto i = _cachedPainters.begin(); i != _cachedPainters.end(); i++) {
         LcPainter* p = i->second;
@@ -243,7 +257,7 @@ void DocumentCanvas::transY(int y) {
 }
 
 void DocumentCanvas::autoScale() {
-    auto extends = _entityContainer.boundingBox();
+    auto extends = _document->spatialIndex().boundingBox();
     extends = extends.increaseBy(std::min(extends.width(), extends.height()) * 0.1);
 
     setDisplayArea(extends);
@@ -260,6 +274,7 @@ void DocumentCanvas::setDisplayArea(const lc::geo::Area& area) {
 }
 
 void DocumentCanvas::render(std::function<void(LcPainter&)> before, std::function<void(LcPainter&)> after) {
+    lc::instrumentation::ScopedTimer renderTimer("canvas.render");
 
     LcPainter& painter = cachedPainter(VIEWER_DOCUMENT);
     painter = cachedPainter(VIEWER_DRAWING);
@@ -282,8 +297,12 @@ void DocumentCanvas::render(std::function<void(LcPainter&)> before, std::functio
 
     LcDrawOptions lcDrawOptions;
     DrawEvent drawEvent(painter, lcDrawOptions, visibleUserArea);
-    painter.lineWidthCompensation(0.);
-    _background(drawEvent);
+
+    {
+        lc::instrumentation::ScopedTimer timer("canvas.render.background");
+        painter.lineWidthCompensation(0.);
+        _background(drawEvent);
+    }
 
     after(painter);
 
@@ -295,11 +314,22 @@ void DocumentCanvas::render(std::function<void(LcPainter&)> before, std::functio
     painter.lineWidthCompensation(0.5);
     painter.enable_antialias();
 
-    auto visibleItems = _entityContainer.entitiesWithinAndCrossingAreaFast(visibleUserArea);
+    {
+        lc::instrumentation::ScopedTimer timer("canvas.render.document");
+        int64_t drawn = 0;
+
+        for (const auto& entity : _document->spatialIndex().entitiesOverlapping(visibleUserArea)) {
+            auto di = drawItem(entity->id());
+
+            if (di != nullptr) {
+                drawEntity(di);
+                drawn++;
+            }
+        }
+
+        lc::instrumentation::count("canvas.render.entities", drawn);
+    }
 
-    visibleItems.each< LCVDrawItem >([&](LCVDrawItem_CSPtr di) {
-		drawEntity(di);
-    });
     painter.line_width(1.);
     painter.source_rgb(1., 1., 1.);
     painter.lineWidthCompensation(0.);
@@ -310,11 +340,14 @@ void DocumentCanvas::render(std::function<void(LcPainter&)> before, std::functio
     before(painter);
     // caller is responsible for clearing  painter.clear(1., 1., 1., 0.0);
 
-    _foreground(drawEvent);
+    {
+        lc::instrumentation::ScopedTimer timer("canvas.render.foreground");
+        _foreground(drawEvent);
 
-    // Draw selection rectangle
-    if (_selectedArea != nullptr) {
-        _selectedAreaPainter(painter, *_selectedArea, _selectedAreaIntersects);
+        // Draw selection rectangle
+        if (_selectedArea != nullptr) {
+            _selectedAreaPainter(painter, *_selectedArea, _selectedAreaIntersects);
+        }
     }
 
 
@@ -331,7 +364,7 @@ void DocumentCanvas::render(std::function<void(LcPainter&)> before, std::functio
     painter.line_width(1.0);
     painter.disable_antialias();
     painter.source_rgba(0.7, 0.7, 1.0, .8);
-    auto *t = _entityContainer.tree();
+    auto *t = _document->spatialIndex().tree();
     t->walkQuad(
         [painter](const lc::QuadTreeSub<lc::entity::CADEntity_SPtr> &tree){
         lc::geo::Area a = tree.bounds();
@@ -485,10 +518,6 @@ void DocumentCanvas::drawEntity(LCVDrawItem_CSPtr entity, lc::entity::Insert_CSP
 	painter.restore();	
 }
 
-void DocumentCanvas::on_commitProcessEvent(const lc::CommitProcessEvent&) {
-    _entityContainer.optimise();
-}
-
 void DocumentCanvas::on_addEntityEvent(const lc::AddEntityEvent& event) {
     auto entity = event.entity();
 
@@ -499,23 +528,51 @@ void DocumentCanvas::on_addEntityEvent(const lc::AddEntityEvent& event) {
     auto drawable = asDrawable(event.entity());
 
     if (drawable != nullptr) {
-		auto drawableEntity = std::dynamic_pointer_cast<lc::entity::CADEntity>(drawable);
-        _entityContainer.insert(drawableEntity);
+        _drawItems[entity->id()] = drawable;
+
+        // The entity isn't tested against the current selection area
+        _newSelectionValid = false;
     }
 }
 
 void DocumentCanvas::on_removeEntityEvent(const lc::RemoveEntityEvent& event) {
-    auto i = _entityContainer.entityByID(event.entity()->id());
+    auto id = event.entity()->id();
 
-    _entityContainer.remove(i);
+    _drawItems.erase(id);
+    _selection.erase(id);
+    _newSelection.erase(id);
 }
 
 std::shared_ptr<lc::Document> DocumentCanvas::document() const {
     return _document;
 }
 
-const lc::EntityContainer<lc::entity::CADEntity_SPtr>& DocumentCanvas::entityContainer() const {
-    return _entityContainer;
+const lc::EntityContainer<lc::entity::CADEntity_CSPtr>& DocumentCanvas::entityContainer() const {
+    return _document->spatialIndex();
+}
+
+LCVDrawItem_SPtr DocumentCanvas::drawItem(ID_DATATYPE id) const {
+    auto it = _drawItems.find(id);
+
+    if (it == _drawItems.end()) {
+        return nullptr;
+    }
+
+    return it->second;
+}
+
+lc::EntityContainer<lc::entity::CADEntity_SPtr> DocumentCanvas::drawItems(const lc::EntityContainer<lc::entity::CADEntity_CSPtr>& entities) const {
+    lc::EntityContainer<lc::entity::CADEntity_SPtr> items;
+
+    for (const auto& entity : entities.asVector()) {
+        auto di = drawItem(entity->id());
+
+        if (di != nullptr) {
+            items.insert(di);
+        }
+    }
+
+    return items;
 }
 
 void DocumentCanvas::createPainterFunctor(const std::function<LcPainter *(const unsigned int, const unsigned int)>& createPainterFunctor) {
@@ -527,50 +584,75 @@ void DocumentCanvas::deletePainterFunctor(const std::function<void(LcPainter*)>&
 }
 
 lc::geo::Area DocumentCanvas::bounds() const {
-    return _entityContainer.bounds();
+    return _document->spatialIndex().bounds();
 }
 
 void DocumentCanvas::makeSelection(double x, double y, double w, double h, bool occupies, bool addTo) {
-    if (_selectedArea != nullptr) {
-        delete _selectedArea;
-        _selectedArea = nullptr;
-    }
+    lc::geo::Area area(lc::geo::Coordinate(x, y), lc::geo::Coordinate(x + w, y + h));
 
-    _selectedArea = new lc::geo::Area(lc::geo::Coordinate(x, y), lc::geo::Coordinate(x + w, y + h));
-    // std::cout << *_selectedArea << std::endl;
-    _selectedAreaIntersects = occupies;
+    // Entities in the selection area are displayed toggled
+    SelectionSet displayed = _selection;
+    displayed.toggle(_newSelection);
 
     // Remove current selection
     if (!addTo) {
-        removeSelection();
+        _selection.clear();
+    }
+
+    if (_selectedArea != nullptr && _newSelectionValid && _selectedAreaIntersects == occupies) {
+        // Only entities touching the strips added or removed since the previous area can change
+        SelectionSet tested;
+
+        for (const auto& strips : {_selectedArea->difference(area), area.difference(*_selectedArea)}) {
+            for (const auto& strip : strips) {
+                for (const auto& entity : _document->spatialIndex().entitiesOverlapping(strip)) {
+                    if (!tested.insert(entity->id()) || _drawItems.find(entity->id()) == _drawItems.end()) {
+                        continue;
+                    }
+
+                    if (inSelectionArea(entity, area, occupies)) {
+                        _newSelection.insert(entity->id());
+                    }
+                    else {
+                        _newSelection.erase(entity->id());
+                    }
+                }
+            }
+        }
     }
+    else {
+        std::vector<lc::entity::CADEntity_CSPtr> entities;
+        if (occupies) {
+            entities = _document->spatialIndex().entitiesFullWithin(area);
+        } else {
+            entities = _document->spatialIndex().entitiesWithinAndCrossing(area);
+        }
 
-    _newSelection.each< LCVDrawItem >([](LCVDrawItem_SPtr di) {
-        di->selected(false);
-    });
-
-    _selectedEntities.each< LCVDrawItem >([](LCVDrawItem_SPtr di) {
-        di->selected(true);
-    });
+        _newSelection.clear();
+        for (const auto& entity : entities) {
+            if (_drawItems.find(entity->id()) != _drawItems.end()) {
+                _newSelection.insert(entity->id());
+            }
+        }
+    }
 
-    if (occupies) {
-        _newSelection = _entityContainer.entitiesFullWithinArea(*_selectedArea);
-    } else {
-        _newSelection = _entityContainer.entitiesWithinAndCrossingArea(*_selectedArea);
+    if (_selectedArea != nullptr) {
+        delete _selectedArea;
     }
 
+    _selectedArea = new lc::geo::Area(area);
+    _selectedAreaIntersects = occupies;
+    _newSelectionValid = true;
 
+    updateSelected(displayed);
+}
 
-    _newSelection.each< LCVDrawItem >([&](LCVDrawItem_SPtr di) {
-        // std::cerr<< __FILE__ << " : " << __FUNCTION__ << " : " << __LINE__ << " " << typeid(*di).name() << std::endl;
-        auto entity = std::dynamic_pointer_cast<lc::entity::CADEntity>(di);
-        if(entity && _selectedEntities.entityByID(entity->id()) != nullptr) {
-            di->selected(false);
-        }
-        else {
-            di->selected(true);
-        }
-    });
+bool DocumentCanvas::inSelectionArea(const lc::entity::CADEntity_CSPtr& entity, const lc::geo::Area& area, bool occupies) {
+    if (occupies) {
+        return entity->boundingBox().inArea(area);
+    }
+
+    return lc::EntityContainer<lc::entity::CADEntity_CSPtr>::withinOrCrossing(entity, area);
 }
 
 void DocumentCanvas::makeSelectionDevice(unsigned int x, unsigned int y, unsigned int w, unsigned int h, bool occupies, bool addTo) {
@@ -590,20 +672,10 @@ void DocumentCanvas::makeSelectionDevice(unsigned int x, unsigned int y, unsigne
 }
 
 void DocumentCanvas::closeSelection() {
-    _newSelection.each<lc::entity::CADEntity>([&](lc::entity::CADEntity_SPtr entity) {
-        auto drawable = std::dynamic_pointer_cast<LCVDrawItem>(entity);
-
-        if(_selectedEntities.entityByID(entity->id()) != nullptr) {
-            _selectedEntities.remove(entity);
-            drawable->selected(false);
-        }
-        else {
-            _selectedEntities.insert(entity);
-            drawable->selected(true);
-        }
-    });
-
-    _newSelection = lc::EntityContainer<lc::entity::CADEntity_SPtr>();
+    // Draw items are already displayed toggled
+    _selection.toggle(_newSelection);
+    _newSelection.clear();
+    _newSelectionValid = false;
 }
 
 void DocumentCanvas::removeSelectionArea() {
@@ -614,11 +686,26 @@ void DocumentCanvas::removeSelectionArea() {
 }
 
 void DocumentCanvas::removeSelection() {
-    _selectedEntities.each< LCVDrawItem >([](LCVDrawItem_SPtr di) {
-        di->selected(false);
-    });
+    SelectionSet displayed = _selection;
+    displayed.toggle(_newSelection);
 
-    _selectedEntities = lc::EntityContainer<lc::entity::CADEntity_SPtr>();
+    _selection.clear();
+
+    updateSelected(displayed);
+}
+
+void DocumentCanvas::updateSelected(const SelectionSet& displayed) {
+    SelectionSet changed = _selection;
+    changed.toggle(_newSelection);
+    changed.toggle(displayed);
+
+    changed.each([&](ID_DATATYPE id) {
+        auto di = drawItem(id);
+
+        if (di != nullptr) {
+            di->selected(!displayed.contains(id));
+        }
+    });
 }
 
 Nano::Signal<void(DrawEvent const & event)> & DocumentCanvas::background ()  {
@@ -628,116 +715,125 @@ Nano::Signal<void(DrawEvent const & event)> & DocumentCanvas::foreground ()  {
     return _foreground;
 }
 
-LCVDrawItem_SPtr DocumentCanvas::asDrawable(lc::entity::CADEntity_CSPtr entity) {
-    // Add a line
-    const auto line = std::dynamic_pointer_cast<const lc::entity::Line>(entity);
-
-    if (line != nullptr) {
-        return std::make_shared<LCVLine>(line);
-    }
-
-    // Add a circle
-    const auto circle = std::dynamic_pointer_cast<const lc::entity::Circle>(entity);
-
-    if (circle != nullptr) {
-        return std::make_shared<LCVCircle>(circle);
-    }
-
-    // Add a Arc
-    const auto arc = std::dynamic_pointer_cast<const lc::entity::Arc>(entity);
-
-    if (arc != nullptr) {
-        return std::make_shared<LCVArc>(arc);
-    }
-
-
-    // Add Ellipse
-    const auto ellipse = std::dynamic_pointer_cast<const lc::entity::Ellipse>(entity);
-
-    if (ellipse != nullptr) {
-        return std::make_shared<LCVEllipse>(ellipse);
-    }
-
-    // Add Text
-    const auto text = std::dynamic_pointer_cast<const lc::entity::Text>(entity);
-
-    if (text != nullptr) {
-        return std::make_shared<LCVText>(text);
-    }
-
-    // Add 'Point' or 'Coordinate'
-    const auto coord = std::dynamic_pointer_cast<const lc::entity::Point>(entity);
-
-    if (coord != nullptr) {
-        return std::make_shared<LCVPoint>(coord);
-    }
-
-    // Add 'DimRadial'
-    const auto dimRadial = std::dynamic_pointer_cast<const lc::entity::DimRadial>(entity);
-
-    if (dimRadial != nullptr) {
-        return std::make_shared<LCDimRadial>(dimRadial);
-    }
+namespace {
+    typedef LCVDrawItem_SPtr (*DrawableFactory)(const lc::entity::CADEntity_CSPtr&);
+
+    template<typename Entity, typename Drawable>
+    LCVDrawItem_SPtr makeDrawable(const lc::entity::CADEntity_CSPtr& entity) {
+        return std::make_shared<Drawable>(std::static_pointer_cast<const Entity>(entity));
+    }
+
+    // Draw item constructor of each entity kind, in the order of lc::entity::EntityKind
+    const DrawableFactory drawableFactories[] = {
+        makeDrawable<lc::entity::Point, LCVPoint>,
+        makeDrawable<lc::entity::Line, LCVLine>,
+        makeDrawable<lc::entity::Circle, LCVCircle>,
+        makeDrawable<lc::entity::Arc, LCVArc>,
+        makeDrawable<lc::entity::Ellipse, LCVEllipse>,
+        makeDrawable<lc::entity::Text, LCVText>,
+        makeDrawable<lc::entity::Spline, LCVSpline>,
+        makeDrawable<lc::entity::DimAligned, LCDimAligned>,
+        makeDrawable<lc::entity::DimAngular, LCDimAngular>,
+        makeDrawable<lc::entity::DimDiametric, LCDimDiametric>,
+        makeDrawable<lc::entity::DimLinear, LCDimLinear>,
+        makeDrawable<lc::entity::DimRadial, LCDimRadial>,
+        makeDrawable<lc::entity::LWPolyline, LCLWPolyline>,
+        makeDrawable<lc::entity::Image, LCImage>,
+        makeDrawable<lc::entity::Insert, LCVInsert>,
+        // Custom entities are drawn as their insert
+        makeDrawable<lc::entity::Insert, LCVInsert>,
+        // Entities unknown to the viewer are not drawn
+        nullptr
+    };
 
-    // Add 'DimDiametric'
-    const auto dimDiametric = std::dynamic_pointer_cast<const lc::entity::DimDiametric>(entity);
+    static_assert(sizeof(drawableFactories) / sizeof(drawableFactories[0]) == static_cast<size_t>(lc::entity::EntityKind::Other) + 1,
+                  "drawableFactories must have a entry for each entity kind");
+
+    // Size of the draw item of each entity kind, same order as drawableFactories
+    const size_t drawableSizes[] = {
+        sizeof(LCVPoint),
+        sizeof(LCVLine),
+        sizeof(LCVCircle),
+        sizeof(LCVArc),
+        sizeof(LCVEllipse),
+        sizeof(LCVText),
+        sizeof(LCVSpline),
+        sizeof(LCDimAligned),
+        sizeof(LCDimAngular),
+        sizeof(LCDimDiametric),
+        sizeof(LCDimLinear),
+        sizeof(LCDimRadial),
+        sizeof(LCLWPolyline),
+        sizeof(LCImage),
+        sizeof(LCVInsert),
+        sizeof(LCVInsert),
+        0
+    };
 
-    if (dimDiametric != nullptr) {
-        return std::make_shared<LCDimDiametric>(dimDiametric);
-    }
+    static_assert(sizeof(drawableSizes) / sizeof(drawableSizes[0]) == static_cast<size_t>(lc::entity::EntityKind::Other) + 1,
+                  "drawableSizes must have a entry for each entity kind");
+}
 
-    // Add 'DimLinear'
-    const auto dimLinear = std::dynamic_pointer_cast<const lc::entity::DimLinear>(entity);
+LCVDrawItem_SPtr DocumentCanvas::asDrawable(lc::entity::CADEntity_CSPtr entity) {
+    auto factory = drawableFactories[static_cast<size_t>(entity->kind())];
 
-    if (dimLinear != nullptr) {
-        return std::make_shared<LCDimLinear>(dimLinear);
+    if (factory == nullptr) {
+        return nullptr;
     }
 
-    // Add 'DimAligned'
-    const auto dimAligned = std::dynamic_pointer_cast<const lc::entity::DimAligned>(entity);
-
-    if (dimAligned != nullptr) {
-        return std::make_shared<LCDimAligned>(dimAligned);
-    }
+    return factory(entity);
+}
 
-    // Add 'DimAngular'
-    const auto dimAngular = std::dynamic_pointer_cast<const lc::entity::DimAngular>(entity);
+size_t DocumentCanvas::drawableSize(const LCVDrawItem& drawItem) {
+    return drawableSizes[static_cast<size_t>(drawItem.kind())] + lc::memory::SHARED_CONTROL_BLOCK;
+}
 
-    if (dimAngular != nullptr) {
-        return std::make_shared<LCDimAngular>(dimAngular);
+void DocumentCanvas::memoryUsage(lc::MemoryUsage& usage) const {
+    size_t drawItems = lc::memory::containerSize(_drawItems);
+    for (const auto& drawItem : _drawItems) {
+        drawItems += drawableSize(*drawItem.second);
+        drawItem.second->memoryUsage(usage);
     }
+    usage.add("canvas.drawItems", drawItems, _drawItems.size());
 
-    // Add 'LWPolyline'
-    const auto lwPolyline = std::dynamic_pointer_cast<const lc::entity::LWPolyline>(entity);
-
-    if (lwPolyline != nullptr) {
-        return std::make_shared<LCLWPolyline>(lwPolyline);
+    // All cache types can use the same painter
+    std::set<LcPainter*> painters;
+    for (const auto& painter : _cachedPainters) {
+        if (painter.second != nullptr && painters.insert(painter.second).second) {
+            size_t bytes = 0;
+            if (painter.second->data() != nullptr) {
+                bytes = static_cast<size_t>(_deviceWidth) * _deviceHeight * 4;
+            }
+            usage.add("canvas.painters", bytes);
+        }
     }
+}
 
-    // Add 'Spline'
-    const auto spline = std::dynamic_pointer_cast<const lc::entity::Spline>(entity);
+lc::EntityContainer<lc::entity::CADEntity_SPtr> DocumentCanvas::selection() {
+    lc::EntityContainer<lc::entity::CADEntity_SPtr> selection;
 
-    if (spline != nullptr) {
-        return std::make_shared<LCVSpline>(spline);
+    for (const auto& di : selectedDrawItems()) {
+        selection.insert(di);
     }
 
-    // Add 'Image'
-    const auto image = std::dynamic_pointer_cast<const lc::entity::Image>(entity);
+    return selection;
+}
 
-    if (image != nullptr) {
-        return std::make_shared<LCImage>(image);
-    }
+std::vector<LCVDrawItem_SPtr> DocumentCanvas::selectedDrawItems() const {
+    std::vector<LCVDrawItem_SPtr> items;
+    items.reserve(_selection.size());
 
-    // Add 'Insert'
-    const auto insert = std::dynamic_pointer_cast<const lc::entity::Insert>(entity);
+    _selection.each([&](ID_DATATYPE id) {
+        auto di = drawItem(id);
 
-    if (insert != nullptr) {
-        return std::make_shared<LCVInsert>(insert);
-    }
+        if (di != nullptr) {
+            items.push_back(di);
+        }
+    });
 
-    return nullptr;
+    return items;
 }
 
-lc::EntityContainer<lc::entity::CADEntity_SPtr> DocumentCanvas::selection() {
-    return _selectedEntities;
+const SelectionSet& DocumentCanvas::selectionSet() const {
+    return _selection;
 }
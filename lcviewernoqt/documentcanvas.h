@@ -1,16 +1,17 @@
 #pragma once
 
 #include <functional>
+#include <unordered_map>
 
 #include "painters/lcpainter.h"
 
 #include "cad/dochelpers/entitycontainer.h"
 #include "drawitems/lcvdrawitem.h"
 #include "events/drawevent.h"
+#include "selectionset.h"
 #include <cad/base/cadentity.h>
 
 #include <cad/events/addentityevent.h>
-#include <cad/events/commitprocessevent.h>
 #include <cad/events/removeentityevent.h>
 #include <nano-signal-slot/nano_signal_slot.hpp>
 
@@ -88,6 +89,12 @@ class DocumentCanvas : public std::enable_shared_from_this<DocumentCanvas> {
          */
         void zoom(double factor, bool relativezoom, double userCenterX, double userCenterY, unsigned int deviceCenterX, unsigned int deviceCenterY);
 
+        /**
+         * @brief setZoomLimits
+         * Scales beyond which zoom() doesn't zoom further, 0.005 and 200 by default
+         */
+        void setZoomLimits(double zoomMin, double zoomMax);
+
         /**
          * @brief newSize
          * for the device. When using a pixel based device this is the number of pixels of the painter
@@ -130,6 +137,7 @@ class DocumentCanvas : public std::enable_shared_from_this<DocumentCanvas> {
          * @brief makeSelection
          * within the document. It will color the area red/green depending on the occupies flag.
          * The coordinates must be given in user coordinates
+         * While the area is dragged only the entities near the moved edges are tested again.
          * @param x
          * @param y
          * @param w
@@ -164,8 +172,25 @@ class DocumentCanvas : public std::enable_shared_from_this<DocumentCanvas> {
 
         void removeSelection();
 
+        /**
+         * @brief selection
+         * @return draw items of the selected entities
+         */
         lc::EntityContainer<lc::entity::CADEntity_SPtr> selection();
 
+        /**
+         * @brief selectedDrawItems
+         * Same as selection() without building a container
+         * @return draw items of the selected entities, ordered by ID
+         */
+        std::vector<LCVDrawItem_SPtr> selectedDrawItems() const;
+
+        /**
+         * @brief selectionSet
+         * @return IDs of the selected entities, without the selection in progress
+         */
+        const SelectionSet& selectionSet() const;
+
         /**
          *
          */
@@ -194,15 +219,44 @@ class DocumentCanvas : public std::enable_shared_from_this<DocumentCanvas> {
         std::shared_ptr<lc::Document> document() const;
 
         /**
-         * Get the current entity container,
-         * do not store this as a reference, always call it
+         * Get the spatial index of the document, the canvas doesn't keep a index of its own.
+         * The entities are the document entities, use drawItem() or drawItems() to get what is drawn.
+         * Do not store this as a reference, always call it
+         */
+        const lc::EntityContainer<lc::entity::CADEntity_CSPtr>& entityContainer() const;
+
+        /**
+         * @brief drawItem
+         * @param id ID of a document entity
+         * @return draw item of the entity, nullptr if it isn't drawn
          */
-        const lc::EntityContainer<lc::entity::CADEntity_SPtr>& entityContainer() const;
+        LCVDrawItem_SPtr drawItem(ID_DATATYPE id) const;
+
+        /**
+         * @brief drawItems
+         * @param entities Entities of the document, for example from entityContainer()
+         * @return draw items of the entities
+         */
+        lc::EntityContainer<lc::entity::CADEntity_SPtr> drawItems(const lc::EntityContainer<lc::entity::CADEntity_CSPtr>& entities) const;
 
         /*
          * Return CADEntity as LCVDrawItem
          */
         static LCVDrawItem_SPtr asDrawable(lc::entity::CADEntity_CSPtr entity);
+
+        /**
+         * @brief drawableSize
+         * @return bytes of a draw item created by asDrawable(), without the data it calculates for drawing
+         */
+        static size_t drawableSize(const LCVDrawItem& drawItem);
+
+        /**
+         * @brief memoryUsage
+         * Add the draw items, their cached paths and insert copies, and the painters with a image buffer.
+         * The painters are created by the application, their size is estimated from the device size.
+         * @param usage filled with the canvas.* categories
+         */
+        void memoryUsage(lc::MemoryUsage& usage) const;
 private:
         /**
          * @brief cachedPainter
@@ -216,7 +270,6 @@ private:
 
         void on_addEntityEvent(const lc::AddEntityEvent&);
         void on_removeEntityEvent(const lc::RemoveEntityEvent&);
-        void on_commitProcessEvent(const lc::CommitProcessEvent&);
 
     private:
         double drawWidth(lc::entity::CADEntity_CSPtr entity, lc::entity::Insert_CSPtr insert);
@@ -230,8 +283,8 @@ private:
         // Original document
         std::shared_ptr<lc::Document> _document;
 
-        // Local entity container
-        lc::EntityContainer<lc::entity::CADEntity_SPtr> _entityContainer;
+        // Draw item of each model space entity, found through the spatial index of the document
+        std::unordered_map<ID_DATATYPE, LCVDrawItem_SPtr> _drawItems;
 
         Nano::Signal<void(DrawEvent const & event)> _background;
         Nano::Signal<void(DrawEvent const & event)> _foreground;
@@ -263,8 +316,26 @@ private:
         // Functor to draw a selected area, that's the green or read area...
         std::function<void(LcPainter&, lc::geo::Area, bool)> _selectedAreaPainter;
 
-        lc::EntityContainer<lc::entity::CADEntity_SPtr> _selectedEntities;
-        lc::EntityContainer<lc::entity::CADEntity_SPtr> _newSelection;
+        /**
+         * @brief updateSelected
+         * Update the selected flag of the draw items which are displayed differently
+         * @param displayed IDs displayed as selected before the change
+         */
+        void updateSelected(const SelectionSet& displayed);
+
+        /**
+         * @brief inSelectionArea
+         * @param occupies true if the entity must be fully within the area, false if it may cross the area
+         * @return true if the entity is selected by the area
+         */
+        static bool inSelectionArea(const lc::entity::CADEntity_CSPtr& entity, const lc::geo::Area& area, bool occupies);
+
+        // Selected entities
+        SelectionSet _selection;
+        // Entities in the selection area, toggled in the selection when the selection is closed
+        SelectionSet _newSelection;
+        // When true _newSelection holds the entities of _selectedArea and can be updated incrementally
+        bool _newSelectionValid;
 };
 
 DECLARE_SHORT_SHARED_PTR(DocumentCanvas)
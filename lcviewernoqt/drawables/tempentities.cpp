@@ -9,15 +9,17 @@ void TempEntities::addEntity(lc::entity::CADEntity_CSPtr entity) {
 
 	auto drawable = _docCanvas->asDrawable(entity);
 
-	_entities.insert(std::dynamic_pointer_cast<const lc::entity::CADEntity>(drawable));
+	if(drawable != nullptr) {
+		_entities[entity->id()] = drawable;
+	}
 }
 
 void TempEntities::removeEntity(lc::entity::CADEntity_CSPtr entity) {
-	_entities.remove(entity);
+	_entities.erase(entity->id());
 }
 
 void TempEntities::onDraw(DrawEvent const &event) {
-	_entities.each<const LCViewer::LCVDrawItem>([&](LCViewer::LCVDrawItem_CSPtr entity) {
-		_docCanvas->drawEntity(entity);
-	});
+	for(const auto& entity : _entities) {
+		_docCanvas->drawEntity(entity.second);
+	}
 }
\ No newline at end of file
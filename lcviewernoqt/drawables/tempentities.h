@@ -1,7 +1,7 @@
 #pragma once
 
 #include <cad/base/cadentity.h>
-#include <cad/dochelpers/entitycontainer.h>
+#include <map>
 #include "../drawitems/lcvdrawitem.h"
 #include "../events/drawevent.h"
 #include "../documentcanvas.h"
@@ -38,7 +38,8 @@ namespace LCViewer {
 
 		private:
 			DocumentCanvas_SPtr _docCanvas;
-			lc::EntityContainer<lc::entity::CADEntity_CSPtr> _entities;
+			// Only a few entities are shown at once and all of them are drawn, no spatial index is needed
+			std::map<ID_DATATYPE, LCVDrawItem_CSPtr> _entities;
 	};
 
 	using TempEntities_SPtr = std::shared_ptr<TempEntities>;
@@ -1,5 +1,5 @@
-#include <cad/geometry/geoarc.h>
-#include <documentcanvas.h>
+#include <cad/primitive/arc.h>
+#include <cad/primitive/line.h>
 #include "lclwpolyline.h"
 #include "../painters/lcpainter.h"
 #include "../lcdrawoptions.h"
@@ -8,20 +8,48 @@ LCLWPolyline::LCLWPolyline(const lc::entity::LWPolyline_CSPtr lwpolyline) :
         LCVDrawItem(lwpolyline, true),
         _polyLine(lwpolyline) {
 
-    for(auto entity : _polyLine->asEntities()) {
-        _drawItems.push_back(DocumentCanvas::asDrawable(entity));
+    // Each segment is stroked separately, like the line and arc draw items do
+    for(const auto& entity : _polyLine->asEntities()) {
+        switch(entity->kind()) {
+            case lc::entity::EntityKind::Line: {
+                auto line = std::static_pointer_cast<const lc::entity::Line>(entity);
+
+                _path.move_to(line->start().x(), line->start().y());
+                _path.line_to(line->end().x(), line->end().y());
+                _path.stroke();
+                break;
+            }
+
+            case lc::entity::EntityKind::Arc: {
+                auto arc = std::static_pointer_cast<const lc::entity::Arc>(entity);
+
+                if (arc->radius()) {
+                    if (arc->CCW()) {
+                        _path.arcNegative(arc->center().x(), arc->center().y(), arc->radius(), arc->startAngle(), arc->endAngle());
+                    } else {
+                        _path.arc(arc->center().x(), arc->center().y(), arc->radius(), arc->startAngle(), arc->endAngle());
+                    }
+                    _path.stroke();
+                }
+                break;
+            }
+
+            default:
+                break;
+        }
     }
+
+    _path.shrink_to_fit();
 }
 
 void LCLWPolyline::draw(LcPainter &painter, const LcDrawOptions &options, const lc::geo::Area &rect) const {
-    for(auto drawItem : _drawItems) {
-        drawItem->draw(painter, options, rect);
-    }
+    _path.draw(painter);
 }
 
 lc::entity::CADEntity_CSPtr LCLWPolyline::entity() const {
     return _polyLine;
 }
 
-
-
+void LCLWPolyline::memoryUsage(lc::MemoryUsage& usage) const {
+    usage.add("canvas.paths", _path.memorySize());
+}
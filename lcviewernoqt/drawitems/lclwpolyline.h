@@ -2,6 +2,7 @@
 
 #include "lcvdrawitem.h"
 #include <cad/primitive/lwpolyline.h>
+#include "../painters/lcpath.h"
 
 namespace LCViewer {
     class LCLWPolyline : public LCVDrawItem {
@@ -18,8 +19,11 @@ namespace LCViewer {
 
             lc::entity::CADEntity_CSPtr entity() const override;
 
+            void memoryUsage(lc::MemoryUsage& usage) const override;
+
         private:
             lc::entity::LWPolyline_CSPtr _polyLine;
-            std::vector<LCVDrawItem_CSPtr> _drawItems;
+            // Segments of the polyline as a single path, calculated once
+            LcPath _path;
     };
 }
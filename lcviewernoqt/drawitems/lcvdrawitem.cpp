@@ -51,4 +51,8 @@ LCVDrawItem::modify(lc::Layer_CSPtr layer, const lc::MetaInfo_CSPtr metaInfo, lc
 
 void LCVDrawItem::dispatch(lc::EntityDispatch& dispatch) const {
     entity()->dispatch(dispatch);
-}
\ No newline at end of file
+}
+
+lc::entity::EntityKind LCVDrawItem::kind() const {
+    return entity()->kind();
+}
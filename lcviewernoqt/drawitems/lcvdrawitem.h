@@ -3,6 +3,7 @@
 #include <memory>
 #include <cad/const.h>
 #include <cad/base/cadentity.h>
+#include <cad/dochelpers/memoryusage.h>
 
 namespace LCViewer {
     class LcDrawOptions;
@@ -43,6 +44,13 @@ namespace LCViewer {
              */
             virtual lc::entity::CADEntity_CSPtr entity() const = 0;
 
+            /**
+             * @brief Add the memory of the data calculated or copied for drawing
+             * The draw item itself is counted by DocumentCanvas::memoryUsage()
+             */
+            virtual void memoryUsage(lc::MemoryUsage& usage) const {
+            }
+
             //CADEntity functions
             lc::entity::CADEntity_CSPtr move(const lc::geo::Coordinate& offset) const override;
             lc::entity::CADEntity_CSPtr copy(const lc::geo::Coordinate& offset) const override;
@@ -52,6 +60,7 @@ namespace LCViewer {
             lc::entity::CADEntity_CSPtr
             modify(lc::Layer_CSPtr layer, const lc::MetaInfo_CSPtr metaInfo, lc::Block_CSPtr block) const override;
             void dispatch(lc::EntityDispatch& dispatch) const override;
+            lc::entity::EntityKind kind() const override;
 
         private:
             bool _selectable;
@@ -76,3 +76,12 @@ void LCVInsert::selected(bool selected) {
 lc::entity::CADEntity_CSPtr LCVInsert::entity() const {
     return _insert;
 }
+
+void LCVInsert::memoryUsage(lc::MemoryUsage& usage) const {
+    usage.add("canvas.insertCopies", lc::memory::containerSize(_entities), 0);
+
+    for(const auto& entity : _entities) {
+        usage.add("canvas.insertCopies", DocumentCanvas::drawableSize(*entity.second) + lc::memory::entitySize(*entity.second->entity()));
+        entity.second->memoryUsage(usage);
+    }
+}
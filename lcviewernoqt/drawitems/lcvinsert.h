@@ -20,6 +20,11 @@ namespace LCViewer {
 
             lc::entity::CADEntity_CSPtr entity() const override;
 
+            /**
+             * @brief Add the moved copies of the block entities and their draw items
+             */
+            void memoryUsage(lc::MemoryUsage& usage) const override;
+
         private:
             void append(lc::entity::CADEntity_CSPtr entity);
 
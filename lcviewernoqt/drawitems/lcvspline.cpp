@@ -7,28 +7,33 @@ using namespace LCViewer;
 LCVSpline::LCVSpline(const lc::entity::Spline_CSPtr spline) :
         LCVDrawItem(spline, true),
         _spline(spline) {
-}
-
-void LCVSpline::draw(LcPainter &painter, const LcDrawOptions &options, const lc::geo::Area &rect) const {
 
-    auto bezlist = _spline->beziers();
-
-    for(const auto &bezier: bezlist) {
+    for(const auto &bezier: _spline->beziers()) {
         auto bez = bezier->getCP();
 
-        painter.move_to(bez[0].x(), bez[0].y());
+        _path.move_to(bez[0].x(), bez[0].y());
 
         if(bez.size()==4) {
-            painter.curve_to(bez[1].x(), bez[1].y(), bez[2].x(), bez[2].y(), bez[3].x(), bez[3].y());
+            _path.curve_to(bez[1].x(), bez[1].y(), bez[2].x(), bez[2].y(), bez[3].x(), bez[3].y());
         } else if (bez.size()==3) {
-            painter.quadratic_curve_to(bez[1].x(), bez[1].y(), bez[2].x(), bez[2].y());
+            _path.quadratic_curve_to(bez[1].x(), bez[1].y(), bez[2].x(), bez[2].y());
         } else if(bez.size()==2) {
-            painter.line_to(bez[1].x(), bez[1].y());
+            _path.line_to(bez[1].x(), bez[1].y());
         }
     }
-    painter.stroke();
+
+    _path.stroke();
+    _path.shrink_to_fit();
+}
+
+void LCVSpline::draw(LcPainter &painter, const LcDrawOptions &options, const lc::geo::Area &rect) const {
+    _path.draw(painter);
 }
 
 lc::entity::CADEntity_CSPtr LCVSpline::entity() const {
     return _spline;
 }
+
+void LCVSpline::memoryUsage(lc::MemoryUsage& usage) const {
+    usage.add("canvas.paths", _path.memorySize());
+}
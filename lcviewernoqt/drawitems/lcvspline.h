@@ -2,6 +2,7 @@
 
 #include "lcvdrawitem.h"
 #include "cad/primitive/spline.h"
+#include "../painters/lcpath.h"
 
 namespace LCViewer {
     class LcDrawOptions;
@@ -21,7 +22,11 @@ namespace LCViewer {
 
             lc::entity::CADEntity_CSPtr entity() const override;
 
+            void memoryUsage(lc::MemoryUsage& usage) const override;
+
         private:
             lc::entity::Spline_CSPtr _spline;
+            // Bezier curves of the spline, calculated once
+            LcPath _path;
     };
 }
@@ -12,22 +12,29 @@ DragManager::DragManager(DocumentCanvas_SPtr docCanvas, std::shared_ptr<Cursor>
 {}
 
 
-std::vector<lc::geo::Coordinate> DragManager::closeEntitiesDragPoints() {
-	std::vector<lc::geo::Coordinate> dragPoints;
+std::vector<LCVDrawItem_SPtr> DragManager::entitiesNearCursor() const {
+	auto entities = _docCanvas->selectedDrawItems();
+
+	if(entities.empty()) {
+		for(const auto& entity : _docCanvas->entityContainer().entitiesOverlapping(_toleranceArea)) {
+			auto drawable = _docCanvas->drawItem(entity->id());
 
-	auto entities = _docCanvas->selection();
-	if(entities.asVector().size() == 0) {
-		entities = _docCanvas->entityContainer().entitiesWithinAndCrossingAreaFast(_toleranceArea);
+			if(drawable) {
+				entities.push_back(drawable);
+			}
+		}
 	}
 
-	entities.each<const LCVDrawItem>([&](LCVDrawItem_CSPtr drawable) {
-        if(!drawable) {
-            return;
-        }
+	return entities;
+}
+
+std::vector<lc::geo::Coordinate> DragManager::closeEntitiesDragPoints() {
+	std::vector<lc::geo::Coordinate> dragPoints;
 
+	for(const auto& drawable : entitiesNearCursor()) {
         auto draggable = std::dynamic_pointer_cast<const lc::Draggable>(drawable->entity());
         if(!draggable) {
-            return;
+            continue;
         }
 
         auto entityDragPoints = draggable->dragPoints();
@@ -35,7 +42,7 @@ std::vector<lc::geo::Coordinate> DragManager::closeEntitiesDragPoints() {
         for(auto dragPoint : entityDragPoints) {
             dragPoints.push_back(dragPoint.second);
         }
-	});
+	}
 
 	return dragPoints;
 }
@@ -129,19 +136,7 @@ void DragManager::onMousePress() {
 	_entityBuilder = std::make_shared<lc::operation::EntityBuilder>(_docCanvas->document());
 	_builder->append(_entityBuilder);
 
-	auto entities = _docCanvas->selection();
-	if(entities.asVector().size() == 0) {
-		entities = _docCanvas->entityContainer().entitiesWithinAndCrossingAreaFast(_toleranceArea);
-	}
-
-	auto entitiesNearCursor = entities.asVector();
-
-	for(auto entity : entitiesNearCursor) {
-		auto drawable = std::dynamic_pointer_cast<const LCVDrawItem>(entity);
-		if(!drawable) {
-            continue;
-		}
-
+	for(const auto& drawable : entitiesNearCursor()) {
 		auto draggable = std::dynamic_pointer_cast<const lc::Draggable>(drawable->entity());
 		if(draggable) {
 			auto entityDragPoints = draggable->dragPoints();
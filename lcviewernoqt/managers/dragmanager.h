@@ -60,6 +60,11 @@ namespace LCViewer {
 			unsigned int _size;
 			lc::geo::Area _toleranceArea;
 
+			/**
+			 * @return draw items of the selection, or the draw items near the cursor when nothing is selected
+			 */
+			std::vector<LCVDrawItem_SPtr> entitiesNearCursor() const;
+
 			std::vector<lc::geo::Coordinate> closeEntitiesDragPoints();
 			std::vector<lc::geo::Coordinate> selectedEntitiesDragPoints();
 			void moveEntities();
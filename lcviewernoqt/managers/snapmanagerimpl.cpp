@@ -3,6 +3,7 @@
 #include <cad/primitive/circle.h>
 #include <cad/base/visitor.h>
 #include <cad/base/cadentity.h>
+#include <cad/base/instrumentation.h>
 #include <cad/functions/intersect.h>
 
 using namespace LCViewer;
@@ -18,6 +19,8 @@ SnapManagerImpl::SnapManagerImpl(DocumentCanvas_SPtr view, lc::Snapable_CSPtr gr
  * are done based on some functor where we can change the order.
  */
 void SnapManagerImpl::setDeviceLocation(int x, int y) {
+    lc::instrumentation::ScopedTimer timer("snap.setDeviceLocation");
+
     double x_ = x;
     double y_ = y;
 
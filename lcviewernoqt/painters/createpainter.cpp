@@ -1,6 +1,13 @@
 #include "createpainter.h"
 
 #include "lccairopainter.tcc"
+#include "lchairlinepainter.h"
+
 LCViewer::LcPainter* createCairoImagePainter(unsigned char* data, const unsigned int width, const unsigned int height) {
     return new LcCairoPainter<CairoPainter::backend::Image>(data, width, height);
-}
\ No newline at end of file
+}
+
+LCViewer::LcPainter* createHairlineImagePainter(unsigned char* data, const unsigned int width, const unsigned int height) {
+    int stride = cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, width);
+    return new LCViewer::LcHairlinePainter(createCairoImagePainter(data, width, height), data, width, height, stride);
+}
@@ -9,3 +9,10 @@
  */
 LCViewer::LcPainter* createCairoImagePainter(unsigned char* data, const unsigned int width, const unsigned int height);
 
+
+/**
+ * \brief Create new painter for images, drawing thin lines without Cairo.
+ * Wider lines, fills, text and images are drawn by a Cairo image painter on the same buffer.
+ * \return LcPainter*
+ */
+LCViewer::LcPainter* createHairlineImagePainter(unsigned char* data, const unsigned int width, const unsigned int height);
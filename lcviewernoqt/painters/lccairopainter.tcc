@@ -201,20 +201,21 @@ public:
     * @brief backend constructor for PDF, SVG - join stream if needed
     *
     * @param width, height, cairo_status_t (void * closure, const uchar *data, unsigned int length)
+    * @param closure passed to f_, allows painters writing to different streams at the same time
     * @see http://cairographics.org/manual/cairo-PNG-Support.html#cairo-write-func-t
     */
     using cairo_stream_func = cairo_status_t(void *closure, const unsigned char *data, unsigned int length);
-    LcCairoPainter(double width, double height, cairo_stream_func *f_) : _constantLineWidth(true), _lineWidth(1.), _lineWidthCompensation(0.) {
+    LcCairoPainter(double width, double height, cairo_stream_func *f_, void* closure = nullptr) : _constantLineWidth(true), _lineWidth(1.), _lineWidthCompensation(0.) {
 
         switch (T) {
             case CairoPainter::backend::PDF: {
                 /* _surface = cairo_pdf_surface_create("fastforward.pdf", width, height); */
-                _surface = cairo_pdf_surface_create_for_stream(f_, nullptr, width, height);
+                _surface = cairo_pdf_surface_create_for_stream(f_, closure, width, height);
             }
                 break;
 
             case CairoPainter::backend::SVG: {
-                _surface = cairo_svg_surface_create_for_stream(f_, nullptr, width, height);
+                _surface = cairo_svg_surface_create_for_stream(f_, closure, width, height);
             }
                 break;
         }
@@ -244,8 +245,8 @@ public:
 
     //template<CairoPainter::backend T_>
     //static LcCairoPainter<T>* createPainter(int width, int height);
-    void writePNG(std::string filename) {
-        cairo_surface_write_to_png(_surface, filename.c_str());
+    bool writePNG(std::string filename) {
+        return cairo_surface_write_to_png(_surface, filename.c_str()) == CAIRO_STATUS_SUCCESS;
     }
 
 public:
@@ -528,6 +529,14 @@ public:
         *y = matrix.y0;
     }
 
+    void flush() {
+        cairo_surface_flush(_surface);
+    }
+
+    void mark_dirty() {
+        cairo_surface_mark_dirty(_surface);
+    }
+
     /**
      * Loda image into a cairo surface
      * return's -1 if the surface wasn't loaded
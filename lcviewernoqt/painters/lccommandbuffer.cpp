@@ -0,0 +1,287 @@
+#include "lccommandbuffer.h"
+#include "lcpainter.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace LCViewer;
+
+LcCommandBuffer::ReplayState::ReplayState() :
+    command(0),
+    value(0),
+    string(0),
+    hasBase(false),
+    baseX(0.),
+    baseY(0.),
+    baseXX(1.),
+    baseYX(0.) {
+}
+
+void LcCommandBuffer::ReplayState::setBase(LcPainter& target) {
+    baseX = 0.;
+    baseY = 0.;
+    baseXX = 1.;
+    baseYX = 0.;
+    target.user_to_device(&baseX, &baseY);
+    target.user_to_device(&baseXX, &baseYX);
+    baseXX -= baseX;
+    baseYX -= baseY;
+    hasBase = true;
+}
+
+double LcCommandBuffer::ReplayState::baseScale() const {
+    return std::hypot(baseXX, baseYX);
+}
+
+void LcCommandBuffer::add(Command command, std::initializer_list<double> values) {
+    _commands.push_back(command);
+    _values.insert(_values.end(), values);
+}
+
+void LcCommandBuffer::add(Command command, const std::string& value) {
+    _commands.push_back(command);
+    _strings.push_back(value);
+}
+
+void LcCommandBuffer::addValues(const double* values, size_t count) {
+    _values.insert(_values.end(), values, values + count);
+}
+
+void LcCommandBuffer::replay(LcPainter& target) const {
+    ReplayState state;
+    replay(target, state, _commands.size(), false);
+}
+
+void LcCommandBuffer::replay(LcPainter& target, ReplayState& state, size_t end, bool skip) const {
+    const double* v = _values.data() + state.value;
+    auto string = _strings.begin() + state.string;
+    auto& patterns = state.patterns;
+    auto& images = state.images;
+
+    for (size_t i = state.command; i < end; i++) {
+        switch (_commands[i]) {
+            case Command::NewPath:
+                if (!skip) target.new_path();
+                break;
+
+            case Command::ClosePath:
+                if (!skip) target.close_path();
+                break;
+
+            case Command::NewSubPath:
+                if (!skip) target.new_sub_path();
+                break;
+
+            case Command::Clear:
+                if (!skip) target.clear(v[0], v[1], v[2], v[3]);
+                v += 4;
+                break;
+
+            case Command::MoveTo:
+                if (!skip) target.move_to(v[0], v[1]);
+                v += 2;
+                break;
+
+            case Command::LineTo:
+                if (!skip) target.line_to(v[0], v[1]);
+                v += 2;
+                break;
+
+            case Command::LineWidthCompensation:
+                target.lineWidthCompensation(v[0]);
+                v += 1;
+                break;
+
+            case Command::LineWidth:
+                target.line_width(v[0]);
+                v += 1;
+                break;
+
+            case Command::Scale:
+                target.scale(v[0]);
+                v += 1;
+                break;
+
+            case Command::Rotate:
+                target.rotate(v[0]);
+                v += 1;
+                break;
+
+            case Command::Arc:
+                if (!skip) target.arc(v[0], v[1], v[2], v[3], v[4]);
+                v += 5;
+                break;
+
+            case Command::ArcNegative:
+                if (!skip) target.arcNegative(v[0], v[1], v[2], v[3], v[4]);
+                v += 5;
+                break;
+
+            case Command::Circle:
+                if (!skip) target.circle(v[0], v[1], v[2]);
+                v += 3;
+                break;
+
+            case Command::Ellipse:
+                if (!skip) target.ellipse(v[0], v[1], v[2], v[3], v[4], v[5], v[6]);
+                v += 7;
+                break;
+
+            case Command::Rectangle:
+                if (!skip) target.rectangle(v[0], v[1], v[2], v[3]);
+                v += 4;
+                break;
+
+            case Command::Stroke:
+                if (!skip) target.stroke();
+                break;
+
+            case Command::SourceRgba:
+                target.source_rgba(v[0], v[1], v[2], v[3]);
+                v += 4;
+                break;
+
+            case Command::Translate:
+                target.translate(v[0], v[1]);
+                v += 2;
+                break;
+
+            case Command::FontSize:
+                target.font_size(v[0], v[1] != 0.);
+                v += 2;
+                break;
+
+            case Command::SelectFontFace:
+                target.select_font_face(string->c_str());
+                string++;
+                break;
+
+            case Command::Text:
+                if (!skip) target.text(string->c_str());
+                string++;
+                break;
+
+            case Command::QuadraticCurveTo:
+                if (!skip) target.quadratic_curve_to(v[0], v[1], v[2], v[3]);
+                v += 4;
+                break;
+
+            case Command::CurveTo:
+                if (!skip) target.curve_to(v[0], v[1], v[2], v[3], v[4], v[5]);
+                v += 6;
+                break;
+
+            case Command::Save:
+                target.save();
+                break;
+
+            case Command::Restore:
+                target.restore();
+                break;
+
+            case Command::PatternCreateLinear:
+                patterns.push_back(target.pattern_create_linear(v[0], v[1], v[2], v[3]));
+                v += 4;
+                break;
+
+            case Command::PatternAddColorStopRgba:
+                target.pattern_add_color_stop_rgba(patterns[static_cast<size_t>(v[0])], v[1], v[2], v[3], v[4], v[5]);
+                v += 6;
+                break;
+
+            case Command::SetPatternSource:
+                target.set_pattern_source(patterns[static_cast<size_t>(v[0])]);
+                v += 1;
+                break;
+
+            case Command::PatternDestroy:
+                target.pattern_destroy(patterns[static_cast<size_t>(v[0])]);
+                v += 1;
+                break;
+
+            case Command::Fill:
+                if (!skip) target.fill();
+                break;
+
+            case Command::Point:
+                if (!skip) target.point(v[0], v[1], v[2], v[3] != 0.);
+                v += 4;
+                break;
+
+            case Command::ResetTransformations:
+                target.reset_transformations();
+
+                if (state.hasBase) {
+                    target.translate(state.baseX, state.baseY);
+                    target.rotate(std::atan2(state.baseYX, state.baseXX));
+                    target.scale(state.baseScale());
+                }
+                break;
+
+            case Command::SetDash: {
+                const int count = static_cast<int>(v[0]);
+                target.set_dash(v + 3, count, v[1], v[2] != 0.);
+                v += 3 + count;
+                break;
+            }
+
+            case Command::ImageCreate:
+                images.push_back(target.image_create(*string));
+                string++;
+                break;
+
+            case Command::ImageDestroy:
+                target.image_destroy(images[static_cast<size_t>(v[0])]);
+                v += 1;
+                break;
+
+            case Command::Image:
+                if (!skip) target.image(images[static_cast<size_t>(v[0])], v[1], v[2], v[3], v[4], v[5], v[6]);
+                v += 7;
+                break;
+
+            case Command::DisableAntialias:
+                target.disable_antialias();
+                break;
+
+            case Command::EnableAntialias:
+                target.enable_antialias();
+                break;
+        }
+    }
+
+    state.command = std::max(state.command, end);
+    state.value = static_cast<size_t>(v - _values.data());
+    state.string = static_cast<size_t>(string - _strings.begin());
+}
+
+size_t LcCommandBuffer::size() const {
+    return _commands.size();
+}
+
+bool LcCommandBuffer::empty() const {
+    return _commands.empty();
+}
+
+void LcCommandBuffer::clear() {
+    _commands.clear();
+    _values.clear();
+    _strings.clear();
+}
+
+void LcCommandBuffer::shrink_to_fit() {
+    _commands.shrink_to_fit();
+    _values.shrink_to_fit();
+    _strings.shrink_to_fit();
+}
+
+size_t LcCommandBuffer::memorySize() const {
+    size_t size = _commands.capacity() * sizeof(Command) + _values.capacity() * sizeof(double) +
+                  _strings.capacity() * sizeof(std::string);
+
+    for (const auto& string : _strings) {
+        size += string.capacity();
+    }
+
+    return size;
+}
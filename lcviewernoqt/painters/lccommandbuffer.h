@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace LCViewer {
+    class LcPainter;
+
+    /**
+     * @brief Painter calls stored to be replayed later
+     * Commands and their values are stored in flat arrays, strings in a separate array.
+     * Used by LcPath for the paths of the draw items and by LcRecordingPainter for complete drawings.
+     */
+    class LcCommandBuffer {
+        public:
+            enum class Command : uint8_t {
+                NewPath,
+                ClosePath,
+                NewSubPath,
+                Clear,
+                MoveTo,
+                LineTo,
+                LineWidthCompensation,
+                LineWidth,
+                Scale,
+                Rotate,
+                Arc,
+                ArcNegative,
+                Circle,
+                Ellipse,
+                Rectangle,
+                Stroke,
+                SourceRgba,
+                Translate,
+                FontSize,
+                SelectFontFace,
+                Text,
+                QuadraticCurveTo,
+                CurveTo,
+                Save,
+                Restore,
+                PatternCreateLinear,
+                PatternAddColorStopRgba,
+                SetPatternSource,
+                PatternDestroy,
+                Fill,
+                Point,
+                ResetTransformations,
+                SetDash,
+                ImageCreate,
+                ImageDestroy,
+                Image,
+                DisableAntialias,
+                EnableAntialias
+            };
+
+            /**
+             * @brief Position of a replay and the objects it created on the target
+             * Allows to replay a buffer in several parts.
+             */
+            struct ReplayState {
+                ReplayState();
+
+                /**
+                 * @brief Return to the current transformation of the target on a recorded reset_transformations()
+                 * Without base, the transformation of the target is reset.
+                 */
+                void setBase(LcPainter& target);
+
+                /**
+                 * @return scale of the base transformation
+                 */
+                double baseScale() const;
+
+                // Next command, value and string to replay
+                size_t command;
+                size_t value;
+                size_t string;
+
+                // Handles of the patterns and images created on the target
+                std::vector<long> patterns;
+                std::vector<long> images;
+
+                bool hasBase;
+                double baseX;
+                double baseY;
+                double baseXX;
+                double baseYX;
+            };
+
+            void add(Command command, std::initializer_list<double> values = {});
+            void add(Command command, const std::string& value);
+            void addValues(const double* values, size_t count);
+
+            /**
+             * @brief Replay all commands on the painter
+             */
+            void replay(LcPainter& target) const;
+
+            /**
+             * @brief Replay the commands from the position of the state until end
+             * @param skip when true only the state changes are replayed, paths and paint operations are skipped
+             */
+            void replay(LcPainter& target, ReplayState& state, size_t end, bool skip) const;
+
+            /**
+             * @return number of commands
+             */
+            size_t size() const;
+            bool empty() const;
+            void clear();
+
+            /**
+             * @brief Release unused memory, call it when the buffer is complete
+             */
+            void shrink_to_fit();
+
+            /**
+             * @brief Bytes allocated for the commands, values and strings
+             */
+            size_t memorySize() const;
+
+        private:
+            std::vector<Command> _commands;
+            std::vector<double> _values;
+            std::vector<std::string> _strings;
+    };
+}
@@ -0,0 +1,286 @@
+#include "lccountingpainter.h"
+
+using namespace LCViewer;
+
+LcCountingPainter::LcCountingPainter() {
+    resetStatistics();
+}
+
+const LcCountingPainter::Statistics& LcCountingPainter::statistics() const {
+    return _statistics;
+}
+
+void LcCountingPainter::resetStatistics() {
+    _statistics = Statistics {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+}
+
+void LcCountingPainter::new_path() {
+    _statistics.calls++;
+    _statistics.paths++;
+    LcNullPainter::new_path();
+}
+
+void LcCountingPainter::close_path() {
+    _statistics.calls++;
+    LcNullPainter::close_path();
+}
+
+void LcCountingPainter::new_sub_path() {
+    _statistics.calls++;
+    LcNullPainter::new_sub_path();
+}
+
+void LcCountingPainter::clear(double r, double g, double b) {
+    _statistics.calls++;
+    LcNullPainter::clear(r, g, b);
+}
+
+void LcCountingPainter::clear(double r, double g, double b, double a) {
+    _statistics.calls++;
+    LcNullPainter::clear(r, g, b, a);
+}
+
+void LcCountingPainter::move_to(double x, double y) {
+    _statistics.calls++;
+    _statistics.segments++;
+    LcNullPainter::move_to(x, y);
+}
+
+void LcCountingPainter::line_to(double x, double y) {
+    _statistics.calls++;
+    _statistics.segments++;
+    LcNullPainter::line_to(x, y);
+}
+
+void LcCountingPainter::lineWidthCompensation(double lwc) {
+    _statistics.calls++;
+    _statistics.stateChanges++;
+    LcNullPainter::lineWidthCompensation(lwc);
+}
+
+void LcCountingPainter::line_width(double lineWidth) {
+    _statistics.calls++;
+    _statistics.stateChanges++;
+    LcNullPainter::line_width(lineWidth);
+}
+
+double LcCountingPainter::scale() {
+    _statistics.calls++;
+    return LcNullPainter::scale();
+}
+
+void LcCountingPainter::scale(double s) {
+    _statistics.calls++;
+    _statistics.transformations++;
+    LcNullPainter::scale(s);
+}
+
+void LcCountingPainter::rotate(double r) {
+    _statistics.calls++;
+    _statistics.transformations++;
+    LcNullPainter::rotate(r);
+}
+
+void LcCountingPainter::arc(double x, double y, double r, double start, double end) {
+    _statistics.calls++;
+    _statistics.segments++;
+    LcNullPainter::arc(x, y, r, start, end);
+}
+
+void LcCountingPainter::arcNegative(double x, double y, double r, double start, double end) {
+    _statistics.calls++;
+    _statistics.segments++;
+    LcNullPainter::arcNegative(x, y, r, start, end);
+}
+
+void LcCountingPainter::circle(double x, double y, double r) {
+    _statistics.calls++;
+    _statistics.segments++;
+    LcNullPainter::circle(x, y, r);
+}
+
+void LcCountingPainter::ellipse(double cx, double cy, double rx, double ry, double sa, double ea, double ra) {
+    _statistics.calls++;
+    _statistics.segments++;
+    LcNullPainter::ellipse(cx, cy, rx, ry, sa, ea, ra);
+}
+
+void LcCountingPainter::rectangle(double x1, double y1, double w, double h) {
+    _statistics.calls++;
+    _statistics.segments++;
+    LcNullPainter::rectangle(x1, y1, w, h);
+}
+
+void LcCountingPainter::stroke() {
+    _statistics.calls++;
+    _statistics.strokes++;
+    LcNullPainter::stroke();
+}
+
+void LcCountingPainter::source_rgb(double r, double g, double b) {
+    _statistics.calls++;
+    _statistics.stateChanges++;
+    LcNullPainter::source_rgb(r, g, b);
+}
+
+void LcCountingPainter::source_rgba(double r, double g, double b, double a) {
+    _statistics.calls++;
+    _statistics.stateChanges++;
+    LcNullPainter::source_rgba(r, g, b, a);
+}
+
+void LcCountingPainter::translate(double x, double y) {
+    _statistics.calls++;
+    _statistics.transformations++;
+    LcNullPainter::translate(x, y);
+}
+
+void LcCountingPainter::user_to_device(double* x, double* y) {
+    _statistics.calls++;
+    LcNullPainter::user_to_device(x, y);
+}
+
+void LcCountingPainter::device_to_user(double* x, double* y) {
+    _statistics.calls++;
+    LcNullPainter::device_to_user(x, y);
+}
+
+void LcCountingPainter::user_to_device_distance(double* dx, double* dy) {
+    _statistics.calls++;
+    LcNullPainter::user_to_device_distance(dx, dy);
+}
+
+void LcCountingPainter::device_to_user_distance(double* dx, double* dy) {
+    _statistics.calls++;
+    LcNullPainter::device_to_user_distance(dx, dy);
+}
+
+void LcCountingPainter::font_size(double size, bool deviceCoords) {
+    _statistics.calls++;
+    _statistics.stateChanges++;
+    LcNullPainter::font_size(size, deviceCoords);
+}
+
+void LcCountingPainter::select_font_face(const char* text_val) {
+    _statistics.calls++;
+    _statistics.stateChanges++;
+    LcNullPainter::select_font_face(text_val);
+}
+
+void LcCountingPainter::text(const char* text_val) {
+    _statistics.calls++;
+    _statistics.texts++;
+    LcNullPainter::text(text_val);
+}
+
+TextExtends LcCountingPainter::text_extends(const char* text_val) {
+    _statistics.calls++;
+    return LcNullPainter::text_extends(text_val);
+}
+
+void LcCountingPainter::quadratic_curve_to(double x1, double y1, double x2, double y2) {
+    _statistics.calls++;
+    _statistics.segments++;
+    LcNullPainter::quadratic_curve_to(x1, y1, x2, y2);
+}
+
+void LcCountingPainter::curve_to(double x1, double y1, double x2, double y2, double x3, double y3) {
+    _statistics.calls++;
+    _statistics.segments++;
+    LcNullPainter::curve_to(x1, y1, x2, y2, x3, y3);
+}
+
+void LcCountingPainter::save() {
+    _statistics.calls++;
+    _statistics.saves++;
+    LcNullPainter::save();
+}
+
+void LcCountingPainter::restore() {
+    _statistics.calls++;
+    _statistics.restores++;
+    LcNullPainter::restore();
+}
+
+long LcCountingPainter::pattern_create_linear(double x1, double y1, double x2, double y2) {
+    _statistics.calls++;
+    return LcNullPainter::pattern_create_linear(x1, y1, x2, y2);
+}
+
+void LcCountingPainter::pattern_add_color_stop_rgba(long pat, double offset, double r, double g, double b, double a) {
+    _statistics.calls++;
+    LcNullPainter::pattern_add_color_stop_rgba(pat, offset, r, g, b, a);
+}
+
+void LcCountingPainter::set_pattern_source(long pat) {
+    _statistics.calls++;
+    _statistics.stateChanges++;
+    LcNullPainter::set_pattern_source(pat);
+}
+
+void LcCountingPainter::pattern_destroy(long pat) {
+    _statistics.calls++;
+    LcNullPainter::pattern_destroy(pat);
+}
+
+void LcCountingPainter::fill() {
+    _statistics.calls++;
+    _statistics.fills++;
+    LcNullPainter::fill();
+}
+
+void LcCountingPainter::point(double x, double y, double size, bool deviceCoords) {
+    _statistics.calls++;
+    _statistics.points++;
+    LcNullPainter::point(x, y, size, deviceCoords);
+}
+
+void LcCountingPainter::reset_transformations() {
+    _statistics.calls++;
+    _statistics.transformations++;
+    LcNullPainter::reset_transformations();
+}
+
+unsigned char* LcCountingPainter::data() {
+    _statistics.calls++;
+    return LcNullPainter::data();
+}
+
+void LcCountingPainter::set_dash(const double* dashes, const int num_dashes, double offset, bool scaled) {
+    _statistics.calls++;
+    _statistics.stateChanges++;
+    LcNullPainter::set_dash(dashes, num_dashes, offset, scaled);
+}
+
+long LcCountingPainter::image_create(const std::string& file) {
+    _statistics.calls++;
+    return LcNullPainter::image_create(file);
+}
+
+void LcCountingPainter::image_destroy(long image) {
+    _statistics.calls++;
+    LcNullPainter::image_destroy(image);
+}
+
+void LcCountingPainter::image(long image, double uvx, double vy, double vvx, double vvy, double x, double y) {
+    _statistics.calls++;
+    _statistics.images++;
+    LcNullPainter::image(image, uvx, vy, vvx, vvy, x, y);
+}
+
+void LcCountingPainter::disable_antialias() {
+    _statistics.calls++;
+    _statistics.stateChanges++;
+    LcNullPainter::disable_antialias();
+}
+
+void LcCountingPainter::enable_antialias() {
+    _statistics.calls++;
+    _statistics.stateChanges++;
+    LcNullPainter::enable_antialias();
+}
+
+void LcCountingPainter::getTranslate(double* x, double* y) {
+    _statistics.calls++;
+    LcNullPainter::getTranslate(x, y);
+}
@@ -0,0 +1,735 @@
+#include "lchairlinepainter.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace LCViewer;
+
+constexpr double LcHairlinePainter::maxLineWidth;
+
+namespace {
+    // Maximum distance, in pixels, between a curve and its flattened segments
+    const double FLATTEN_TOLERANCE = 0.1;
+    const size_t MAX_CURVE_SEGMENTS = 8192;
+
+    size_t arcSegments(double sweep, double deviceRadius) {
+        if (deviceRadius <= FLATTEN_TOLERANCE) {
+            return 1;
+        }
+
+        double step = 2. * std::acos(1. - FLATTEN_TOLERANCE / deviceRadius);
+        double segments = std::ceil(std::abs(sweep) / step);
+
+        return static_cast<size_t>(std::max(1., std::min(segments, static_cast<double>(MAX_CURVE_SEGMENTS))));
+    }
+
+    /**
+     * @brief Number of segments of a Bezier curve, using Wang's formula
+     * @param factor degree * (degree - 1) / 8
+     * @param secondDifference largest second difference of the control points
+     */
+    size_t curveSegments(double factor, double secondDifference) {
+        double segments = std::ceil(std::sqrt(factor * secondDifference / FLATTEN_TOLERANCE));
+
+        if (!std::isfinite(segments)) {
+            return 1;
+        }
+
+        return static_cast<size_t>(std::max(1., std::min(segments, static_cast<double>(MAX_CURVE_SEGMENTS))));
+    }
+
+    uint32_t toColorComponent(double value) {
+        return static_cast<uint32_t>(std::max(0., std::min(value, 1.)) * 255. + 0.5);
+    }
+
+#ifdef __SSE2__
+    inline __m128i div255(__m128i value) {
+        value = _mm_add_epi16(value, _mm_set1_epi16(128));
+        return _mm_srli_epi16(_mm_add_epi16(value, _mm_srli_epi16(value, 8)), 8);
+    }
+#else
+    inline uint32_t div255(uint32_t value) {
+        value += 128;
+        return (value + (value >> 8)) >> 8;
+    }
+#endif
+
+    /**
+     * @brief Draw a premultiplied colour over a pixel
+     * @param coverage part of the pixel covered, between 0 and 255
+     */
+    inline void blend(uint32_t* pixel, uint32_t color, uint32_t coverage) {
+        if (coverage == 255 && (color >> 24) == 255) {
+            *pixel = color;
+            return;
+        }
+
+#ifdef __SSE2__
+        const __m128i zero = _mm_setzero_si128();
+        __m128i source = _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(color)), zero);
+        __m128i destination = _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(*pixel)), zero);
+
+        source = div255(_mm_mullo_epi16(source, _mm_set1_epi16(static_cast<short>(coverage))));
+
+        // Alpha is in the fourth lane
+        __m128i inverseAlpha = _mm_sub_epi16(_mm_set1_epi16(255), _mm_shufflelo_epi16(source, _MM_SHUFFLE(3, 3, 3, 3)));
+        destination = _mm_add_epi16(source, div255(_mm_mullo_epi16(destination, inverseAlpha)));
+
+        *pixel = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(destination, zero)));
+#else
+        uint32_t alpha = div255((color >> 24) * coverage);
+        uint32_t inverseAlpha = 255 - alpha;
+        uint32_t result = alpha << 24;
+
+        for (int shift = 0; shift < 24; shift += 8) {
+            uint32_t source = div255(((color >> shift) & 0xFF) * coverage);
+            uint32_t destination = div255(((*pixel >> shift) & 0xFF) * inverseAlpha);
+            result |= std::min<uint32_t>(source + destination, 255) << shift;
+        }
+
+        result = (result & 0x00FFFFFF) | (std::min<uint32_t>(alpha + div255((*pixel >> 24) * inverseAlpha), 255) << 24);
+        *pixel = result;
+#endif
+    }
+}
+
+LcHairlinePainter::LcHairlinePainter(LcPainter* fallback, unsigned char* data, unsigned int width, unsigned int height, unsigned int stride) :
+    _fallback(fallback),
+    _data(data),
+    _width(width),
+    _height(height),
+    _stride(stride),
+    _forwarded(false),
+    _hasCurrentPoint(false),
+    _flat(true),
+    _deviceScale(1.),
+    _matrixValid(false),
+    _state({1., 0xFF000000, false, false, true}),
+    _lineWidth(1.),
+    _lineWidthCompensation(0.),
+    _hairlineStrokes(0),
+    _fallbackStrokes(0) {
+
+    _state.userLineWidth = 1. / std::abs(_fallback->scale());
+}
+
+size_t LcHairlinePainter::hairlineStrokes() const {
+    return _hairlineStrokes;
+}
+
+size_t LcHairlinePainter::fallbackStrokes() const {
+    return _fallbackStrokes;
+}
+
+LcPainter& LcHairlinePainter::pathPainter() {
+    if (_forwarded) {
+        return *_fallback;
+    }
+
+    return _path;
+}
+
+void LcHairlinePainter::forwardPath() {
+    if (!_forwarded) {
+        _path.replay(*_fallback);
+        _path.reset();
+        _forwarded = true;
+    }
+}
+
+void LcHairlinePainter::resetPath() {
+    _path.reset();
+    _forwarded = false;
+    _points.clear();
+    _subpaths.clear();
+    _hasCurrentPoint = false;
+    _flat = true;
+}
+
+void LcHairlinePainter::updateMatrix() {
+    if (_matrixValid) {
+        return;
+    }
+
+    double ox = 0., oy = 0.;
+    double xx = 1., xy = 0.;
+    double yx = 0., yy = 1.;
+    _fallback->user_to_device(&ox, &oy);
+    _fallback->user_to_device(&xx, &xy);
+    _fallback->user_to_device(&yx, &yy);
+
+    _matrix[0] = ox;
+    _matrix[1] = oy;
+    _matrix[2] = xx - ox;
+    _matrix[3] = xy - oy;
+    _matrix[4] = yx - ox;
+    _matrix[5] = yy - oy;
+
+    _deviceScale = std::sqrt(std::abs(_matrix[2] * _matrix[5] - _matrix[3] * _matrix[4]));
+    _matrixValid = true;
+}
+
+void LcHairlinePainter::toDevice(double x, double y, double& deviceX, double& deviceY) {
+    updateMatrix();
+    deviceX = _matrix[0] + x * _matrix[2] + y * _matrix[4];
+    deviceY = _matrix[1] + x * _matrix[3] + y * _matrix[5];
+}
+
+void LcHairlinePainter::deviceMoveTo(double x, double y) {
+    _subpaths.push_back(_points.size() / 2);
+    _points.push_back(x);
+    _points.push_back(y);
+    _hasCurrentPoint = true;
+}
+
+void LcHairlinePainter::deviceLineTo(double x, double y) {
+    if (!_hasCurrentPoint) {
+        deviceMoveTo(x, y);
+        return;
+    }
+
+    _points.push_back(x);
+    _points.push_back(y);
+}
+
+void LcHairlinePainter::deviceClosePath() {
+    if (!_hasCurrentPoint) {
+        return;
+    }
+
+    // Like Cairo, a new subpath starts at the first point of the closed one
+    size_t first = _subpaths.back() * 2;
+    double x = _points[first];
+    double y = _points[first + 1];
+
+    deviceLineTo(x, y);
+    deviceMoveTo(x, y);
+}
+
+void LcHairlinePainter::flattenArc(double x, double y, double r, double start, double end) {
+    updateMatrix();
+
+    const size_t segments = arcSegments(end - start, r * _deviceScale);
+    const double step = (end - start) / segments;
+
+    // Like Cairo, the arc is connected to the current point
+    for (size_t i = 0; i <= segments; i++) {
+        double angle = start + step * i;
+        double deviceX, deviceY;
+        toDevice(x + r * std::cos(angle), y + r * std::sin(angle), deviceX, deviceY);
+        deviceLineTo(deviceX, deviceY);
+    }
+}
+
+void LcHairlinePainter::new_path() {
+    if (_forwarded) {
+        _fallback->new_path();
+    }
+
+    resetPath();
+}
+
+void LcHairlinePainter::close_path() {
+    pathPainter().close_path();
+    deviceClosePath();
+}
+
+void LcHairlinePainter::new_sub_path() {
+    pathPainter().new_sub_path();
+    _hasCurrentPoint = false;
+}
+
+void LcHairlinePainter::clear(double r, double g, double b) {
+    _fallback->clear(r, g, b);
+}
+
+void LcHairlinePainter::clear(double r, double g, double b, double a) {
+    _fallback->clear(r, g, b, a);
+}
+
+void LcHairlinePainter::move_to(double x, double y) {
+    pathPainter().move_to(x, y);
+
+    double deviceX, deviceY;
+    toDevice(x, y, deviceX, deviceY);
+    deviceMoveTo(deviceX, deviceY);
+}
+
+void LcHairlinePainter::line_to(double x, double y) {
+    pathPainter().line_to(x, y);
+
+    double deviceX, deviceY;
+    toDevice(x, y, deviceX, deviceY);
+    deviceLineTo(deviceX, deviceY);
+}
+
+void LcHairlinePainter::lineWidthCompensation(double lwc) {
+    _fallback->lineWidthCompensation(lwc);
+    _lineWidthCompensation = lwc;
+}
+
+void LcHairlinePainter::line_width(double lineWidth) {
+    _fallback->line_width(lineWidth);
+
+    _lineWidth = lineWidth;
+    _state.userLineWidth = (lineWidth + _lineWidthCompensation) / std::abs(_fallback->scale());
+}
+
+double LcHairlinePainter::scale() {
+    return _fallback->scale();
+}
+
+void LcHairlinePainter::scale(double s) {
+    // The points of the current path were added with the previous transformation
+    if (!_path.empty()) {
+        forwardPath();
+    }
+
+    _fallback->scale(s);
+    _matrixValid = false;
+
+    _state.userLineWidth = (_lineWidth + _lineWidthCompensation) / std::abs(_fallback->scale());
+}
+
+void LcHairlinePainter::rotate(double r) {
+    if (!_path.empty()) {
+        forwardPath();
+    }
+
+    _fallback->rotate(r);
+    _matrixValid = false;
+}
+
+void LcHairlinePainter::arc(double x, double y, double r, double start, double end) {
+    pathPainter().arc(x, y, r, start, end);
+
+    // Clockwise, same angles as Cairo
+    while (end > start) {
+        end -= 2. * M_PI;
+    }
+
+    flattenArc(x, y, r, start, end);
+}
+
+void LcHairlinePainter::arcNegative(double x, double y, double r, double start, double end) {
+    pathPainter().arcNegative(x, y, r, start, end);
+
+    while (end < start) {
+        end += 2. * M_PI;
+    }
+
+    flattenArc(x, y, r, start, end);
+}
+
+void LcHairlinePainter::circle(double x, double y, double r) {
+    pathPainter().circle(x, y, r);
+    flattenArc(x, y, r, 0., -2. * M_PI);
+}
+
+void LcHairlinePainter::ellipse(double cx, double cy, double rx, double ry, double sa, double ea, double ra) {
+    pathPainter().ellipse(cx, cy, rx, ry, sa, ea, ra);
+
+    if (rx == 0) {
+        rx = 0.1;
+    }
+    if (ry == 0) {
+        ry = 0.1;
+    }
+
+    // Same direction as the Cairo painter, from ea to sa clockwise
+    double start = ea;
+    double end = sa;
+    if (ea == sa) {
+        start = 0.;
+        end = -2. * M_PI;
+    }
+    else {
+        while (end > start) {
+            end -= 2. * M_PI;
+        }
+    }
+
+    updateMatrix();
+
+    const double cosRotation = std::cos(ra);
+    const double sinRotation = std::sin(ra);
+    const size_t segments = arcSegments(end - start, std::max(std::abs(rx), std::abs(ry)) * _deviceScale);
+    const double step = (end - start) / segments;
+
+    for (size_t i = 0; i <= segments; i++) {
+        double angle = start + step * i;
+        double x = rx * std::cos(angle);
+        double y = ry * std::sin(angle);
+
+        double deviceX, deviceY;
+        toDevice(cx + x * cosRotation - y * sinRotation, cy + x * sinRotation + y * cosRotation, deviceX, deviceY);
+        deviceLineTo(deviceX, deviceY);
+    }
+}
+
+void LcHairlinePainter::rectangle(double x1, double y1, double w, double h) {
+    pathPainter().rectangle(x1, y1, w, h);
+
+    double x, y;
+    toDevice(x1, y1, x, y);
+    deviceMoveTo(x, y);
+    toDevice(x1 + w, y1, x, y);
+    deviceLineTo(x, y);
+    toDevice(x1 + w, y1 + h, x, y);
+    deviceLineTo(x, y);
+    toDevice(x1, y1 + h, x, y);
+    deviceLineTo(x, y);
+    deviceClosePath();
+}
+
+void LcHairlinePainter::stroke() {
+    if (_flat && hairline()) {
+        const double width = _state.userLineWidth * _deviceScale;
+
+        // Cairo may still have pending drawing on the surface, and caches what it knows of the pixels
+        _fallback->flush();
+
+        for (size_t i = 0; i < _subpaths.size(); i++) {
+            size_t first = _subpaths[i];
+            size_t last = i + 1 < _subpaths.size() ? _subpaths[i + 1] : _points.size() / 2;
+
+            for (size_t point = first; point + 1 < last; point++) {
+                drawSegment(_points[point * 2], _points[point * 2 + 1],
+                            _points[point * 2 + 2], _points[point * 2 + 3],
+                            width, _state.antialias);
+            }
+        }
+
+        _fallback->mark_dirty();
+
+        if (_forwarded) {
+            _fallback->new_path();
+        }
+
+        _hairlineStrokes++;
+    }
+    else {
+        forwardPath();
+        _fallback->stroke();
+
+        _fallbackStrokes++;
+    }
+
+    resetPath();
+}
+
+void LcHairlinePainter::source_rgb(double r, double g, double b) {
+    source_rgba(r, g, b, 1.);
+}
+
+void LcHairlinePainter::source_rgba(double r, double g, double b, double a) {
+    _fallback->source_rgba(r, g, b, a);
+
+    a = std::max(0., std::min(a, 1.));
+    _state.color = toColorComponent(a) << 24 |
+                   toColorComponent(r * a) << 16 |
+                   toColorComponent(g * a) << 8 |
+                   toColorComponent(b * a);
+    _state.pattern = false;
+}
+
+void LcHairlinePainter::translate(double x, double y) {
+    if (!_path.empty()) {
+        forwardPath();
+    }
+
+    _fallback->translate(x, y);
+    _matrixValid = false;
+}
+
+void LcHairlinePainter::user_to_device(double* x, double* y) {
+    _fallback->user_to_device(x, y);
+}
+
+void LcHairlinePainter::device_to_user(double* x, double* y) {
+    _fallback->device_to_user(x, y);
+}
+
+void LcHairlinePainter::user_to_device_distance(double* dx, double* dy) {
+    _fallback->user_to_device_distance(dx, dy);
+}
+
+void LcHairlinePainter::device_to_user_distance(double* dx, double* dy) {
+    _fallback->device_to_user_distance(dx, dy);
+}
+
+void LcHairlinePainter::font_size(double size, bool deviceCoords) {
+    _fallback->font_size(size, deviceCoords);
+}
+
+void LcHairlinePainter::select_font_face(const char* text_val) {
+    _fallback->select_font_face(text_val);
+}
+
+void LcHairlinePainter::text(const char* text_val) {
+    // Text starts at the current point and moves it
+    forwardPath();
+    _fallback->text(text_val);
+    _flat = false;
+}
+
+TextExtends LcHairlinePainter::text_extends(const char* text_val) {
+    return _fallback->text_extends(text_val);
+}
+
+void LcHairlinePainter::quadratic_curve_to(double x1, double y1, double x2, double y2) {
+    pathPainter().quadratic_curve_to(x1, y1, x2, y2);
+
+    double p1x, p1y, p2x, p2y;
+    toDevice(x1, y1, p1x, p1y);
+    toDevice(x2, y2, p2x, p2y);
+
+    if (!_hasCurrentPoint) {
+        deviceMoveTo(p1x, p1y);
+    }
+
+    const double p0x = _points[_points.size() - 2];
+    const double p0y = _points[_points.size() - 1];
+    const size_t segments = curveSegments(0.25, std::hypot(p0x - 2. * p1x + p2x, p0y - 2. * p1y + p2y));
+
+    for (size_t i = 1; i <= segments; i++) {
+        double t = static_cast<double>(i) / segments;
+        double mt = 1. - t;
+
+        deviceLineTo(mt * mt * p0x + 2. * mt * t * p1x + t * t * p2x,
+                     mt * mt * p0y + 2. * mt * t * p1y + t * t * p2y);
+    }
+}
+
+void LcHairlinePainter::curve_to(double x1, double y1, double x2, double y2, double x3, double y3) {
+    pathPainter().curve_to(x1, y1, x2, y2, x3, y3);
+
+    double p1x, p1y, p2x, p2y, p3x, p3y;
+    toDevice(x1, y1, p1x, p1y);
+    toDevice(x2, y2, p2x, p2y);
+    toDevice(x3, y3, p3x, p3y);
+
+    if (!_hasCurrentPoint) {
+        deviceMoveTo(p1x, p1y);
+    }
+
+    const double p0x = _points[_points.size() - 2];
+    const double p0y = _points[_points.size() - 1];
+    const size_t segments = curveSegments(0.75, std::max(
+            std::hypot(p0x - 2. * p1x + p2x, p0y - 2. * p1y + p2y),
+            std::hypot(p1x - 2. * p2x + p3x, p1y - 2. * p2y + p3y)
+    ));
+
+    for (size_t i = 1; i <= segments; i++) {
+        double t = static_cast<double>(i) / segments;
+        double mt = 1. - t;
+        double a = mt * mt * mt;
+        double b = 3. * mt * mt * t;
+        double c = 3. * mt * t * t;
+        double d = t * t * t;
+
+        deviceLineTo(a * p0x + b * p1x + c * p2x + d * p3x,
+                     a * p0y + b * p1y + c * p2y + d * p3y);
+    }
+}
+
+void LcHairlinePainter::save() {
+    if (!_path.empty()) {
+        forwardPath();
+    }
+
+    _fallback->save();
+    _savedStates.push_back(_state);
+}
+
+void LcHairlinePainter::restore() {
+    if (!_path.empty()) {
+        forwardPath();
+    }
+
+    _fallback->restore();
+    _matrixValid = false;
+
+    if (!_savedStates.empty()) {
+        _state = _savedStates.back();
+        _savedStates.pop_back();
+    }
+}
+
+long LcHairlinePainter::pattern_create_linear(double x1, double y1, double x2, double y2) {
+    return _fallback->pattern_create_linear(x1, y1, x2, y2);
+}
+
+void LcHairlinePainter::pattern_add_color_stop_rgba(long pat, double offset, double r, double g, double b, double a) {
+    _fallback->pattern_add_color_stop_rgba(pat, offset, r, g, b, a);
+}
+
+void LcHairlinePainter::set_pattern_source(long pat) {
+    _fallback->set_pattern_source(pat);
+    _state.pattern = true;
+}
+
+void LcHairlinePainter::pattern_destroy(long pat) {
+    _fallback->pattern_destroy(pat);
+}
+
+void LcHairlinePainter::fill() {
+    forwardPath();
+    _fallback->fill();
+    resetPath();
+}
+
+void LcHairlinePainter::point(double x, double y, double size, bool deviceCoords) {
+    // The point is added to the current path, which is filled
+    forwardPath();
+    _fallback->point(x, y, size, deviceCoords);
+    resetPath();
+}
+
+void LcHairlinePainter::reset_transformations() {
+    if (!_path.empty()) {
+        forwardPath();
+    }
+
+    _fallback->reset_transformations();
+    _matrixValid = false;
+}
+
+unsigned char* LcHairlinePainter::data() {
+    return _fallback->data();
+}
+
+void LcHairlinePainter::set_dash(const double* dashes, const int num_dashes, double offset, bool scaled) {
+    _fallback->set_dash(dashes, num_dashes, offset, scaled);
+    _state.dashed = num_dashes > 0;
+}
+
+long LcHairlinePainter::image_create(const std::string& file) {
+    return _fallback->image_create(file);
+}
+
+void LcHairlinePainter::image_destroy(long image) {
+    _fallback->image_destroy(image);
+}
+
+void LcHairlinePainter::image(long image, double uvx, double vy, double vvx, double vvy, double x, double y) {
+    _fallback->image(image, uvx, vy, vvx, vvy, x, y);
+}
+
+void LcHairlinePainter::disable_antialias() {
+    _fallback->disable_antialias();
+    _state.antialias = false;
+}
+
+void LcHairlinePainter::enable_antialias() {
+    _fallback->enable_antialias();
+    _state.antialias = true;
+}
+
+void LcHairlinePainter::getTranslate(double* x, double* y) {
+    _fallback->getTranslate(x, y);
+}
+
+void LcHairlinePainter::flush() {
+    _fallback->flush();
+}
+
+void LcHairlinePainter::mark_dirty() {
+    _fallback->mark_dirty();
+}
+
+bool LcHairlinePainter::hairline() {
+    if (_state.pattern || _state.dashed) {
+        return false;
+    }
+
+    updateMatrix();
+    return _state.userLineWidth * _deviceScale <= maxLineWidth;
+}
+
+void LcHairlinePainter::drawSegment(double x0, double y0, double x1, double y1, double width, bool antialias) {
+    const double dx = x1 - x0;
+    const double dy = y1 - y0;
+    const double length = std::hypot(dx, dy);
+
+    // Butt caps, a segment without length is not drawn
+    if (length == 0. || !std::isfinite(length)) {
+        return;
+    }
+
+    // Walk along the major axis u, the line covers a span of the minor axis v in each column
+    const bool steep = std::abs(dy) > std::abs(dx);
+    double u0 = steep ? y0 : x0;
+    double v0 = steep ? x0 : y0;
+    double u1 = steep ? y1 : x1;
+    double v1 = steep ? x1 : y1;
+
+    if (u0 > u1) {
+        std::swap(u0, u1);
+        std::swap(v0, v1);
+    }
+
+    const double majorSize = steep ? _height : _width;
+    const double minorSize = steep ? _width : _height;
+    const double slope = (v1 - v0) / (u1 - u0);
+
+    // Lines thinner than a pixel are drawn one pixel wide, with a lower coverage
+    const double halfThickness = 0.5 * std::max(width, 1.) * length / (u1 - u0);
+    const double opacity = std::min(width, 1.);
+
+    // Clamped on both sides before the conversion, segments can be far outside of the buffer
+    const int uStart = static_cast<int>(std::min(majorSize, std::max(0., std::floor(u0))));
+    const int uEnd = static_cast<int>(std::min(majorSize, std::max(0., std::ceil(u1))));
+
+    for (int u = uStart; u < uEnd; u++) {
+        double spanStart = std::max(u0, static_cast<double>(u));
+        double spanEnd = std::min(u1, u + 1.);
+
+        if (spanEnd <= spanStart) {
+            continue;
+        }
+
+        double center;
+        if (antialias) {
+            center = v0 + ((spanStart + spanEnd) * 0.5 - u0) * slope;
+        }
+        else {
+            // Without anti-aliasing a pixel is drawn when its center is inside the line
+            if (u + 0.5 < u0 || u + 0.5 >= u1) {
+                continue;
+            }
+
+            center = v0 + (u + 0.5 - u0) * slope;
+        }
+
+        const double top = center - halfThickness;
+        const double bottom = center + halfThickness;
+
+        const int vStart = static_cast<int>(std::min(minorSize, std::max(0., std::floor(top))));
+        const int vEnd = static_cast<int>(std::min(minorSize, std::max(0., std::ceil(bottom))));
+
+        for (int v = vStart; v < vEnd; v++) {
+            uint32_t coverage;
+
+            if (antialias) {
+                double covered = (spanEnd - spanStart) * (std::min(bottom, v + 1.) - std::max(top, static_cast<double>(v))) * opacity;
+                coverage = static_cast<uint32_t>(covered * 255. + 0.5);
+            }
+            else {
+                coverage = v + 0.5 >= top && v + 0.5 < bottom ? 255 : 0;
+            }
+
+            if (coverage == 0) {
+                continue;
+            }
+
+            const unsigned int x = steep ? v : u;
+            const unsigned int y = steep ? u : v;
+            blend(reinterpret_cast<uint32_t*>(_data + y * _stride) + x, _state.color, std::min<uint32_t>(coverage, 255));
+        }
+    }
+}
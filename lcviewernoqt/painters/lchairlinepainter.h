@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "lcpainter.h"
+#include "lcrecordingpainter.h"
+
+namespace LCViewer {
+    /**
+     * @brief Painter drawing thin solid lines directly into an ARGB32 buffer
+     *
+     * Paths are flattened to device coordinates while they are build. When a path is stroked with a solid colour,
+     * without dashes and with a line width up to maxLineWidth pixels, its segments are rasterized straight into
+     * the buffer with area coverage anti-aliasing.
+     * Pixels are blended one at a time, SSE2 is only used for the four channels of a pixel. A hairline covers
+     * one to three pixels across, so the spans are too short to vectorize over several pixels.
+     * Everything else (wider lines, dashes, patterns, fills, text and images) is drawn by the fallback painter,
+     * which must draw into the same buffer. All transformations and queries are handled by the fallback painter.
+     */
+    class LcHairlinePainter : public LcPainter {
+        public:
+            /**
+             * @brief Widest line, in pixels, drawn by the rasterizer
+             */
+            static constexpr double maxLineWidth = 2.;
+
+            /**
+             * @param fallback Painter drawing into data, this painter takes ownership
+             * @param data ARGB32 buffer with premultiplied alpha, like the buffer of a Cairo image surface
+             * @param stride Number of bytes between two rows
+             */
+            LcHairlinePainter(LcPainter* fallback, unsigned char* data, unsigned int width, unsigned int height, unsigned int stride);
+
+            /**
+             * @return number of strokes drawn by the rasterizer
+             */
+            size_t hairlineStrokes() const;
+
+            /**
+             * @return number of strokes drawn by the fallback painter
+             */
+            size_t fallbackStrokes() const;
+
+            void new_path() override;
+            void close_path() override;
+            void new_sub_path() override;
+            void clear(double r, double g, double b) override;
+            void clear(double r, double g, double b, double a) override;
+            void move_to(double x, double y) override;
+            void line_to(double x, double y) override;
+            void lineWidthCompensation(double lwc) override;
+            void line_width(double lineWidth) override;
+            double scale() override;
+            void scale(double s) override;
+            void rotate(double r) override;
+            void arc(double x, double y, double r, double start, double end) override;
+            void arcNegative(double x, double y, double r, double start, double end) override;
+            void circle(double x, double y, double r) override;
+            void ellipse(double cx, double cy, double rx, double ry, double sa, double ea, double ra = 0) override;
+            void rectangle(double x1, double y1, double w, double h) override;
+            void stroke() override;
+            void source_rgb(double r, double g, double b) override;
+            void source_rgba(double r, double g, double b, double a) override;
+            void translate(double x, double y) override;
+            void user_to_device(double* x, double* y) override;
+            void device_to_user(double* x, double* y) override;
+            void user_to_device_distance(double* dx, double* dy) override;
+            void device_to_user_distance(double* dx, double* dy) override;
+            void font_size(double size, bool deviceCoords) override;
+            void select_font_face(const char* text_val) override;
+            void text(const char* text_val) override;
+            TextExtends text_extends(const char* text_val) override;
+            void quadratic_curve_to(double x1, double y1, double x2, double y2) override;
+            void curve_to(double x1, double y1, double x2, double y2, double x3, double y3) override;
+            void save() override;
+            void restore() override;
+            long pattern_create_linear(double x1, double y1, double x2, double y2) override;
+            void pattern_add_color_stop_rgba(long pat, double offset, double r, double g, double b, double a) override;
+            void set_pattern_source(long pat) override;
+            void pattern_destroy(long pat) override;
+            void fill() override;
+            void point(double x, double y, double size, bool deviceCoords) override;
+            void reset_transformations() override;
+            unsigned char* data() override;
+            void set_dash(const double* dashes, const int num_dashes, double offset, bool scaled) override;
+            long image_create(const std::string& file) override;
+            void image_destroy(long image) override;
+            void image(long image, double uvx, double vy, double vvx, double vvy, double x, double y) override;
+            void disable_antialias() override;
+            void enable_antialias() override;
+            void getTranslate(double* x, double* y) override;
+            void flush() override;
+            void mark_dirty() override;
+
+        private:
+            /**
+             * @brief Graphic state saved by save()
+             */
+            struct State {
+                // Line width in user coordinates, calculated like the Cairo painter does
+                double userLineWidth;
+                // Premultiplied 0xAARRGGBB colour
+                uint32_t color;
+                bool pattern;
+                bool dashed;
+                bool antialias;
+            };
+
+            /**
+             * @brief Painter receiving the path commands in user coordinates
+             * The path is recorded until it needs to be drawn by the fallback painter.
+             */
+            LcPainter& pathPainter();
+
+            /**
+             * @brief Send the recorded path to the fallback painter, the next path commands are sent directly
+             */
+            void forwardPath();
+            void resetPath();
+
+            /**
+             * @brief Cache the transformation of the fallback painter
+             */
+            void updateMatrix();
+            void toDevice(double x, double y, double& deviceX, double& deviceY);
+
+            void deviceMoveTo(double x, double y);
+            void deviceLineTo(double x, double y);
+            void deviceClosePath();
+
+            /**
+             * @brief Add an arc from angle start to end, the angles are in user space
+             */
+            void flattenArc(double x, double y, double r, double start, double end);
+
+            /**
+             * @return true if the current path can be stroked by the rasterizer
+             */
+            bool hairline();
+
+            void drawSegment(double x0, double y0, double x1, double y1, double width, bool antialias);
+
+            std::unique_ptr<LcPainter> _fallback;
+            uint8_t* _data;
+            unsigned int _width;
+            unsigned int _height;
+            unsigned int _stride;
+
+            // Path in user coordinates
+            LcRecordingPainter _path;
+            bool _forwarded;
+
+            // Flattened path in device coordinates, x,y pairs, and index of the first point of each subpath
+            std::vector<double> _points;
+            std::vector<size_t> _subpaths;
+            bool _hasCurrentPoint;
+            // Set to false when the flattened path doesn't match the path of the fallback painter
+            bool _flat;
+
+            // Device coordinate of user (x, y) is origin + x * xAxis + y * yAxis
+            double _matrix[6];
+            double _deviceScale;
+            bool _matrixValid;
+
+            State _state;
+            std::vector<State> _savedStates;
+            double _lineWidth;
+            double _lineWidthCompensation;
+
+            size_t _hairlineStrokes;
+            size_t _fallbackStrokes;
+    };
+}
@@ -0,0 +1,202 @@
+#include "lcnullpainter.h"
+
+using namespace LCViewer;
+
+LcNullPainter::LcNullPainter() :
+    _matrix(lc::geo::Transform2D::identity()) {
+}
+
+const lc::geo::Transform2D& LcNullPainter::matrix() const {
+    return _matrix;
+}
+
+void LcNullPainter::resetMatrix() {
+    _matrix = lc::geo::Transform2D::identity();
+    _savedMatrices.clear();
+}
+
+void LcNullPainter::new_path() {
+}
+
+void LcNullPainter::close_path() {
+}
+
+void LcNullPainter::new_sub_path() {
+}
+
+void LcNullPainter::clear(double r, double g, double b) {
+}
+
+void LcNullPainter::clear(double r, double g, double b, double a) {
+}
+
+void LcNullPainter::move_to(double x, double y) {
+}
+
+void LcNullPainter::line_to(double x, double y) {
+}
+
+void LcNullPainter::lineWidthCompensation(double lwc) {
+}
+
+void LcNullPainter::line_width(double lineWidth) {
+}
+
+double LcNullPainter::scale() {
+    return _matrix.yy();
+}
+
+void LcNullPainter::scale(double s) {
+    _matrix = _matrix * lc::geo::Transform2D(s, 0., 0., s, 0., 0.);
+}
+
+void LcNullPainter::rotate(double r) {
+    _matrix = _matrix * lc::geo::Transform2D::rotation(lc::geo::Coordinate(0., 0.), r);
+}
+
+void LcNullPainter::arc(double x, double y, double r, double start, double end) {
+}
+
+void LcNullPainter::arcNegative(double x, double y, double r, double start, double end) {
+}
+
+void LcNullPainter::circle(double x, double y, double r) {
+}
+
+void LcNullPainter::ellipse(double cx, double cy, double rx, double ry, double sa, double ea, double ra) {
+}
+
+void LcNullPainter::rectangle(double x1, double y1, double w, double h) {
+}
+
+void LcNullPainter::stroke() {
+}
+
+void LcNullPainter::source_rgb(double r, double g, double b) {
+}
+
+void LcNullPainter::source_rgba(double r, double g, double b, double a) {
+}
+
+void LcNullPainter::translate(double x, double y) {
+    _matrix = _matrix * lc::geo::Transform2D::translation(lc::geo::Coordinate(x, y));
+}
+
+void LcNullPainter::user_to_device(double* x, double* y) {
+    auto device = _matrix.apply(lc::geo::Coordinate(*x, -*y));
+    *x = device.x();
+    *y = device.y();
+}
+
+void LcNullPainter::device_to_user(double* x, double* y) {
+    const double det = _matrix.xx() * _matrix.yy() - _matrix.xy() * _matrix.yx();
+    const double dx = *x - _matrix.x0();
+    const double dy = *y - _matrix.y0();
+
+    *x = (_matrix.yy() * dx - _matrix.xy() * dy) / det;
+    *y = -(_matrix.xx() * dy - _matrix.yx() * dx) / det;
+}
+
+void LcNullPainter::user_to_device_distance(double* dx, double* dy) {
+    const double x = *dx;
+    const double y = -*dy;
+
+    *dx = _matrix.xx() * x + _matrix.xy() * y;
+    *dy = _matrix.yx() * x + _matrix.yy() * y;
+}
+
+void LcNullPainter::device_to_user_distance(double* dx, double* dy) {
+    const double det = _matrix.xx() * _matrix.yy() - _matrix.xy() * _matrix.yx();
+    const double x = *dx;
+    const double y = *dy;
+
+    *dx = (_matrix.yy() * x - _matrix.xy() * y) / det;
+    *dy = -(_matrix.xx() * y - _matrix.yx() * x) / det;
+}
+
+void LcNullPainter::font_size(double size, bool deviceCoords) {
+}
+
+void LcNullPainter::select_font_face(const char* text_val) {
+}
+
+void LcNullPainter::text(const char* text_val) {
+}
+
+TextExtends LcNullPainter::text_extends(const char* text_val) {
+    return TextExtends {0., 0., 0., 0., 0., 0.};
+}
+
+void LcNullPainter::quadratic_curve_to(double x1, double y1, double x2, double y2) {
+}
+
+void LcNullPainter::curve_to(double x1, double y1, double x2, double y2, double x3, double y3) {
+}
+
+void LcNullPainter::save() {
+    _savedMatrices.push_back(_matrix);
+}
+
+void LcNullPainter::restore() {
+    if (!_savedMatrices.empty()) {
+        _matrix = _savedMatrices.back();
+        _savedMatrices.pop_back();
+    }
+}
+
+long LcNullPainter::pattern_create_linear(double x1, double y1, double x2, double y2) {
+    return 0;
+}
+
+void LcNullPainter::pattern_add_color_stop_rgba(long pat, double offset, double r, double g, double b, double a) {
+}
+
+void LcNullPainter::set_pattern_source(long pat) {
+}
+
+void LcNullPainter::pattern_destroy(long pat) {
+}
+
+void LcNullPainter::fill() {
+}
+
+void LcNullPainter::point(double x, double y, double size, bool deviceCoords) {
+}
+
+void LcNullPainter::reset_transformations() {
+    _matrix = lc::geo::Transform2D::identity();
+}
+
+unsigned char* LcNullPainter::data() {
+    return nullptr;
+}
+
+void LcNullPainter::set_dash(const double* dashes, const int num_dashes, double offset, bool scaled) {
+}
+
+long LcNullPainter::image_create(const std::string& file) {
+    return 0;
+}
+
+void LcNullPainter::image_destroy(long image) {
+}
+
+void LcNullPainter::image(long image, double uvx, double vy, double vvx, double vvy, double x, double y) {
+}
+
+void LcNullPainter::disable_antialias() {
+}
+
+void LcNullPainter::enable_antialias() {
+}
+
+void LcNullPainter::getTranslate(double* x, double* y) {
+    *x = _matrix.x0();
+    *y = _matrix.y0();
+}
+
+void LcNullPainter::flush() {
+}
+
+void LcNullPainter::mark_dirty() {
+}
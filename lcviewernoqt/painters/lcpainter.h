@@ -70,5 +70,9 @@ class LcPainter {
         // We should consider returning a matrix?
         virtual void getTranslate(double* x, double* y) = 0;
 
+        // Called before and after writing directly into data()
+        virtual void flush() = 0;
+        virtual void mark_dirty() = 0;
+
 };
 }
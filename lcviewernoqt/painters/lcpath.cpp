@@ -0,0 +1,47 @@
+#include "lcpath.h"
+
+using namespace LCViewer;
+
+void LcPath::move_to(double x, double y) {
+    _buffer.add(LcCommandBuffer::Command::MoveTo, {x, y});
+}
+
+void LcPath::line_to(double x, double y) {
+    _buffer.add(LcCommandBuffer::Command::LineTo, {x, y});
+}
+
+void LcPath::quadratic_curve_to(double x1, double y1, double x2, double y2) {
+    _buffer.add(LcCommandBuffer::Command::QuadraticCurveTo, {x1, y1, x2, y2});
+}
+
+void LcPath::curve_to(double x1, double y1, double x2, double y2, double x3, double y3) {
+    _buffer.add(LcCommandBuffer::Command::CurveTo, {x1, y1, x2, y2, x3, y3});
+}
+
+void LcPath::arc(double x, double y, double r, double start, double end) {
+    _buffer.add(LcCommandBuffer::Command::Arc, {x, y, r, start, end});
+}
+
+void LcPath::arcNegative(double x, double y, double r, double start, double end) {
+    _buffer.add(LcCommandBuffer::Command::ArcNegative, {x, y, r, start, end});
+}
+
+void LcPath::stroke() {
+    _buffer.add(LcCommandBuffer::Command::Stroke);
+}
+
+void LcPath::draw(LcPainter& painter) const {
+    _buffer.replay(painter);
+}
+
+bool LcPath::empty() const {
+    return _buffer.empty();
+}
+
+void LcPath::shrink_to_fit() {
+    _buffer.shrink_to_fit();
+}
+
+size_t LcPath::memorySize() const {
+    return _buffer.memorySize();
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+
+#include "lccommandbuffer.h"
+
+namespace LCViewer {
+    /**
+     * @brief Path which can be replayed on a painter
+     * Used by draw items with a path which is expensive to calculate, the path is build once
+     * and each draw only replays the commands.
+     * The commands are kept in the same buffer as LcRecordingPainter, only path commands can be added.
+     */
+    class LcPath {
+        public:
+            void move_to(double x, double y);
+            void line_to(double x, double y);
+            void quadratic_curve_to(double x1, double y1, double x2, double y2);
+            void curve_to(double x1, double y1, double x2, double y2, double x3, double y3);
+            void arc(double x, double y, double r, double start, double end);
+            void arcNegative(double x, double y, double r, double start, double end);
+            void stroke();
+
+            /**
+             * @brief Replay the commands on the painter
+             */
+            void draw(LcPainter& painter) const;
+
+            bool empty() const;
+
+            /**
+             * @brief Release unused memory, call it when the path is complete
+             */
+            void shrink_to_fit();
+
+            /**
+             * @brief Bytes allocated for the commands and values
+             */
+            size_t memorySize() const;
+
+        private:
+            LcCommandBuffer _buffer;
+    };
+}
@@ -0,0 +1,317 @@
+#include "lcrecordingpainter.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace LCViewer;
+
+LcRecordingPainter::LcRecordingPainter() :
+    _patterns(0),
+    _images(0),
+    _lineWidthCompensation(0.),
+    _lineWidth(1.) {
+
+    reset();
+}
+
+void LcRecordingPainter::reset() {
+    _buffer.clear();
+    _chunks.clear();
+    _chunks.push_back({0, lc::geo::Area(), false, false, 0.});
+
+    resetMatrix();
+    _patterns = 0;
+    _images = 0;
+    _lineWidthCompensation = 0.;
+    _lineWidth = 1.;
+    _savedLineWidths.clear();
+}
+
+bool LcRecordingPainter::empty() const {
+    return _buffer.empty();
+}
+
+size_t LcRecordingPainter::chunks() const {
+    return _chunks.back().command == _buffer.size() ? _chunks.size() - 1 : _chunks.size();
+}
+
+void LcRecordingPainter::record(Command command, std::initializer_list<double> values) {
+    _buffer.add(command, values);
+}
+
+void LcRecordingPainter::include(double x, double y) {
+    // Same as the Cairo painter, the y axis is flipped before applying the transformation
+    auto device = matrix().apply(lc::geo::Coordinate(x, -y));
+    lc::geo::Coordinate user(device.x(), -device.y());
+
+    auto& chunk = _chunks.back();
+    if (chunk.hasGeometry) {
+        chunk.boundingBox = chunk.boundingBox.merge(user);
+    }
+    else {
+        chunk.boundingBox = lc::geo::Area(user, user);
+        chunk.hasGeometry = true;
+    }
+}
+
+void LcRecordingPainter::include(double x, double y, double r) {
+    include(x - r, y - r);
+    include(x + r, y - r);
+    include(x - r, y + r);
+    include(x + r, y + r);
+}
+
+void LcRecordingPainter::endChunk(bool unbounded) {
+    _chunks.back().unbounded |= unbounded;
+    _chunks.push_back({_buffer.size(), lc::geo::Area(), false, false, 0.});
+}
+
+double LcRecordingPainter::matrixScale() const {
+    return std::sqrt(std::abs(matrix().xx() * matrix().yy() - matrix().xy() * matrix().yx()));
+}
+
+bool LcRecordingPainter::replay(LcPainter& target, const lc::geo::Transform2D& transform, const lc::geo::Area* visible) const {
+    // Decompose the transformation in translation, rotation and scale
+    const double scale = std::sqrt(std::abs(transform.xx() * transform.yy() - transform.xy() * transform.yx()));
+    const double tolerance = 1e-9 * std::max(scale, 1.);
+
+    if (scale == 0. ||
+        std::abs(transform.xx() - transform.yy()) > tolerance ||
+        std::abs(transform.xy() + transform.yx()) > tolerance) {
+        return false;
+    }
+
+    const bool transformed = transform.xx() != 1. || transform.yx() != 0. || transform.x0() != 0. || transform.y0() != 0.;
+
+    if (transformed) {
+        target.save();
+        target.translate(transform.x0(), -transform.y0());
+        target.rotate(-std::atan2(transform.yx(), transform.xx()));
+        target.scale(scale);
+    }
+
+    // A recorded reset_transformations() returns to the transformation of the target once the replay
+    // transformation is applied
+    LcCommandBuffer::ReplayState state;
+    state.setBase(target);
+    const double baseScale = state.baseScale();
+
+    // State changes are replayed for skipped chunks too, only the geometry is skipped
+    for (size_t chunk = 0; chunk < _chunks.size(); chunk++) {
+        const auto& c = _chunks[chunk];
+        const size_t end = chunk + 1 < _chunks.size() ? _chunks[chunk + 1].command : _buffer.size();
+        const bool skip = visible != nullptr && c.hasGeometry && !c.unbounded &&
+                          !c.boundingBox.increaseBy(c.lineWidth / 2. / baseScale).overlaps(*visible);
+
+        _buffer.replay(target, state, end, skip);
+    }
+
+    if (transformed) {
+        target.restore();
+    }
+
+    return true;
+}
+
+void LcRecordingPainter::new_path() {
+    record(Command::NewPath);
+}
+
+void LcRecordingPainter::close_path() {
+    record(Command::ClosePath);
+}
+
+void LcRecordingPainter::new_sub_path() {
+    record(Command::NewSubPath);
+}
+
+void LcRecordingPainter::clear(double r, double g, double b) {
+    clear(r, g, b, 1.);
+}
+
+void LcRecordingPainter::clear(double r, double g, double b, double a) {
+    record(Command::Clear, {r, g, b, a});
+    endChunk(true);
+}
+
+void LcRecordingPainter::move_to(double x, double y) {
+    record(Command::MoveTo, {x, y});
+    include(x, y);
+}
+
+void LcRecordingPainter::line_to(double x, double y) {
+    record(Command::LineTo, {x, y});
+    include(x, y);
+}
+
+void LcRecordingPainter::lineWidthCompensation(double lwc) {
+    record(Command::LineWidthCompensation, {lwc});
+    _lineWidthCompensation = lwc;
+}
+
+void LcRecordingPainter::line_width(double lineWidth) {
+    record(Command::LineWidth, {lineWidth});
+    // Same as the Cairo painter, the width is converted to user coordinates when it is set
+    _lineWidth = (lineWidth + _lineWidthCompensation) / matrixScale();
+}
+
+void LcRecordingPainter::scale(double s) {
+    record(Command::Scale, {s});
+    LcNullPainter::scale(s);
+}
+
+void LcRecordingPainter::rotate(double r) {
+    record(Command::Rotate, {r});
+    LcNullPainter::rotate(r);
+}
+
+void LcRecordingPainter::arc(double x, double y, double r, double start, double end) {
+    record(Command::Arc, {x, y, r, start, end});
+    include(x, y, r);
+}
+
+void LcRecordingPainter::arcNegative(double x, double y, double r, double start, double end) {
+    record(Command::ArcNegative, {x, y, r, start, end});
+    include(x, y, r);
+}
+
+void LcRecordingPainter::circle(double x, double y, double r) {
+    record(Command::Circle, {x, y, r});
+    include(x, y, r);
+}
+
+void LcRecordingPainter::ellipse(double cx, double cy, double rx, double ry, double sa, double ea, double ra) {
+    record(Command::Ellipse, {cx, cy, rx, ry, sa, ea, ra});
+    include(cx, cy, std::max(std::abs(rx), std::abs(ry)));
+}
+
+void LcRecordingPainter::rectangle(double x1, double y1, double w, double h) {
+    record(Command::Rectangle, {x1, y1, w, h});
+    include(x1, y1);
+    include(x1 + w, y1);
+    include(x1, y1 + h);
+    include(x1 + w, y1 + h);
+}
+
+void LcRecordingPainter::stroke() {
+    record(Command::Stroke);
+    _chunks.back().lineWidth = std::max(_chunks.back().lineWidth, _lineWidth * matrixScale());
+    endChunk();
+}
+
+void LcRecordingPainter::source_rgb(double r, double g, double b) {
+    source_rgba(r, g, b, 1.);
+}
+
+void LcRecordingPainter::source_rgba(double r, double g, double b, double a) {
+    record(Command::SourceRgba, {r, g, b, a});
+}
+
+void LcRecordingPainter::translate(double x, double y) {
+    record(Command::Translate, {x, y});
+    LcNullPainter::translate(x, y);
+}
+
+void LcRecordingPainter::font_size(double size, bool deviceCoords) {
+    record(Command::FontSize, {size, deviceCoords ? 1. : 0.});
+}
+
+void LcRecordingPainter::select_font_face(const char* text_val) {
+    _buffer.add(Command::SelectFontFace, text_val);
+}
+
+void LcRecordingPainter::text(const char* text_val) {
+    _buffer.add(Command::Text, text_val);
+    endChunk(true);
+}
+
+void LcRecordingPainter::quadratic_curve_to(double x1, double y1, double x2, double y2) {
+    // The curve is within its control points
+    record(Command::QuadraticCurveTo, {x1, y1, x2, y2});
+    include(x1, y1);
+    include(x2, y2);
+}
+
+void LcRecordingPainter::curve_to(double x1, double y1, double x2, double y2, double x3, double y3) {
+    record(Command::CurveTo, {x1, y1, x2, y2, x3, y3});
+    include(x1, y1);
+    include(x2, y2);
+    include(x3, y3);
+}
+
+void LcRecordingPainter::save() {
+    record(Command::Save);
+    _savedLineWidths.push_back(_lineWidth);
+    LcNullPainter::save();
+}
+
+void LcRecordingPainter::restore() {
+    record(Command::Restore);
+
+    if (!_savedLineWidths.empty()) {
+        _lineWidth = _savedLineWidths.back();
+        _savedLineWidths.pop_back();
+    }
+
+    LcNullPainter::restore();
+}
+
+long LcRecordingPainter::pattern_create_linear(double x1, double y1, double x2, double y2) {
+    record(Command::PatternCreateLinear, {x1, y1, x2, y2});
+    return _patterns++;
+}
+
+void LcRecordingPainter::pattern_add_color_stop_rgba(long pat, double offset, double r, double g, double b, double a) {
+    record(Command::PatternAddColorStopRgba, {static_cast<double>(pat), offset, r, g, b, a});
+}
+
+void LcRecordingPainter::set_pattern_source(long pat) {
+    record(Command::SetPatternSource, {static_cast<double>(pat)});
+}
+
+void LcRecordingPainter::pattern_destroy(long pat) {
+    record(Command::PatternDestroy, {static_cast<double>(pat)});
+}
+
+void LcRecordingPainter::fill() {
+    record(Command::Fill);
+    endChunk();
+}
+
+void LcRecordingPainter::point(double x, double y, double size, bool deviceCoords) {
+    record(Command::Point, {x, y, size, deviceCoords ? 1. : 0.});
+    include(x, y, deviceCoords ? size / std::abs(scale()) : size);
+    endChunk();
+}
+
+void LcRecordingPainter::reset_transformations() {
+    record(Command::ResetTransformations);
+    LcNullPainter::reset_transformations();
+}
+
+void LcRecordingPainter::set_dash(const double* dashes, const int num_dashes, double offset, bool scaled) {
+    record(Command::SetDash, {static_cast<double>(num_dashes), offset, scaled ? 1. : 0.});
+    _buffer.addValues(dashes, static_cast<size_t>(num_dashes));
+}
+
+long LcRecordingPainter::image_create(const std::string& file) {
+    _buffer.add(Command::ImageCreate, file);
+    return _images++;
+}
+
+void LcRecordingPainter::image_destroy(long image) {
+    record(Command::ImageDestroy, {static_cast<double>(image)});
+}
+
+void LcRecordingPainter::image(long image, double uvx, double vy, double vvx, double vvy, double x, double y) {
+    record(Command::Image, {static_cast<double>(image), uvx, vy, vvx, vvy, x, y});
+    endChunk(true);
+}
+
+void LcRecordingPainter::disable_antialias() {
+    record(Command::DisableAntialias);
+}
+
+void LcRecordingPainter::enable_antialias() {
+    record(Command::EnableAntialias);
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#include <cad/geometry/geoarea.h>
+#include <cad/math/transform2d.h>
+#include "lccommandbuffer.h"
+#include "lcnullpainter.h"
+
+namespace LCViewer {
+    /**
+     * @brief Painter recording all calls to replay them later on another painter
+     *
+     * Calls are stored in a LcCommandBuffer. The recording is split in chunks,
+     * a chunk ends after each stroke, fill, text, point, image or clear. The bounding box of each chunk
+     * is calculated while recording, so chunks outside the visible area can be skipped on replay.
+     * Line widths are in device pixels, the bounding box is grown by half the widest stroke of the chunk
+     * once the scale of the target is known. Transformations are tracked by LcNullPainter, a recorded
+     * reset_transformations() returns to the transformation of the target when the replay started.
+     *
+     * A recording painter has no shared state, it can be filled in a worker thread and replayed
+     * from any thread. Text extends are not known without a font, text_extends() returns empty extends
+     * and data() returns nullptr.
+     */
+    class LcRecordingPainter : public LcNullPainter {
+        public:
+            LcRecordingPainter();
+
+            /**
+             * @brief Replay the recording
+             * @param target Painter to draw on
+             * @param transform Transformation applied on the recording, must be a combination of translation,
+             * rotation and uniform scale because LcPainter can't express other transformations
+             * @param visible When not nullptr, chunks outside this area are skipped. The area is in the user
+             * coordinates of the recording, before applying transform.
+             * @return false if the transformation is not supported, nothing is drawn in that case
+             */
+            bool replay(LcPainter& target,
+                        const lc::geo::Transform2D& transform = lc::geo::Transform2D::identity(),
+                        const lc::geo::Area* visible = nullptr) const;
+
+            /**
+             * @brief Remove all recorded calls
+             */
+            void reset();
+
+            bool empty() const;
+
+            /**
+             * @return number of chunks which can be skipped separately
+             */
+            size_t chunks() const;
+
+            void new_path() override;
+            void close_path() override;
+            void new_sub_path() override;
+            void clear(double r, double g, double b) override;
+            void clear(double r, double g, double b, double a) override;
+            void move_to(double x, double y) override;
+            void line_to(double x, double y) override;
+            void lineWidthCompensation(double lwc) override;
+            void line_width(double lineWidth) override;
+            using LcNullPainter::scale;
+            void scale(double s) override;
+            void rotate(double r) override;
+            void arc(double x, double y, double r, double start, double end) override;
+            void arcNegative(double x, double y, double r, double start, double end) override;
+            void circle(double x, double y, double r) override;
+            void ellipse(double cx, double cy, double rx, double ry, double sa, double ea, double ra = 0) override;
+            void rectangle(double x1, double y1, double w, double h) override;
+            void stroke() override;
+            void source_rgb(double r, double g, double b) override;
+            void source_rgba(double r, double g, double b, double a) override;
+            void translate(double x, double y) override;
+            void font_size(double size, bool deviceCoords) override;
+            void select_font_face(const char* text_val) override;
+            void text(const char* text_val) override;
+            void quadratic_curve_to(double x1, double y1, double x2, double y2) override;
+            void curve_to(double x1, double y1, double x2, double y2, double x3, double y3) override;
+            void save() override;
+            void restore() override;
+            long pattern_create_linear(double x1, double y1, double x2, double y2) override;
+            void pattern_add_color_stop_rgba(long pat, double offset, double r, double g, double b, double a) override;
+            void set_pattern_source(long pat) override;
+            void pattern_destroy(long pat) override;
+            void fill() override;
+            void point(double x, double y, double size, bool deviceCoords) override;
+            void reset_transformations() override;
+            void set_dash(const double* dashes, const int num_dashes, double offset, bool scaled) override;
+            long image_create(const std::string& file) override;
+            void image_destroy(long image) override;
+            void image(long image, double uvx, double vy, double vvx, double vvy, double x, double y) override;
+            void disable_antialias() override;
+            void enable_antialias() override;
+
+        private:
+            using Command = LcCommandBuffer::Command;
+
+            struct Chunk {
+                // Index of the first command
+                size_t command;
+                // Bounding box of the geometry, in the user coordinates of the recording
+                lc::geo::Area boundingBox;
+                bool hasGeometry;
+                // Set when the extends can't be calculated, the chunk is never skipped
+                bool unbounded;
+                // Widest stroke, in device pixels of a target without scale
+                double lineWidth;
+            };
+
+            void record(Command command, std::initializer_list<double> values = {});
+
+            /**
+             * @brief Add a point in the current user coordinates to the bounding box of the current chunk
+             */
+            void include(double x, double y);
+
+            /**
+             * @brief Add a square around a center to the bounding box of the current chunk
+             */
+            void include(double x, double y, double r);
+
+            /**
+             * @brief End the current chunk after a paint operation
+             */
+            void endChunk(bool unbounded = false);
+
+            /**
+             * @return scale of the current transformation, whatever its rotation
+             */
+            double matrixScale() const;
+
+            LcCommandBuffer _buffer;
+            std::vector<Chunk> _chunks;
+
+            long _patterns;
+            long _images;
+
+            double _lineWidthCompensation;
+            // Width of the strokes in the current user coordinates, without the scale of the target
+            double _lineWidth;
+            std::vector<double> _savedLineWidths;
+    };
+}
@@ -0,0 +1,197 @@
+#include "selectionset.h"
+
+#include <algorithm>
+#include <bitset>
+
+using namespace LCViewer;
+
+const size_t SelectionSet::MIN_DENSE_WORDS;
+const size_t SelectionSet::DENSE_WORDS_PER_ID;
+
+SelectionSet::SelectionSet() : _size(0) {
+}
+
+bool SelectionSet::contains(ID_DATATYPE id) const {
+    const size_t word = id / 64;
+    if (word >= _words.size()) {
+        return _sparse.count(id) != 0;
+    }
+
+    return (_words[word] & (uint64_t(1) << (id % 64))) != 0;
+}
+
+bool SelectionSet::insert(ID_DATATYPE id) {
+    const size_t word = id / 64;
+    if (!reserve(word + 1, _size + 1)) {
+        if (!_sparse.insert(id).second) {
+            return false;
+        }
+
+        _size++;
+        return true;
+    }
+
+    const uint64_t bit = uint64_t(1) << (id % 64);
+    if ((_words[word] & bit) != 0) {
+        return false;
+    }
+
+    _words[word] |= bit;
+    _size++;
+    return true;
+}
+
+bool SelectionSet::erase(ID_DATATYPE id) {
+    const size_t word = id / 64;
+    if (word >= _words.size()) {
+        if (_sparse.erase(id) == 0) {
+            return false;
+        }
+
+        _size--;
+        return true;
+    }
+
+    const uint64_t bit = uint64_t(1) << (id % 64);
+    if ((_words[word] & bit) == 0) {
+        return false;
+    }
+
+    _words[word] &= ~bit;
+    _size--;
+    return true;
+}
+
+bool SelectionSet::toggle(ID_DATATYPE id) {
+    if (erase(id)) {
+        return false;
+    }
+
+    insert(id);
+    return true;
+}
+
+void SelectionSet::insert(const SelectionSet& other) {
+    reserve(other._words.size(), _size + other._size);
+
+    const size_t words = std::min(_words.size(), other._words.size());
+    for (size_t i = 0; i < words; i++) {
+        const uint64_t added = other._words[i] & ~_words[i];
+        _words[i] |= added;
+        _size += bitCount(added);
+    }
+
+    // Parts of other which are not covered by the bitmap
+    other.eachBit(words, [this](ID_DATATYPE id) {
+        insert(id);
+    });
+    for (auto id : other._sparse) {
+        insert(id);
+    }
+}
+
+void SelectionSet::erase(const SelectionSet& other) {
+    const size_t words = std::min(_words.size(), other._words.size());
+
+    for (size_t i = 0; i < words; i++) {
+        const uint64_t removed = other._words[i] & _words[i];
+        _words[i] &= ~removed;
+        _size -= bitCount(removed);
+    }
+
+    if (!_sparse.empty()) {
+        other.eachBit(words, [this](ID_DATATYPE id) {
+            erase(id);
+        });
+    }
+    for (auto id : other._sparse) {
+        erase(id);
+    }
+}
+
+void SelectionSet::toggle(const SelectionSet& other) {
+    reserve(other._words.size(), _size + other._size);
+
+    const size_t words = std::min(_words.size(), other._words.size());
+    for (size_t i = 0; i < words; i++) {
+        _size -= bitCount(_words[i]);
+        _words[i] ^= other._words[i];
+        _size += bitCount(_words[i]);
+    }
+
+    other.eachBit(words, [this](ID_DATATYPE id) {
+        toggle(id);
+    });
+    for (auto id : other._sparse) {
+        toggle(id);
+    }
+}
+
+void SelectionSet::clear() {
+    std::fill(_words.begin(), _words.end(), 0);
+    _sparse.clear();
+    _size = 0;
+}
+
+size_t SelectionSet::size() const {
+    return _size;
+}
+
+bool SelectionSet::empty() const {
+    return _size == 0;
+}
+
+std::vector<ID_DATATYPE> SelectionSet::ids() const {
+    std::vector<ID_DATATYPE> ids;
+    ids.reserve(_size);
+
+    each([&ids](ID_DATATYPE id) {
+        ids.push_back(id);
+    });
+
+    return ids;
+}
+
+size_t SelectionSet::memorySize() const {
+    // Nodes of std::set hold the value, three pointers and the color
+    return sizeof(SelectionSet) + _words.capacity() * sizeof(uint64_t) +
+           _sparse.size() * (sizeof(ID_DATATYPE) + 4 * sizeof(void*));
+}
+
+bool SelectionSet::operator==(const SelectionSet& other) const {
+    if (_size != other._size) {
+        return false;
+    }
+
+    // The same ID can be in the bitmap of one set and in the sparse set of the other
+    if (!_sparse.empty() || !other._sparse.empty()) {
+        return ids() == other.ids();
+    }
+
+    const size_t words = std::min(_words.size(), other._words.size());
+    return std::equal(_words.begin(), _words.begin() + words, other._words.begin());
+}
+
+unsigned int SelectionSet::bitCount(uint64_t word) {
+    return std::bitset<64>(word).count();
+}
+
+bool SelectionSet::reserve(size_t words, size_t count) {
+    if (_words.size() >= words) {
+        return true;
+    }
+
+    if (words > std::max(MIN_DENSE_WORDS, count * DENSE_WORDS_PER_ID)) {
+        return false;
+    }
+
+    _words.resize(words, 0);
+
+    const auto covered = _sparse.lower_bound(static_cast<ID_DATATYPE>(words * 64));
+    for (auto it = _sparse.begin(); it != covered; it++) {
+        _words[*it / 64] |= uint64_t(1) << (*it % 64);
+    }
+    _sparse.erase(_sparse.begin(), covered);
+
+    return true;
+}
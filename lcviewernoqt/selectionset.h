@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <vector>
+#include <cad/base/id.h>
+
+namespace LCViewer {
+    /**
+     * @brief Set of entity IDs
+     * Used for the selection state of the document canvas. The IDs are stored as a bitmap indexed by ID,
+     * testing, adding and removing a entity is a single bit operation and the set operations work on
+     * 64 entities at once.
+     * The bitmap only grows while it uses at most DENSE_WORDS_PER_ID words per ID in the set (or MIN_DENSE_WORDS),
+     * higher IDs are kept in a sorted set. A few entities with a large ID don't allocate a bitmap up to that ID,
+     * they are moved to the bitmap when enough entities are selected.
+     * Spatial queries are done on the document, the set only knows the IDs.
+     */
+    class SelectionSet {
+        public:
+            SelectionSet();
+
+            /**
+             * @return true if the entity is in the set
+             */
+            bool contains(ID_DATATYPE id) const;
+
+            /**
+             * @brief Add a entity
+             * @return false if it already was in the set
+             */
+            bool insert(ID_DATATYPE id);
+
+            /**
+             * @brief Remove a entity
+             * @return false if it wasn't in the set
+             */
+            bool erase(ID_DATATYPE id);
+
+            /**
+             * @brief Add the entity if it isn't in the set, remove it otherwise
+             * @return true if the entity is in the set afterwards
+             */
+            bool toggle(ID_DATATYPE id);
+
+            /**
+             * @brief Add all entities of other (union)
+             */
+            void insert(const SelectionSet& other);
+
+            /**
+             * @brief Remove all entities of other (difference)
+             */
+            void erase(const SelectionSet& other);
+
+            /**
+             * @brief Toggle all entities of other (symmetric difference)
+             */
+            void toggle(const SelectionSet& other);
+
+            /**
+             * @brief Remove all entities
+             * Keeps the memory, the set is usually filled again
+             */
+            void clear();
+
+            /**
+             * @return number of entities in the set
+             */
+            size_t size() const;
+
+            bool empty() const;
+
+            /**
+             * @return IDs in ascending order
+             */
+            std::vector<ID_DATATYPE> ids() const;
+
+            /**
+             * @brief Call func for each ID, in ascending order
+             */
+            template<typename F>
+            void each(F func) const {
+                eachBit(0, func);
+
+                // All IDs of the sparse set are above the bitmap
+                for (auto id : _sparse) {
+                    func(id);
+                }
+            }
+
+            /**
+             * @return bytes used by the set
+             */
+            size_t memorySize() const;
+
+            bool operator==(const SelectionSet& other) const;
+
+            /**
+             * Bitmap size which is always allowed, 65536 IDs
+             */
+            static const size_t MIN_DENSE_WORDS = 1024;
+
+            /**
+             * Words of the bitmap allowed for each ID in the set
+             */
+            static const size_t DENSE_WORDS_PER_ID = 2;
+
+        private:
+            /**
+             * @brief Call func for each ID of the bitmap, starting at the given word
+             */
+            template<typename F>
+            void eachBit(size_t firstWord, F func) const {
+                for (size_t i = firstWord; i < _words.size(); i++) {
+                    uint64_t word = _words[i];
+
+                    while (word != 0) {
+                        func(static_cast<ID_DATATYPE>(i * 64 + lowestBit(word)));
+                        word &= word - 1;
+                    }
+                }
+            }
+
+            static unsigned int lowestBit(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+                return __builtin_ctzll(word);
+#else
+                unsigned int bit = 0;
+                while ((word & 1) == 0) {
+                    word >>= 1;
+                    bit++;
+                }
+                return bit;
+#endif
+            }
+
+            static unsigned int bitCount(uint64_t word);
+
+            /**
+             * @brief Grow the bitmap to the given number of words if it's allowed for count IDs
+             * IDs of the sparse set which are covered afterwards are moved to the bitmap.
+             * @return true if the bitmap has at least this size
+             */
+            bool reserve(size_t words, size_t count);
+
+            std::vector<uint64_t> _words;
+            std::set<ID_DATATYPE> _sparse;
+            size_t _size;
+    };
+}
@@ -0,0 +1,679 @@
+#include "tileexporter.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+
+#include <cad/base/instrumentation.h>
+#include <cad/base/metainfo.h>
+#include <cad/base/threadpool.h>
+#include <cad/interface/entitydispatch.h>
+#include <cad/meta/block.h>
+#include <cad/meta/dxflinepattern.h>
+#include <cad/meta/layer.h>
+#include <cad/meta/metacolor.h>
+#include <cad/meta/metalinewidth.h>
+#include <cad/primitive/arc.h>
+#include <cad/primitive/circle.h>
+#include <cad/primitive/dimaligned.h>
+#include <cad/primitive/dimangular.h>
+#include <cad/primitive/dimdiametric.h>
+#include <cad/primitive/dimlinear.h>
+#include <cad/primitive/dimradial.h>
+#include <cad/primitive/ellipse.h>
+#include <cad/primitive/image.h>
+#include <cad/primitive/insert.h>
+#include <cad/primitive/line.h>
+#include <cad/primitive/lwpolyline.h>
+#include <cad/primitive/point.h>
+#include <cad/primitive/spline.h>
+#include <cad/primitive/text.h>
+#include "documentcanvas.h"
+
+using namespace LCViewer;
+
+namespace {
+    // 1 << 31 tiles per side would overflow the tile indices
+    const unsigned int MAX_ZOOM = 30;
+
+    // Tiles rendered by a thread with the same canvas before taking the next range
+    const size_t MIN_TILES_PER_RANGE = 4;
+
+    // Candidate tiles tested by a thread before taking the next range
+    const size_t MIN_CANDIDATES_PER_RANGE = 64;
+
+    void checkZoom(unsigned int zoom) {
+        if (zoom > MAX_ZOOM) {
+            throw std::runtime_error("Zoom level " + std::to_string(zoom) + " is above " + std::to_string(MAX_ZOOM));
+        }
+    }
+
+    /**
+     * FNV-1a hash of the values drawn on a tile
+     * Entities add their kind, layer, meta info and the values of their geometry. IDs are not added,
+     * they differ each time a file is opened.
+     */
+    class ContentHash : public lc::EntityDispatch {
+        public:
+            explicit ContentHash(const std::function<uint64_t(const lc::Block_CSPtr&)>& blockHash) :
+                _blockHash(blockHash),
+                _hash(14695981039346656037ULL) {
+            }
+
+            void add(const void* data, size_t size) {
+                auto bytes = static_cast<const unsigned char*>(data);
+
+                for (size_t i = 0; i < size; i++) {
+                    _hash ^= bytes[i];
+                    _hash *= 1099511628211ULL;
+                }
+            }
+
+            void add(uint64_t value) {
+                add(&value, sizeof(value));
+            }
+
+            void add(double value) {
+                add(&value, sizeof(value));
+            }
+
+            void add(const std::string& value) {
+                add(static_cast<uint64_t>(value.size()));
+                add(value.data(), value.size());
+            }
+
+            void add(const lc::geo::Coordinate& coordinate) {
+                add(coordinate.x());
+                add(coordinate.y());
+                add(coordinate.z());
+            }
+
+            void add(const lc::Color& color) {
+                add(color.red());
+                add(color.green());
+                add(color.blue());
+                add(color.alpha());
+            }
+
+            void add(const lc::geo::Area& area) {
+                add(area.minP());
+                add(area.maxP());
+            }
+
+            /**
+             * Add the entities ordered by their own hash, the order of the spatial index depends on its layout
+             */
+            void add(const std::vector<lc::entity::CADEntity_CSPtr>& entities) {
+                std::vector<uint64_t> hashes;
+                hashes.reserve(entities.size());
+
+                for (const auto& entity : entities) {
+                    ContentHash hash(_blockHash);
+                    hash.add(*entity);
+                    hashes.push_back(hash._hash);
+                }
+
+                std::sort(hashes.begin(), hashes.end());
+                for (auto hash : hashes) {
+                    add(hash);
+                }
+            }
+
+            void add(const lc::entity::CADEntity& entity) {
+                add(static_cast<uint64_t>(entity.kind()));
+
+                auto layer = entity.layer();
+                if (layer != nullptr) {
+                    add(layer->name());
+                    add(layer->color());
+                    add(layer->lineWidth().width());
+                    add(static_cast<uint64_t>(layer->isFrozen()));
+                    add(layer->linePattern() != nullptr ? layer->linePattern()->name() : std::string());
+                }
+
+                if (entity.metaInfo() != nullptr) {
+                    auto color = entity.metaInfo<lc::MetaColorByValue>(lc::MetaColor::LCMETANAME());
+                    if (color != nullptr) {
+                        add(color->color());
+                    }
+                    add(static_cast<uint64_t>(entity.metaInfo<lc::MetaColorByBlock>(lc::MetaColor::LCMETANAME()) != nullptr));
+
+                    auto lineWidth = entity.metaInfo<lc::MetaLineWidthByValue>(lc::MetaLineWidth::LCMETANAME());
+                    if (lineWidth != nullptr) {
+                        add(lineWidth->width());
+                    }
+                    add(static_cast<uint64_t>(entity.metaInfo<lc::MetaLineWidthByBlock>(lc::MetaLineWidth::LCMETANAME()) != nullptr));
+
+                    auto linePattern = entity.metaInfo<lc::DxfLinePatternByValue>(lc::DxfLinePattern::LCMETANAME());
+                    if (linePattern != nullptr) {
+                        add(linePattern->name());
+                    }
+                    add(static_cast<uint64_t>(entity.metaInfo<lc::DxfLinePatternByBlock>(lc::DxfLinePattern::LCMETANAME()) != nullptr));
+                }
+
+                entity.dispatch(*this);
+            }
+
+            void visit(lc::entity::Point_CSPtr point) override {
+                add(point->x());
+                add(point->y());
+            }
+
+            void visit(lc::entity::Line_CSPtr line) override {
+                add(line->start());
+                add(line->end());
+            }
+
+            void visit(lc::entity::Circle_CSPtr circle) override {
+                add(circle->center());
+                add(circle->radius());
+            }
+
+            void visit(lc::entity::Arc_CSPtr arc) override {
+                add(arc->center());
+                add(arc->radius());
+                add(arc->startAngle());
+                add(arc->endAngle());
+                add(static_cast<uint64_t>(arc->CCW()));
+            }
+
+            void visit(lc::entity::Ellipse_CSPtr ellipse) override {
+                add(ellipse->center());
+                add(ellipse->majorP());
+                add(ellipse->minorRadius());
+                add(ellipse->startAngle());
+                add(ellipse->endAngle());
+                add(static_cast<uint64_t>(ellipse->isReversed()));
+            }
+
+            void visit(lc::entity::Text_CSPtr text) override {
+                add(text->text_value());
+                add(text->style());
+                add(text->insertion_point());
+                add(text->height());
+                add(text->angle());
+                add(static_cast<uint64_t>(text->textgeneration()));
+                add(static_cast<uint64_t>(text->halign()));
+                add(static_cast<uint64_t>(text->valign()));
+            }
+
+            void visit(lc::entity::Spline_CSPtr spline) override {
+                for (const auto& point : spline->controlPoints()) {
+                    add(point);
+                }
+                for (auto knot : spline->knotPoints()) {
+                    add(knot);
+                }
+                for (const auto& point : spline->fitPoints()) {
+                    add(point);
+                }
+                add(static_cast<uint64_t>(spline->degree()));
+                add(static_cast<uint64_t>(spline->closed()));
+                add(static_cast<uint64_t>(spline->flags()));
+            }
+
+            void visit(lc::entity::DimAligned_CSPtr dimension) override {
+                addDimension(*dimension);
+                add(dimension->definitionPoint2());
+                add(dimension->definitionPoint3());
+            }
+
+            void visit(lc::entity::DimAngular_CSPtr dimension) override {
+                addDimension(*dimension);
+                add(dimension->defLine11());
+                add(dimension->defLine12());
+                add(dimension->defLine21());
+                add(dimension->defLine22());
+            }
+
+            void visit(lc::entity::DimDiametric_CSPtr dimension) override {
+                addDimension(*dimension);
+                add(dimension->definitionPoint2());
+                add(dimension->leader());
+            }
+
+            void visit(lc::entity::DimLinear_CSPtr dimension) override {
+                addDimension(*dimension);
+                add(dimension->definitionPoint2());
+                add(dimension->definitionPoint3());
+                add(dimension->angle());
+                add(dimension->oblique());
+            }
+
+            void visit(lc::entity::DimRadial_CSPtr dimension) override {
+                addDimension(*dimension);
+                add(dimension->definitionPoint2());
+                add(dimension->leader());
+            }
+
+            void visit(lc::entity::LWPolyline_CSPtr lwPolyline) override {
+                for (const auto& vertex : lwPolyline->vertex()) {
+                    add(vertex.location());
+                    add(vertex.bulge());
+                    add(vertex.startWidth());
+                    add(vertex.endWidth());
+                }
+                add(lwPolyline->width());
+                add(static_cast<uint64_t>(lwPolyline->closed()));
+            }
+
+            void visit(lc::entity::Image_CSPtr image) override {
+                add(image->name());
+                add(image->base());
+                add(image->uv());
+                add(image->vv());
+                add(image->width());
+                add(image->height());
+                add(image->brightness());
+                add(image->contrast());
+                add(image->fade());
+            }
+
+            void visit(lc::entity::Insert_CSPtr insert) override {
+                add(insert->position());
+
+                // The entities of the block are drawn at the position of the insert
+                if (insert->displayBlock() != nullptr) {
+                    add(insert->displayBlock()->name());
+                    add(_blockHash(insert->displayBlock()));
+                }
+            }
+
+            uint64_t value() const {
+                // 0 means no hash
+                return _hash == 0 ? 1 : _hash;
+            }
+
+        private:
+            void addDimension(const lc::entity::Dimension& dimension) {
+                add(dimension.definitionPoint());
+                add(dimension.middleOfText());
+                add(dimension.textAngle());
+                add(dimension.lineSpacingFactor());
+                add(dimension.explicitValue());
+                add(static_cast<uint64_t>(dimension.attachmentPoint()));
+                add(static_cast<uint64_t>(dimension.lineSpacingStyle()));
+            }
+
+            const std::function<uint64_t(const lc::Block_CSPtr&)>& _blockHash;
+            uint64_t _hash;
+    };
+}
+
+/**
+ * Canvas and painter of a thread, reused for all tiles of a range
+ */
+struct TileExporter::Renderer {
+    std::shared_ptr<DocumentCanvas> canvas;
+    LcPainter* painter = nullptr;
+};
+
+TileExporter::TileExporter(lc::Document_SPtr document) :
+    _document(document),
+    _tileSize(256),
+    _hasBounds(false),
+    _background(0., 0., 0., 1.) {
+}
+
+TileExporter::~TileExporter() {
+    // The canvases delete their painters through _deletePainterFunctor
+    _freeRenderers.clear();
+    _renderers.clear();
+}
+
+void TileExporter::setTileSize(unsigned int tileSize) {
+    std::lock_guard<std::mutex> lock(_renderersMutex);
+
+    _tileSize = tileSize;
+    _freeRenderers.clear();
+    _renderers.clear();
+}
+
+unsigned int TileExporter::tileSize() const {
+    return _tileSize;
+}
+
+void TileExporter::setBounds(const lc::geo::Area& bounds) {
+    _hasBounds = true;
+    _bounds = bounds;
+}
+
+lc::geo::Area TileExporter::bounds() const {
+    if (_hasBounds) {
+        return _bounds;
+    }
+
+    auto extends = _document->spatialIndex().boundingBox();
+    const double side = std::max(extends.width(), extends.height());
+    const double centerX = extends.minP().x() + extends.width() / 2.;
+    const double centerY = extends.minP().y() + extends.height() / 2.;
+
+    return lc::geo::Area(lc::geo::Coordinate(centerX - side / 2., centerY - side / 2.), side, side);
+}
+
+void TileExporter::setBackground(const lc::Color& background) {
+    _background = background;
+}
+
+void TileExporter::createPainterFunctor(const std::function<LcPainter*(const unsigned int, const unsigned int)>& createPainterFunctor) {
+    _createPainterFunctor = createPainterFunctor;
+}
+
+void TileExporter::deletePainterFunctor(const std::function<void(LcPainter*)>& deletePainterFunctor) {
+    _deletePainterFunctor = deletePainterFunctor;
+}
+
+void TileExporter::writeTileFunctor(const std::function<bool(LcPainter&, const Tile&)>& writeTileFunctor) {
+    _writeTileFunctor = writeTileFunctor;
+}
+
+void TileExporter::removeTileFunctor(const std::function<bool(const Tile&)>& removeTileFunctor) {
+    _removeTileFunctor = removeTileFunctor;
+}
+
+std::vector<TileExporter::Tile> TileExporter::occupiedTiles(unsigned int zoom) const {
+    checkZoom(zoom);
+
+    const auto area = bounds();
+    const auto blocks = blockHashes();
+
+    auto tiles = childTiles(std::vector<Tile>(), area, blocks);
+    for (unsigned int z = 1; z <= zoom; z++) {
+        tiles = childTiles(tiles, area, blocks);
+    }
+
+    return tiles;
+}
+
+TileExporter::Statistics TileExporter::exportTiles(unsigned int minZoom, unsigned int maxZoom) {
+    lc::instrumentation::ScopedTimer timer("tiles.export");
+
+    checkZoom(maxZoom);
+
+    Statistics total;
+    std::mutex totalMutex;
+
+    const auto area = bounds();
+    const auto blocks = blockHashes();
+
+    auto tiles = childTiles(std::vector<Tile>(), area, blocks);
+
+    for (unsigned int zoom = 0; zoom <= maxZoom; zoom++) {
+        if (zoom > 0) {
+            tiles = childTiles(tiles, area, blocks);
+        }
+
+        if (zoom < minZoom) {
+            continue;
+        }
+
+        lc::ThreadPool::instance().parallelFor(tiles.size(), [&](size_t begin, size_t end) {
+            Statistics statistics;
+            auto renderer = acquireRenderer();
+
+            try {
+                for (auto i = begin; i < end; i++) {
+                    render(*renderer, tiles[i], statistics);
+                }
+            }
+            catch (...) {
+                releaseRenderer(renderer);
+                throw;
+            }
+
+            releaseRenderer(renderer);
+
+            std::lock_guard<std::mutex> lock(totalMutex);
+            total.rendered += statistics.rendered;
+            total.written += statistics.written;
+            total.unchanged += statistics.unchanged;
+            total.failed += statistics.failed;
+        }, MIN_TILES_PER_RANGE);
+
+        removeEmptyTiles(zoom, tiles, area, total);
+    }
+
+    lc::instrumentation::count("tiles.rendered", total.rendered);
+    lc::instrumentation::count("tiles.unchanged", total.unchanged);
+    lc::instrumentation::count("tiles.removed", total.removed);
+
+    return total;
+}
+
+TileExporter::BlockHashes TileExporter::blockHashes() const {
+    BlockHashes hashes;
+
+    std::function<uint64_t(const lc::Block_CSPtr&)> blockHash = [&](const lc::Block_CSPtr& block) -> uint64_t {
+        auto it = hashes.find(block->name());
+        if (it != hashes.end()) {
+            return it->second;
+        }
+
+        // A block inserting itself uses this value for the nested insert
+        hashes[block->name()] = 0;
+
+        ContentHash hash(blockHash);
+        hash.add(_document->entitiesByBlock(block).asVector());
+
+        return hashes[block->name()] = hash.value();
+    };
+
+    for (const auto& block : _document->blocks()) {
+        blockHash(block);
+    }
+
+    return hashes;
+}
+
+TileExporter::Tile TileExporter::tileAt(const lc::geo::Area& bounds, unsigned int zoom, unsigned int x, unsigned int y) const {
+    const double size = bounds.width() / (1u << zoom);
+
+    // y grows downwards, from the top of the bounds
+    const lc::geo::Coordinate bottomLeft(bounds.minP().x() + x * size, bounds.maxP().y() - (y + 1) * size);
+    return Tile {zoom, x, y, lc::geo::Area(bottomLeft, size, size), 0};
+}
+
+std::vector<TileExporter::Tile> TileExporter::childTiles(const std::vector<Tile>& parents, const lc::geo::Area& bounds, const BlockHashes& blocks) const {
+    std::vector<Tile> tiles;
+
+    if (bounds.width() <= 0.) {
+        return tiles;
+    }
+
+    // Without parents the candidate is the tile of zoom level 0
+    if (parents.empty()) {
+        tiles.push_back(tileAt(bounds, 0, 0, 0));
+    }
+    else {
+        tiles.reserve(parents.size() * 4);
+
+        for (const auto& parent : parents) {
+            for (unsigned int x = 0; x < 2; x++) {
+                for (unsigned int y = 0; y < 2; y++) {
+                    tiles.push_back(tileAt(bounds, parent.zoom + 1, parent.x * 2 + x, parent.y * 2 + y));
+                }
+            }
+        }
+    }
+
+    hashOccupied(tiles, blocks);
+
+    tiles.erase(std::remove_if(tiles.begin(), tiles.end(), [](const Tile& tile) {
+        return tile.hash == 0;
+    }), tiles.end());
+
+    std::sort(tiles.begin(), tiles.end(), [](const Tile& a, const Tile& b) {
+        return std::tie(a.x, a.y) < std::tie(b.x, b.y);
+    });
+
+    return tiles;
+}
+
+void TileExporter::hashOccupied(std::vector<Tile>& tiles, const BlockHashes& blocks) const {
+    const std::function<uint64_t(const lc::Block_CSPtr&)> blockHash = [&blocks](const lc::Block_CSPtr& block) -> uint64_t {
+        auto it = blocks.find(block->name());
+        return it != blocks.end() ? it->second : 0;
+    };
+
+    const auto& spatialIndex = _document->spatialIndex();
+
+    lc::ThreadPool::instance().parallelFor(tiles.size(), [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; i++) {
+            auto& tile = tiles[i];
+
+            // The path of the entities is tested, not only their bounding box
+            auto entities = spatialIndex.entitiesWithinAndCrossing(tile.area);
+            if (entities.empty()) {
+                tile.hash = 0;
+                continue;
+            }
+
+            ContentHash hash(blockHash);
+            hash.add(static_cast<uint64_t>(_tileSize));
+            hash.add(_background);
+            hash.add(tile.area);
+            hash.add(entities);
+
+            tile.hash = hash.value();
+        }
+    }, MIN_CANDIDATES_PER_RANGE);
+}
+
+void TileExporter::removeEmptyTiles(unsigned int zoom, const std::vector<Tile>& tiles, const lc::geo::Area& bounds, Statistics& statistics) {
+    std::lock_guard<std::mutex> lock(_hashesMutex);
+
+    auto it = _hashes.lower_bound(std::make_tuple(zoom, 0u, 0u));
+    const auto last = _hashes.lower_bound(std::make_tuple(zoom + 1, 0u, 0u));
+
+    while (it != last) {
+        const auto x = std::get<1>(it->first);
+        const auto y = std::get<2>(it->first);
+
+        // The tiles are ordered by x and y
+        const bool occupied = std::binary_search(tiles.begin(), tiles.end(), tileAt(bounds, zoom, x, y), [](const Tile& a, const Tile& b) {
+            return std::tie(a.x, a.y) < std::tie(b.x, b.y);
+        });
+
+        if (occupied) {
+            ++it;
+            continue;
+        }
+
+        if (_removeTileFunctor && !_removeTileFunctor(tileAt(bounds, zoom, x, y))) {
+            statistics.failed++;
+            ++it;
+            continue;
+        }
+
+        statistics.removed++;
+        it = _hashes.erase(it);
+    }
+}
+
+TileExporter::Renderer* TileExporter::acquireRenderer() {
+    std::lock_guard<std::mutex> lock(_renderersMutex);
+
+    if (!_freeRenderers.empty()) {
+        auto renderer = _freeRenderers.back();
+        _freeRenderers.pop_back();
+        return renderer;
+    }
+
+    // Created while locked, the canvas connects itself to the document events
+    std::unique_ptr<Renderer> renderer(new Renderer());
+    auto r = renderer.get();
+
+    r->canvas = std::make_shared<DocumentCanvas>(_document);
+
+    // Deep zoom levels of large drawings are far beyond the limits of interactive viewers
+    r->canvas->setZoomLimits(0., std::numeric_limits<double>::max());
+
+    r->canvas->createPainterFunctor([this, r](const unsigned int width, const unsigned int height) {
+        if (r->painter == nullptr) {
+            r->painter = _createPainterFunctor(width, height);
+        }
+
+        return r->painter;
+    });
+
+    r->canvas->deletePainterFunctor([this, r](LcPainter* painter) {
+        if (painter != nullptr && r->painter != nullptr) {
+            _deletePainterFunctor(painter);
+            r->painter = nullptr;
+        }
+    });
+
+    r->canvas->newDeviceSize(_tileSize, _tileSize);
+
+    // All cache types share the painter, create them now so they don't apply the transformations again
+    r->canvas->render([](LcPainter&) {}, [](LcPainter&) {});
+
+    _renderers.push_back(std::move(renderer));
+    return r;
+}
+
+void TileExporter::releaseRenderer(Renderer* renderer) {
+    std::lock_guard<std::mutex> lock(_renderersMutex);
+    _freeRenderers.push_back(renderer);
+}
+
+void TileExporter::render(Renderer& renderer, const Tile& tile, Statistics& statistics) {
+    const auto key = std::make_tuple(tile.zoom, tile.x, tile.y);
+
+    {
+        std::lock_guard<std::mutex> lock(_hashesMutex);
+
+        auto it = _hashes.find(key);
+        if (it != _hashes.end() && it->second == tile.hash) {
+            statistics.unchanged++;
+            return;
+        }
+    }
+
+    renderer.canvas->setDisplayArea(tile.area);
+
+    renderer.painter->clear(_background.red(), _background.green(), _background.blue(), _background.alpha());
+    renderer.canvas->render([](LcPainter&) {}, [](LcPainter&) {});
+    statistics.rendered++;
+
+    if (_writeTileFunctor && !_writeTileFunctor(*renderer.painter, tile)) {
+        statistics.failed++;
+        return;
+    }
+
+    statistics.written++;
+
+    std::lock_guard<std::mutex> lock(_hashesMutex);
+    _hashes[key] = tile.hash;
+}
+
+void TileExporter::readHashes(std::istream& stream) {
+    std::lock_guard<std::mutex> lock(_hashesMutex);
+
+    unsigned int zoom;
+    unsigned int x;
+    unsigned int y;
+    char separator1;
+    char separator2;
+    uint64_t hash;
+
+    while (stream >> zoom >> separator1 >> x >> separator2 >> y >> std::hex >> hash >> std::dec) {
+        if (separator1 == '/' && separator2 == '/') {
+            _hashes[std::make_tuple(zoom, x, y)] = hash;
+        }
+    }
+}
+
+void TileExporter::writeHashes(std::ostream& stream) const {
+    std::lock_guard<std::mutex> lock(_hashesMutex);
+
+    const auto flags = stream.flags();
+
+    for (const auto& hash : _hashes) {
+        stream << std::dec << std::get<0>(hash.first) << '/' << std::get<1>(hash.first) << '/' << std::get<2>(hash.first)
+               << ' ' << std::hex << hash.second << '\n';
+    }
+
+    stream.flags(flags);
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include <cad/document/document.h>
+#include <cad/geometry/geoarea.h>
+#include <cad/meta/color.h>
+#include "painters/lcpainter.h"
+
+namespace LCViewer {
+    class DocumentCanvas;
+
+    /**
+     * @brief Export a document as a pyramid of square tiles, in the XYZ scheme of web maps
+     * Zoom level z has 2^z x 2^z tiles, tile 0/0/0 covers bounds() and y grows downwards.
+     * Only the tiles containing entities are rendered. They are spread over lc::ThreadPool, each
+     * thread renders its tiles with its own canvas and painter.
+     *
+     * A hash of the content of each tile is kept: the IDs and geometry of its entities, the tile size
+     * and the background. Tiles with the same hash as in a previous export are not rendered again,
+     * write the hashes with writeHashes() and read them before the next export.
+     * Tiles of a previous export which are empty now are passed to the remove tile functor.
+     */
+    class TileExporter {
+        public:
+            struct Tile {
+                unsigned int zoom;
+                unsigned int x;
+                unsigned int y;
+                // Drawing area of the tile
+                lc::geo::Area area;
+                // Hash of the tile content, never 0
+                uint64_t hash;
+            };
+
+            struct Statistics {
+                size_t rendered = 0;
+                size_t written = 0;
+                size_t unchanged = 0;
+                size_t removed = 0;
+                size_t failed = 0;
+            };
+
+            explicit TileExporter(lc::Document_SPtr document);
+            ~TileExporter();
+
+            TileExporter(const TileExporter&) = delete;
+            TileExporter& operator = (const TileExporter&) = delete;
+
+            /**
+             * @brief Size of the tiles in pixels, 256 by default
+             */
+            void setTileSize(unsigned int tileSize);
+            unsigned int tileSize() const;
+
+            /**
+             * @brief Area covered by the tile 0/0/0
+             * By default the bounding box of the document, made square around its center
+             */
+            void setBounds(const lc::geo::Area& bounds);
+            lc::geo::Area bounds() const;
+
+            /**
+             * @brief Color the tiles are cleared with, opaque black by default
+             */
+            void setBackground(const lc::Color& background);
+
+            /**
+             * @brief Create a painter of the tile size, each thread gets its own painter
+             */
+            void createPainterFunctor(const std::function<LcPainter*(const unsigned int, const unsigned int)>& createPainterFunctor);
+            void deletePainterFunctor(const std::function<void(LcPainter*)>& deletePainterFunctor);
+
+            /**
+             * @brief Write a rendered tile, for example as z/x/y.png
+             * Called from the threads of the pool, the function must be thread safe.
+             * It returns false when the tile couldn't be written.
+             */
+            void writeTileFunctor(const std::function<bool(LcPainter&, const Tile&)>& writeTileFunctor);
+
+            /**
+             * @brief Remove a tile written by a previous export which has no entities anymore
+             * It returns false when the tile couldn't be removed, its hash is kept to try again.
+             */
+            void removeTileFunctor(const std::function<bool(const Tile&)>& removeTileFunctor);
+
+            /**
+             * @brief Tiles of a zoom level containing at least one entity
+             * The candidates of zoom level z are the children of the occupied tiles of z - 1. A candidate
+             * is occupied when the path of an entity is within or crosses it, empty areas in the bounding
+             * box of an entity are skipped.
+             * @return tiles ordered by x and y
+             */
+            std::vector<Tile> occupiedTiles(unsigned int zoom) const;
+
+            /**
+             * @brief Render and write the changed tiles of the zoom levels minZoom to maxZoom
+             * Hashes of these levels which are not occupied anymore are dropped and their tiles removed.
+             */
+            Statistics exportTiles(unsigned int minZoom, unsigned int maxZoom);
+
+            /**
+             * @brief Read hashes written by writeHashes(), lines "z/x/y hash"
+             */
+            void readHashes(std::istream& stream);
+            void writeHashes(std::ostream& stream) const;
+
+        private:
+            struct Renderer;
+
+            // Hash of the entities of each block, for the inserts
+            typedef std::unordered_map<std::string, uint64_t> BlockHashes;
+
+            BlockHashes blockHashes() const;
+            Tile tileAt(const lc::geo::Area& bounds, unsigned int zoom, unsigned int x, unsigned int y) const;
+            std::vector<Tile> childTiles(const std::vector<Tile>& parents, const lc::geo::Area& bounds, const BlockHashes& blocks) const;
+            void hashOccupied(std::vector<Tile>& tiles, const BlockHashes& blocks) const;
+            void removeEmptyTiles(unsigned int zoom, const std::vector<Tile>& tiles, const lc::geo::Area& bounds, Statistics& statistics);
+
+            Renderer* acquireRenderer();
+            void releaseRenderer(Renderer* renderer);
+            void render(Renderer& renderer, const Tile& tile, Statistics& statistics);
+
+            lc::Document_SPtr _document;
+            unsigned int _tileSize;
+            bool _hasBounds;
+            lc::geo::Area _bounds;
+            lc::Color _background;
+
+            std::function<LcPainter*(const unsigned int, const unsigned int)> _createPainterFunctor;
+            std::function<void(LcPainter*)> _deletePainterFunctor;
+            std::function<bool(LcPainter&, const Tile&)> _writeTileFunctor;
+            std::function<bool(const Tile&)> _removeTileFunctor;
+
+            std::mutex _renderersMutex;
+            std::vector<std::unique_ptr<Renderer>> _renderers;
+            std::vector<Renderer*> _freeRenderers;
+
+            mutable std::mutex _hashesMutex;
+            std::map<std::tuple<unsigned int, unsigned int, unsigned int>, uint64_t> _hashes;
+    };
+}
@@ -0,0 +1,423 @@
+#include "batchrenderer.h"
+
+#include <lclua.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include <cad/base/instrumentation.h>
+#include <cad/dochelpers/documentimpl.h>
+#include <cad/dochelpers/storagemanagerimpl.h>
+#include <documentcanvas.h>
+#include <painters/lccairopainter.tcc>
+#include <drawables/gradientbackground.h>
+#include <managers/pluginmanager.h>
+#include <managers/luacustomentitymanager.h>
+#include <curl/curl.h>
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#if USE_lcDXFDWG
+#include <file.h>
+#endif
+
+using LcPainter = LCViewer::LcPainter;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+    uint64_t nanoseconds(Clock::time_point start, Clock::time_point end) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    }
+
+    size_t writeBuffer(void* contents, size_t size, size_t nmemb, void* userp) {
+        size_t realsize = size * nmemb;
+        static_cast<std::string*>(userp)->append(static_cast<char*>(contents), realsize);
+        return realsize;
+    }
+
+    std::string extension(const std::string& path) {
+        std::string extension = boost::filesystem::extension(path);
+        extension = extension.substr(extension.find_first_of(".") + 1);
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        return extension;
+    }
+
+    /**
+     * @brief Run the code of a job in its own environment
+     * Globals set by the job go to a new table, reading a global falls back to the globals of the worker
+     * which contain the plugins. A job doesn't see the variables of the previous jobs of its worker.
+     * Tables shared through the globals, like the ones of the plugins, can still be changed.
+     * @return error message, empty when the code ran
+     */
+    std::string runInEnvironment(lua_State* L, const std::string& code, const std::string& name) {
+        const std::string chunkName = "=" + name;
+
+        if (luaL_loadbuffer(L, code.data(), code.size(), chunkName.c_str()) == LUA_OK) {
+            lua_newtable(L);
+            lua_newtable(L);
+            lua_pushglobaltable(L);
+            lua_setfield(L, -2, "__index");
+            lua_setmetatable(L, -2);
+
+            // The first upvalue of a main chunk is _ENV
+            lua_setupvalue(L, -2, 1);
+
+            if (lua_pcall(L, 0, 0, 0) == LUA_OK) {
+                return "";
+            }
+        }
+
+        std::string error = lua_tostring(L, -1) != nullptr ? lua_tostring(L, -1) : "Lua error";
+        lua_pop(L, 1);
+        return error;
+    }
+}
+
+/**
+ * Lua state of a worker thread, plugins are loaded once per thread
+ */
+struct BatchRenderer::Worker {
+    Worker() :
+        state(LuaIntf::LuaState::newState()) {
+
+        try {
+            lc::PluginManager pluginManager(state, "cli");
+            pluginManager.loadPlugins();
+
+            auto lcLua = lc::LCLua(state);
+            lcLua.addLuaLibs();
+            lcLua.importLCKernel();
+        }
+        catch (...) {
+            state.close();
+            throw;
+        }
+    }
+
+    ~Worker() {
+        lc::LuaCustomEntityManager::getInstance().removePlugins();
+        state.close();
+    }
+
+    LuaIntf::LuaState state;
+};
+
+BatchRenderer::BatchRenderer(unsigned int threads) :
+    _threads(threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads) {
+}
+
+unsigned int BatchRenderer::threads() const {
+    return _threads;
+}
+
+std::vector<BatchJob> BatchRenderer::readManifest(const std::string& path) {
+    std::vector<BatchJob> jobs;
+
+    try {
+        boost::property_tree::ptree manifest;
+        boost::property_tree::read_json(path, manifest);
+
+        BatchJob defaults;
+        const auto width = manifest.get("width", defaults.width);
+        const auto height = manifest.get("height", defaults.height);
+
+        for (const auto& entry : manifest.get_child("jobs")) {
+            const auto& node = entry.second;
+
+            BatchJob job;
+            job.input = node.get<std::string>("input");
+            job.output = node.get<std::string>("output");
+            job.type = node.get("type", extension(job.output));
+            job.width = node.get("width", width);
+            job.height = node.get("height", height);
+
+            auto viewport = node.get_child_optional("viewport");
+            if (viewport) {
+                job.hasViewport = true;
+                job.viewport = lc::geo::Area(
+                        lc::geo::Coordinate(viewport->get<double>("x"), viewport->get<double>("y")),
+                        viewport->get<double>("width"),
+                        viewport->get<double>("height")
+                );
+            }
+
+            std::transform(job.type.begin(), job.type.end(), job.type.begin(), ::tolower);
+            jobs.push_back(job);
+        }
+    }
+    catch (const boost::property_tree::ptree_error& e) {
+        throw std::runtime_error("Cannot read manifest " + path + ": " + e.what());
+    }
+
+    return jobs;
+}
+
+std::vector<BatchJobResult> BatchRenderer::run(const std::vector<BatchJob>& jobs) {
+    std::vector<BatchJobResult> results(jobs.size());
+    std::atomic<size_t> nextJob(0);
+
+    const auto threads = static_cast<unsigned int>(std::min<size_t>(_threads, jobs.size()));
+
+    // Plugins get the waiting custom entities of every document when they are registered,
+    // jobs start once all workers loaded their plugins so they only get entities of their own thread
+    std::mutex mutex;
+    std::condition_variable condition;
+    unsigned int ready = 0;
+    std::string workerError;
+
+    // The workers keep their Lua state for all their jobs, which is why they don't use lc::ThreadPool
+    std::vector<std::thread> workers;
+    for (unsigned int i = 0; i < threads; i++) {
+        workers.emplace_back([&]() {
+            std::unique_ptr<Worker> worker;
+            try {
+                worker.reset(new Worker());
+            }
+            catch (const std::exception& e) {
+                std::lock_guard<std::mutex> lock(mutex);
+                workerError = std::string("Cannot load the plugins: ") + e.what();
+            }
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                ready++;
+                condition.notify_all();
+                condition.wait(lock, [&]() {
+                    return ready == threads;
+                });
+            }
+
+            // A worker without plugins leaves its jobs to the other workers
+            if (worker == nullptr) {
+                return;
+            }
+
+            for (size_t job = nextJob++; job < jobs.size(); job = nextJob++) {
+                results[job] = render(jobs[job], *worker);
+            }
+        });
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // No worker could load the plugins
+    for (size_t job = nextJob; job < jobs.size(); job++) {
+        results[job].error = workerError;
+    }
+
+    return results;
+}
+
+BatchJobResult BatchRenderer::render(const BatchJob& job, Worker& worker) {
+    lc::instrumentation::ScopedTimer timer("batch.job");
+
+    using namespace CairoPainter;
+
+    BatchJobResult result;
+
+    try {
+        auto start = Clock::now();
+
+        // Destroyed after the canvas, which deletes the painter and finishes the PDF and SVG surfaces
+        std::ofstream file;
+        auto stream = static_cast<std::ostream*>(&file);
+        if (job.type == "pdf" || job.type == "svg") {
+            file.open(job.output, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                throw std::runtime_error("Cannot write " + job.output);
+            }
+        }
+
+        LcPainter* lcPainter = nullptr;
+        // Pixels of the PNG painter, destroyed after the canvas like the file
+        std::unique_ptr<unsigned char[]> image;
+
+        auto document = std::make_shared<lc::DocumentImpl>(std::make_shared<lc::StorageManagerImpl>());
+        auto canvas = std::make_shared<LCViewer::DocumentCanvas>(document);
+
+        auto gradientBackground = std::make_shared<LCViewer::GradientBackground>(lc::Color(0x90, 0x90, 0x90),
+                                                                                 lc::Color(0x00, 0x00, 0x00));
+        canvas->background().connect<LCViewer::GradientBackground, &LCViewer::GradientBackground::draw>(gradientBackground.get());
+
+        canvas->createPainterFunctor([&](const unsigned int width, const unsigned int height) {
+            if (lcPainter == nullptr) {
+                if (job.type == "pdf") {
+                    lcPainter = new LcCairoPainter<backend::PDF>(width, height, &writeStream, stream);
+                }
+                else if (job.type == "svg") {
+                    lcPainter = new LcCairoPainter<backend::SVG>(width, height, &writeStream, stream);
+                }
+                else {
+                    image.reset(new unsigned char[width * height * 4]);
+                    lcPainter = new LcCairoPainter<backend::Image>(image.get(), width, height);
+                }
+            }
+
+            return lcPainter;
+        });
+
+        canvas->deletePainterFunctor([&](LcPainter* painter) {
+            if (painter != nullptr && lcPainter != nullptr) {
+                delete painter;
+                lcPainter = nullptr;
+            }
+        });
+
+        canvas->newDeviceSize(job.width, job.height);
+
+        // This creates the painter
+        canvas->render([](LcPainter&) {}, [](LcPainter&) {});
+
+        if (extension(job.input) == "lua") {
+            std::string code = loadFile(job.input);
+            if (code.empty()) {
+                throw std::runtime_error("Cannot read " + job.input);
+            }
+
+            auto lcLua = lc::LCLua(worker.state);
+            lcLua.setDocument(document);
+
+            std::string out = runInEnvironment(worker.state, code, job.input);
+            if (!out.empty()) {
+                throw std::runtime_error(out);
+            }
+        }
+        else {
+#if USE_lcDXFDWG
+            std::string path = job.input;
+            if (path.compare(0, 5, "file:") == 0) {
+                path = path.substr(5);
+            }
+
+            auto libraries = lc::File::getAvailableLibrariesForFormat(extension(path));
+            if (libraries.empty()) {
+                throw std::runtime_error("Unknown file format " + job.input);
+            }
+
+            if (!lc::File::open(document, path, libraries.begin()->first)) {
+                throw std::runtime_error("Cannot read " + job.input);
+            }
+#else
+            throw std::runtime_error("LibreCAD was built without DXF/DWG support, cannot open " + job.input);
+#endif
+        }
+
+        result.entities = document->entities().size();
+
+        auto loaded = Clock::now();
+        result.loadTime = nanoseconds(start, loaded);
+
+        if (job.hasViewport) {
+            canvas->setDisplayArea(job.viewport);
+        }
+        else {
+            canvas->autoScale();
+        }
+        canvas->render([](LcPainter&) {}, [](LcPainter&) {});
+
+        auto rendered = Clock::now();
+        result.renderTime = nanoseconds(loaded, rendered);
+
+        if (job.type == "pdf" || job.type == "svg") {
+            // PDF and SVG surfaces are written when they are destroyed
+            canvas->removePainters();
+            file.close();
+            if (!file) {
+                throw std::runtime_error("Cannot write " + job.output);
+            }
+        }
+        else if (!static_cast<LcCairoPainter<backend::Image>*>(lcPainter)->writePNG(job.output)) {
+            throw std::runtime_error("Cannot write " + job.output);
+        }
+
+        result.writeTime = nanoseconds(rendered, Clock::now());
+    }
+    catch (const std::exception& e) {
+        result.error = e.what();
+    }
+
+    return result;
+}
+
+void BatchRenderer::writeReport(std::ostream& stream, const std::vector<BatchJob>& jobs, const std::vector<BatchJobResult>& results) {
+    const auto flags = stream.flags();
+    const auto precision = stream.precision();
+
+    stream << std::left << std::setw(40) << "output" << std::right
+           << std::setw(10) << "entities"
+           << std::setw(12) << "load ms"
+           << std::setw(12) << "render ms"
+           << std::setw(12) << "write ms" << std::endl;
+
+    size_t failed = 0;
+
+    stream << std::fixed << std::setprecision(3);
+    for (size_t i = 0; i < jobs.size() && i < results.size(); i++) {
+        const auto& result = results[i];
+
+        stream << std::left << std::setw(40) << jobs[i].output << std::right;
+        if (result.error.empty()) {
+            stream << std::setw(10) << result.entities
+                   << std::setw(12) << result.loadTime / 1e6
+                   << std::setw(12) << result.renderTime / 1e6
+                   << std::setw(12) << result.writeTime / 1e6 << std::endl;
+        }
+        else {
+            stream << "  failed: " << result.error << std::endl;
+            failed++;
+        }
+    }
+
+    stream << jobs.size() - failed << " jobs rendered, " << failed << " failed" << std::endl;
+
+    stream.flags(flags);
+    stream.precision(precision);
+}
+
+std::string loadFile(const std::string& url) {
+    std::string buffer;
+
+    CURL* curl = curl_easy_init();
+    if (curl == nullptr) {
+        return "";
+    }
+
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    /* example.com is redirected, so we tell libcurl to follow redirection */
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeBuffer);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &buffer);
+
+    /* Perform the request, res will get the return code */
+    CURLcode res = curl_easy_perform(curl);
+    curl_easy_cleanup(curl);
+
+    /* Check for errors */
+    if (res != CURLE_OK) {
+        std::cerr << "curl_easy_perform() failed: " << curl_easy_strerror(res) << std::endl;
+        return "";
+    }
+
+    return buffer;
+}
+
+cairo_status_t writeStream(void* closure, const unsigned char* data, unsigned int length) {
+    auto stream = static_cast<std::ostream*>(closure);
+
+    if (stream == nullptr || !stream->write(reinterpret_cast<const char*>(data), length)) {
+        return CAIRO_STATUS_WRITE_ERROR;
+    }
+
+    return CAIRO_STATUS_SUCCESS;
+}
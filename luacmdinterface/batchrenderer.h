@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cairo.h>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <cad/geometry/geoarea.h>
+
+/**
+ * @brief Image to render in batch
+ */
+struct BatchJob {
+    // Lua file read with curl like -i, for example file:plot.lua, or a drawing opened with lc::File
+    std::string input;
+    std::string output;
+    // png, svg or pdf, guessed from the output extension when empty
+    std::string type;
+    unsigned int width = 400;
+    unsigned int height = 400;
+    // Displayed area in drawing units, the whole drawing is displayed when not set
+    bool hasViewport = false;
+    lc::geo::Area viewport;
+};
+
+struct BatchJobResult {
+    // Empty when the job succeeded
+    std::string error;
+    size_t entities = 0;
+    // Nanoseconds spent running the Lua code or opening the drawing, drawing it and writing the output
+    uint64_t loadTime = 0;
+    uint64_t renderTime = 0;
+    uint64_t writeTime = 0;
+};
+
+/**
+ * @brief Render many images at the same time
+ * Each worker thread has its own Lua state with the plugins loaded once, and keeps it for all its jobs.
+ * The Lua code of a job runs in its own global environment on top of the globals of the worker.
+ * A worker which can't load the plugins takes no jobs, when no worker could load them all jobs fail.
+ * A document, a canvas and a painter are created for each job.
+ */
+class BatchRenderer {
+    public:
+        /**
+         * @param threads number of jobs rendered at the same time, 0 uses std::thread::hardware_concurrency()
+         */
+        explicit BatchRenderer(unsigned int threads = 0);
+
+        /**
+         * @brief Read a JSON manifest
+         * {"width": 400, "height": 400, "jobs": [
+         *     {"input": "file:plot.lua", "output": "plot.png"},
+         *     {"input": "plan.dxf", "output": "plan.svg", "width": 800, "viewport": {"x": 0, "y": 0, "width": 100, "height": 50}}
+         * ]}
+         * width and height at the top level are the default size of the jobs.
+         * @throw std::runtime_error when the manifest can't be read or a job has no input or output
+         */
+        static std::vector<BatchJob> readManifest(const std::string& path);
+
+        /**
+         * @brief Render the jobs, errors of a job don't stop the others
+         * @return result of each job, in the order of the jobs
+         */
+        std::vector<BatchJobResult> run(const std::vector<BatchJob>& jobs);
+
+        unsigned int threads() const;
+
+        /**
+         * @brief Write the status and times of each job as a table
+         */
+        static void writeReport(std::ostream& stream, const std::vector<BatchJob>& jobs, const std::vector<BatchJobResult>& results);
+
+    private:
+        struct Worker;
+
+        static BatchJobResult render(const BatchJob& job, Worker& worker);
+
+        unsigned int _threads;
+};
+
+/**
+ * @brief Read a file with curl
+ * @param url for example file:test.lua
+ * @return content, empty when it can't be read
+ */
+std::string loadFile(const std::string& url);
+
+/**
+ * @brief Cairo write function writing to the std::ostream given as closure
+ */
+cairo_status_t writeStream(void* closure, const unsigned char* data, unsigned int length);
@@ -1,14 +1,22 @@
 #include <lclua.h>
+#include "batchrenderer.h"
 
 #include <cad/dochelpers/documentimpl.h>
+#include <chrono>
 #include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
 
 #include <cad/dochelpers/storagemanagerimpl.h>
 #include <cad/operations/entitybuilder.h>
 #include <documentcanvas.h>
+#include <tileexporter.h>
 #include <painters/lccairopainter.tcc>
 #include <drawables/gradientbackground.h>
 #include <cad/dochelpers/undomanagerimpl.h>
+#include <cad/base/instrumentation.h>
 #include <curl/curl.h>
 #include <boost/program_options.hpp>
 #include <boost/filesystem.hpp>
@@ -24,65 +32,191 @@ static char const* const DEFAULT_OUT_FILENAME = "out.png";
 static const int DEFAULT_IMAGE_WIDTH = 400;
 static const int DEFAULT_IMAGE_HEIGHT = 400;
 
-static std::string readBuffer;
-static size_t WriteCallback(void* contents, size_t size, size_t nmemb, void* userp) {
-    size_t realsize = size * nmemb;
-    readBuffer.append((char*) contents, realsize);
-    return realsize;
-}
+static FILE* openFileDialog(bool isOpening, const char* description, const char* mode) {
+    std::string path;
 
-std::string loadFile(std::string url) {
-    CURL* curl;
-    CURLcode res;
+    if(isOpening) {
+        std::cout << "Enter path to open " << description << ": ";
+    }
+    else {
+        std::cout << "Enter path to save " << description << ": ";
+    }
 
-    curl = curl_easy_init();
+    std::cin >> path;
 
-    if (curl) {
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        /* example.com is redirected, so we tell libcurl to follow redirection */
-        curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+    return fopen(path.c_str(), mode);
+}
 
-        /* Perform the request, res will get the return code */
-        res = curl_easy_perform(curl);
+/**
+ * Print the instrumentation timers and counters, and write the Chrome trace
+ */
+static void reportInstrumentation(bool stats, const std::string& traceFile) {
+    auto& instrumentation = lc::instrumentation::Instrumentation::instance();
+
+    if (stats) {
+        std::cerr << std::left << std::setw(32) << "timer" << std::right
+                  << std::setw(9) << "calls"
+                  << std::setw(12) << "total ms"
+                  << std::setw(12) << "mean ms"
+                  << std::setw(12) << "max ms" << std::endl;
+        for (const auto& timer : instrumentation.timers()) {
+            std::cerr << std::left << std::setw(32) << timer.name << std::right
+                      << std::setw(9) << timer.calls
+                      << std::fixed << std::setprecision(3)
+                      << std::setw(12) << timer.total / 1e6
+                      << std::setw(12) << timer.total / 1e6 / timer.calls
+                      << std::setw(12) << timer.max / 1e6 << std::endl;
+        }
 
-        /* Check for errors */
-        if (res != CURLE_OK) {
-            std::cerr << "curl_easy_perform() failed: " << curl_easy_strerror(res) << std::endl;
-            curl_easy_cleanup(curl);
-            return "";
+        for (const auto& counter : instrumentation.counters()) {
+            std::cerr << std::left << std::setw(32) << counter.first << std::right
+                      << std::setw(9) << counter.second << std::endl;
         }
+    }
 
-        /* always cleanup */
-        curl_easy_cleanup(curl);
-        return readBuffer;
-    } else {
-        return "";
+    if (!traceFile.empty() && !instrumentation.writeChromeTrace(traceFile)) {
+        std::cerr << "Cannot write trace file " << traceFile << std::endl;
     }
 }
 
-std::ofstream ofile;
-cairo_status_t write_func (void * closure, const unsigned char *data, unsigned int length) {
+/**
+ * Render the jobs of a manifest and print their times
+ */
+static int runBatch(const std::string& manifest, unsigned int threads, bool stats, const std::string& traceFile) {
+    std::vector<BatchJob> jobs;
+    try {
+        jobs = BatchRenderer::readManifest(manifest);
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    // curl_global_init() is not thread safe, it can't be left to the workers
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+
+    BatchRenderer renderer(threads);
+
+    auto start = std::chrono::steady_clock::now();
+    auto results = renderer.run(jobs);
+    auto duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
 
-    if (ofile.is_open())
-        ofile.write((const char *)data, length);
+    curl_global_cleanup();
 
-    return CAIRO_STATUS_SUCCESS;
+    BatchRenderer::writeReport(std::cerr, jobs, results);
+    std::cerr << "Total " << std::fixed << std::setprecision(3) << duration << " ms on "
+              << std::min<size_t>(renderer.threads(), jobs.size()) << " threads" << std::endl;
+
+    reportInstrumentation(stats, traceFile);
+
+    for (const auto& result : results) {
+        if (!result.error.empty()) {
+            return 2;
+        }
+    }
+
+    return 0;
 }
 
-static FILE* openFileDialog(bool isOpening, const char* description, const char* mode) {
-    std::string path;
+/**
+ * Write the tiles of the document as directory/z/x/y.png
+ * Tiles which didn't change since the previous export, according to directory/tiles.hash, are kept
+ * and tiles which have no entities anymore are deleted
+ */
+static int exportTiles(lc::Document_SPtr document, const std::string& directory, const std::string& zoomLevels, unsigned int tileSize) {
+    using namespace CairoPainter;
 
-    if(isOpening) {
-        std::cout << "Enter path to open " << description << ": ";
+    // A single level or min:max
+    unsigned int minZoom = 0;
+    unsigned int maxZoom = 0;
+    char separator = ':';
+    std::istringstream zoomStream(zoomLevels);
+    bool valid = static_cast<bool>(zoomStream >> minZoom);
+    maxZoom = minZoom;
+    if (valid && zoomStream >> separator) {
+        valid = separator == ':' && zoomStream >> maxZoom && maxZoom >= minZoom;
     }
-    else {
-        std::cout << "Enter path to save " << description << ": ";
+
+    if (!valid) {
+        std::cerr << "Invalid zoom levels " << zoomLevels << ", example 0:4" << std::endl;
+        return 1;
     }
 
-    std::cin >> path;
+    LCViewer::TileExporter exporter(document);
+    exporter.setTileSize(tileSize);
 
-    return fopen(path.c_str(), mode);
+    // Image painters don't own their pixels
+    std::mutex buffersMutex;
+    std::map<LcPainter*, std::unique_ptr<unsigned char[]>> buffers;
+
+    exporter.createPainterFunctor([&](const unsigned int width, const unsigned int height) {
+        std::unique_ptr<unsigned char[]> buffer(new unsigned char[width * height * 4]);
+        auto painter = new LcCairoPainter<backend::Image>(buffer.get(), width, height);
+
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        buffers[painter] = std::move(buffer);
+        return painter;
+    });
+
+    exporter.deletePainterFunctor([&](LcPainter* painter) {
+        delete painter;
+
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        buffers.erase(painter);
+    });
+
+    exporter.writeTileFunctor([&](LcPainter& painter, const LCViewer::TileExporter::Tile& tile) {
+        auto path = boost::filesystem::path(directory) / std::to_string(tile.zoom) / std::to_string(tile.x);
+
+        boost::system::error_code error;
+        boost::filesystem::create_directories(path, error);
+        if (error) {
+            return false;
+        }
+
+        path /= std::to_string(tile.y) + ".png";
+        return static_cast<LcCairoPainter<backend::Image>&>(painter).writePNG(path.string());
+    });
+
+    exporter.removeTileFunctor([&](const LCViewer::TileExporter::Tile& tile) {
+        auto path = boost::filesystem::path(directory) / std::to_string(tile.zoom) / std::to_string(tile.x) / (std::to_string(tile.y) + ".png");
+
+        // A tile which is already gone counts as removed
+        boost::system::error_code error;
+        boost::filesystem::remove(path, error);
+        return !error;
+    });
+
+    const auto hashFile = (boost::filesystem::path(directory) / "tiles.hash").string();
+    {
+        std::ifstream hashes(hashFile);
+        exporter.readHashes(hashes);
+    }
+
+    LCViewer::TileExporter::Statistics statistics;
+    try {
+        statistics = exporter.exportTiles(minZoom, maxZoom);
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    {
+        std::ofstream hashes(hashFile, std::ios::trunc);
+        exporter.writeHashes(hashes);
+        if (!hashes) {
+            std::cerr << "Cannot write " << hashFile << std::endl;
+        }
+    }
+
+    std::cerr << statistics.rendered << " tiles rendered, "
+              << statistics.written << " written, "
+              << statistics.unchanged << " unchanged, "
+              << statistics.removed << " removed, "
+              << statistics.failed << " failed" << std::endl;
+
+    return statistics.failed == 0 ? 0 : 2;
 }
 
 int main(int argc, char** argv) {
@@ -91,6 +225,13 @@ int main(int argc, char** argv) {
     std::string fIn = "";
     std::string fOut = DEFAULT_OUT_FILENAME;
     std::string fType;
+    std::string traceFile;
+    std::string profileFile;
+    std::string batchFile;
+    unsigned int threads = 0;
+    std::string tilesDirectory;
+    std::string zoomLevels = "0:4";
+    unsigned int tileSize = 256;
 
     // Read CMD options
     po::options_description desc("Allowed options");
@@ -100,7 +241,16 @@ int main(int argc, char** argv) {
             ("height,h", po::value<int>(&height), "(optional) Set output image height, example -h 200")
             ("ifile,i", po::value<std::string>(&fIn), "(required) Set LUA input file name, example: -i file:myFile.lua")
             ("ofile,o", po::value<std::string>(&fOut), "(optional) Set output filename, example -o out.png")
-            ("otype,t", po::value<std::string>(&fType), "(optional) output file type, example -t svg");
+            ("otype,t", po::value<std::string>(&fType), "(optional) output file type, example -t svg")
+            ("stats", "(optional) Print the time spent in the document operations, rendering and file access")
+            ("trace", po::value<std::string>(&traceFile), "(optional) Write a Chrome trace JSON file, example --trace trace.json")
+            ("memory", "(optional) Print the memory used by the document and the canvas")
+            ("profile", po::value<std::string>(&profileFile), "(optional) Profile the Lua code, write flame graph stacks and print the slowest functions, example --profile lua.folded")
+            ("batch", po::value<std::string>(&batchFile), "(optional) Render the jobs of a JSON manifest instead of -i, example --batch jobs.json")
+            ("jobs,j", po::value<unsigned int>(&threads), "(optional) Number of batch jobs rendered at the same time, all cores by default, example -j 4")
+            ("tiles", po::value<std::string>(&tilesDirectory), "(optional) Write XYZ tiles as <directory>/z/x/y.png instead of -o, unchanged tiles are kept and empty ones deleted, example --tiles tiles")
+            ("zoom", po::value<std::string>(&zoomLevels), "(optional) Zoom levels of the tiles, 0:4 by default, example --zoom 2:6")
+            ("tile-size", po::value<unsigned int>(&tileSize), "(optional) Size of the tiles in pixels, 256 by default, example --tile-size 512");
 
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -119,12 +269,28 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    if (fIn.size() == 0) {
+    if (fIn.size() == 0 && batchFile.empty()) {
         std::cerr << "Input filename cannot be empty" << std::endl;
         std::cout << desc << "\n";
         return 1;
     }
 
+    const bool stats = vm.count("stats") > 0;
+    const bool memory = vm.count("memory") > 0;
+    if (stats) {
+        lc::instrumentation::Instrumentation::instance().setEnabled(true);
+    }
+    if (!traceFile.empty()) {
+        lc::instrumentation::Instrumentation::instance().setTracing(true);
+    }
+
+    if (!batchFile.empty()) {
+        return runBatch(batchFile, threads, stats, traceFile);
+    }
+
+    // Written by the PDF and SVG painters, it must outlive the canvas
+    std::ofstream ofile;
+
     // Create Librecad document
     auto _storageManager = std::make_shared<lc::StorageManagerImpl>();
     auto _document = std::make_shared<lc::DocumentImpl>(_storageManager);
@@ -142,7 +308,9 @@ int main(int argc, char** argv) {
     }
 
     std::transform(fType.begin(), fType.end(), fType.begin(), ::tolower);
-    ofile.open(fOut);
+    if (tilesDirectory.empty()) {
+        ofile.open(fOut, std::ios::binary);
+    }
 
     using namespace CairoPainter;
 
@@ -153,9 +321,9 @@ int main(int argc, char** argv) {
 
                 if (lcPainter == nullptr) {
                     if (fType == "pdf")
-                        lcPainter = new LcCairoPainter<backend::PDF>(width, height, &write_func);
+                        lcPainter = new LcCairoPainter<backend::PDF>(width, height, &writeStream, static_cast<std::ostream*>(&ofile));
                     else if (fType == "svg")
-                        lcPainter = new LcCairoPainter<backend::SVG>(width, height, &write_func);
+                        lcPainter = new LcCairoPainter<backend::SVG>(width, height, &writeStream, static_cast<std::ostream*>(&ofile));
                         // cairo can print any surface to PNG
                     else
                         lcPainter = new LcCairoPainter<backend::SVG>(width, height, nullptr);
@@ -193,10 +361,24 @@ int main(int argc, char** argv) {
     std::string luaCode = loadFile(fIn);
 
     if (luaCode.size() != 0) {
+        auto profiler = lcLua.profiler();
+        if (!profileFile.empty()) {
+            profiler->start();
+        }
+
         std::string out = lcLua.runString(luaCode.c_str());
 
+        if (!profileFile.empty()) {
+            profiler->stop();
+            profiler->writeReport(std::cerr);
+            if (!profiler->writeFoldedStacks(profileFile)) {
+                std::cerr << "Cannot write profile file " << profileFile << std::endl;
+            }
+        }
+
         if (out.size() > 0) {
             std::cerr << out << std::endl;
+            reportInstrumentation(stats, traceFile);
             return 2;
         }
     } else {
@@ -204,14 +386,32 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    if (!tilesDirectory.empty()) {
+        int result = exportTiles(_document, tilesDirectory, zoomLevels, tileSize);
+        reportInstrumentation(stats, traceFile);
+        lc::LuaCustomEntityManager::getInstance().removePlugins();
+        return result;
+    }
+
     _canvas->autoScale();
     _canvas->render([&](LcPainter& lcPainter) {},
                     [&](LcPainter& lcPainter) {});
 
     if (fType == "png" || (fType != "pdf" && fType != "svg"))
         static_cast<LcCairoPainter<CairoPainter::backend::Image>*>(lcPainter)->writePNG(fOut);
+
+    // PDF and SVG surfaces are written when the painter is deleted
+    _canvas->removePainters();
     ofile.close();
 
+    reportInstrumentation(stats, traceFile);
+
+    if (memory) {
+        auto usage = _document->memoryUsage();
+        _canvas->memoryUsage(usage);
+        usage.write(std::cerr);
+    }
+
     lc::LuaCustomEntityManager::getInstance().removePlugins();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+#include <cad/dochelpers/documentimpl.h>
+#include <cad/dochelpers/storagemanagerimpl.h>
+#include <cad/primitive/line.h>
+#include <cad/primitive/circle.h>
+#include <cad/primitive/arc.h>
+#include <cad/primitive/ellipse.h>
+#include <cad/primitive/insert.h>
+#include <cad/primitive/point.h>
+#include <cad/primitive/spline.h>
+#include <cad/builders/insert.h>
+#include <cad/operations/blockops.h>
+#include <cad/primitive/dimaligned.h>
+#include <cad/primitive/dimangular.h>
+#include <cad/primitive/dimdiametric.h>
+#include <cad/primitive/dimlinear.h>
+#include <cad/primitive/dimradial.h>
+#include <cad/primitive/image.h>
+#include <cad/primitive/lwpolyline.h>
+#include <cad/primitive/text.h>
+#include <map>
+#include <file.h>
+#include <libdxfrw/dxfimpl.h>
+
+using namespace lc;
+
+namespace {
+	std::string readFile(const std::string& path) {
+		std::ifstream file(path, std::ios::binary);
+		std::stringstream content;
+		content << file.rdbuf();
+		return content.str();
+	}
+}
+
+TEST(DXFWriteTest, ParallelWriteIsIdentical) {
+	auto document = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+	auto layer = document->layerByName("0");
+
+	for(int i = 0; i < 20000; i++) {
+		document->insertEntity(std::make_shared<entity::Line>(geo::Coordinate(i, 0), geo::Coordinate(i, 10), layer));
+		document->insertEntity(std::make_shared<entity::Circle>(geo::Coordinate(i, i), 5, layer));
+		document->insertEntity(std::make_shared<entity::Arc>(geo::Coordinate(0, i), 3, 0.5, 2.5, true, layer));
+	}
+
+	const std::string sequentialPath = "dxfwrite_sequential.dxf";
+	const std::string parallelPath = "dxfwrite_parallel.dxf";
+
+	DXFimpl sequential(document);
+	sequential.setParallelWrite(false);
+	ASSERT_TRUE(sequential.writeDXF(sequentialPath, File::LIBDXFRW_DXF_R2013));
+
+	DXFimpl parallel(document);
+	ASSERT_TRUE(parallel.writeDXF(parallelPath, File::LIBDXFRW_DXF_R2013));
+
+	auto sequentialContent = readFile(sequentialPath);
+	EXPECT_FALSE(sequentialContent.empty());
+	EXPECT_TRUE(sequentialContent == readFile(parallelPath));
+
+	auto reopened = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+	ASSERT_TRUE(File::open(reopened, parallelPath, File::LIBDXFRW));
+	EXPECT_EQ(document->entities().size(), reopened->entities().size());
+
+	std::remove(sequentialPath.c_str());
+	std::remove(parallelPath.c_str());
+}
+
+TEST(DXFWriteTest, RoundTripAllEntityKinds) {
+	auto document = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+	auto layer = document->layerByName("0");
+	auto block = std::make_shared<Block>("Block", geo::Coordinate(1, 2));
+	std::make_shared<operation::AddBlock>(document, block)->execute();
+
+	document->insertEntity(std::make_shared<entity::Point>(geo::Coordinate(3, 4), layer));
+	document->insertEntity(std::make_shared<entity::Line>(geo::Coordinate(0, 0), geo::Coordinate(10, 20), layer));
+	document->insertEntity(std::make_shared<entity::Circle>(geo::Coordinate(5, 5), 2.5, layer));
+	document->insertEntity(std::make_shared<entity::Arc>(geo::Coordinate(6, 6), 3, 0.5, 2.5, true, layer));
+	document->insertEntity(std::make_shared<entity::Ellipse>(geo::Coordinate(20, 20), geo::Coordinate(4, 0), 2, 0., 6., false, layer));
+
+	std::vector<geo::Coordinate> controlPoints = {geo::Coordinate(0, 0), geo::Coordinate(10, 20), geo::Coordinate(20, 0), geo::Coordinate(30, 10)};
+	std::vector<double> knots = {0, 0, 0, 0, 1, 1, 1, 1};
+	document->insertEntity(std::make_shared<entity::Spline>(controlPoints, knots, std::vector<geo::Coordinate>(), 3, false, 0.5,
+			1, 0, 0, 0, 1, 0, 0, 0, 1, geo::Spline::PLANAR, layer));
+
+	builder::InsertBuilder insertBuilder;
+	insertBuilder.setDocument(document);
+	insertBuilder.setDisplayBlock(block);
+	insertBuilder.setCoordinate(geo::Coordinate(100, 100));
+	insertBuilder.setLayer(layer);
+	document->insertEntity(insertBuilder.build());
+
+	document->insertEntity(std::make_shared<entity::Text>(geo::Coordinate(1, 2), "text", 2.5, 0.5, "STANDARD",
+			TextConst::None, TextConst::HACenter, TextConst::VAMiddle, layer));
+	document->insertEntity(std::make_shared<entity::DimAligned>(geo::Coordinate(0, 0), geo::Coordinate(5, 5), TextConst::Middle_center, 0., 1.,
+			TextConst::AtLeast, "aligned", geo::Coordinate(0, 10), geo::Coordinate(10, 10), layer));
+	document->insertEntity(std::make_shared<entity::DimAngular>(geo::Coordinate(0, 20), geo::Coordinate(5, 25), TextConst::Middle_center, 0., 1.,
+			TextConst::AtLeast, "angular", geo::Coordinate(0, 20), geo::Coordinate(10, 20), geo::Coordinate(0, 20), geo::Coordinate(0, 30), layer));
+	document->insertEntity(std::make_shared<entity::DimDiametric>(geo::Coordinate(0, 40), geo::Coordinate(5, 45), TextConst::Middle_center, 0., 1.,
+			TextConst::AtLeast, "diametric", geo::Coordinate(10, 40), 2.5, layer));
+	document->insertEntity(std::make_shared<entity::DimLinear>(geo::Coordinate(0, 50), geo::Coordinate(5, 55), TextConst::Middle_center, 0., 1.,
+			TextConst::AtLeast, "linear", geo::Coordinate(0, 60), geo::Coordinate(10, 60), 0.5, 0.25, layer));
+	document->insertEntity(std::make_shared<entity::DimRadial>(geo::Coordinate(0, 70), geo::Coordinate(5, 75), TextConst::Middle_center, 0., 1.,
+			TextConst::AtLeast, "radial", geo::Coordinate(10, 70), 3.5, layer));
+	document->insertEntity(std::make_shared<entity::LWPolyline>(std::vector<entity::LWVertex2D>{
+			entity::LWVertex2D(geo::Coordinate(0, 0), 0.5),
+			entity::LWVertex2D(geo::Coordinate(10, 0)),
+			entity::LWVertex2D(geo::Coordinate(10, 10))
+		}, 0., 0., 0., true, geo::Coordinate(0, 0, 1), layer));
+	document->insertEntity(std::make_shared<entity::Image>("image.png", geo::Coordinate(50, 50), geo::Coordinate(1, 0), geo::Coordinate(0, 1),
+			640, 480, 50, 60, 70, layer));
+
+	const std::string path = "dxfwrite_types.dxf";
+	ASSERT_TRUE(File::save(document, path, File::LIBDXFRW_DXF_R2013));
+
+	auto reopened = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+	ASSERT_TRUE(File::open(reopened, path, File::LIBDXFRW));
+
+	std::map<entity::EntityKind, unsigned int> kinds;
+	for(const auto& entity : reopened->entities()) {
+		kinds[entity->kind()]++;
+
+		auto point = std::dynamic_pointer_cast<const entity::Point>(entity);
+		if(point != nullptr) {
+			EXPECT_EQ(geo::Coordinate(3, 4), geo::Coordinate(point->x(), point->y()));
+		}
+
+		auto line = std::dynamic_pointer_cast<const entity::Line>(entity);
+		if(line != nullptr) {
+			EXPECT_EQ(geo::Coordinate(0, 0), line->start());
+			EXPECT_EQ(geo::Coordinate(10, 20), line->end());
+		}
+
+		auto circle = std::dynamic_pointer_cast<const entity::Circle>(entity);
+		if(circle != nullptr) {
+			EXPECT_EQ(geo::Coordinate(5, 5), circle->center());
+			EXPECT_DOUBLE_EQ(2.5, circle->radius());
+		}
+
+		auto arc = std::dynamic_pointer_cast<const entity::Arc>(entity);
+		if(arc != nullptr) {
+			EXPECT_EQ(geo::Coordinate(6, 6), arc->center());
+			EXPECT_DOUBLE_EQ(3, arc->radius());
+			EXPECT_NEAR(0.5, arc->startAngle(), 1e-9);
+			EXPECT_NEAR(2.5, arc->endAngle(), 1e-9);
+		}
+
+		auto ellipse = std::dynamic_pointer_cast<const entity::Ellipse>(entity);
+		if(ellipse != nullptr) {
+			EXPECT_EQ(geo::Coordinate(20, 20), ellipse->center());
+			EXPECT_NEAR(2, ellipse->minorRadius(), 1e-9);
+		}
+
+		auto spline = std::dynamic_pointer_cast<const entity::Spline>(entity);
+		if(spline != nullptr) {
+			EXPECT_EQ(controlPoints.size(), spline->controlPoints().size());
+			EXPECT_EQ(knots, spline->knotPoints());
+			EXPECT_EQ(3, spline->degree());
+		}
+
+		auto insert = std::dynamic_pointer_cast<const entity::Insert>(entity);
+		if(insert != nullptr) {
+			ASSERT_NE(nullptr, insert->displayBlock());
+			EXPECT_EQ("Block", insert->displayBlock()->name());
+			EXPECT_EQ(geo::Coordinate(100, 100), insert->position());
+		}
+
+		auto text = std::dynamic_pointer_cast<const entity::Text>(entity);
+		if(text != nullptr) {
+			EXPECT_EQ("text", text->text_value());
+			EXPECT_EQ(geo::Coordinate(1, 2), text->insertion_point());
+		}
+
+		auto lwPolyline = std::dynamic_pointer_cast<const entity::LWPolyline>(entity);
+		if(lwPolyline != nullptr) {
+			ASSERT_EQ(3u, lwPolyline->vertex().size());
+			EXPECT_TRUE(lwPolyline->closed());
+			EXPECT_EQ(0.5, lwPolyline->vertex()[0].bulge());
+		}
+
+		auto dimLinear = std::dynamic_pointer_cast<const entity::DimLinear>(entity);
+		if(dimLinear != nullptr) {
+			EXPECT_EQ("linear", dimLinear->explicitValue());
+			EXPECT_EQ(geo::Coordinate(10, 60), dimLinear->definitionPoint3());
+		}
+	}
+
+	// Custom entities need their plugin, all other kinds are written
+	for(auto kind = static_cast<int>(entity::EntityKind::Point); kind <= static_cast<int>(entity::EntityKind::Insert); kind++) {
+		EXPECT_EQ(1u, kinds[static_cast<entity::EntityKind>(kind)]) << "Entity kind " << kind << " was not read back";
+	}
+
+	std::remove(path.c_str());
+}
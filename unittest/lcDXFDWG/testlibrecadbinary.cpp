@@ -0,0 +1,407 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+
+#include <cad/dochelpers/documentimpl.h>
+#include <cad/dochelpers/storagemanagerimpl.h>
+#include <cad/meta/metacolor.h>
+#include <cad/operations/blockops.h>
+#include <cad/operations/layerops.h>
+#include <cad/primitive/arc.h>
+#include <cad/primitive/circle.h>
+#include <cad/primitive/dimaligned.h>
+#include <cad/primitive/dimangular.h>
+#include <cad/primitive/dimdiametric.h>
+#include <cad/primitive/dimlinear.h>
+#include <cad/primitive/dimradial.h>
+#include <cad/primitive/image.h>
+#include <cad/primitive/insert.h>
+#include <cad/primitive/line.h>
+#include <cad/primitive/lwpolyline.h>
+#include <cad/primitive/spline.h>
+#include <cad/primitive/text.h>
+#include <cad/builders/insert.h>
+#include <file.h>
+#include <native/librecadbinary.h>
+
+using namespace lc;
+
+namespace {
+	Document_SPtr openBinary(const std::string& path) {
+		auto document = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+		auto builder = std::make_shared<operation::Builder>(document, "Open file");
+
+		FileLibs::LibreCadBinary binary(document, builder);
+		EXPECT_TRUE(binary.open(path));
+		builder->execute();
+
+		return document;
+	}
+}
+
+TEST(LibreCadBinaryTest, RoundTrip) {
+	auto storageManager = std::make_shared<StorageManagerImpl>();
+	auto document = std::make_shared<DocumentImpl>(storageManager);
+	auto layer = std::make_shared<Layer>("Binary", MetaLineWidthByValue(0.5), Color(1., 0., 0., 1.));
+	auto block = std::make_shared<Block>("Binary Block", geo::Coordinate(1, 2));
+	std::make_shared<operation::AddLayer>(document, layer)->execute();
+	std::make_shared<operation::AddBlock>(document, block)->execute();
+
+	auto metaInfo = MetaInfo::create()->add(std::make_shared<MetaColorByValue>(0., 1., 0.));
+
+	for(int i = 0; i < 1000; i++) {
+		document->insertEntity(std::make_shared<entity::Line>(geo::Coordinate(i, 0), geo::Coordinate(i, 10), layer, metaInfo));
+		document->insertEntity(std::make_shared<entity::Circle>(geo::Coordinate(i, i), 5, layer));
+	}
+
+	document->insertEntity(std::make_shared<entity::Arc>(geo::Coordinate(0, 0), 3, 0.5, 2.5, false, layer, nullptr, block));
+
+	std::vector<entity::LWVertex2D> vertex = {
+		entity::LWVertex2D(geo::Coordinate(0, 0), 0.5),
+		entity::LWVertex2D(geo::Coordinate(10, 0)),
+		entity::LWVertex2D(geo::Coordinate(10, 10))
+	};
+	document->insertEntity(std::make_shared<entity::LWPolyline>(vertex, 1, 0, 0, true, geo::Coordinate(0, 0, 1), layer));
+
+	builder::InsertBuilder insertBuilder;
+	insertBuilder.setDocument(document);
+	insertBuilder.setDisplayBlock(block);
+	insertBuilder.setCoordinate(geo::Coordinate(100, 100));
+	insertBuilder.setLayer(layer);
+	document->insertEntity(insertBuilder.build());
+
+	document->insertEntity(std::make_shared<entity::Text>(geo::Coordinate(5, 6), "LibreCAD", 2.5, 0.25, "Standard",
+			TextConst::Backward, TextConst::HACenter, TextConst::VAMiddle, layer, metaInfo));
+
+	std::vector<geo::Coordinate> controlPoints = {geo::Coordinate(0, 0), geo::Coordinate(10, 20), geo::Coordinate(20, 0), geo::Coordinate(30, 10)};
+	std::vector<double> knots = {0, 0, 0, 0, 1, 1, 1, 1};
+	document->insertEntity(std::make_shared<entity::Spline>(controlPoints, knots, std::vector<geo::Coordinate>(), 3, false, 0.5,
+			1, 0, 0, 0, 1, 0, 0, 0, 1, geo::Spline::PLANAR, layer));
+
+	document->insertEntity(std::make_shared<entity::DimAligned>(geo::Coordinate(0, 20), geo::Coordinate(5, 25), TextConst::Middle_center, 0.1, 1.5,
+			TextConst::Exact, "aligned", geo::Coordinate(0, 0), geo::Coordinate(10, 0), layer));
+	document->insertEntity(std::make_shared<entity::DimAngular>(geo::Coordinate(0, 30), geo::Coordinate(5, 35), TextConst::Middle_center, 0., 1.,
+			TextConst::AtLeast, "angular", geo::Coordinate(0, 0), geo::Coordinate(10, 0), geo::Coordinate(0, 0), geo::Coordinate(0, 10), layer));
+	document->insertEntity(std::make_shared<entity::DimDiametric>(geo::Coordinate(0, 40), geo::Coordinate(5, 45), TextConst::Top_left, 0., 1.,
+			TextConst::AtLeast, "diametric", geo::Coordinate(10, 40), 2.5, layer));
+	document->insertEntity(std::make_shared<entity::DimLinear>(geo::Coordinate(0, 50), geo::Coordinate(5, 55), TextConst::Middle_center, 0., 1.,
+			TextConst::AtLeast, "linear", geo::Coordinate(0, 60), geo::Coordinate(10, 60), 0.5, 0.25, layer));
+	document->insertEntity(std::make_shared<entity::DimRadial>(geo::Coordinate(0, 70), geo::Coordinate(5, 75), TextConst::Middle_center, 0., 1.,
+			TextConst::AtLeast, "radial", geo::Coordinate(10, 70), 3.5, layer));
+	document->insertEntity(std::make_shared<entity::Image>("image.png", geo::Coordinate(50, 50), geo::Coordinate(1, 0), geo::Coordinate(0, 1),
+			640, 480, 50, 60, 70, layer));
+
+	// Opening a file runs a single operation, which optimises the spatial index afterwards
+	storageManager->optimise();
+
+	const std::string path = "librecadbinary_roundtrip.lcb";
+	FileLibs::LibreCadBinary binary(document);
+	ASSERT_TRUE(binary.save(path));
+
+	auto reopened = openBinary(path);
+	auto reopenedLayer = reopened->layerByName("Binary");
+	Block_CSPtr reopenedBlock;
+	for(const auto& reopenedBlocks : reopened->blocks()) {
+		if(reopenedBlocks->name() == "Binary Block") {
+			reopenedBlock = reopenedBlocks;
+		}
+	}
+
+	ASSERT_NE(nullptr, reopenedLayer);
+	ASSERT_NE(nullptr, reopenedBlock);
+	EXPECT_EQ(0.5, reopenedLayer->lineWidth().width());
+	EXPECT_TRUE(Color(1., 0., 0., 1.) == reopenedLayer->color());
+	EXPECT_EQ(geo::Coordinate(1, 2), reopenedBlock->base());
+
+	EXPECT_EQ(document->entities().size(), reopened->entities().size());
+	EXPECT_EQ(document->spatialIndexLayout(), reopened->spatialIndexLayout());
+	EXPECT_EQ(1u, reopened->entitiesByBlock(reopenedBlock).asVector().size());
+	EXPECT_EQ(2010u, reopened->entitiesByLayer(reopenedLayer).asVector().size());
+
+	unsigned int lines = 0;
+	unsigned int dimensions = 0;
+	for(const auto& entity : reopened->entities()) {
+		auto line = std::dynamic_pointer_cast<const entity::Line>(entity);
+		if(line != nullptr) {
+			lines++;
+			auto color = line->metaInfo<MetaColorByValue>(MetaColor::LCMETANAME());
+			ASSERT_NE(nullptr, color);
+			EXPECT_EQ(1., color->color().green());
+			EXPECT_EQ(10., line->end().y() - line->start().y());
+		}
+
+		auto lwPolyline = std::dynamic_pointer_cast<const entity::LWPolyline>(entity);
+		if(lwPolyline != nullptr) {
+			ASSERT_EQ(3u, lwPolyline->vertex().size());
+			EXPECT_EQ(0.5, lwPolyline->vertex()[0].bulge());
+			EXPECT_TRUE(lwPolyline->closed());
+		}
+
+		auto insert = std::dynamic_pointer_cast<const entity::Insert>(entity);
+		if(insert != nullptr) {
+			EXPECT_EQ(reopenedBlock, insert->displayBlock());
+			EXPECT_EQ(geo::Coordinate(100, 100), insert->position());
+		}
+
+		auto text = std::dynamic_pointer_cast<const entity::Text>(entity);
+		if(text != nullptr) {
+			EXPECT_EQ("LibreCAD", text->text_value());
+			EXPECT_EQ("Standard", text->style());
+			EXPECT_EQ(geo::Coordinate(5, 6), text->insertion_point());
+			EXPECT_EQ(2.5, text->height());
+			EXPECT_EQ(0.25, text->angle());
+			EXPECT_EQ(TextConst::Backward, text->textgeneration());
+			EXPECT_EQ(TextConst::HACenter, text->halign());
+			EXPECT_EQ(TextConst::VAMiddle, text->valign());
+			EXPECT_NE(nullptr, text->metaInfo<MetaColorByValue>(MetaColor::LCMETANAME()));
+		}
+
+		auto spline = std::dynamic_pointer_cast<const entity::Spline>(entity);
+		if(spline != nullptr) {
+			EXPECT_EQ(controlPoints, spline->controlPoints());
+			EXPECT_EQ(knots, spline->knotPoints());
+			EXPECT_EQ(3, spline->degree());
+			EXPECT_EQ(0.5, spline->fitTolerance());
+			EXPECT_EQ(1., spline->startTanX());
+			EXPECT_EQ(1., spline->nZ());
+			EXPECT_EQ(geo::Spline::PLANAR, spline->flags());
+		}
+
+		auto dimAligned = std::dynamic_pointer_cast<const entity::DimAligned>(entity);
+		if(dimAligned != nullptr) {
+			dimensions++;
+			EXPECT_EQ("aligned", dimAligned->explicitValue());
+			EXPECT_EQ(geo::Coordinate(0, 20), dimAligned->definitionPoint());
+			EXPECT_EQ(geo::Coordinate(5, 25), dimAligned->middleOfText());
+			EXPECT_EQ(0.1, dimAligned->textAngle());
+			EXPECT_EQ(1.5, dimAligned->lineSpacingFactor());
+			EXPECT_EQ(TextConst::Exact, dimAligned->lineSpacingStyle());
+			EXPECT_EQ(geo::Coordinate(10, 0), dimAligned->definitionPoint3());
+		}
+
+		auto dimAngular = std::dynamic_pointer_cast<const entity::DimAngular>(entity);
+		if(dimAngular != nullptr) {
+			dimensions++;
+			EXPECT_EQ("angular", dimAngular->explicitValue());
+			EXPECT_EQ(geo::Coordinate(0, 10), dimAngular->defLine22());
+		}
+
+		auto dimDiametric = std::dynamic_pointer_cast<const entity::DimDiametric>(entity);
+		if(dimDiametric != nullptr) {
+			dimensions++;
+			EXPECT_EQ(TextConst::Top_left, dimDiametric->attachmentPoint());
+			EXPECT_EQ(geo::Coordinate(10, 40), dimDiametric->definitionPoint2());
+			EXPECT_EQ(2.5, dimDiametric->leader());
+		}
+
+		auto dimLinear = std::dynamic_pointer_cast<const entity::DimLinear>(entity);
+		if(dimLinear != nullptr) {
+			dimensions++;
+			EXPECT_EQ(geo::Coordinate(10, 60), dimLinear->definitionPoint3());
+			EXPECT_EQ(0.5, dimLinear->angle());
+			EXPECT_EQ(0.25, dimLinear->oblique());
+		}
+
+		auto dimRadial = std::dynamic_pointer_cast<const entity::DimRadial>(entity);
+		if(dimRadial != nullptr) {
+			dimensions++;
+			EXPECT_EQ(geo::Coordinate(10, 70), dimRadial->definitionPoint2());
+			EXPECT_EQ(3.5, dimRadial->leader());
+		}
+
+		auto image = std::dynamic_pointer_cast<const entity::Image>(entity);
+		if(image != nullptr) {
+			EXPECT_EQ("image.png", image->name());
+			EXPECT_EQ(geo::Coordinate(50, 50), image->base());
+			EXPECT_EQ(geo::Coordinate(0, 1), image->vv());
+			EXPECT_EQ(480., image->height());
+			EXPECT_EQ(70., image->fade());
+		}
+	}
+	EXPECT_EQ(1000u, lines);
+	EXPECT_EQ(5u, dimensions);
+
+	std::remove(path.c_str());
+}
+
+TEST(LibreCadBinaryTest, EntityNotStored) {
+	auto document = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+
+	// The layer is not part of the document, the entity can't refer to it
+	auto layer = std::make_shared<Layer>("Unknown", Color(1., 1., 1., 1.));
+	document->insertEntity(std::make_shared<entity::Line>(geo::Coordinate(0, 0), geo::Coordinate(10, 10), layer));
+
+	const std::string path = "librecadbinary_incomplete.lcb";
+	FileLibs::LibreCadBinary binary(document);
+	EXPECT_FALSE(binary.save(path));
+	EXPECT_FALSE(std::ifstream(path).good()) << "Incomplete file was written";
+}
+
+TEST(LibreCadBinaryTest, SpatialIndexRestoredByBuilder) {
+	auto storageManager = std::make_shared<StorageManagerImpl>();
+	auto document = std::make_shared<DocumentImpl>(storageManager);
+	auto layer = document->layerByName("0");
+	for(int i = 0; i < 1000; i++) {
+		document->insertEntity(std::make_shared<entity::Line>(geo::Coordinate(i, 0), geo::Coordinate(i, i), layer));
+	}
+	storageManager->optimise();
+
+	const std::string path = "librecadbinary_spatialindex.lcb";
+	FileLibs::LibreCadBinary saved(document);
+	ASSERT_TRUE(saved.save(path));
+
+	auto reopened = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+	auto builder = std::make_shared<operation::Builder>(reopened, "Open file");
+	FileLibs::LibreCadBinary binary(reopened, builder);
+	ASSERT_TRUE(binary.open(path));
+
+	// Nothing touches the document before the builder runs
+	EXPECT_FALSE(binary.spatialIndexRestored());
+	EXPECT_TRUE(reopened->entities().empty());
+
+	builder->execute();
+	EXPECT_TRUE(binary.spatialIndexRestored());
+	EXPECT_EQ(document->spatialIndexLayout(), reopened->spatialIndexLayout());
+
+	// A document which already has entities keeps its own index
+	auto notEmpty = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+	notEmpty->insertEntity(std::make_shared<entity::Line>(geo::Coordinate(0, 0), geo::Coordinate(1, 1), notEmpty->layerByName("0")));
+	auto notEmptyBuilder = std::make_shared<operation::Builder>(notEmpty, "Open file");
+	FileLibs::LibreCadBinary notEmptyBinary(notEmpty, notEmptyBuilder);
+	ASSERT_TRUE(notEmptyBinary.open(path));
+	notEmptyBuilder->execute();
+
+	EXPECT_FALSE(notEmptyBinary.spatialIndexRestored());
+	EXPECT_EQ(1001u, notEmpty->entities().size());
+
+	std::remove(path.c_str());
+}
+
+TEST(LibreCadBinaryTest, InvalidFile) {
+	const std::string path = "librecadbinary_invalid.lcb";
+	{
+		std::ofstream file(path, std::ios::binary);
+		file << "This is not a LibreCAD binary file";
+	}
+
+	auto document = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+	auto builder = std::make_shared<operation::Builder>(document, "Open file");
+	FileLibs::LibreCadBinary binary(document, builder);
+
+	EXPECT_FALSE(binary.open(path));
+	EXPECT_FALSE(binary.open("librecadbinary_missing.lcb"));
+
+	std::remove(path.c_str());
+}
+
+TEST(LibreCadBinaryTest, OpenCorruptFile) {
+	const std::string path = "corrupt.lcb";
+	{
+		std::ofstream file(path, std::ios::binary);
+		file << "not a LibreCAD binary file";
+	}
+
+	auto document = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+	EXPECT_FALSE(File::open(document, path, File::LIBRECAD));
+	EXPECT_TRUE(document->entities().empty());
+
+	EXPECT_FALSE(File::open(document, "does_not_exist.dxf", File::LIBDXFRW));
+	EXPECT_TRUE(document->entities().empty());
+
+	std::remove(path.c_str());
+}
+
+namespace {
+	// Section table entry of the file format
+	struct Section {
+		uint32_t type;
+		uint32_t columns;
+		uint64_t offset;
+		uint64_t size;
+		uint64_t count;
+	};
+
+	/**
+	 * Change the section of the given type in a saved file, then try to open it
+	 */
+	bool openModified(const std::string& path, uint32_t type, const std::function<void(std::vector<char>&, Section&)>& modify) {
+		std::vector<char> data;
+		{
+			std::ifstream file(path, std::ios::binary);
+			data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		}
+
+		uint32_t sectionCount;
+		uint64_t sectionTableOffset;
+		std::memcpy(&sectionCount, data.data() + 12, sizeof(sectionCount));
+		std::memcpy(&sectionTableOffset, data.data() + 16, sizeof(sectionTableOffset));
+
+		auto sections = reinterpret_cast<Section*>(data.data() + sectionTableOffset);
+		auto section = std::find_if(sections, sections + sectionCount, [type](const Section& section) {
+			return section.type == type;
+		});
+		EXPECT_NE(sections + sectionCount, section) << "Section " << type << " not found";
+		if (section == sections + sectionCount) {
+			return true;
+		}
+
+		modify(data, *section);
+
+		const std::string modifiedPath = "librecadbinary_modified.lcb";
+		{
+			std::ofstream file(modifiedPath, std::ios::binary);
+			file.write(data.data(), data.size());
+		}
+
+		auto document = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+		auto builder = std::make_shared<operation::Builder>(document, "Open file");
+		FileLibs::LibreCadBinary binary(document, builder);
+		auto opened = binary.open(modifiedPath);
+
+		std::remove(modifiedPath.c_str());
+		return opened;
+	}
+}
+
+TEST(LibreCadBinaryTest, InvalidTables) {
+	auto document = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+	auto layer = document->layerByName("0");
+	auto block = std::make_shared<Block>("Block", geo::Coordinate(0, 0));
+	auto addBlock = std::make_shared<operation::AddBlock>(document, block);
+	addBlock->execute();
+
+	document->insertEntity(std::make_shared<entity::Line>(geo::Coordinate(0, 0), geo::Coordinate(10, 10), layer));
+
+	builder::InsertBuilder insertBuilder;
+	insertBuilder.setDocument(document);
+	insertBuilder.setDisplayBlock(block);
+	insertBuilder.setCoordinate(geo::Coordinate(5, 5));
+	insertBuilder.setLayer(layer);
+	document->insertEntity(insertBuilder.build());
+
+	const std::string path = "librecadbinary_tables.lcb";
+	FileLibs::LibreCadBinary saved(document);
+	ASSERT_TRUE(saved.save(path));
+
+	const uint32_t LINES = 17;
+	const uint32_t INSERTS = 23;
+
+	EXPECT_TRUE(openModified(path, LINES, [](std::vector<char>&, Section&) {}));
+
+	// One line has 12 bytes of indices padded to 16 and 4 double columns, 44 bytes fit without the padding
+	EXPECT_FALSE(openModified(path, LINES, [](std::vector<char>&, Section& section) {
+		section.size = 44;
+	})) << "Columns after the padded indices were read past the section";
+
+	// The insert refers to a block which doesn't exist
+	EXPECT_FALSE(openModified(path, INSERTS, [](std::vector<char>& data, Section& section) {
+		int64_t block = 99;
+		std::memcpy(data.data() + section.offset + 16, &block, sizeof(block));
+	}));
+
+	std::remove(path.c_str());
+}
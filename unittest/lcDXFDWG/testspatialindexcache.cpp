@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+
+#include <cad/dochelpers/documentimpl.h>
+#include <cad/dochelpers/storagemanagerimpl.h>
+#include <cad/operations/entitybuilder.h>
+#include <cad/primitive/circle.h>
+#include <cad/primitive/line.h>
+#include <native/spatialindexcache.h>
+
+using namespace lc;
+
+namespace {
+	void writeDrawing(const std::string& path, const std::string& content) {
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file << content;
+	}
+
+	// Insert the same entities in the same order, like opening the drawing
+	void open(Document_SPtr document) {
+		auto layer = document->layerByName("0");
+		auto builder = std::make_shared<operation::EntityBuilder>(document);
+
+		for(int i = 0; i < 2000; i++) {
+			builder->appendEntity(std::make_shared<entity::Line>(geo::Coordinate(i, 0), geo::Coordinate(i, 10), layer));
+			builder->appendEntity(std::make_shared<entity::Circle>(geo::Coordinate(i % 100 * 50, i / 100 * 50), 5, layer));
+		}
+
+		builder->execute();
+	}
+}
+
+TEST(SpatialIndexCacheTest, RestoreWhenUnchanged) {
+	const std::string path = "spatialindexcache.dxf";
+	writeDrawing(path, "drawing content");
+
+	auto document = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+	FileLibs::SpatialIndexCache cache(path);
+	EXPECT_FALSE(cache.restore(document));
+	open(document);
+	ASSERT_TRUE(cache.save(document));
+
+	auto reopened = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+	EXPECT_TRUE(FileLibs::SpatialIndexCache(path).restore(reopened));
+	open(reopened);
+
+	EXPECT_EQ(document->spatialIndexLayout(), reopened->spatialIndexLayout());
+	EXPECT_EQ(document->spatialIndexPlacement(), reopened->spatialIndexPlacement());
+	EXPECT_EQ(4000u, reopened->entities().size());
+
+	auto area = geo::Area(geo::Coordinate(0, 0), geo::Coordinate(500, 500));
+	EXPECT_EQ(
+		document->entityContainer().entitiesFullWithinArea(area).asVector().size(),
+		reopened->entityContainer().entitiesFullWithinArea(area).asVector().size()
+	);
+
+	// Removing entities must find them in their restored node
+	auto builder = std::make_shared<operation::EntityBuilder>(reopened);
+	for(const auto& entity : reopened->entities()) {
+		builder->appendEntity(entity);
+	}
+	builder->appendOperation(std::make_shared<operation::Push>());
+	builder->appendOperation(std::make_shared<operation::Remove>());
+	builder->execute();
+	EXPECT_EQ(0u, reopened->entities().size());
+	EXPECT_EQ(std::vector<uint8_t>({0}), reopened->spatialIndexLayout());
+
+	std::remove(path.c_str());
+	std::remove(FileLibs::SpatialIndexCache::cachePath(path).c_str());
+}
+
+TEST(SpatialIndexCacheTest, IgnoreWhenChanged) {
+	const std::string path = "spatialindexcache_changed.dxf";
+	writeDrawing(path, "drawing content");
+
+	auto document = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+	open(document);
+	ASSERT_TRUE(FileLibs::SpatialIndexCache(path).save(document));
+
+	writeDrawing(path, "changed drawing content");
+
+	auto reopened = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+	EXPECT_FALSE(FileLibs::SpatialIndexCache(path).restore(reopened));
+
+	std::remove(path.c_str());
+	std::remove(FileLibs::SpatialIndexCache::cachePath(path).c_str());
+}
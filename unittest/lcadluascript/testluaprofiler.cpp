@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+extern "C" {
+	#include "lua.h"
+	#include "lualib.h"
+	#include "lauxlib.h"
+}
+
+#include <utils/luaprofiler.h>
+
+using namespace lc;
+
+namespace {
+	const char* SCRIPT = R"(
+		local function leaf(n)
+			local sum = 0
+			for i = 1, n do
+				sum = sum + i
+			end
+			return sum
+		end
+
+		local function outer()
+			for i = 1, 200 do
+				leaf(2000)
+			end
+		end
+
+		-- Errors unwind frames without return events
+		for i = 1, 100 do
+			pcall(function() error("unwound") end)
+		end
+
+		outer()
+	)";
+
+	const char* COROUTINE_SCRIPT = R"(
+		local function leaf(n)
+			local sum = 0
+			for i = 1, n do
+				sum = sum + i
+			end
+			return sum
+		end
+
+		local function worker()
+			leaf(100)
+			coroutine.yield()
+			leaf(100)
+		end
+
+		for i = 1, 50 do
+			local co = coroutine.create(worker)
+			coroutine.resume(co)
+			coroutine.resume(co)
+		end
+	)";
+
+	std::vector<std::string> lines(const std::string& text) {
+		std::vector<std::string> result;
+		std::istringstream stream(text);
+		std::string line;
+		while(std::getline(stream, line)) {
+			result.push_back(line);
+		}
+		return result;
+	}
+}
+
+TEST(LuaProfilerTest, FoldedStacks) {
+	lua_State* L = luaL_newstate();
+	luaL_openlibs(L);
+
+	{
+		LuaProfiler profiler(L);
+		profiler.start();
+		ASSERT_EQ(LUA_OK, luaL_loadbuffer(L, SCRIPT, std::strlen(SCRIPT), "=test"));
+		ASSERT_EQ(LUA_OK, lua_pcall(L, 0, 0, 0));
+		profiler.stop();
+
+		std::ostringstream folded;
+		profiler.writeFoldedStacks(folded);
+
+		// outer() runs after the errors, its stack starts at the main chunk again
+		bool leafFound = false;
+		for(const auto& line : lines(folded.str())) {
+			if(line.find("leaf (test:") == std::string::npos) {
+				continue;
+			}
+
+			leafFound = true;
+			EXPECT_EQ(0u, line.find("main chunk (test);outer (test:10);leaf (test:2) ")) << line;
+		}
+		EXPECT_TRUE(leafFound) << folded.str();
+
+		for(const auto& function : profiler.functions()) {
+			if(function.name == "leaf (test:2)") {
+				EXPECT_EQ(200u, function.calls);
+			}
+			if(function.name == "pcall [C]") {
+				EXPECT_EQ(100u, function.calls);
+				EXPECT_TRUE(function.native);
+			}
+		}
+	}
+
+	lua_close(L);
+}
+
+TEST(LuaProfilerTest, Coroutines) {
+	lua_State* L = luaL_newstate();
+	luaL_openlibs(L);
+
+	{
+		LuaProfiler profiler(L);
+		profiler.start();
+		ASSERT_EQ(LUA_OK, luaL_loadbuffer(L, COROUTINE_SCRIPT, std::strlen(COROUTINE_SCRIPT), "=test"));
+		ASSERT_EQ(LUA_OK, lua_pcall(L, 0, 0, 0));
+		profiler.stop();
+
+		std::ostringstream folded;
+		profiler.writeFoldedStacks(folded);
+
+		// Each coroutine has its own stack, starting at the function it runs.
+		// That function is called by resume, Lua doesn't know its name.
+		const std::string worker = "(test:10)";
+		for(const auto& line : lines(folded.str())) {
+			if(line.find("leaf (test:") != std::string::npos) {
+				auto first = line.substr(0, line.find(';'));
+				EXPECT_EQ(first.size() - worker.size(), first.rfind(worker)) << line;
+				EXPECT_NE(std::string::npos, line.find(worker + ";leaf (test:2) ")) << line;
+			}
+		}
+
+		bool workerFound = false;
+		for(const auto& function : profiler.functions()) {
+			if(function.name == "leaf (test:2)") {
+				EXPECT_EQ(100u, function.calls);
+			}
+			if(function.name.size() > worker.size() && function.name.rfind(worker) == function.name.size() - worker.size()) {
+				workerFound = true;
+				EXPECT_EQ(50u, function.calls);
+			}
+		}
+		EXPECT_TRUE(workerFound);
+	}
+
+	lua_close(L);
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <cad/base/entitypool.h>
+#include <cad/builders/line.h>
+#include <cad/primitive/line.h>
+#include <thread>
+#include <vector>
+
+TEST(EntityPoolTest, ReuseBlocks) {
+	lc::pool::FixedSizePool pool(48, 4);
+
+	auto a = pool.allocate();
+	auto b = pool.allocate();
+	EXPECT_NE(a, b);
+	EXPECT_EQ(2, pool.blocksInUse());
+
+	pool.deallocate(a);
+	EXPECT_EQ(a, pool.allocate()) << "Freed block was not reused";
+
+	EXPECT_FALSE(pool.releaseUnused()) << "Pool released slabs which are still in use";
+
+	pool.deallocate(a);
+	pool.deallocate(b);
+	EXPECT_TRUE(pool.releaseUnused());
+	EXPECT_EQ(0, pool.bytesReserved());
+}
+
+TEST(EntityPoolTest, ReleasePartiallyUsedPool) {
+	lc::pool::FixedSizePool pool(48, 4);
+
+	std::vector<void*> blocks;
+	for (int i = 0; i < 12; i++) {
+		blocks.push_back(pool.allocate());
+	}
+	EXPECT_EQ(3 * 4 * 48, pool.bytesReserved());
+
+	// Keep one block of the first slab
+	for (size_t i = 1; i < blocks.size(); i++) {
+		pool.deallocate(blocks[i]);
+	}
+
+	EXPECT_TRUE(pool.releaseUnused()) << "Empty slabs were kept because a block is still in use";
+	EXPECT_EQ(4 * 48, pool.bytesReserved());
+	EXPECT_EQ(1, pool.blocksInUse());
+
+	pool.deallocate(blocks[0]);
+	EXPECT_TRUE(pool.releaseUnused());
+	EXPECT_EQ(0, pool.bytesReserved());
+}
+
+TEST(EntityPoolTest, ThreadCaches) {
+	lc::pool::FixedSizePool pool(48, 16);
+	const size_t blocksPerThread = 1000;
+
+	// Blocks are allocated by one thread and freed by another, the caches give them back to the pool
+	std::vector<std::vector<void*>> blocks(4);
+	std::vector<std::thread> threads;
+	for (auto& threadBlocks : blocks) {
+		threads.emplace_back([&pool, &threadBlocks, blocksPerThread]() {
+			for (size_t i = 0; i < blocksPerThread; i++) {
+				threadBlocks.push_back(pool.allocate());
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	threads.clear();
+
+	EXPECT_EQ(blocks.size() * blocksPerThread, pool.blocksInUse());
+
+	for (size_t i = 0; i < blocks.size(); i++) {
+		threads.emplace_back([&pool, &blocks, i]() {
+			for (auto block : blocks[(i + 1) % blocks.size()]) {
+				pool.deallocate(block);
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	EXPECT_EQ(0, pool.blocksInUse());
+	EXPECT_TRUE(pool.releaseUnused());
+	EXPECT_EQ(0, pool.bytesReserved());
+}
+
+TEST(EntityPoolTest, PooledEntities) {
+	auto layer = std::make_shared<const lc::Layer>();
+	auto line = lc::pool::makeShared<lc::entity::Line>(lc::geo::Coordinate(0, 0), lc::geo::Coordinate(10, 10), layer);
+
+	auto moved = std::static_pointer_cast<const lc::entity::Line>(line->move(lc::geo::Coordinate(10, 0)));
+	EXPECT_EQ(line->id(), moved->id());
+	EXPECT_EQ(lc::geo::Coordinate(10, 0), moved->start());
+
+	lc::builder::LineBuilder builder;
+	builder.setStart(lc::geo::Coordinate(1, 2));
+	builder.setEnd(lc::geo::Coordinate(3, 4));
+	builder.setLayer(layer);
+	auto built = builder.build();
+
+	EXPECT_EQ(lc::geo::Coordinate(1, 2), built->start());
+	EXPECT_EQ(built, built->shared_from_this()) << "enable_shared_from_this not set up";
+}
+
+TEST(EntityPoolTest, AllocationSize) {
+	using lc::pool::FixedSizePool;
+
+	EXPECT_EQ(FixedSizePool::forSize(1).blockSize(), FixedSizePool::allocationSize(1));
+	EXPECT_EQ(FixedSizePool::Alignment * 2, FixedSizePool::allocationSize(FixedSizePool::Alignment + 1));
+	EXPECT_EQ(FixedSizePool::MaxBlockSize, FixedSizePool::allocationSize(FixedSizePool::MaxBlockSize));
+
+	// Not pooled
+	EXPECT_EQ(FixedSizePool::MaxBlockSize + 1, FixedSizePool::allocationSize(FixedSizePool::MaxBlockSize + 1));
+}
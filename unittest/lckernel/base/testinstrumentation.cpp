@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+#include <cad/base/instrumentation.h>
+#include <cad/dochelpers/documentimpl.h>
+#include <cad/dochelpers/storagemanagerimpl.h>
+#include <cad/operations/entitybuilder.h>
+#include <cad/primitive/line.h>
+
+using namespace lc::instrumentation;
+
+namespace {
+	const TimerStatistics* findTimer(const std::vector<TimerStatistics>& timers, const std::string& name) {
+		for(const auto& timer : timers) {
+			if(timer.name == name) {
+				return &timer;
+			}
+		}
+
+		return nullptr;
+	}
+}
+
+TEST(InstrumentationTest, Disabled) {
+	auto& instrumentation = Instrumentation::instance();
+	instrumentation.setEnabled(false);
+	instrumentation.reset();
+
+	{
+		ScopedTimer timer("test.disabled");
+	}
+	count("test.disabled");
+
+	EXPECT_EQ(nullptr, findTimer(instrumentation.timers(), "test.disabled"));
+	EXPECT_EQ(0, instrumentation.counters().count("test.disabled"));
+}
+
+TEST(InstrumentationTest, TimersAndCounters) {
+	auto& instrumentation = Instrumentation::instance();
+	instrumentation.reset();
+	instrumentation.setEnabled(true);
+
+	for(int i = 0; i < 3; i++) {
+		ScopedTimer timer("test.timer");
+		count("test.counter", 2);
+	}
+
+	// Other threads are merged
+	std::thread thread([]() {
+		ScopedTimer timer("test.timer");
+		count("test.counter");
+	});
+	thread.join();
+
+	instrumentation.setEnabled(false);
+
+	auto timers = instrumentation.timers();
+	auto timer = findTimer(timers, "test.timer");
+	ASSERT_NE(nullptr, timer);
+	EXPECT_EQ(4, timer->calls);
+	EXPECT_LE(timer->min, timer->max);
+	EXPECT_LE(timer->max, timer->total);
+
+	EXPECT_EQ(7, instrumentation.counters().at("test.counter"));
+
+	instrumentation.reset();
+	EXPECT_EQ(nullptr, findTimer(instrumentation.timers(), "test.timer"));
+}
+
+TEST(InstrumentationTest, ChromeTrace) {
+	auto& instrumentation = Instrumentation::instance();
+	instrumentation.reset();
+	instrumentation.setTracing(true, 2);
+
+	for(int i = 0; i < 3; i++) {
+		ScopedTimer timer("test.trace");
+	}
+
+	instrumentation.setTracing(false);
+	instrumentation.setEnabled(false);
+
+	std::stringstream trace;
+	instrumentation.writeChromeTrace(trace);
+	auto json = trace.str();
+
+	EXPECT_EQ(0, json.find("{\"displayTimeUnit\": \"ms\", \"traceEvents\": ["));
+	EXPECT_NE(std::string::npos, json.find("\"name\": \"test.trace\", \"cat\": \"librecad\", \"ph\": \"X\""));
+
+	// Only 2 events are kept
+	size_t events = 0;
+	for(auto position = json.find("\"ph\": \"X\""); position != std::string::npos; position = json.find("\"ph\": \"X\"", position + 1)) {
+		events++;
+	}
+	EXPECT_EQ(2, events);
+	EXPECT_EQ(1, instrumentation.counters().at("instrumentation.droppedEvents"));
+
+	instrumentation.reset();
+}
+
+TEST(InstrumentationTest, DocumentExecute) {
+	auto& instrumentation = Instrumentation::instance();
+	instrumentation.reset();
+	instrumentation.setEnabled(true);
+
+	auto document = std::make_shared<lc::DocumentImpl>(std::make_shared<lc::StorageManagerImpl>());
+	auto builder = std::make_shared<lc::operation::EntityBuilder>(document);
+	builder->appendEntity(std::make_shared<lc::entity::Line>(lc::geo::Coordinate(0, 0), lc::geo::Coordinate(10, 10), document->layerByName("0")));
+	builder->execute();
+
+	instrumentation.setEnabled(false);
+
+	auto timers = instrumentation.timers();
+	for(auto name : {"document.execute", "document.execute.begin", "document.execute.process",
+					 "document.execute.optimise", "document.execute.commit"}) {
+		auto timer = findTimer(timers, name);
+		ASSERT_NE(nullptr, timer) << name;
+		EXPECT_EQ(1, timer->calls) << name;
+	}
+
+	instrumentation.reset();
+}
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include <memory>
+#include <thread>
+#include <vector>
 #include <cad/dochelpers/documentimpl.h>
 #include <cad/dochelpers/documentlist.h>
 #include <cad/dochelpers/storagemanagerimpl.h>
@@ -32,4 +34,23 @@ TEST(DocumentList, NewWaitingCustomEntity) {
 
     ASSERT_TRUE(eventReceived);
     ASSERT_EQ(1, lc::DocumentList::getInstance().waitingCustomEntities("plugin").size());
-}
\ No newline at end of file
+}
+
+TEST(DocumentList, ConcurrentDocuments) {
+    auto waiting = lc::DocumentList::getInstance().waitingCustomEntities("plugin").size();
+
+    std::vector<std::thread> threads;
+    for(int i = 0; i < 4; i++) {
+        threads.emplace_back([]() {
+            for(int j = 0; j < 200; j++) {
+                std::make_shared<lc::DocumentImpl>(std::make_shared<lc::StorageManagerImpl>());
+            }
+        });
+    }
+
+    for(auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(waiting, lc::DocumentList::getInstance().waitingCustomEntities("plugin").size());
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <cad/base/entitypool.h>
+#include <cad/dochelpers/documentimpl.h>
+#include <cad/dochelpers/memoryusage.h>
+#include <cad/dochelpers/storagemanagerimpl.h>
+#include <cad/dochelpers/undomanagerimpl.h>
+#include <cad/operations/entitybuilder.h>
+#include <cad/primitive/circle.h>
+#include <cad/primitive/line.h>
+#include <cad/primitive/lwpolyline.h>
+
+using namespace lc;
+
+TEST(MemoryUsageTest, Categories) {
+	MemoryUsage usage;
+	usage.add("entity.Line", 100, 2);
+	usage.add("entity.Line", 50);
+	usage.add("index.spatial", 1000, 5);
+
+	MemoryUsage other;
+	other.add("entity.Circle", 80);
+	usage.merge(other);
+
+	EXPECT_EQ(150, usage.category("entity.Line").bytes);
+	EXPECT_EQ(3, usage.category("entity.Line").count);
+	EXPECT_EQ(0, usage.category("undo.operations").count);
+	EXPECT_EQ(230, usage.totalBytes("entity."));
+	EXPECT_EQ(1230, usage.totalBytes());
+	EXPECT_EQ(3, usage.categories().size());
+
+	std::ostringstream stream;
+	usage.write(stream);
+	EXPECT_NE(std::string::npos, stream.str().find("index.spatial"));
+	EXPECT_NE(std::string::npos, stream.str().find("total"));
+}
+
+TEST(MemoryUsageTest, EntitySize) {
+	auto layer = std::make_shared<const Layer>("0", Color(255, 255, 255));
+	entity::Line line(geo::Coordinate(0, 0), geo::Coordinate(10, 0), layer);
+	EXPECT_LE(sizeof(entity::Line) + memory::SHARED_CONTROL_BLOCK, memory::entitySize(line));
+	// Rounded to the block size of the pool
+	EXPECT_EQ(0, memory::entitySize(line) % pool::FixedSizePool::Alignment);
+	EXPECT_STREQ("Line", memory::entityKindName(line.kind()));
+
+	// The segments generated from the vertices are included
+	std::vector<entity::LWVertex2D> vertices;
+	for(int i = 0; i < 100; i++) {
+		vertices.emplace_back(geo::Coordinate(i, i % 2));
+	}
+	entity::LWPolyline polyline(vertices, 0., 0., 0., false, geo::Coordinate(0, 0), layer);
+	EXPECT_LT(99 * memory::entitySize(line), memory::entitySize(polyline));
+}
+
+TEST(MemoryUsageTest, Document) {
+	auto document = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+	auto undoManager = std::make_shared<UndoManagerImpl>(10);
+	document->commitProcessEvent().connect<UndoManagerImpl, &UndoManagerImpl::on_CommitProcessEvent>(undoManager.get());
+	auto layer = document->layerByName("0");
+
+	std::vector<entity::CADEntity_CSPtr> lines;
+	auto builder = std::make_shared<operation::EntityBuilder>(document);
+	for(int i = 0; i < 1000; i++) {
+		auto line = std::make_shared<entity::Line>(geo::Coordinate(i, 0), geo::Coordinate(i, 10), layer);
+		lines.push_back(line);
+		builder->appendEntity(line);
+	}
+	builder->appendEntity(std::make_shared<entity::Circle>(geo::Coordinate(5, 5), 2, layer));
+	builder->execute();
+
+	auto usage = document->memoryUsage();
+	EXPECT_EQ(1000, usage.category("entity.Line").count);
+	EXPECT_EQ(1000 * memory::entitySize(*lines[0]), usage.category("entity.Line").bytes);
+	EXPECT_EQ(1, usage.category("entity.Circle").count);
+	EXPECT_LT(1, usage.category("index.spatial").count);
+	EXPECT_LT(1000 * sizeof(entity::CADEntity_CSPtr), usage.category("index.spatial").bytes);
+	EXPECT_LT(0, usage.category("index.layers").bytes);
+	EXPECT_EQ(0, undoManager->memoryUsage().category("undo.entities.Line").count);
+
+	builder = std::make_shared<operation::EntityBuilder>(document);
+	for(int i = 0; i < 100; i++) {
+		builder->appendEntity(lines[i]);
+	}
+	builder->appendOperation(std::make_shared<operation::Push>());
+	builder->appendOperation(std::make_shared<operation::Remove>());
+	builder->execute();
+
+	// Removed entities are only kept by the undo history
+	EXPECT_EQ(900, document->memoryUsage().category("entity.Line").count);
+
+	auto undoUsage = undoManager->memoryUsage();
+	EXPECT_EQ(100, undoUsage.category("undo.entities.Line").count);
+	EXPECT_EQ(2, undoUsage.category("undo.operations").count);
+
+	undoManager->removeUndoables();
+	EXPECT_EQ(0, undoManager->memoryUsage().totalBytes());
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <cad/dochelpers/quadtree.h>
+#include <cad/primitive/line.h>
+
+namespace {
+	lc::QuadTree<lc::entity::CADEntity_CSPtr> createTree(int count) {
+		lc::QuadTree<lc::entity::CADEntity_CSPtr> tree(lc::geo::Area(lc::geo::Coordinate(-1000, -1000), lc::geo::Coordinate(1000, 1000)));
+		auto layer = std::make_shared<const lc::Layer>();
+
+		for(int i = 0; i < count; i++) {
+			tree.insert(std::make_shared<lc::entity::Line>(
+					lc::geo::Coordinate(i % 100 * 10, i / 100 * 10),
+					lc::geo::Coordinate(i % 100 * 10 + 5, i / 100 * 10 + 5),
+					layer
+			));
+		}
+
+		return tree;
+	}
+}
+
+TEST(QuadTreeTest, Retrieve) {
+	auto tree = createTree(1000);
+	EXPECT_EQ(1000, tree.size());
+
+	auto area = lc::geo::Area(lc::geo::Coordinate(0, 0), lc::geo::Coordinate(100, 100));
+
+	auto within = tree.retrieveFullWithin(area);
+	for(auto entity : within) {
+		EXPECT_TRUE(entity->boundingBox().inArea(area));
+	}
+	EXPECT_EQ(100, within.size());
+
+	auto overlapping = tree.retrieveOverlapping(area);
+	for(auto entity : overlapping) {
+		EXPECT_TRUE(entity->boundingBox().overlaps(area));
+	}
+	// Lines starting at x = 100 touch the area
+	EXPECT_EQ(110, overlapping.size());
+}
+
+TEST(QuadTreeTest, CopyAndErase) {
+	auto tree = createTree(1000);
+	auto copy = tree;
+
+	EXPECT_EQ(tree.size(), copy.size());
+
+	auto area = lc::geo::Area(lc::geo::Coordinate(0, 0), lc::geo::Coordinate(100, 100));
+	for(auto entity : copy.retrieveFullWithin(area)) {
+		EXPECT_TRUE(copy.erase(entity));
+	}
+
+	EXPECT_EQ(900, copy.size());
+	EXPECT_EQ(1000, tree.size());
+	EXPECT_EQ(0, copy.retrieveFullWithin(area).size());
+}
+
+TEST(QuadTreeTest, SplitLayout) {
+	auto tree = createTree(1000);
+	auto layout = tree.splitLayout();
+	EXPECT_GT(layout.size(), 1);
+
+	lc::QuadTree<lc::entity::CADEntity_CSPtr> restored(lc::geo::Area(lc::geo::Coordinate(-1000, -1000), lc::geo::Coordinate(1000, 1000)));
+	EXPECT_TRUE(restored.restoreSplitLayout(layout));
+	EXPECT_EQ(layout, restored.splitLayout());
+
+	for(auto entity : tree.retrieve()) {
+		restored.insert(entity);
+	}
+	EXPECT_EQ(layout, restored.splitLayout());
+	EXPECT_EQ(1000, restored.size());
+
+	lc::QuadTree<lc::entity::CADEntity_CSPtr> invalid;
+	EXPECT_FALSE(invalid.restoreSplitLayout({1, 0}));
+}
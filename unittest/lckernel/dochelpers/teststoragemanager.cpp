@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+
+#include <cad/dochelpers/documentimpl.h>
+#include <cad/dochelpers/storagemanagerimpl.h>
+#include <cad/primitive/line.h>
+#include <cad/operations/entitybuilder.h>
+#include <cad/operations/entityops.h>
+#include <cad/operations/layerops.h>
+#include <cad/primitive/insert.h>
+
+using namespace lc;
+
+namespace {
+	void expectArea(const geo::Area& expected, const geo::Area& actual) {
+		EXPECT_EQ(expected.minP(), actual.minP());
+		EXPECT_EQ(expected.maxP(), actual.maxP());
+	}
+
+	entity::Insert_CSPtr insertOf(const Document_SPtr& document, const Block_CSPtr& block, const geo::Coordinate& position, const Block_CSPtr& parent = nullptr) {
+		builder::InsertBuilder builder;
+		builder.setLayer(document->layerByName("0"));
+		builder.setDisplayBlock(block);
+		builder.setDocument(document);
+		builder.setCoordinate(position);
+		builder.setBlock(parent);
+		return builder.build();
+	}
+}
+
+TEST(StorageManagerTest, EntitiesByLayer) {
+	StorageManagerImpl storageManager;
+	auto layer1 = std::make_shared<const Layer>("1", Color(255, 255, 255));
+	auto layer2 = std::make_shared<const Layer>("2", Color(255, 255, 255));
+
+	std::vector<entity::Line_CSPtr> lines;
+	for(int i = 0; i < 100; i++) {
+		auto line = std::make_shared<entity::Line>(geo::Coordinate(i, 0), geo::Coordinate(i, 10), i % 4 == 0 ? layer1 : layer2);
+		lines.push_back(line);
+		storageManager.insertEntity(line);
+	}
+
+	EXPECT_EQ(25, storageManager.entitiesByLayer(layer1).size());
+	EXPECT_EQ(75, storageManager.entitiesByLayer(layer2).size());
+
+	storageManager.removeEntity(lines[0]);
+	EXPECT_EQ(24, storageManager.entitiesByLayer(layer1).size());
+
+	// Replace an entity by a version on a other layer with the same ID
+	auto moved = lines[4]->modify(layer2, nullptr, nullptr);
+	storageManager.removeEntity(moved);
+	storageManager.insertEntity(moved);
+	EXPECT_EQ(23, storageManager.entitiesByLayer(layer1).size());
+	EXPECT_EQ(76, storageManager.entitiesByLayer(layer2).size());
+	EXPECT_EQ(99, storageManager.entityContainer().size());
+
+	for(auto entity : storageManager.entitiesByLayer(layer1).asVector()) {
+		EXPECT_EQ(layer1, entity->layer());
+	}
+}
+
+TEST(StorageManagerTest, EntitiesByBlock) {
+	StorageManagerImpl storageManager;
+	auto layer = std::make_shared<const Layer>("0", Color(255, 255, 255));
+	auto block = std::make_shared<const Block>("Block", geo::Coordinate());
+
+	auto line = std::make_shared<entity::Line>(geo::Coordinate(0, 0), geo::Coordinate(10, 10), layer, nullptr, block);
+	storageManager.insertEntity(line);
+	EXPECT_EQ(1, storageManager.entitiesByBlock(block).size());
+	EXPECT_EQ(0, storageManager.entitiesByLayer(layer).size());
+
+	storageManager.removeEntity(line);
+	EXPECT_EQ(0, storageManager.entitiesByBlock(block).size());
+}
+
+TEST(StorageManagerTest, RemoveLayer) {
+	auto document = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+	auto layer = std::make_shared<const Layer>("1", Color(255, 255, 255));
+	document->addDocumentMetaType(layer);
+
+	for(int i = 0; i < 10; i++) {
+		document->insertEntity(std::make_shared<entity::Line>(geo::Coordinate(i, 0), geo::Coordinate(i, 10), layer));
+	}
+	EXPECT_EQ(10, document->entitiesByLayer(layer).size());
+
+	auto op = std::make_shared<operation::RemoveLayer>(document, layer);
+	op->execute();
+	EXPECT_EQ(0, document->entitiesByLayer(layer).size());
+	EXPECT_EQ(0, document->entityContainer().size());
+
+	op->undo();
+	EXPECT_EQ(10, document->entitiesByLayer(layer).size());
+}
+
+TEST(StorageManagerTest, ReplaceLayer) {
+	auto document = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+	auto oldLayer = std::make_shared<const Layer>("1", Color(255, 255, 255));
+	auto newLayer = std::make_shared<const Layer>("1", Color(255, 0, 0));
+	document->addDocumentMetaType(oldLayer);
+
+	for(int i = 0; i < 10; i++) {
+		document->insertEntity(std::make_shared<entity::Line>(geo::Coordinate(i, 0), geo::Coordinate(i, 10), oldLayer));
+	}
+
+	// The operation reads the layer index while the document is locked
+	auto op = std::make_shared<operation::ReplaceLayer>(document, oldLayer, newLayer);
+	op->execute();
+	EXPECT_EQ(0, document->entitiesByLayer(oldLayer).size());
+	EXPECT_EQ(10, document->entitiesByLayer(newLayer).size());
+	EXPECT_EQ(10, document->entityContainer().size());
+}
+
+TEST(StorageManagerTest, BlockExtents) {
+	StorageManagerImpl storageManager;
+	auto layer = std::make_shared<const Layer>("0", Color(255, 255, 255));
+	auto block = std::make_shared<const Block>("Block", geo::Coordinate(1, 1));
+
+	expectArea(geo::Area(geo::Coordinate(1, 1), geo::Coordinate(1, 1)), storageManager.blockExtents(block));
+
+	auto line1 = std::make_shared<entity::Line>(geo::Coordinate(0, 0), geo::Coordinate(10, 10), layer, nullptr, block);
+	auto line2 = std::make_shared<entity::Line>(geo::Coordinate(2, 2), geo::Coordinate(3, 3), layer, nullptr, block);
+	auto line3 = std::make_shared<entity::Line>(geo::Coordinate(-5, 4), geo::Coordinate(5, 4), layer, nullptr, block);
+	storageManager.insertEntity(line1);
+	storageManager.insertEntity(line2);
+	expectArea(geo::Area(geo::Coordinate(0, 0), geo::Coordinate(10, 10)), storageManager.blockExtents(block));
+
+	storageManager.insertEntity(line3);
+	expectArea(geo::Area(geo::Coordinate(-5, 0), geo::Coordinate(10, 10)), storageManager.blockExtents(block));
+
+	storageManager.removeEntity(line2);
+	expectArea(geo::Area(geo::Coordinate(-5, 0), geo::Coordinate(10, 10)), storageManager.blockExtents(block));
+
+	storageManager.removeEntity(line1);
+	expectArea(geo::Area(geo::Coordinate(-5, 4), geo::Coordinate(5, 4)), storageManager.blockExtents(block));
+}
+
+TEST(StorageManagerTest, BlockExtentsReplacedEntity) {
+	StorageManagerImpl storageManager;
+	auto layer = std::make_shared<const Layer>("0", Color(255, 255, 255));
+	auto block = std::make_shared<const Block>("Block", geo::Coordinate(1, 1));
+
+	auto line1 = std::make_shared<entity::Line>(geo::Coordinate(0, 0), geo::Coordinate(10, 10), layer, nullptr, block);
+	auto line2 = std::make_shared<entity::Line>(geo::Coordinate(2, 2), geo::Coordinate(3, 3), layer, nullptr, block);
+	storageManager.insertEntity(line1);
+	storageManager.insertEntity(line2);
+	expectArea(geo::Area(geo::Coordinate(0, 0), geo::Coordinate(10, 10)), storageManager.blockExtents(block));
+
+	// The new version is inside the extents, the stored one is on their border
+	auto moved = std::make_shared<entity::Line>(geo::Coordinate(4, 4), geo::Coordinate(5, 5), layer, nullptr, block);
+	moved->setID(line1->id());
+	storageManager.removeEntity(moved);
+	storageManager.insertEntity(moved);
+	expectArea(geo::Area(geo::Coordinate(2, 2), geo::Coordinate(5, 5)), storageManager.blockExtents(block));
+	EXPECT_EQ(2, storageManager.entitiesByBlock(block).size());
+}
+
+TEST(StorageManagerTest, InsertBoundingBox) {
+	auto document = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+	auto layer = document->layerByName("0");
+	auto block = std::make_shared<const Block>("Block", geo::Coordinate(1, 1));
+
+	auto insert = insertOf(document, block, geo::Coordinate(11, 21));
+	expectArea(geo::Area(geo::Coordinate(11, 21), geo::Coordinate(11, 21)), insert->boundingBox());
+
+	auto builder = std::make_shared<operation::EntityBuilder>(document);
+	builder->appendEntity(insert);
+	builder->execute();
+
+	// The inserts are updated when the operation is committed
+	builder = std::make_shared<operation::EntityBuilder>(document);
+	builder->appendEntity(std::make_shared<entity::Line>(geo::Coordinate(0, 0), geo::Coordinate(10, 10), layer, nullptr, block));
+	builder->execute();
+	expectArea(geo::Area(geo::Coordinate(10, 20), geo::Coordinate(20, 30)), insert->boundingBox());
+
+	auto moved = insert->move(geo::Coordinate(5, 5));
+	expectArea(geo::Area(geo::Coordinate(15, 25), geo::Coordinate(25, 35)), moved->boundingBox());
+}
+
+TEST(StorageManagerTest, NestedInsertBoundingBox) {
+	auto document = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+	auto layer = document->layerByName("0");
+	auto inner = std::make_shared<const Block>("Inner", geo::Coordinate(0, 0));
+	auto outer = std::make_shared<const Block>("Outer", geo::Coordinate(0, 0));
+
+	// Outer contains a insert of Inner at (100, 0), the document a insert of Outer at (0, 100)
+	auto nested = insertOf(document, inner, geo::Coordinate(100, 0), outer);
+	auto insert = insertOf(document, outer, geo::Coordinate(0, 100));
+
+	auto builder = std::make_shared<operation::EntityBuilder>(document);
+	builder->appendEntity(nested);
+	builder->appendEntity(insert);
+	builder->appendEntity(std::make_shared<entity::Line>(geo::Coordinate(0, 0), geo::Coordinate(1, 1), layer, nullptr, inner));
+	builder->execute();
+
+	expectArea(geo::Area(geo::Coordinate(100, 0), geo::Coordinate(101, 1)), nested->boundingBox());
+	expectArea(geo::Area(geo::Coordinate(100, 0), geo::Coordinate(101, 1)), document->blockExtents(outer));
+	expectArea(geo::Area(geo::Coordinate(100, 100), geo::Coordinate(101, 101)), insert->boundingBox());
+}
+
+TEST(StorageManagerTest, InsertIndexedAfterBlockChange) {
+	auto document = std::make_shared<DocumentImpl>(std::make_shared<StorageManagerImpl>());
+	auto layer = document->layerByName("0");
+	auto block = std::make_shared<const Block>("Block", geo::Coordinate(0, 0));
+
+	// Enough entities far away to split the quad tree
+	auto builder = std::make_shared<operation::EntityBuilder>(document);
+	for (int i = 0; i < 200; i++) {
+		builder->appendEntity(std::make_shared<entity::Line>(geo::Coordinate(-1000 + i, -1000), geo::Coordinate(-1000 + i, -999), layer));
+	}
+	builder->appendEntity(std::make_shared<entity::Line>(geo::Coordinate(1000, 1000), geo::Coordinate(1001, 1001), layer));
+	auto insert = insertOf(document, block, geo::Coordinate(500, 500));
+	builder->appendEntity(insert);
+	builder->execute();
+
+	builder = std::make_shared<operation::EntityBuilder>(document);
+	builder->appendEntity(std::make_shared<entity::Line>(geo::Coordinate(0, 0), geo::Coordinate(100, 100), layer, nullptr, block));
+	builder->execute();
+
+	auto found = document->spatialIndex().entitiesOverlapping(geo::Area(geo::Coordinate(590, 590), geo::Coordinate(595, 595)));
+	ASSERT_EQ(1, found.size());
+	EXPECT_EQ(insert->id(), found[0]->id());
+
+	// Removing it finds it at its new place
+	builder = std::make_shared<operation::EntityBuilder>(document);
+	builder->appendEntity(insert);
+	builder->appendOperation(std::make_shared<operation::Push>());
+	builder->appendOperation(std::make_shared<operation::Remove>());
+	builder->execute();
+	EXPECT_EQ(nullptr, document->entityContainer().entityByID(insert->id()));
+	EXPECT_EQ(201, document->entityContainer().asVector().size());
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include "cad/math/transform2d.h"
+#include "cad/primitive/lwpolyline.h"
+
+namespace {
+    std::vector<lc::geo::Coordinate> testPoints() {
+        std::vector<lc::geo::Coordinate> points;
+
+        // Odd number of points to test the tail of the batch kernel
+        for(int i = 0; i < 101; i++) {
+            points.emplace_back(i * 1.5 - 20., i * -0.75 + 3., i);
+        }
+
+        return points;
+    }
+
+    void expectNear(const lc::geo::Coordinate& expected, const lc::geo::Coordinate& actual) {
+        EXPECT_NEAR(expected.x(), actual.x(), 1e-9);
+        EXPECT_NEAR(expected.y(), actual.y(), 1e-9);
+    }
+}
+
+TEST(Transform2D, Rotate) {
+    auto points = testPoints();
+    auto center = lc::geo::Coordinate(10., -5.);
+    auto result = lc::geo::Transform2D::rotation(center, 0.7).apply(points);
+
+    ASSERT_EQ(points.size(), result.size());
+    for(size_t i = 0; i < points.size(); i++) {
+        expectNear(points[i].rotate(center, 0.7), result[i]);
+        EXPECT_EQ(points[i].z(), result[i].z());
+    }
+}
+
+TEST(Transform2D, Scale) {
+    auto points = testPoints();
+    auto center = lc::geo::Coordinate(3., 4.);
+    auto factor = lc::geo::Coordinate(2., 0.5);
+    auto result = lc::geo::Transform2D::scale(center, factor).apply(points);
+
+    for(size_t i = 0; i < points.size(); i++) {
+        expectNear(points[i].scale(center, factor), result[i]);
+    }
+}
+
+TEST(Transform2D, Mirror) {
+    auto points = testPoints();
+    auto axis1 = lc::geo::Coordinate(1., 2.);
+    auto axis2 = lc::geo::Coordinate(4., -3.);
+    auto result = lc::geo::Transform2D::mirror(axis1, axis2).apply(points);
+
+    for(size_t i = 0; i < points.size(); i++) {
+        expectNear(points[i].mirror(axis1, axis2), result[i]);
+    }
+}
+
+TEST(Transform2D, Combine) {
+    auto points = testPoints();
+    auto offset = lc::geo::Coordinate(7., 8.);
+    auto center = lc::geo::Coordinate(-1., 2.);
+    auto combined = lc::geo::Transform2D::translation(offset) * lc::geo::Transform2D::rotation(center, 1.2);
+
+    for(size_t i = 0; i < points.size(); i++) {
+        expectNear(points[i].rotate(center, 1.2) + offset, combined.apply(points[i]));
+    }
+}
+
+TEST(Transform2D, LWPolylineMirror) {
+    std::vector<lc::entity::LWVertex2D> vertex;
+    vertex.emplace_back(lc::geo::Coordinate(0., 0.), 0.5);
+    vertex.emplace_back(lc::geo::Coordinate(10., 0.));
+
+    auto polyline = std::make_shared<lc::entity::LWPolyline>(vertex, 0., 0., 0., false, lc::geo::Coordinate(0., 0., 1.),
+                                                             std::make_shared<const lc::Layer>());
+    auto mirrored = std::static_pointer_cast<const lc::entity::LWPolyline>(
+            polyline->mirror(lc::geo::Coordinate(0., 1.), lc::geo::Coordinate(1., 1.)));
+
+    ASSERT_EQ(2, mirrored->vertex().size());
+    expectNear(lc::geo::Coordinate(0., 2.), mirrored->vertex()[0].location());
+    EXPECT_EQ(-0.5, mirrored->vertex()[0].bulge());
+    EXPECT_EQ(polyline->id(), mirrored->id());
+}
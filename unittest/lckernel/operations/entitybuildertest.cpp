@@ -3,6 +3,7 @@
 #include <cad/dochelpers/storagemanagerimpl.h>
 #include <cad/operations/entitybuilder.h>
 #include <cad/primitive/line.h>
+#include <cad/primitive/circle.h>
 
 TEST(EntityBuilderTest, Append) {
 	auto storageManager = std::make_shared<lc::StorageManagerImpl>();
@@ -203,6 +204,55 @@ TEST(EntityBuilderTest, Rotate) {
 	EXPECT_EQ(manualOperation->end(), builderOperation->end());
 }
 
+TEST(EntityBuilderTest, RotateMany) {
+	auto storageManager = std::make_shared<lc::StorageManagerImpl>();
+	auto document = std::make_shared<lc::DocumentImpl>(storageManager);
+	auto layer = std::make_shared<const lc::Layer>();
+	auto center = lc::geo::Coordinate(10, 20);
+	const double angle = 0.3;
+
+	std::vector<lc::entity::CADEntity_CSPtr> entities;
+	for(int i = 0; i < 3000; i++) {
+		if(i % 3 == 0) {
+			entities.push_back(std::make_shared<lc::entity::Circle>(lc::geo::Coordinate(i, -i), 5, layer));
+		}
+		else {
+			entities.push_back(std::make_shared<lc::entity::Line>(
+					lc::geo::Coordinate(i, 0),
+					lc::geo::Coordinate(0, i),
+					layer
+			));
+		}
+	}
+
+	std::vector<lc::entity::CADEntity_CSPtr> workingBuffer;
+	std::vector<lc::entity::CADEntity_CSPtr> removals;
+
+	auto rotated = lc::operation::Rotate(center, angle).process(document, entities, workingBuffer, removals, {});
+	ASSERT_EQ(entities.size(), rotated.size());
+
+	for(size_t i = 0; i < entities.size(); i++) {
+		const auto& entity = entities[i];
+		EXPECT_EQ(entity->id(), rotated[i]->id()) << "Rotate should keep the same ID";
+
+		auto manualOperation = entity->rotate(center, angle);
+		EXPECT_EQ(manualOperation->kind(), rotated[i]->kind());
+
+		if(entity->kind() == lc::entity::EntityKind::Line) {
+			auto manualLine = std::static_pointer_cast<const lc::entity::Line>(manualOperation);
+			auto builderLine = std::static_pointer_cast<const lc::entity::Line>(rotated[i]);
+			EXPECT_EQ(manualLine->start(), builderLine->start());
+			EXPECT_EQ(manualLine->end(), builderLine->end());
+		}
+		else {
+			auto manualCircle = std::static_pointer_cast<const lc::entity::Circle>(manualOperation);
+			auto builderCircle = std::static_pointer_cast<const lc::entity::Circle>(rotated[i]);
+			EXPECT_EQ(manualCircle->center(), builderCircle->center());
+			EXPECT_EQ(manualCircle->radius(), builderCircle->radius());
+		}
+	}
+}
+
 TEST(EntityBuilderTest, Scale) {
 	auto storageManager = std::make_shared<lc::StorageManagerImpl>();
 	auto document = std::make_shared<lc::DocumentImpl>(storageManager);
@@ -315,4 +365,77 @@ TEST(EntityBuilderTest, SelectByLayer) {
 
 	EXPECT_TRUE((firstEntity_isExpected1 && secondEntity_isExpected2) ||
 				(firstEntity_isExpected2 && secondEntity_isExpected1));
-}
\ No newline at end of file
+}
+
+TEST(EntityBuilderTest, LargeSelectionOrder) {
+	auto storageManager = std::make_shared<lc::StorageManagerImpl>();
+	auto document = std::make_shared<lc::DocumentImpl>(storageManager);
+	auto layer = std::make_shared<const lc::Layer>();
+
+	std::vector<lc::entity::CADEntity_CSPtr> entities;
+	for(int i = 0; i < 10000; i++) {
+		entities.push_back(std::make_shared<lc::entity::Line>(
+				lc::geo::Coordinate(i, 0),
+				lc::geo::Coordinate(i, 10),
+				layer
+		));
+	}
+
+	std::vector<lc::entity::CADEntity_CSPtr> workingBuffer;
+	std::vector<lc::entity::CADEntity_CSPtr> removals;
+	auto offset = lc::geo::Coordinate(0, 100);
+
+	auto moved = lc::operation::Move(offset).process(document, entities, workingBuffer, removals, {});
+	ASSERT_EQ(entities.size(), moved.size());
+
+	for(size_t i = 0; i < entities.size(); i++) {
+		auto line = std::static_pointer_cast<const lc::entity::Line>(moved[i]);
+		EXPECT_EQ(entities[i]->id(), line->id()) << "Move should keep the same ID";
+		EXPECT_EQ(lc::geo::Coordinate(i, 100), line->start()) << "Entities are not in the same order";
+	}
+
+	auto copied = lc::operation::Copy(offset).process(document, entities, workingBuffer, removals, {});
+	ASSERT_EQ(entities.size(), copied.size());
+	ASSERT_EQ(entities.size(), workingBuffer.size());
+
+	for(size_t i = 0; i < entities.size(); i++) {
+		auto line = std::static_pointer_cast<const lc::entity::Line>(copied[i]);
+		EXPECT_NE(entities[i]->id(), line->id()) << "Copy should create a new ID";
+		EXPECT_EQ(entities[i], workingBuffer[i]);
+		EXPECT_EQ(lc::geo::Coordinate(i, 100), line->start()) << "Entities are not in the same order";
+	}
+}
+
+TEST(EntityBuilderTest, AppendBulk) {
+	auto document = std::make_shared<lc::DocumentImpl>(std::make_shared<lc::StorageManagerImpl>());
+	auto layer = document->layerByName("0");
+	auto builder = std::make_shared<lc::operation::EntityBuilder>(document);
+
+	builder->appendLines({0, 0, 10, 0, 10, 0, 10, 10}, layer);
+	builder->appendCircles({5, 5, 2}, layer);
+	builder->appendArcs({0, 0, 5, 0, 1.5, 20, 20, 1, 1, 2}, true, layer);
+	builder->execute();
+
+	auto entities = document->entityContainer().asVector();
+	ASSERT_EQ(5, entities.size());
+
+	size_t lines = 0;
+	for(const auto& entity : entities) {
+		EXPECT_EQ(layer, entity->layer());
+
+		if(entity->kind() == lc::entity::EntityKind::Line) {
+			lines++;
+		}
+	}
+	EXPECT_EQ(2, lines);
+
+	auto line = std::dynamic_pointer_cast<const lc::entity::Line>(document->entityContainer().entitiesFullWithinArea(
+			lc::geo::Area(lc::geo::Coordinate(-1, -1), lc::geo::Coordinate(11, 1))).asVector().at(0));
+	ASSERT_NE(nullptr, line);
+	EXPECT_EQ(lc::geo::Coordinate(0, 0), line->start());
+	EXPECT_EQ(lc::geo::Coordinate(10, 0), line->end());
+
+	EXPECT_THROW(builder->appendLines({0, 0, 10}, layer), std::runtime_error);
+	EXPECT_THROW(builder->appendCircles({0, 0}, layer), std::runtime_error);
+	EXPECT_THROW(builder->appendArcs({0, 0, 1, 0}, true, layer), std::runtime_error);
+}
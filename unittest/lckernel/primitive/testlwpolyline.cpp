@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include <cad/primitive/arc.h>
+#include <cad/primitive/line.h>
+#include <cad/primitive/lwpolyline.h>
+
+using namespace lc;
+using namespace entity;
+
+namespace {
+	LWPolyline_CSPtr zigzag(unsigned int vertices) {
+		std::vector<LWVertex2D> vertex;
+		for(unsigned int i = 0; i < vertices; i++) {
+			// Every fourth segment is a half circle
+			vertex.emplace_back(geo::Coordinate(i * 10., (i % 2) * 10.), i % 4 == 3 ? 1. : 0.);
+		}
+
+		return std::make_shared<LWPolyline>(vertex, 0., 0., 0., false, geo::Coordinate(0., 0., 1.), std::make_shared<const Layer>());
+	}
+}
+
+TEST(lc__entity__LWPolylineTest, nearestPointOnPath) {
+	auto polyline = zigzag(1000);
+	ASSERT_EQ(999, polyline->asEntities().size());
+
+	// Compare with a search through all segments
+	for(double x = -20.; x < 10020.; x += 7.3) {
+		geo::Coordinate coord(x, 7.);
+
+		double expected = std::numeric_limits<double>::max();
+		for(const auto& entity : polyline->asEntities()) {
+			geo::Coordinate npoe;
+			if(entity->kind() == EntityKind::Arc) {
+				npoe = std::static_pointer_cast<const Arc>(entity)->nearestPointOnEntity(coord);
+			}
+			else {
+				npoe = std::static_pointer_cast<const Line>(entity)->nearestPointOnEntity(coord);
+			}
+			expected = std::min(expected, npoe.distanceTo(coord));
+		}
+
+		auto info = polyline->nearestPointOnPath2(coord);
+		EXPECT_NEAR(expected, std::get<0>(info).distanceTo(coord), 1e-9);
+		EXPECT_TRUE((std::get<1>(info) == nullptr) != (std::get<2>(info) == nullptr));
+	}
+}
+
+TEST(lc__entity__LWPolylineTest, nearestPointOnSegment) {
+	std::vector<LWVertex2D> vertex = {
+		LWVertex2D(geo::Coordinate(0., 0.)),
+		LWVertex2D(geo::Coordinate(10., 0.)),
+		LWVertex2D(geo::Coordinate(10., 1.))
+	};
+	auto polyline = std::make_shared<LWPolyline>(vertex, 0., 0., 0., false, geo::Coordinate(0., 0., 1.), std::make_shared<const Layer>());
+
+	// The extension of the second segment is closer, but not part of the polyline
+	auto npoe = polyline->nearestPointOnPath(geo::Coordinate(9., 20.));
+	EXPECT_EQ(geo::Coordinate(10., 1.), npoe);
+
+	auto copy = std::make_shared<LWPolyline>(polyline, true);
+	EXPECT_EQ(polyline->asEntities(), copy->asEntities());
+	EXPECT_EQ(polyline->boundingBox(), copy->boundingBox());
+}
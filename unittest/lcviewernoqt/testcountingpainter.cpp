@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include "documentcanvas.h"
+#include <cad/dochelpers/documentimpl.h>
+#include <cad/dochelpers/storagemanagerimpl.h>
+#include <cad/operations/entitybuilder.h>
+#include <cad/primitive/circle.h>
+#include <cad/primitive/line.h>
+#include <painters/lccountingpainter.h>
+
+using namespace LCViewer;
+
+TEST(CountingPainterTest, Transformations) {
+	LcCountingPainter painter;
+	painter.scale(2.);
+	painter.translate(10, 5);
+
+	double x = 1.;
+	double y = 1.;
+	painter.user_to_device(&x, &y);
+	EXPECT_EQ(22., x);
+	EXPECT_EQ(8., y);
+
+	painter.device_to_user(&x, &y);
+	EXPECT_EQ(1., x);
+	EXPECT_EQ(1., y);
+
+	painter.save();
+	painter.reset_transformations();
+	EXPECT_EQ(1., painter.scale());
+	painter.restore();
+	EXPECT_EQ(2., painter.scale());
+
+	EXPECT_EQ(3, painter.statistics().transformations);
+	EXPECT_EQ(1, painter.statistics().saves);
+	EXPECT_EQ(1, painter.statistics().restores);
+}
+
+TEST(CountingPainterTest, Render) {
+	auto document = std::make_shared<lc::DocumentImpl>(std::make_shared<lc::StorageManagerImpl>());
+	auto canvas = std::make_shared<DocumentCanvas>(document);
+	auto layer = document->layerByName("0");
+
+	auto builder = std::make_shared<lc::operation::EntityBuilder>(document);
+	for(int i = 0; i < 10; i++) {
+		builder->appendEntity(std::make_shared<lc::entity::Line>(lc::geo::Coordinate(i, 0), lc::geo::Coordinate(i, 10), layer));
+	}
+	builder->appendEntity(std::make_shared<lc::entity::Circle>(lc::geo::Coordinate(5, 5), 2, layer));
+	// Outside of the visible area
+	builder->appendEntity(std::make_shared<lc::entity::Line>(lc::geo::Coordinate(1000, 1000), lc::geo::Coordinate(1010, 1000), layer));
+	builder->execute();
+
+	LcCountingPainter* painter = nullptr;
+	canvas->createPainterFunctor([&](const unsigned int, const unsigned int) {
+		if(painter == nullptr) {
+			painter = new LcCountingPainter();
+		}
+		return painter;
+	});
+	canvas->deletePainterFunctor([&](LcPainter* p) {
+		if(p != nullptr && painter != nullptr) {
+			delete p;
+			painter = nullptr;
+		}
+	});
+
+	canvas->newDeviceSize(100, 100);
+	canvas->render([](LcPainter&) {}, [](LcPainter&) {});
+	ASSERT_NE(nullptr, painter);
+
+	canvas->setDisplayArea(lc::geo::Area(lc::geo::Coordinate(-10, -10), lc::geo::Coordinate(20, 20)));
+	painter->resetStatistics();
+
+	unsigned int phases = 0;
+	canvas->render([&](LcPainter&) { phases++; }, [](LcPainter&) {});
+
+	const auto& statistics = painter->statistics();
+	EXPECT_EQ(3, phases);
+	EXPECT_EQ(11, statistics.strokes);
+	EXPECT_EQ(21, statistics.segments);
+	EXPECT_EQ(0, statistics.fills);
+	EXPECT_EQ(statistics.saves, statistics.restores);
+	EXPECT_LE(11, statistics.stateChanges);
+
+	canvas->removePainters();
+}
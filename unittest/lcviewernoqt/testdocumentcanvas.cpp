@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include "documentcanvas.h"
+#include <cad/dochelpers/documentimpl.h>
+#include <cad/dochelpers/storagemanagerimpl.h>
+
+#include <cad/operations/entitybuilder.h>
+#include <cad/primitive/arc.h>
+#include <cad/primitive/circle.h>
+#include <cad/primitive/line.h>
+#include "drawitems/lcvarc.h"
+#include "drawitems/lcvcircle.h"
+#include "drawitems/lcvdrawitem.h"
+#include "drawitems/lcvline.h"
+
+TEST(DocumentCanvasTest, SharedSpatialIndex) {
+	auto storageManager = std::make_shared<lc::StorageManagerImpl>();
+	auto document = std::make_shared<lc::DocumentImpl>(storageManager);
+	auto docCanvas = std::make_shared<LCViewer::DocumentCanvas>(document);
+	auto layer = document->layerByName("0");
+
+	auto line = std::make_shared<lc::entity::Line>(lc::geo::Coordinate(0, 0), lc::geo::Coordinate(10, 10), layer);
+	auto builder = std::make_shared<lc::operation::EntityBuilder>(document);
+	builder->appendEntity(line);
+	builder->execute();
+
+	EXPECT_EQ(&document->spatialIndex(), &docCanvas->entityContainer());
+
+	auto drawItem = docCanvas->drawItem(line->id());
+	ASSERT_NE(nullptr, drawItem);
+	EXPECT_EQ(line, drawItem->entity());
+
+	// Replacing the entity replaces its draw item
+	auto moved = line->move(lc::geo::Coordinate(5, 5));
+	builder = std::make_shared<lc::operation::EntityBuilder>(document);
+	builder->appendEntity(moved);
+	builder->execute();
+
+	ASSERT_NE(nullptr, docCanvas->drawItem(line->id()));
+	EXPECT_EQ(moved, docCanvas->drawItem(line->id())->entity());
+	EXPECT_EQ(1, docCanvas->drawItems(docCanvas->entityContainer()).asVector().size());
+
+	builder = std::make_shared<lc::operation::EntityBuilder>(document);
+	builder->appendEntity(moved);
+	builder->appendOperation(std::make_shared<lc::operation::Push>());
+	builder->appendOperation(std::make_shared<lc::operation::Remove>());
+	builder->execute();
+
+	EXPECT_EQ(nullptr, docCanvas->drawItem(line->id()));
+	EXPECT_EQ(0, docCanvas->entityContainer().size());
+}
+
+TEST(DocumentCanvasTest, DrawableByKind) {
+	auto document = std::make_shared<lc::DocumentImpl>(std::make_shared<lc::StorageManagerImpl>());
+	auto layer = document->layerByName("0");
+
+	auto line = std::make_shared<lc::entity::Line>(lc::geo::Coordinate(0, 0), lc::geo::Coordinate(10, 10), layer);
+	auto circle = std::make_shared<lc::entity::Circle>(lc::geo::Coordinate(0, 0), 5, layer);
+	auto arc = std::make_shared<lc::entity::Arc>(lc::geo::Coordinate(0, 0), 5, 0, 1, true, layer);
+
+	EXPECT_EQ(lc::entity::EntityKind::Line, line->kind());
+	EXPECT_EQ(lc::entity::EntityKind::Circle, circle->kind());
+	EXPECT_EQ(lc::entity::EntityKind::Arc, arc->kind());
+
+	auto drawLine = LCViewer::DocumentCanvas::asDrawable(line);
+	EXPECT_NE(nullptr, std::dynamic_pointer_cast<LCViewer::LCVLine>(drawLine));
+	EXPECT_EQ(line, drawLine->entity());
+	EXPECT_EQ(lc::entity::EntityKind::Line, drawLine->kind());
+
+	EXPECT_NE(nullptr, std::dynamic_pointer_cast<LCViewer::LCVCircle>(LCViewer::DocumentCanvas::asDrawable(circle)));
+	EXPECT_NE(nullptr, std::dynamic_pointer_cast<LCViewer::LCVArc>(LCViewer::DocumentCanvas::asDrawable(arc)));
+}
+
+TEST(DocumentCanvasTest, MemoryUsage) {
+	auto document = std::make_shared<lc::DocumentImpl>(std::make_shared<lc::StorageManagerImpl>());
+	auto docCanvas = std::make_shared<LCViewer::DocumentCanvas>(document);
+	auto layer = document->layerByName("0");
+
+	auto builder = std::make_shared<lc::operation::EntityBuilder>(document);
+	for(int i = 0; i < 10; i++) {
+		builder->appendEntity(std::make_shared<lc::entity::Line>(lc::geo::Coordinate(i, 0), lc::geo::Coordinate(i, 10), layer));
+	}
+	builder->execute();
+
+	lc::MemoryUsage usage;
+	docCanvas->memoryUsage(usage);
+
+	auto drawItems = usage.category("canvas.drawItems");
+	EXPECT_EQ(10, drawItems.count);
+	EXPECT_LE(10 * sizeof(LCViewer::LCVLine), drawItems.bytes);
+	EXPECT_EQ(0, usage.category("canvas.painters").count);
+}
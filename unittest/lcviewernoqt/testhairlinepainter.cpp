@@ -0,0 +1,236 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <painters/lchairlinepainter.h>
+#include <painters/lcrecordingpainter.h>
+
+using namespace LCViewer;
+
+namespace {
+	const unsigned int SIZE = 40;
+
+	/**
+	 * Hairline painter drawing in its own buffer, the fallback painter only records the calls
+	 */
+	class TestPainter {
+		public:
+			TestPainter() :
+				image(SIZE * SIZE, 0),
+				painter(new LcRecordingPainter(), reinterpret_cast<unsigned char*>(image.data()), SIZE, SIZE, SIZE * 4) {
+			}
+
+			uint32_t pixel(unsigned int x, unsigned int y) const {
+				return image[y * SIZE + x];
+			}
+
+			double alpha(unsigned int x, unsigned int y) const {
+				return (pixel(x, y) >> 24) / 255.;
+			}
+
+			double totalAlpha() const {
+				double total = 0;
+				for(unsigned int y = 0; y < SIZE; y++) {
+					for(unsigned int x = 0; x < SIZE; x++) {
+						total += alpha(x, y);
+					}
+				}
+				return total;
+			}
+
+			std::vector<uint32_t> image;
+			LcHairlinePainter painter;
+	};
+}
+
+TEST(HairlinePainterTest, HorizontalLine) {
+	TestPainter test;
+	test.painter.source_rgb(1., 0., 0.);
+	test.painter.line_width(1.);
+
+	// Device y is the opposite of user y
+	test.painter.move_to(10, -10.5);
+	test.painter.line_to(30, -10.5);
+	test.painter.stroke();
+
+	EXPECT_EQ(1, test.painter.hairlineStrokes());
+	EXPECT_EQ(0, test.painter.fallbackStrokes());
+
+	EXPECT_EQ(0xFFFF0000, test.pixel(10, 10));
+	EXPECT_EQ(0xFFFF0000, test.pixel(29, 10));
+	EXPECT_EQ(0, test.pixel(9, 10));
+	EXPECT_EQ(0, test.pixel(30, 10));
+	EXPECT_EQ(0, test.pixel(20, 9));
+	EXPECT_EQ(0, test.pixel(20, 11));
+}
+
+TEST(HairlinePainterTest, Coverage) {
+	TestPainter test;
+	test.painter.source_rgb(1., 1., 1.);
+	test.painter.line_width(1.);
+
+	test.painter.move_to(5, -5);
+	test.painter.line_to(35, -25);
+	test.painter.stroke();
+
+	// Butt caps, the area of the line is its length
+	EXPECT_NEAR(std::hypot(30, 20), test.totalAlpha(), 0.5);
+
+	TestPainter circle;
+	circle.painter.source_rgb(1., 1., 1.);
+	circle.painter.line_width(1.);
+	circle.painter.circle(20, -20, 10);
+	circle.painter.stroke();
+
+	// The ends of two segments are blended over each other, the joints are a bit lighter
+	EXPECT_NEAR(2. * M_PI * 10, circle.totalAlpha(), 4.);
+	EXPECT_EQ(0, circle.pixel(20, 20));
+}
+
+TEST(HairlinePainterTest, Transformation) {
+	TestPainter test;
+	test.painter.scale(2.);
+	test.painter.source_rgb(1., 1., 1.);
+	// Line width doesn't change with the scale
+	test.painter.line_width(1.);
+
+	test.painter.move_to(5, -5);
+	test.painter.line_to(15, -5);
+	test.painter.stroke();
+
+	// The line is centered on y = 10, it covers half of two rows
+	EXPECT_EQ(1, test.painter.hairlineStrokes());
+	EXPECT_NEAR(0.5, test.alpha(20, 9), 0.01);
+	EXPECT_NEAR(0.5, test.alpha(20, 10), 0.01);
+	EXPECT_EQ(0, test.pixel(5, 9));
+	EXPECT_NEAR(20, test.totalAlpha(), 0.5);
+}
+
+TEST(HairlinePainterTest, Antialias) {
+	TestPainter test;
+	test.painter.disable_antialias();
+	test.painter.source_rgb(1., 1., 1.);
+	test.painter.line_width(1.);
+
+	test.painter.move_to(5, -5);
+	test.painter.line_to(35, -25);
+	test.painter.stroke();
+
+	for(unsigned int y = 0; y < SIZE; y++) {
+		for(unsigned int x = 0; x < SIZE; x++) {
+			EXPECT_TRUE(test.pixel(x, y) == 0 || test.pixel(x, y) == 0xFFFFFFFF);
+		}
+	}
+	// A pixel is drawn in each column, two when the line is 1.2 pixel high around their center
+	EXPECT_LE(30, test.totalAlpha());
+	EXPECT_GE(60, test.totalAlpha());
+}
+
+TEST(HairlinePainterTest, Fallback) {
+	TestPainter test;
+	test.painter.source_rgb(1., 1., 1.);
+
+	test.painter.line_width(3.);
+	test.painter.move_to(5, -5);
+	test.painter.line_to(35, -25);
+	test.painter.stroke();
+	EXPECT_EQ(1, test.painter.fallbackStrokes());
+
+	double dashes[] = {2., 2.};
+	test.painter.line_width(1.);
+	test.painter.set_dash(dashes, 2, 0, false);
+	test.painter.move_to(5, -5);
+	test.painter.line_to(35, -25);
+	test.painter.stroke();
+	EXPECT_EQ(2, test.painter.fallbackStrokes());
+
+	// The dash is restored
+	test.painter.save();
+	test.painter.set_dash(dashes, 0, 0, false);
+	test.painter.restore();
+	test.painter.rectangle(5, -5, 10, -10);
+	test.painter.stroke();
+	EXPECT_EQ(3, test.painter.fallbackStrokes());
+
+	test.painter.set_dash(dashes, 0, 0, false);
+	test.painter.rectangle(5, -5, 10, -10);
+	test.painter.fill();
+	EXPECT_EQ(3, test.painter.fallbackStrokes());
+	EXPECT_EQ(0, test.painter.hairlineStrokes());
+	EXPECT_EQ(0, test.totalAlpha());
+}
+
+TEST(HairlinePainterTest, FarOutside) {
+	TestPainter test;
+	test.painter.source_rgb(1., 1., 1.);
+	test.painter.line_width(1.);
+
+	// Segments before the buffer along both axes, their pixel range is clamped before converting to int
+	test.painter.move_to(-1e12, 1e11);
+	test.painter.line_to(-1e11, 1e12);
+	test.painter.stroke();
+	test.painter.move_to(-1e12, 1e12);
+	test.painter.line_to(-1e11, 1e13);
+	test.painter.stroke();
+	EXPECT_EQ(0, test.totalAlpha());
+
+	// A segment crossing the buffer is drawn in the buffer only
+	test.painter.move_to(-1e12, -20.5);
+	test.painter.line_to(1e12, -20.5);
+	test.painter.stroke();
+	EXPECT_EQ(3, test.painter.hairlineStrokes());
+	EXPECT_NEAR(SIZE, test.totalAlpha(), 0.5);
+}
+
+namespace {
+	/**
+	 * Checks that the surface is flushed before the pixels are written and marked dirty after
+	 */
+	class SurfacePainter : public LcRecordingPainter {
+		public:
+			SurfacePainter(const std::vector<uint32_t>& image, int& flushes, int& marks) :
+				_image(image),
+				_flushes(flushes),
+				_marks(marks) {
+			}
+
+			void flush() override {
+				EXPECT_EQ(_flushes, _marks) << "Flushed twice before marking the surface dirty";
+				_flushes++;
+				_before = _image;
+			}
+
+			void mark_dirty() override {
+				EXPECT_EQ(_flushes, _marks + 1) << "Surface marked dirty without being flushed";
+				_marks++;
+				EXPECT_NE(_before, _image);
+			}
+
+		private:
+			const std::vector<uint32_t>& _image;
+			std::vector<uint32_t> _before;
+			int& _flushes;
+			int& _marks;
+	};
+}
+
+TEST(HairlinePainterTest, SurfaceSynchronisation) {
+	std::vector<uint32_t> image(SIZE * SIZE, 0);
+	int flushes = 0;
+	int marks = 0;
+	LcHairlinePainter painter(new SurfacePainter(image, flushes, marks), reinterpret_cast<unsigned char*>(image.data()), SIZE, SIZE, SIZE * 4);
+	painter.source_rgb(1., 1., 1.);
+
+	painter.line_width(1.);
+	painter.move_to(5, -5);
+	painter.line_to(35, -25);
+	painter.stroke();
+	EXPECT_EQ(1, flushes);
+	EXPECT_EQ(1, marks);
+
+	// Cairo draws wide lines itself
+	painter.line_width(3.);
+	painter.move_to(5, -5);
+	painter.line_to(35, -25);
+	painter.stroke();
+	EXPECT_EQ(1, flushes);
+	EXPECT_EQ(1, marks);
+}
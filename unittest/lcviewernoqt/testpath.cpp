@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <painters/lcpath.h>
+#include <painters/lcrecordingpainter.h>
+
+using namespace LCViewer;
+
+namespace {
+	/**
+	 * Painter writing the path calls it receives as text
+	 */
+	class LogPainter : public LcNullPainter {
+		public:
+			void move_to(double x, double y) override {
+				log << "move_to " << x << " " << y << "\n";
+			}
+
+			void line_to(double x, double y) override {
+				log << "line_to " << x << " " << y << "\n";
+			}
+
+			void quadratic_curve_to(double x1, double y1, double x2, double y2) override {
+				log << "quadratic_curve_to " << x1 << " " << y1 << " " << x2 << " " << y2 << "\n";
+			}
+
+			void curve_to(double x1, double y1, double x2, double y2, double x3, double y3) override {
+				log << "curve_to " << x1 << " " << y1 << " " << x2 << " " << y2 << " " << x3 << " " << y3 << "\n";
+			}
+
+			void arc(double x, double y, double r, double start, double end) override {
+				log << "arc " << x << " " << y << " " << r << " " << start << " " << end << "\n";
+			}
+
+			void arcNegative(double x, double y, double r, double start, double end) override {
+				log << "arcNegative " << x << " " << y << " " << r << " " << start << " " << end << "\n";
+			}
+
+			void stroke() override {
+				log << "stroke\n";
+			}
+
+			std::ostringstream log;
+	};
+
+	template<typename Painter>
+	void drawPath(Painter& painter) {
+		painter.move_to(0, 0);
+		painter.line_to(10, 0.5);
+		painter.quadratic_curve_to(15, 5, 20, 0);
+		painter.curve_to(25, -5, 30, 5, 35, 0);
+		painter.stroke();
+		painter.arc(10, 10, 5, 0, 1.5);
+		painter.arcNegative(10, 10, 5, 1.5, 0.25);
+		painter.stroke();
+	}
+}
+
+TEST(PathTest, Replay) {
+	LogPainter direct;
+	drawPath(direct);
+
+	LcPath path;
+	EXPECT_TRUE(path.empty());
+	drawPath(path);
+	path.shrink_to_fit();
+	EXPECT_FALSE(path.empty());
+	EXPECT_LT(0, path.memorySize());
+
+	LogPainter replayed;
+	path.draw(replayed);
+	EXPECT_EQ(direct.log.str(), replayed.log.str());
+
+	// The path can be drawn more than once
+	LogPainter secondReplay;
+	path.draw(secondReplay);
+	EXPECT_EQ(direct.log.str(), secondReplay.log.str());
+
+	// Same calls as a recording of the path
+	LcRecordingPainter recording;
+	path.draw(recording);
+	LogPainter recorded;
+	EXPECT_TRUE(recording.replay(recorded));
+	EXPECT_EQ(direct.log.str(), recorded.log.str());
+}
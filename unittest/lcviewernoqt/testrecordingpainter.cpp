@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <painters/lcrecordingpainter.h>
+
+using namespace LCViewer;
+
+namespace {
+	/**
+	 * Recording painter keeping the device coordinates of all line_to calls
+	 */
+	class DevicePointsPainter : public LcRecordingPainter {
+		public:
+			void line_to(double x, double y) override {
+				double dx = x;
+				double dy = y;
+				user_to_device(&dx, &dy);
+				points.emplace_back(dx, dy);
+
+				LcRecordingPainter::line_to(x, y);
+			}
+
+			std::vector<lc::geo::Coordinate> points;
+	};
+
+	void drawLine(LcPainter& painter, double x1, double y1, double x2, double y2) {
+		painter.move_to(x1, y1);
+		painter.line_to(x2, y2);
+		painter.stroke();
+	}
+}
+
+TEST(RecordingPainterTest, Chunks) {
+	LcRecordingPainter painter;
+	EXPECT_TRUE(painter.empty());
+	EXPECT_EQ(0, painter.chunks());
+
+	painter.source_rgb(1., 0., 0.);
+	drawLine(painter, 0, 0, 10, 0);
+	drawLine(painter, 100, 100, 110, 100);
+	EXPECT_FALSE(painter.empty());
+	EXPECT_EQ(2, painter.chunks());
+
+	LcRecordingPainter copy;
+	EXPECT_TRUE(painter.replay(copy));
+	EXPECT_EQ(2, copy.chunks());
+
+	painter.reset();
+	EXPECT_TRUE(painter.empty());
+	EXPECT_EQ(0, painter.chunks());
+}
+
+TEST(RecordingPainterTest, Culling) {
+	LcRecordingPainter painter;
+	drawLine(painter, 0, 0, 10, 0);
+
+	painter.save();
+	painter.translate(100, -100);
+	drawLine(painter, 0, 0, 10, 0);
+	painter.restore();
+
+	painter.text("Never culled");
+
+	// The second line is at (100, 100) because of the translation
+	lc::geo::Area visible(lc::geo::Coordinate(90, 90), lc::geo::Coordinate(120, 120));
+	LcRecordingPainter culled;
+	EXPECT_TRUE(painter.replay(culled, lc::geo::Transform2D::identity(), &visible));
+	EXPECT_EQ(2, culled.chunks());
+
+	lc::geo::Area empty(lc::geo::Coordinate(-100, -100), lc::geo::Coordinate(-90, -90));
+	LcRecordingPainter onlyText;
+	EXPECT_TRUE(painter.replay(onlyText, lc::geo::Transform2D::identity(), &empty));
+	EXPECT_EQ(1, onlyText.chunks());
+
+	double x, y;
+	onlyText.getTranslate(&x, &y);
+	EXPECT_EQ(0, x);
+	EXPECT_EQ(0, y);
+}
+
+TEST(RecordingPainterTest, ReplayTransformed) {
+	LcRecordingPainter painter;
+	drawLine(painter, 0, 0, 10, 0);
+
+	auto transform = lc::geo::Transform2D::translation(lc::geo::Coordinate(5, 5)) *
+					 lc::geo::Transform2D::rotation(lc::geo::Coordinate(0, 0), M_PI / 2) *
+					 lc::geo::Transform2D::scale(lc::geo::Coordinate(0, 0), lc::geo::Coordinate(2, 2));
+
+	DevicePointsPainter target;
+	EXPECT_TRUE(painter.replay(target, transform));
+	ASSERT_EQ(1, target.points.size());
+
+	// (10, 0) scaled, rotated and translated is (5, 25) in user coordinates, y is flipped on the device
+	EXPECT_NEAR(5, target.points[0].x(), 1e-9);
+	EXPECT_NEAR(-25, target.points[0].y(), 1e-9);
+
+	double x, y;
+	target.getTranslate(&x, &y);
+	EXPECT_EQ(0, x);
+	EXPECT_EQ(0, y);
+
+	// Non uniform scale can't be replayed
+	LcRecordingPainter unsupported;
+	EXPECT_FALSE(painter.replay(unsupported, lc::geo::Transform2D::scale(lc::geo::Coordinate(0, 0), lc::geo::Coordinate(1, 2))));
+	EXPECT_TRUE(unsupported.empty());
+}
+
+TEST(RecordingPainterTest, ResetTransformations) {
+	LcRecordingPainter painter;
+	painter.translate(100, 100);
+	painter.reset_transformations();
+	drawLine(painter, 0, 0, 10, 0);
+
+	DevicePointsPainter target;
+	target.scale(2);
+	EXPECT_TRUE(painter.replay(target, lc::geo::Transform2D::translation(lc::geo::Coordinate(5, 0))));
+	ASSERT_EQ(1, target.points.size());
+
+	// The reset returns to the scale of the target and the replay transformation
+	EXPECT_NEAR(30, target.points[0].x(), 1e-9);
+	EXPECT_NEAR(0, target.points[0].y(), 1e-9);
+
+	double x, y;
+	target.getTranslate(&x, &y);
+	EXPECT_EQ(0, x);
+	EXPECT_EQ(0, y);
+	EXPECT_EQ(2, target.scale());
+}
+
+TEST(RecordingPainterTest, CullingLineWidth) {
+	LcRecordingPainter painter;
+	painter.line_width(20.);
+	drawLine(painter, 0, 0, 10, 0);
+
+	// The stroke is 20 pixels wide, it covers the area above the line
+	lc::geo::Area visible(lc::geo::Coordinate(0, 5), lc::geo::Coordinate(10, 8));
+	DevicePointsPainter target;
+	EXPECT_TRUE(painter.replay(target, lc::geo::Transform2D::identity(), &visible));
+	EXPECT_EQ(1, target.points.size());
+
+	// Zoomed in ten times, the stroke is only 2 units wide
+	DevicePointsPainter zoomed;
+	zoomed.scale(10);
+	EXPECT_TRUE(painter.replay(zoomed, lc::geo::Transform2D::identity(), &visible));
+	EXPECT_EQ(0, zoomed.points.size());
+}
@@ -31,7 +31,7 @@ TEST(SelectionTest, NormalSelection) {
 
 	unsigned int i = 0;
 
-	docCanvas->entityContainer().each<LCViewer::LCVDrawItem>([&](LCViewer::LCVDrawItem_CSPtr di) {
+	docCanvas->drawItems(docCanvas->entityContainer()).each<LCViewer::LCVDrawItem>([&](LCViewer::LCVDrawItem_CSPtr di) {
 		if(di->selected()) {
 			i++;
 		}
@@ -61,7 +61,7 @@ TEST(SelectionTest, IntersectionSelection) {
 
 	unsigned int i = 0;
 
-	docCanvas->entityContainer().each<LCViewer::LCVDrawItem>([&](LCViewer::LCVDrawItem_CSPtr di) {
+	docCanvas->drawItems(docCanvas->entityContainer()).each<LCViewer::LCVDrawItem>([&](LCViewer::LCVDrawItem_CSPtr di) {
 		if(di->selected() == true) {
 			i++;
 		}
@@ -94,7 +94,7 @@ TEST(SelectionTest, AddToSelection) {
 
 	unsigned int i = 0;
 
-	docCanvas->entityContainer().each<LCViewer::LCVDrawItem>([&](LCViewer::LCVDrawItem_CSPtr di) {
+	docCanvas->drawItems(docCanvas->entityContainer()).each<LCViewer::LCVDrawItem>([&](LCViewer::LCVDrawItem_CSPtr di) {
 		if(di->selected() == true) {
 			i++;
 		}
@@ -127,7 +127,7 @@ TEST(SelectionTest, Reselect) {
 
 	unsigned int i = 0;
 
-	docCanvas->entityContainer().each<LCViewer::LCVDrawItem>([&](LCViewer::LCVDrawItem_CSPtr di) {
+	docCanvas->drawItems(docCanvas->entityContainer()).each<LCViewer::LCVDrawItem>([&](LCViewer::LCVDrawItem_CSPtr di) {
 		if(di->selected() == true) {
 			i++;
 		}
@@ -160,7 +160,7 @@ TEST(SelectionTest, ClearSelection) {
 
 	unsigned int i = 0;
 
-	docCanvas->entityContainer().each<LCViewer::LCVDrawItem>([&](LCViewer::LCVDrawItem_CSPtr di) {
+	docCanvas->drawItems(docCanvas->entityContainer()).each<LCViewer::LCVDrawItem>([&](LCViewer::LCVDrawItem_CSPtr di) {
 		if(di->selected() == true) {
 			i++;
 		}
@@ -191,7 +191,7 @@ TEST(SelectionTest, Deselect) {
 
 	unsigned int i = 0;
 
-	docCanvas->entityContainer().each<LCViewer::LCVDrawItem>([&](LCViewer::LCVDrawItem_CSPtr di) {
+	docCanvas->drawItems(docCanvas->entityContainer()).each<LCViewer::LCVDrawItem>([&](LCViewer::LCVDrawItem_CSPtr di) {
 		if(di->selected() == true) {
 			i++;
 		}
@@ -225,11 +225,59 @@ TEST(SelectionTest, DeselectAddTo) {
 
 	unsigned int i = 0;
 
-	docCanvas->entityContainer().each<LCViewer::LCVDrawItem>([&](LCViewer::LCVDrawItem_CSPtr di) {
+	docCanvas->drawItems(docCanvas->entityContainer()).each<LCViewer::LCVDrawItem>([&](LCViewer::LCVDrawItem_CSPtr di) {
 		if(di->selected() == true) {
 			i++;
 		}
 	});
 
 	EXPECT_TRUE(i == docCanvas->selection().asVector().size());
-}
\ No newline at end of file
+}
+
+TEST(SelectionTest, IncrementalSelection) {
+	auto storageManager = std::make_shared<lc::StorageManagerImpl>();
+	auto document = std::make_shared<lc::DocumentImpl>(storageManager);
+	auto docCanvas = std::make_shared<LCViewer::DocumentCanvas>(document);
+	auto expectedCanvas = std::make_shared<LCViewer::DocumentCanvas>(document);
+
+	auto layer = std::make_shared<lc::Layer>("0", lc::Color(1., 1., 1., 1.));
+	std::shared_ptr<lc::operation::AddLayer> al = std::make_shared<lc::operation::AddLayer>(document, layer);
+	al->execute();
+
+	auto builder = std::make_shared<lc::operation::EntityBuilder>(document);
+	for(int x = 0; x < 20; x++) {
+		for(int y = 0; y < 20; y++) {
+			builder->appendEntity(std::make_shared<lc::entity::Line>(lc::geo::Coordinate(x * 10, y * 10), lc::geo::Coordinate(x * 10 + 15, y * 10 + 5), layer));
+		}
+	}
+	builder->execute();
+
+	for(auto occupies : {true, false}) {
+		// Drag the area in all directions, each step must give the same result as a new selection
+		std::vector<std::vector<double>> areas = {
+			{5, 5, 10, 10}, {5, 5, 60, 40}, {5, 5, 120, 130}, {-10, 20, 80, 30}, {40, -5, 10, 200}, {5, 5, 60, 40}
+		};
+
+		for(const auto& area : areas) {
+			docCanvas->makeSelection(area[0], area[1], area[2], area[3], occupies, false);
+			expectedCanvas->makeSelection(area[0], area[1], area[2], area[3], occupies, false);
+			expectedCanvas->closeSelection();
+
+			unsigned int selected = 0;
+			for(const auto& entity : document->entities()) {
+				auto di = docCanvas->drawItem(entity->id());
+				EXPECT_EQ(expectedCanvas->selectionSet().contains(entity->id()), di->selected());
+
+				if(di->selected()) {
+					selected++;
+				}
+			}
+
+			EXPECT_EQ(expectedCanvas->selectionSet().size(), selected);
+		}
+
+		docCanvas->closeSelection();
+		docCanvas->removeSelectionArea();
+		EXPECT_TRUE(expectedCanvas->selectionSet() == docCanvas->selectionSet());
+	}
+}
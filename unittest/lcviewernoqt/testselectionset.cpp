@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include "selectionset.h"
+
+using namespace LCViewer;
+
+TEST(SelectionSetTest, InsertErase) {
+	SelectionSet set;
+	EXPECT_TRUE(set.empty());
+
+	EXPECT_TRUE(set.insert(3));
+	EXPECT_TRUE(set.insert(200));
+	EXPECT_FALSE(set.insert(3));
+	EXPECT_EQ(2, set.size());
+	EXPECT_TRUE(set.contains(3));
+	EXPECT_TRUE(set.contains(200));
+	EXPECT_FALSE(set.contains(4));
+	EXPECT_FALSE(set.contains(100000));
+
+	EXPECT_TRUE(set.erase(3));
+	EXPECT_FALSE(set.erase(3));
+	EXPECT_FALSE(set.erase(100000));
+	EXPECT_EQ(1, set.size());
+
+	EXPECT_TRUE(set.toggle(64));
+	EXPECT_FALSE(set.toggle(200));
+	EXPECT_EQ(std::vector<ID_DATATYPE>({64}), set.ids());
+
+	set.clear();
+	EXPECT_TRUE(set.empty());
+	EXPECT_FALSE(set.contains(64));
+}
+
+TEST(SelectionSetTest, SetOperations) {
+	SelectionSet a;
+	SelectionSet b;
+
+	for(ID_DATATYPE id = 0; id < 100; id++) {
+		a.insert(id);
+	}
+	for(ID_DATATYPE id = 50; id < 300; id++) {
+		b.insert(id);
+	}
+
+	auto unionSet = a;
+	unionSet.insert(b);
+	EXPECT_EQ(300, unionSet.size());
+
+	auto difference = a;
+	difference.erase(b);
+	EXPECT_EQ(50, difference.size());
+	EXPECT_TRUE(difference.contains(49));
+	EXPECT_FALSE(difference.contains(50));
+
+	auto symmetricDifference = a;
+	symmetricDifference.toggle(b);
+	EXPECT_EQ(250, symmetricDifference.size());
+	EXPECT_FALSE(symmetricDifference.contains(75));
+	EXPECT_TRUE(symmetricDifference.contains(299));
+
+	// Toggling twice gives the original set
+	symmetricDifference.toggle(b);
+	EXPECT_TRUE(symmetricDifference == a);
+
+	// Sets with different capacity can be equal
+	SelectionSet small;
+	small.insert(1);
+	SelectionSet large;
+	large.insert(1000);
+	large.insert(1);
+	large.erase(1000);
+	EXPECT_TRUE(small == large);
+}
+
+TEST(SelectionSetTest, LargeIds) {
+	// IDs keep growing over a session, a few selected entities don't need a bitmap up to their ID
+	const ID_DATATYPE high = static_cast<ID_DATATYPE>(1) << 40;
+
+	SelectionSet set;
+	EXPECT_TRUE(set.insert(5));
+	EXPECT_TRUE(set.insert(high));
+	EXPECT_TRUE(set.insert(high + 70));
+	EXPECT_FALSE(set.insert(high));
+	EXPECT_EQ(3, set.size());
+	EXPECT_LT(set.memorySize(), 64 * 1024u);
+
+	EXPECT_TRUE(set.contains(high));
+	EXPECT_FALSE(set.contains(high + 1));
+	EXPECT_EQ(std::vector<ID_DATATYPE>({5, high, high + 70}), set.ids());
+
+	SelectionSet other;
+	other.insert(high + 70);
+	other.insert(6);
+
+	auto unionSet = set;
+	unionSet.insert(other);
+	EXPECT_EQ(std::vector<ID_DATATYPE>({5, 6, high, high + 70}), unionSet.ids());
+
+	auto difference = set;
+	difference.erase(other);
+	EXPECT_EQ(std::vector<ID_DATATYPE>({5, high}), difference.ids());
+
+	auto symmetricDifference = set;
+	symmetricDifference.toggle(other);
+	EXPECT_EQ(std::vector<ID_DATATYPE>({5, 6, high}), symmetricDifference.ids());
+
+	EXPECT_TRUE(set.erase(high));
+	EXPECT_FALSE(set.erase(high));
+	EXPECT_EQ(2, set.size());
+}
+
+TEST(SelectionSetTest, SparseMovesToBitmap) {
+	// Entities with IDs far above the bitmap are selected one by one, until there are enough of them for a bitmap
+	const ID_DATATYPE first = 1000000;
+	const ID_DATATYPE count = 100000;
+
+	SelectionSet set;
+	SelectionSet reference;
+	for(ID_DATATYPE id = first; id < first + count; id++) {
+		set.insert(id);
+	}
+	for(ID_DATATYPE id = first + count - 1; id >= first; id--) {
+		reference.insert(id);
+	}
+
+	EXPECT_EQ(count, set.size());
+	EXPECT_TRUE(set.contains(first));
+	EXPECT_TRUE(set.contains(first + count - 1));
+	EXPECT_FALSE(set.contains(first + count));
+	EXPECT_TRUE(set == reference);
+
+	// Mostly stored as bitmap, which is smaller than the set nodes
+	EXPECT_LT(set.memorySize(), count * sizeof(ID_DATATYPE));
+
+	auto ids = set.ids();
+	ASSERT_EQ(count, ids.size());
+	EXPECT_TRUE(std::is_sorted(ids.begin(), ids.end()));
+}
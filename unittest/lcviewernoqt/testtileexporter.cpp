@@ -0,0 +1,265 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <set>
+#include <sstream>
+#include "tileexporter.h"
+#include <cad/dochelpers/documentimpl.h>
+#include <cad/dochelpers/storagemanagerimpl.h>
+#include <cad/operations/entitybuilder.h>
+#include <cad/operations/entityops.h>
+#include <cad/primitive/line.h>
+#include <painters/lccountingpainter.h>
+
+using namespace LCViewer;
+
+namespace {
+	// Lines in the bottom left and top right corners of the square (1, 1) (99, 99)
+	std::shared_ptr<lc::DocumentImpl> cornersDocument() {
+		auto document = std::make_shared<lc::DocumentImpl>(std::make_shared<lc::StorageManagerImpl>());
+		auto layer = document->layerByName("0");
+
+		auto builder = std::make_shared<lc::operation::EntityBuilder>(document);
+		builder->appendEntity(std::make_shared<lc::entity::Line>(lc::geo::Coordinate(1, 1), lc::geo::Coordinate(2, 2), layer));
+		builder->appendEntity(std::make_shared<lc::entity::Line>(lc::geo::Coordinate(98, 98), lc::geo::Coordinate(99, 99), layer));
+		builder->execute();
+
+		return document;
+	}
+
+	void useNullPainters(TileExporter& exporter) {
+		exporter.createPainterFunctor([](const unsigned int, const unsigned int) {
+			return new LcNullPainter();
+		});
+		exporter.deletePainterFunctor([](LcPainter* painter) {
+			delete painter;
+		});
+	}
+}
+
+TEST(TileExporterTest, OccupiedTiles) {
+	TileExporter exporter(cornersDocument());
+
+	auto bounds = exporter.bounds();
+	EXPECT_DOUBLE_EQ(1., bounds.minP().x());
+	EXPECT_DOUBLE_EQ(99., bounds.maxP().y());
+
+	EXPECT_EQ(1, exporter.occupiedTiles(0).size());
+
+	// y grows downwards
+	auto tiles = exporter.occupiedTiles(3);
+	ASSERT_EQ(2, tiles.size());
+	EXPECT_EQ(0, tiles[0].x);
+	EXPECT_EQ(7, tiles[0].y);
+	EXPECT_EQ(7, tiles[1].x);
+	EXPECT_EQ(0, tiles[1].y);
+	EXPECT_DOUBLE_EQ(86.75, tiles[1].area.minP().x());
+	EXPECT_DOUBLE_EQ(86.75, tiles[1].area.minP().y());
+	EXPECT_DOUBLE_EQ(12.25, tiles[1].area.width());
+
+	EXPECT_THROW(exporter.occupiedTiles(31), std::runtime_error);
+}
+
+TEST(TileExporterTest, DeepZoomDiagonal) {
+	auto document = std::make_shared<lc::DocumentImpl>(std::make_shared<lc::StorageManagerImpl>());
+	auto builder = std::make_shared<lc::operation::EntityBuilder>(document);
+	builder->appendEntity(std::make_shared<lc::entity::Line>(lc::geo::Coordinate(0, 0), lc::geo::Coordinate(1000000, 370000), document->layerByName("0")));
+	builder->execute();
+
+	TileExporter exporter(document);
+
+	// The bounding box of the line covers 16384 x 6062 tiles, the line crosses about 22500 of them
+	const unsigned int zoom = 14;
+	const size_t count = 1u << zoom;
+	auto tiles = exporter.occupiedTiles(zoom);
+
+	EXPECT_GE(tiles.size(), count);
+	EXPECT_LT(tiles.size(), 2 * count);
+
+	// Every column has a tile, close to the line
+	std::set<unsigned int> columns;
+	const double tileSize = exporter.bounds().width() / count;
+	for (const auto& tile : tiles) {
+		columns.insert(tile.x);
+
+		const double lineY = tile.area.minP().x() * 0.37;
+		EXPECT_LE(tile.area.minP().y(), lineY + tileSize);
+		EXPECT_GE(tile.area.maxP().y(), lineY - tileSize);
+	}
+	EXPECT_EQ(count, columns.size());
+}
+
+TEST(TileExporterTest, Export) {
+	std::atomic<int> written(0);
+	size_t strokes = 0;
+
+	{
+		TileExporter exporter(cornersDocument());
+		exporter.setTileSize(32);
+		exporter.createPainterFunctor([](const unsigned int, const unsigned int) {
+			return new LcCountingPainter();
+		});
+		exporter.deletePainterFunctor([&](LcPainter* painter) {
+			strokes += static_cast<LcCountingPainter*>(painter)->statistics().strokes;
+			delete painter;
+		});
+		exporter.writeTileFunctor([&](LcPainter&, const TileExporter::Tile& tile) {
+			written++;
+			return true;
+		});
+
+		auto statistics = exporter.exportTiles(0, 3);
+		EXPECT_EQ(7, statistics.rendered);
+		EXPECT_EQ(7, statistics.written);
+		EXPECT_EQ(0, statistics.unchanged);
+
+		// The hashes don't depend on the painter
+		std::ostringstream hashes;
+		exporter.writeHashes(hashes);
+		auto content = hashes.str();
+		EXPECT_EQ(7, std::count(content.begin(), content.end(), '\n'));
+	}
+
+	EXPECT_EQ(7, written);
+	// Both lines on tile 0/0/0, one line on each other tile
+	EXPECT_EQ(8, strokes);
+}
+
+TEST(TileExporterTest, UnchangedTiles) {
+	auto document = cornersDocument();
+	std::ostringstream hashes;
+
+	auto exportTiles = [&](TileExporter& exporter) {
+		exporter.setTileSize(16);
+		useNullPainters(exporter);
+		exporter.writeTileFunctor([](LcPainter&, const TileExporter::Tile&) {
+			return true;
+		});
+
+		return exporter.exportTiles(0, 2);
+	};
+
+	{
+		TileExporter exporter(document);
+		auto statistics = exportTiles(exporter);
+		EXPECT_EQ(5, statistics.written);
+		exporter.writeHashes(hashes);
+	}
+
+	TileExporter exporter(document);
+	std::istringstream stream(hashes.str());
+	exporter.readHashes(stream);
+
+	// Unchanged tiles are not rendered
+	auto statistics = exportTiles(exporter);
+	EXPECT_EQ(0, statistics.rendered);
+	EXPECT_EQ(0, statistics.written);
+	EXPECT_EQ(5, statistics.unchanged);
+
+	// A different tile size changes all hashes
+	TileExporter resized(document);
+	std::istringstream resizedStream(hashes.str());
+	resized.readHashes(resizedStream);
+	resized.setTileSize(32);
+	useNullPainters(resized);
+
+	statistics = resized.exportTiles(0, 2);
+	EXPECT_EQ(5, statistics.rendered);
+	EXPECT_EQ(0, statistics.unchanged);
+}
+
+TEST(TileExporterTest, SameDrawingInAnotherDocument) {
+	std::ostringstream hashes;
+
+	{
+		TileExporter exporter(cornersDocument());
+		useNullPainters(exporter);
+
+		auto statistics = exporter.exportTiles(0, 2);
+		EXPECT_EQ(5, statistics.written);
+		exporter.writeHashes(hashes);
+	}
+
+	// Same lines added in the other order, the entities get other IDs
+	auto document = std::make_shared<lc::DocumentImpl>(std::make_shared<lc::StorageManagerImpl>());
+	auto layer = document->layerByName("0");
+	auto builder = std::make_shared<lc::operation::EntityBuilder>(document);
+	builder->appendEntity(std::make_shared<lc::entity::Line>(lc::geo::Coordinate(98, 98), lc::geo::Coordinate(99, 99), layer));
+	builder->appendEntity(std::make_shared<lc::entity::Line>(lc::geo::Coordinate(1, 1), lc::geo::Coordinate(2, 2), layer));
+	builder->execute();
+
+	TileExporter exporter(document);
+	useNullPainters(exporter);
+	std::istringstream stream(hashes.str());
+	exporter.readHashes(stream);
+
+	auto statistics = exporter.exportTiles(0, 2);
+	EXPECT_EQ(0, statistics.rendered) << "Tiles of the same drawing were rendered again";
+	EXPECT_EQ(5, statistics.unchanged);
+}
+
+TEST(TileExporterTest, EditAndExportAgain) {
+	auto document = cornersDocument();
+	const lc::geo::Area bounds(lc::geo::Coordinate(0, 0), lc::geo::Coordinate(100, 100));
+	std::ostringstream hashes;
+
+	{
+		TileExporter exporter(document);
+		exporter.setBounds(bounds);
+		useNullPainters(exporter);
+
+		auto statistics = exporter.exportTiles(0, 2);
+		EXPECT_EQ(5, statistics.written);
+		exporter.writeHashes(hashes);
+	}
+
+	// Move the line in the top right corner down to the right half of the bottom
+	lc::entity::CADEntity_CSPtr topRight;
+	for (const auto& entity : document->entityContainer().asVector()) {
+		if (entity->boundingBox().minP().x() > 50.) {
+			topRight = entity;
+		}
+	}
+	ASSERT_NE(nullptr, topRight);
+
+	auto builder = std::make_shared<lc::operation::EntityBuilder>(document);
+	builder->appendEntity(topRight);
+	builder->appendOperation(std::make_shared<lc::operation::Push>());
+	builder->appendOperation(std::make_shared<lc::operation::Move>(lc::geo::Coordinate(0, -50)));
+	builder->execute();
+
+	TileExporter exporter(document);
+	exporter.setBounds(bounds);
+	useNullPainters(exporter);
+
+	std::istringstream stream(hashes.str());
+	exporter.readHashes(stream);
+
+	std::set<std::string> rendered;
+	std::set<std::string> removed;
+	auto name = [](const TileExporter::Tile& tile) {
+		return std::to_string(tile.zoom) + "/" + std::to_string(tile.x) + "/" + std::to_string(tile.y);
+	};
+	exporter.writeTileFunctor([&](LcPainter&, const TileExporter::Tile& tile) {
+		rendered.insert(name(tile));
+		return true;
+	});
+	exporter.removeTileFunctor([&](const TileExporter::Tile& tile) {
+		removed.insert(name(tile));
+		return true;
+	});
+
+	auto statistics = exporter.exportTiles(0, 2);
+	EXPECT_EQ(3, statistics.rendered);
+	EXPECT_EQ(2, statistics.unchanged);
+	EXPECT_EQ(2, statistics.removed);
+
+	EXPECT_EQ(std::set<std::string>({"0/0/0", "1/1/1", "2/3/2"}), rendered);
+	EXPECT_EQ(std::set<std::string>({"1/1/0", "2/3/0"}), removed);
+
+	std::ostringstream updated;
+	exporter.writeHashes(updated);
+	EXPECT_EQ(std::string::npos, updated.str().find("1/1/0 "));
+	EXPECT_EQ(std::string::npos, updated.str().find("2/3/0 "));
+	EXPECT_NE(std::string::npos, updated.str().find("2/3/2 "));
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <batchrenderer.h>
+
+namespace {
+	// Sets a global, the next job of the worker must not see it
+	const char* SETTER = R"(
+		leaked = true
+
+		local builder = EntityBuilder(document)
+		builder:appendLines({0, 0, 100, 100}, document:layerByName("0"))
+		builder:execute()
+	)";
+
+	const char* READER = R"(
+		if leaked ~= nil then
+			error("global of the previous job is visible")
+		end
+
+		local builder = EntityBuilder(document)
+		builder:appendLines({0, 100, 100, 0, 0, 0, 100, 0}, document:layerByName("0"))
+		builder:execute()
+	)";
+
+	void writeFile(const boost::filesystem::path& path, const std::string& content) {
+		std::ofstream file(path.string(), std::ios::binary | std::ios::trunc);
+		file << content;
+	}
+
+	std::string readSignature(const boost::filesystem::path& path) {
+		std::ifstream file(path.string(), std::ios::binary);
+		std::string signature(8, '\0');
+		file.read(&signature[0], signature.size());
+		return file ? signature : "";
+	}
+}
+
+TEST(BatchRendererTest, JobIsolation) {
+	auto directory = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("lcbatch-%%%%-%%%%");
+	boost::filesystem::create_directories(directory);
+
+	writeFile(directory / "setter.lua", SETTER);
+	writeFile(directory / "reader.lua", READER);
+
+	std::vector<BatchJob> jobs(2);
+	jobs[0].input = "file:" + (directory / "setter.lua").string();
+	jobs[0].output = (directory / "setter.png").string();
+	jobs[0].type = "png";
+	jobs[1].input = "file:" + (directory / "reader.lua").string();
+	jobs[1].output = (directory / "reader.png").string();
+	jobs[1].type = "png";
+	jobs[1].width = 200;
+	jobs[1].height = 100;
+
+	// A single worker runs both jobs in order with the same Lua state
+	BatchRenderer renderer(1);
+	auto results = renderer.run(jobs);
+
+	ASSERT_EQ(2u, results.size());
+	EXPECT_EQ("", results[0].error);
+	EXPECT_EQ("", results[1].error);
+	EXPECT_EQ(1u, results[0].entities);
+	EXPECT_EQ(2u, results[1].entities);
+
+	const std::string pngSignature("\x89PNG\r\n\x1a\n", 8);
+	for(const auto& job : jobs) {
+		EXPECT_TRUE(boost::filesystem::exists(job.output)) << job.output;
+		EXPECT_EQ(pngSignature, readSignature(job.output)) << job.output;
+	}
+
+	boost::filesystem::remove_all(directory);
+}
@@ -10,6 +10,7 @@
 #include <cad/dochelpers/storagemanagerimpl.h>
 #include <documentcanvas.h>
 #include <painters/lccairopainter.tcc>
+#include <painters/createpainter.h>
 #include <file.h>
 #include <drawables/gradientbackground.h>
 #include <boost/program_options/variables_map.hpp>
@@ -128,7 +129,10 @@ bool checkRender(const std::string& image1, const std::string& image2, float tol
     return true;
 }
 
-TEST(RenderingTest, Test) {
+/**
+ * Call f for each test in the rendering resources dir, with the configuration of the test
+ */
+void forEachRenderingTest(const std::function<void(unsigned int, const std::string&, int, int, int, int, int, int, int)>& f) {
     int imageW;
     int imageH;
     int x;
@@ -189,9 +193,6 @@ TEST(RenderingTest, Test) {
 
         if(dxfFound && pngFound && configFound) {
             auto base = std::string("../unittest/rendering/res/") + std::to_string(newNumber);
-            auto expectedFile = base + ".png";
-            auto dxfFile = base + ".dxf";
-            auto resultFile = base + ".out";
             auto configFile = base + ".cfg";
 
             resetConfig(&imageW, &imageH, &x, &y, &w, &h, &tolerance);
@@ -206,12 +207,91 @@ TEST(RenderingTest, Test) {
             std::cout << "Box " << x << ";" << y << " - " << w << "*" << h << std::endl;
             std::cout << "Tolerance " << tolerance << std::endl;
 
-            render(dxfFile, resultFile, imageW, imageH, x, y, w, h);
-            ASSERT_TRUE(checkRender(expectedFile, resultFile, tolerance)) << "Failed with " << expectedFile;
+            f(newNumber, base, imageW, imageH, x, y, w, h, tolerance);
 
             dxfFound = false; //Prevent running the test more than once
             pngFound = false;
             configFound = false;
         }
     }
-}
\ No newline at end of file
+}
+
+TEST(RenderingTest, Test) {
+    forEachRenderingTest([](unsigned int, const std::string& base, int imageW, int imageH, int x, int y, int w, int h, int tolerance) {
+        auto expectedFile = base + ".png";
+        auto resultFile = base + ".out";
+
+        render(base + ".dxf", resultFile, imageW, imageH, x, y, w, h);
+        ASSERT_TRUE(checkRender(expectedFile, resultFile, tolerance)) << "Failed with " << expectedFile;
+    });
+}
+
+/**
+ * Render a DXF file into an ARGB32 buffer with the painter created by createPainter
+ */
+std::vector<unsigned char> renderImage(const std::string& dxf,
+                                       const std::function<LcPainter*(unsigned char*, unsigned int, unsigned int)>& createPainter,
+                                       unsigned int imageWidth, unsigned int imageHeight, int x, int y, int w, int h) {
+    std::vector<unsigned char> image(cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, imageWidth) * imageHeight);
+    LcPainter* lcPainter = nullptr;
+
+    auto _storageManager = std::make_shared<lc::StorageManagerImpl>();
+    auto _document = std::make_shared<lc::DocumentImpl>(_storageManager);
+    auto _canvas = std::make_shared<LCViewer::DocumentCanvas>(_document);
+
+    auto _gradientBackground = std::make_shared<GradientBackground>(
+            lc::Color(0x00, 0x00, 0x00),
+            lc::Color(0x00, 0x00, 0x00)
+    );
+    _canvas->background().connect<GradientBackground, &GradientBackground::draw>(_gradientBackground.get());
+
+    _canvas->createPainterFunctor(
+            [&](const unsigned int width, const unsigned int height) {
+                if (lcPainter == nullptr) {
+                    lcPainter = createPainter(image.data(), imageWidth, imageHeight);
+                }
+
+                return lcPainter;
+            }
+    );
+
+    _canvas->deletePainterFunctor([&](LcPainter* painter) {
+        if (painter != nullptr && lcPainter != nullptr) {
+            delete painter;
+            lcPainter = nullptr;
+        }
+    });
+
+    _canvas->newDeviceSize(imageWidth, imageHeight);
+
+    lc::File::open(_document, dxf, lc::File::LIBDXFRW);
+
+    _canvas->setDisplayArea(lc::geo::Area(lc::geo::Coordinate(x, y), w, h));
+    _canvas->render(
+            [&](LcPainter&) {},
+            [&](LcPainter&) {}
+    );
+
+    _canvas->removePainters();
+
+    return image;
+}
+
+TEST(RenderingTest, Hairline) {
+    forEachRenderingTest([](unsigned int, const std::string& base, int imageW, int imageH, int x, int y, int w, int h, int tolerance) {
+        auto expected = renderImage(base + ".dxf", createCairoImagePainter, imageW, imageH, x, y, w, h);
+        auto result = renderImage(base + ".dxf", createHairlineImagePainter, imageW, imageH, x, y, w, h);
+
+        ASSERT_EQ(expected.size(), result.size());
+
+        // The rasterizer uses its own anti-aliasing, edges of the lines are slightly different.
+        // The images are compared on the mean difference of the channels.
+        double difference = 0.;
+        for(size_t i = 0; i < expected.size(); i++) {
+            difference += std::abs(expected[i] - result[i]);
+        }
+        difference /= expected.size();
+
+        EXPECT_LE(difference, 256.0 * (tolerance / 100.0)) << "Failed with " << base;
+    });
+}